@@ -0,0 +1,126 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "../xSchedule/Blend.h"
+
+static const std::vector<APPLYMETHOD> APPLY_METHODS = {
+    METHOD_OVERWRITE, METHOD_OVERWRITEIFZERO, METHOD_OVERWRITESKIPBLACK, METHOD_MASK,
+    METHOD_UNMASK, METHOD_AVERAGE, METHOD_MAX, METHOD_OVERWRITEIFBLACK,
+    METHOD_MASKPIXEL, METHOD_UNMASKPIXEL, METHOD_MIN, METHOD_BRIGHTNESS
+};
+
+static const std::vector<BLENDINSTRUCTIONSET> INSTRUCTION_SETS = { BLEND_SSE2, BLEND_AVX2, BLEND_NEON };
+
+// random bytes with plenty of zero channels and black pixels as those are where the modes branch
+static std::vector<uint8_t> RandomChannels(size_t size, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> kind(0, 3);
+    std::vector<uint8_t> res(size);
+    for (size_t i = 0; i < size; i += 3) {
+        int k = kind(rng);
+        for (size_t j = i; j < std::min(i + 3, size); ++j) {
+            res[j] = k == 0 ? 0 : (k == 1 && byte(rng) < 128 ? 0 : byte(rng));
+        }
+    }
+    return res;
+}
+
+TEST(Blend_Tests, InstructionSetsMatchScalar) {
+    BLENDINSTRUCTIONSET original = GetBlendInstructionSet();
+    std::mt19937 rng(42);
+
+    for (auto set : INSTRUCTION_SETS) {
+        if (!IsBlendInstructionSetSupported(set)) continue;
+
+        for (size_t size : { 0, 1, 3, 14, 15, 16, 17, 30, 31, 32, 47, 48, 50, 97, 300, 1001 }) {
+            for (size_t offset : { 0, 1, 3 }) {
+                auto buffer = RandomChannels(size + offset, rng);
+                auto blend = RandomChannels(size, rng);
+                for (auto method : APPLY_METHODS) {
+                    auto expected = buffer;
+                    SetBlendInstructionSet(BLEND_SCALAR);
+                    Blend(expected.data(), expected.size(), blend.data(), blend.size(), method, offset);
+
+                    auto actual = buffer;
+                    SetBlendInstructionSet(set);
+                    Blend(actual.data(), actual.size(), blend.data(), blend.size(), method, offset);
+
+                    ASSERT_EQ(expected, actual) << DecodeBlendInstructionSet(set) << " " << DecodeBlendMode(method)
+                                                << " size " << size << " offset " << offset;
+                }
+            }
+        }
+    }
+    SetBlendInstructionSet(original);
+}
+
+TEST(Blend_Tests, Brightness) {
+    BLENDINSTRUCTIONSET original = GetBlendInstructionSet();
+
+    // every pair of values so the divide by 255 is checked exhaustively
+    std::vector<uint8_t> buffer(256 * 256);
+    std::vector<uint8_t> blend(256 * 256);
+    for (int i = 0; i < 256 * 256; ++i) {
+        buffer[i] = i / 256;
+        blend[i] = i % 256;
+    }
+    for (auto set : { BLEND_SCALAR, BLEND_SSE2, BLEND_AVX2, BLEND_NEON }) {
+        if (!IsBlendInstructionSetSupported(set)) continue;
+        SetBlendInstructionSet(set);
+        auto actual = buffer;
+        Blend(actual.data(), actual.size(), blend.data(), blend.size(), METHOD_BRIGHTNESS);
+        for (int i = 0; i < 256 * 256 - 1; ++i) {
+            ASSERT_EQ(actual[i], buffer[i] * blend[i] / 255) << DecodeBlendInstructionSet(set) << " " << i;
+        }
+    }
+    SetBlendInstructionSet(original);
+}
+
+// Prints the per frame time of each mode for every instruction set the cpu has. InstructionSetsMatchScalar is
+// what checks the results, run this one by hand with --gtest_also_run_disabled_tests
+TEST(Blend_Tests, DISABLED_BlendBenchmark) {
+    const size_t CHANNELS = 510 * 1024;
+    const int FRAMES = 50;
+    BLENDINSTRUCTIONSET original = GetBlendInstructionSet();
+    std::mt19937 rng(42);
+    auto buffer = RandomChannels(CHANNELS, rng);
+    auto blend = RandomChannels(CHANNELS, rng);
+
+    auto time = [&](BLENDINSTRUCTIONSET set, APPLYMETHOD method) {
+        SetBlendInstructionSet(set);
+        auto b = buffer;
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 0; f < FRAMES; ++f) {
+            Blend(b.data(), b.size(), blend.data(), blend.size(), method);
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+    };
+
+    printf("Blend using %s\n", DecodeBlendInstructionSet(original).c_str());
+    for (auto method : APPLY_METHODS) {
+        double scalar = time(BLEND_SCALAR, method);
+        printf("%-22s scalar %8.1fus", DecodeBlendMode(method).c_str(), scalar);
+        for (auto set : INSTRUCTION_SETS) {
+            if (!IsBlendInstructionSetSupported(set)) continue;
+            double t = time(set, method);
+            printf(", %s %8.1fus %5.1fx", DecodeBlendInstructionSet(set).c_str(), t, scalar / t);
+        }
+        printf("\n");
+    }
+    SetBlendInstructionSet(original);
+}
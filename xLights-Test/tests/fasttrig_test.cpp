@@ -0,0 +1,48 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <cmath>
+#include <vector>
+
+#include "../xLights/FastTrig.h"
+
+TEST(FastTrig_Tests, Trig_Test) {
+    // odd count so the scalar tail gets used too
+    std::vector<float> in;
+    for (float f = -200.0f; f < 200.0f; f += 0.0371f) {
+        in.push_back(f);
+    }
+    in.push_back(0.0f);
+
+    std::vector<float> s = in;
+    std::vector<float> c = in;
+    FastTrig::Sin(s.data(), (int)s.size());
+    FastTrig::Cos(c.data(), (int)c.size());
+
+    for (size_t i = 0; i < in.size(); i++) {
+        ASSERT_NEAR(std::sin((double)in[i]), s[i], 1e-5) << in[i];
+        ASSERT_NEAR(std::cos((double)in[i]), c[i], 1e-5) << in[i];
+        ASSERT_NEAR(FastTrig::FastSin(in[i]), s[i], 1e-6) << in[i];
+    }
+}
+
+TEST(FastTrig_Tests, Sqrt_Test) {
+    std::vector<float> v = { 0.0f, 1.0f, 2.0f, 4.0f, 9.0f, 0.25f, 1000000.0f };
+    FastTrig::Sqrt(v.data(), (int)v.size());
+    EXPECT_EQ(0.0f, v[0]);
+    EXPECT_EQ(1.0f, v[1]);
+    EXPECT_FLOAT_EQ(std::sqrt(2.0f), v[2]);
+    EXPECT_EQ(2.0f, v[3]);
+    EXPECT_EQ(3.0f, v[4]);
+    EXPECT_EQ(0.5f, v[5]);
+    EXPECT_EQ(1000.0f, v[6]);
+}
@@ -0,0 +1,122 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../xLights/FSEQFile.h"
+
+namespace
+{
+    const uint32_t CHANNELS = 200000;
+    const uint32_t FRAMES = 600;
+
+    uint8_t ChannelValue(uint32_t frame, uint32_t channel) {
+        // some structure so it compresses a bit like real sequences do
+        return (uint8_t)(((channel / 3) * 2654435761u ^ (frame / 4) * 40503u) >> (channel % 5));
+    }
+
+    std::string TempFSEQ(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    double WriteFSEQ(const std::string& fn, int level, int threads, bool zstdWorkers, const std::vector<std::pair<uint32_t, uint32_t>>& groups = {}) {
+        std::vector<uint8_t> frame(CHANNELS);
+        auto start = std::chrono::steady_clock::now();
+        FSEQFile* file = FSEQFile::createFSEQFile(fn, 2, FSEQFile::CompressionType::zstd, level);
+        file->enableMinorVersionFeatures(2);
+        file->enableMultiThreadedCompression(threads, zstdWorkers);
+        file->setChannelCount(CHANNELS);
+        file->setStepTime(50);
+        file->setNumFrames(FRAMES);
+        file->enableChannelGroups(groups);
+        file->writeHeader();
+        for (uint32_t f = 0; f < FRAMES; f++) {
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                frame[c] = ChannelValue(f, c);
+            }
+            file->addFrame(f, &frame[0]);
+        }
+        file->finalize();
+        delete file;
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool VerifyFSEQ(const std::string& fn, const std::vector<std::pair<uint32_t, uint32_t>>& ranges = { { 0, CHANNELS } }) {
+        FSEQFile* file = FSEQFile::openFSEQFile(fn);
+        if (file == nullptr) return false;
+        file->prepareRead(ranges, 0);
+        std::vector<uint8_t> frame(CHANNELS);
+        bool ok = file->getNumFrames() == FRAMES;
+        for (uint32_t f = 0; f < FRAMES && ok; f++) {
+            FSEQFile::FrameData* data = file->getFrame(f);
+            data->readFrame(&frame[0], CHANNELS);
+            delete data;
+            for (const auto& r : ranges) {
+                for (uint32_t c = r.first; c < r.first + r.second && ok; c++) {
+                    ok = frame[c] == ChannelValue(f, c);
+                }
+            }
+        }
+        delete file;
+        return ok;
+    }
+}
+
+TEST(FSEQ_Tests, ParallelCompressionRoundTrip_Test) {
+    std::string fn = TempFSEQ("xlights_fseq_test.fseq");
+    WriteFSEQ(fn, 2, 4, false);
+    EXPECT_TRUE(VerifyFSEQ(fn));
+    std::filesystem::remove(fn);
+}
+
+TEST(FSEQ_Tests, ChannelGroupsPartialRead_Test) {
+    std::string fn = TempFSEQ("xlights_fseq_groups.fseq");
+    std::vector<std::pair<uint32_t, uint32_t>> groups;
+    for (uint32_t c = 0; c < CHANNELS; c += 16384) {
+        groups.push_back({ c, 16384 });
+    }
+    WriteFSEQ(fn, 2, 1, false, groups);
+    EXPECT_TRUE(VerifyFSEQ(fn));
+    // spans a group boundary
+    EXPECT_TRUE(VerifyFSEQ(fn, { { 20000, 15000 } }));
+    std::filesystem::remove(fn);
+}
+
+// Reports the write time and compression ratio at each level for the single threaded, parallel block
+// and zstd worker compressors. The timings depend on the machine so only the files are checked ... it is
+// slow so it is disabled, run it with --gtest_also_run_disabled_tests
+TEST(FSEQ_Tests, DISABLED_CompressionBenchmark) {
+    std::string fn = TempFSEQ("xlights_fseq_bench.fseq");
+    int threads = std::max(2u, std::thread::hardware_concurrency());
+    double raw = (double)CHANNELS * FRAMES;
+
+    for (int level : { -10, 1, 2, 3, 6, 9, 15 }) {
+        struct {
+            const char* name;
+            int threads;
+            bool zstdWorkers;
+        } modes[] = { { "single", 1, false }, { "blocks", threads, false }, { "zstdmt", threads, true } };
+        for (auto& m : modes) {
+            double ms = WriteFSEQ(fn, level, m.threads, m.zstdWorkers);
+            double ratio = raw / (double)std::filesystem::file_size(fn);
+            printf("Level %3d %-6s: %8.1fms ratio %.2f\n", level, m.name, ms, ratio);
+            EXPECT_TRUE(VerifyFSEQ(fn)) << "level " << level << " " << m.name;
+        }
+    }
+    std::filesystem::remove(fn);
+}
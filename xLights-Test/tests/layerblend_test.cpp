@@ -0,0 +1,157 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "../xLights/LayerBlend.h"
+
+static const std::vector<std::pair<MixTypes, const char*>> BLOCK_MIX_TYPES = {
+    { MixTypes::Mix_Normal, "Normal" },
+    { MixTypes::Mix_Effect1, "Effect 1" },
+    { MixTypes::Mix_Effect2, "Effect 2" },
+    { MixTypes::Mix_Mask1, "1 is Mask" },
+    { MixTypes::Mix_Mask2, "2 is Mask" },
+    { MixTypes::Mix_TrueUnmask1, "1 is True Unmask" },
+    { MixTypes::Mix_TrueUnmask2, "2 is True Unmask" },
+    { MixTypes::Mix_1_reveals_2, "1 reveals 2" },
+    { MixTypes::Mix_2_reveals_1, "2 reveals 1" },
+    { MixTypes::Mix_Layered, "Layered" },
+    { MixTypes::Mix_Average, "Average" },
+    { MixTypes::Mix_Highlight, "Highlight" },
+    { MixTypes::Mix_Highlight_Vibrant, "Highlight Vibrant" },
+    { MixTypes::Mix_Additive, "Additive" },
+    { MixTypes::Mix_Subtractive, "Subtractive" },
+    { MixTypes::Mix_Min, "Min" },
+    { MixTypes::Mix_Max, "Max" },
+    { MixTypes::Mix_AsBrightness, "Brightness" }
+};
+
+// random colours with plenty of black, full alpha and transparent pixels as those are where the modes branch
+static void FillPlanes(ColorPlanes& p, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> kind(0, 5);
+    for (int i = 0; i < LAYER_BLEND_BLOCK; ++i) {
+        switch (kind(rng)) {
+        case 0:
+            p.Set(i, xlColor(0, 0, 0, byte(rng)));
+            break;
+        case 1:
+            p.Set(i, xlColor(byte(rng), byte(rng), byte(rng), 255));
+            break;
+        case 2:
+            p.Set(i, xlColor(byte(rng), byte(rng), byte(rng), 0));
+            break;
+        default:
+            p.Set(i, xlColor(byte(rng), byte(rng), byte(rng), byte(rng)));
+            break;
+        }
+    }
+}
+
+TEST(LayerBlend_Tests, BlockMatchesPixel_Test) {
+    std::mt19937 rng(1234);
+    for (const auto& mt : BLOCK_MIX_TYPES) {
+        LAYER_BLEND_FN blend = GetLayerBlendFunction(mt.first);
+        ASSERT_NE(nullptr, blend) << mt.second;
+
+        for (float threshold : { 0.0f, 0.1f, 0.5f, 0.73f, 1.0f }) {
+            for (double fade : { 1.0, 0.6 }) {
+                for (bool varies : { false, true }) {
+                    LayerBlendParams params;
+                    params.mixType = mt.first;
+                    params.effectMixThreshold = threshold;
+                    params.fadeFactor = fade;
+                    params.effectMixVaries = varies;
+                    params.Prepare();
+
+                    ColorPlanes fg;
+                    ColorPlanes bg;
+                    FillPlanes(fg, rng);
+                    FillPlanes(bg, rng);
+                    ColorPlanes expected = bg;
+                    for (int i = 0; i < LAYER_BLEND_BLOCK; ++i) {
+                        xlColor f = fg.Get(i);
+                        xlColor b = expected.Get(i);
+                        MixPixel(params, 0, 0, f, b);
+                        expected.Set(i, b);
+                    }
+
+                    // an odd count checks the tail handling of the vector loops
+                    const int count = LAYER_BLEND_BLOCK - 3;
+                    blend(params, fg, bg, count);
+                    for (int i = 0; i < count; ++i) {
+                        xlColor e = expected.Get(i);
+                        xlColor a = bg.Get(i);
+                        ASSERT_TRUE(e == a && e.alpha == a.alpha) << mt.second << " threshold " << threshold << " fade " << fade << " node " << i
+                                                                 << " expected " << (int)e.red << "," << (int)e.green << "," << (int)e.blue << "," << (int)e.alpha
+                                                                 << " got " << (int)a.red << "," << (int)a.green << "," << (int)a.blue << "," << (int)a.alpha;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(LayerBlend_Tests, PositionAndHSVModesStayPerPixel_Test) {
+    for (auto mt : { MixTypes::Mix_BottomTop, MixTypes::Mix_LeftRight, MixTypes::Mix_Unmask1, MixTypes::Mix_Unmask2, MixTypes::Mix_Shadow_1on2, MixTypes::Mix_Shadow_2on1 }) {
+        EXPECT_EQ(nullptr, GetLayerBlendFunction(mt));
+    }
+}
+
+// Not a pass/fail test ... compares the per pixel mix against the block functions for each mix type.
+// BlockMatchesPixel_Test checks the results, the timings vary too much between machines to assert on so it
+// is disabled, run it with --gtest_also_run_disabled_tests
+TEST(LayerBlend_Tests, DISABLED_MixBenchmark) {
+    const int BLOCKS = 2000;
+    std::mt19937 rng(42);
+    ColorPlanes fg;
+    ColorPlanes bg;
+    FillPlanes(fg, rng);
+    FillPlanes(bg, rng);
+
+    auto time = [](std::function<void()> f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)BLOCKS * LAYER_BLEND_BLOCK);
+    };
+
+    for (const auto& mt : BLOCK_MIX_TYPES) {
+        LayerBlendParams params;
+        params.mixType = mt.first;
+        params.effectMixThreshold = 0.5f;
+        params.Prepare();
+        LAYER_BLEND_FN blend = GetLayerBlendFunction(mt.first);
+
+        ColorPlanes out;
+        double pixel = time([&]() {
+            for (int b = 0; b < BLOCKS; ++b) {
+                for (int i = 0; i < LAYER_BLEND_BLOCK; ++i) {
+                    xlColor f = fg.Get(i);
+                    xlColor c = bg.Get(i);
+                    MixPixel(params, 0, 0, f, c);
+                    out.Set(i, c);
+                }
+            }
+        });
+        double block = time([&]() {
+            for (int b = 0; b < BLOCKS; ++b) {
+                out = bg;
+                blend(params, fg, out, LAYER_BLEND_BLOCK);
+            }
+        });
+        printf("%-18s per pixel %6.2fns, block %6.2fns per node\n", mt.second, pixel, block);
+    }
+}
@@ -0,0 +1,50 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include "../xLights/MappedBuffer.h"
+
+static void CheckBuffer(MappedBuffer& buffer, size_t size)
+{
+    ASSERT_NE(nullptr, buffer.Data());
+    EXPECT_EQ(size, buffer.Size());
+    for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(0, buffer.Data()[i]);
+    }
+    float* f = buffer.As<float>();
+    for (size_t i = 0; i < size / sizeof(float); i++) {
+        f[i] = (float)i;
+    }
+    for (size_t i = 0; i < size / sizeof(float); i++) {
+        ASSERT_EQ((float)i, f[i]);
+    }
+}
+
+TEST(MappedBuffer_Tests, Heap_Test) {
+    MappedBuffer buffer;
+    ASSERT_TRUE(buffer.Allocate(4096));
+    EXPECT_FALSE(buffer.IsMapped());
+    CheckBuffer(buffer, 4096);
+    buffer.Free();
+    EXPECT_EQ(nullptr, buffer.Data());
+    EXPECT_EQ(0, buffer.Size());
+}
+
+TEST(MappedBuffer_Tests, Mapped_Test) {
+    MappedBuffer buffer;
+    ASSERT_TRUE(buffer.Allocate(1024 * 1024, 1024));
+    EXPECT_TRUE(buffer.IsMapped());
+    CheckBuffer(buffer, 1024 * 1024);
+
+    // reallocating drops the old contents
+    ASSERT_TRUE(buffer.Allocate(8192, 1024));
+    CheckBuffer(buffer, 8192);
+}
@@ -0,0 +1,221 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../xSchedule/OutputPipeline.h"
+#include "../xSchedule/OutputProcessColourOrder.h"
+#include "../xSchedule/OutputProcessDeadChannel.h"
+#include "../xSchedule/OutputProcessDim.h"
+#include "../xSchedule/OutputProcessDimWhite.h"
+#include "../xSchedule/OutputProcessExcludeDim.h"
+#include "../xSchedule/OutputProcessGamma.h"
+#include "../xSchedule/OutputProcessRemap.h"
+#include "../xSchedule/OutputProcessReverse.h"
+#include "../xSchedule/OutputProcessSet.h"
+#include "../xSchedule/OutputProcessSustain.h"
+#include "../xLights/outputs/OutputManager.h"
+
+// OutputProcess links against this but the processes here all have their start channel decoded already so it is
+// never called ... linking the real one would drag in the whole output stack
+int32_t OutputManager::DecodeStartChannel(const std::string& startChannelString)
+{
+    return std::stoi(startChannelString);
+}
+
+// the processes with their start channel already decoded so no output manager is needed
+template<class T>
+struct At : public T
+{
+    template<typename... Args>
+    At(size_t sc, Args... args) :
+        T(nullptr, std::to_string(sc), args..., "")
+    {
+        this->_sc = sc;
+    }
+};
+
+struct ProcessDef
+{
+    int type;
+    size_t sc;
+    size_t p1;
+    size_t p2;
+    bool enabled;
+};
+
+static OutputProcess* MakeProcess(const ProcessDef& d)
+{
+    static const size_t orders[] = { 123, 132, 213, 231, 312, 321 };
+    OutputProcess* p = nullptr;
+    switch (d.type) {
+    case 0: p = new At<OutputProcessGamma>(d.sc, d.p1, d.p2 == 0 ? 0.0f : 2.2f, 1.5f, 0.8f, 2.0f); break;
+    case 1: p = new At<OutputProcessColourOrder>(d.sc, d.p1, orders[d.p2]); break;
+    case 2: p = new At<OutputProcessRemap>(d.sc, d.p2, d.p1); break;
+    case 3: p = new At<OutputProcessReverse>(d.sc, d.p1, (size_t)0); break;
+    case 4: p = new At<OutputProcessSet>(d.sc, d.p1, d.p2); break;
+    case 5: p = new At<OutputProcessDimWhite>(d.sc, d.p1, d.p2); break;
+    case 6: p = new At<OutputProcessSustain>(d.sc, d.p1); break;
+    case 7: p = new At<OutputProcessDeadChannel>(d.sc, d.p1); break;
+    case 8: p = new At<OutputProcessExcludeDim>(d.sc, d.p1); break;
+    default: p = new At<OutputProcessDim>(d.sc, d.p1, d.p2); break;
+    }
+    if (!d.enabled) p->Enable(false);
+    return p;
+}
+
+struct ProcessList
+{
+    std::list<OutputProcess*> processes;
+    ProcessList(const std::vector<ProcessDef>& defs)
+    {
+        for (const auto& it : defs) {
+            processes.push_back(MakeProcess(it));
+        }
+    }
+    ~ProcessList()
+    {
+        for (auto it : processes) {
+            delete it;
+        }
+    }
+};
+
+// what xSchedule did before the pipeline ... each process in turn then brightness on the channels not excluded
+static void ChainedFrame(std::vector<uint8_t>& buffer, std::list<OutputProcess*>& processes, const uint8_t* brightness)
+{
+    for (auto it : processes) {
+        it->Frame(buffer.data(), buffer.size(), processes);
+    }
+    if (brightness != nullptr) {
+        auto ed = OutputProcess::GetExcludeDim(processes, 1, buffer.size());
+        for (size_t i = 0; i < buffer.size(); i++) {
+            bool excluded = false;
+            for (auto e : ed) {
+                if (i + 1 >= e->GetFirstExcludeChannel() && i + 1 <= e->GetLastExcludeChannel()) excluded = true;
+            }
+            if (!excluded) buffer[i] = brightness[buffer[i]];
+        }
+    }
+}
+
+static std::vector<uint8_t> RandomChannels(size_t size, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<uint8_t> res(size);
+    for (auto& it : res) {
+        it = byte(rng) < 64 ? 0 : byte(rng);
+    }
+    // some grey pixels so dim white has something to do
+    for (size_t i = 0; i + 2 < size; i += 3) {
+        if (byte(rng) < 64) res[i + 1] = res[i + 2] = res[i];
+    }
+    return res;
+}
+
+static void CheckEquivalent(const std::vector<ProcessDef>& defs, size_t size, int brightness, std::mt19937& rng)
+{
+    uint8_t table[256];
+    for (int i = 0; i < 256; i++) {
+        table[i] = i * brightness / 100;
+    }
+    const uint8_t* bt = brightness == 100 ? nullptr : table;
+
+    ProcessList chained(defs);
+    ProcessList fused(defs);
+    OutputPipeline pipeline;
+
+    // a few frames as sustain depends on the last one
+    for (int frame = 0; frame < 3; frame++) {
+        auto expected = RandomChannels(size, rng);
+        auto actual = expected;
+        ChainedFrame(expected, chained.processes, bt);
+        if (!pipeline.IsCompiled(fused.processes, size, 0, brightness)) {
+            pipeline.Compile(fused.processes, size, 0, brightness, bt);
+        }
+        pipeline.Frame(actual.data(), size, fused.processes);
+        ASSERT_EQ(expected, actual) << "frame " << frame;
+    }
+}
+
+TEST(OutputPipeline_Tests, Dim_Test)
+{
+    std::mt19937 rng(1);
+    CheckEquivalent({ { 9, 10, 100, 50, true } }, 300, 100, rng);
+    CheckEquivalent({ { 9, 10, 100, 0, true } }, 300, 100, rng);
+    // dim running past the end of the buffer
+    CheckEquivalent({ { 9, 250, 100, 50, true } }, 300, 100, rng);
+}
+
+TEST(OutputPipeline_Tests, DimWithExclusions_Test)
+{
+    std::mt19937 rng(2);
+    // excluded channels part way into a dim that does not start at channel 1
+    CheckEquivalent({ { 8, 120, 20, 0, true }, { 9, 100, 100, 50, true } }, 300, 100, rng);
+    CheckEquivalent({ { 8, 120, 20, 0, true }, { 9, 100, 100, 0, true } }, 300, 100, rng);
+    CheckEquivalent({ { 8, 120, 20, 0, true }, { 9, 100, 100, 50, true } }, 300, 70, rng);
+}
+
+TEST(OutputPipeline_Tests, Brightness_Test)
+{
+    std::mt19937 rng(3);
+    CheckEquivalent({}, 300, 70, rng);
+    CheckEquivalent({ { 8, 1, 30, 0, true }, { 8, 200, 30, 0, true } }, 300, 40, rng);
+}
+
+TEST(OutputPipeline_Tests, Reorder_Test)
+{
+    std::mt19937 rng(4);
+    for (size_t order = 0; order < 6; order++) {
+        CheckEquivalent({ { 1, 4, 20, order, true } }, 300, 100, rng);
+    }
+    CheckEquivalent({ { 3, 4, 20, 0, true } }, 300, 100, rng);
+    CheckEquivalent({ { 2, 10, 30, 200, true } }, 300, 100, rng);
+    CheckEquivalent({ { 2, 200, 30, 10, true }, { 0, 1, 100, 1, true } }, 300, 80, rng);
+}
+
+TEST(OutputPipeline_Tests, Random_Test)
+{
+    std::mt19937 rng(5);
+    auto r = [&rng](int a, int b) { return (size_t)std::uniform_int_distribution<int>(a, b)(rng); };
+    const size_t size = 3000;
+
+    for (int trial = 0; trial < 500; trial++) {
+        std::vector<ProcessDef> defs;
+        size_t n = r(1, 8);
+        for (size_t i = 0; i < n; i++) {
+            ProcessDef d{ (int)r(0, 9), r(1, size - 200), 0, 0, r(0, 5) != 0 };
+            switch (d.type) {
+            case 0: d.p1 = r(1, 50); d.p2 = r(0, 1); break;
+            case 1: d.p1 = r(1, 30); d.p2 = r(0, 5); break;
+            case 2:
+                d.p1 = r(1, 60);
+                do {
+                    d.p2 = r(1, size - 100);
+                } while ((d.p2 > d.sc ? d.p2 - d.sc : d.sc - d.p2) < d.p1);
+                break;
+            case 4: case 9: d.p1 = r(1, 300); d.p2 = r(0, 100); break;
+            case 5: d.p1 = r(1, 30); d.p2 = r(0, 100); break;
+            case 7: d.p1 = r(1, 3); break;
+            case 8: d.p1 = r(1, 300); break;
+            default: d.p1 = r(1, 50); break;
+            }
+            defs.push_back(d);
+        }
+        SCOPED_TRACE(trial);
+        CheckEquivalent(defs, size, r(0, 1) == 0 ? 100 : (int)r(10, 99), rng);
+        if (HasFatalFailure()) return;
+    }
+}
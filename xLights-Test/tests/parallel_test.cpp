@@ -0,0 +1,103 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <vector>
+
+#include "../xLights/Parallel.h"
+
+TEST(Parallel_Tests, ForVisitsEveryIndexOnce_Test) {
+    for (int n : { 0, 1, 7, 1000, 250000 }) {
+        std::vector<std::atomic_int> hits(n);
+        parallel_for(0, n, [&hits](int i) { hits[i]++; });
+        for (int i = 0; i < n; i++) {
+            EXPECT_EQ(1, hits[i].load());
+        }
+    }
+}
+
+TEST(Parallel_Tests, ForRangeVisitsEveryIndexOnce_Test) {
+    std::vector<std::atomic_int> hits(100000);
+    parallel_for_range(0, hits.size(), [&hits](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            hits[i]++;
+        }
+    });
+    for (auto& h : hits) {
+        EXPECT_EQ(1, h.load());
+    }
+}
+
+TEST(Parallel_Tests, ListAndVector_Test) {
+    std::function<void(int&, int)> f = [](int& v, int idx) { v = idx + 1; };
+
+    std::list<int> list(5000, 0);
+    parallel_for(list, f);
+    int idx = 0;
+    for (auto v : list) {
+        EXPECT_EQ(++idx, v);
+    }
+
+    std::vector<int> vec(5000, 0);
+    parallel_for(vec, f);
+    for (int i = 0; i < (int)vec.size(); i++) {
+        EXPECT_EQ(i + 1, vec[i]);
+    }
+}
+
+TEST(Parallel_Tests, Nested_Test) {
+    std::atomic_int count(0);
+    parallel_for(0, 64, [&count](int) {
+        parallel_for(0, 1000, [&count](int) { count++; });
+    });
+    EXPECT_EQ(64000, count.load());
+}
+
+// Not a pass/fail test ... reports the scheduling overhead per task so we can tell how small a loop
+// body can be before parallelising it stops paying off. Timings depend too much on the machine to assert on
+// so it is disabled, run it with --gtest_also_run_disabled_tests
+TEST(Parallel_Tests, DISABLED_OverheadBenchmark) {
+    const int REPEATS = 200;
+    const int TASKS = 100000;
+    std::vector<uint8_t> src(TASKS * 3, 1);
+    std::vector<uint8_t> dst(TASKS * 3, 0);
+
+    auto time = [](std::function<void()> f) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < REPEATS; r++) {
+            f();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)REPEATS * TASKS);
+    };
+
+    double serial = time([&]() {
+        for (int i = 0; i < TASKS; i++) {
+            memcpy(&dst[i * 3], &src[i * 3], 3);
+        }
+    });
+    double perIndex = time([&]() {
+        parallel_for(0, TASKS, [&](int i) { memcpy(&dst[i * 3], &src[i * 3], 3); });
+    });
+    double perRange = time([&]() {
+        parallel_for_range(0, TASKS, [&](int begin, int end) { memcpy(&dst[begin * 3], &src[begin * 3], (end - begin) * 3); });
+    });
+    double empty = time([&]() {
+        parallel_for(0, TASKS, [](int) {});
+    });
+
+    printf("Per node pixel copy: serial %.2fns, parallel_for %.2fns, parallel_for_range %.2fns, empty task overhead %.2fns\n",
+           serial, perIndex, perRange, empty);
+    EXPECT_EQ(src, dst);
+}
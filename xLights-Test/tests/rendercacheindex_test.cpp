@@ -0,0 +1,94 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <sstream>
+
+#include "../xLights/RenderCacheIndex.h"
+
+static RenderCacheIndexEntry MakeEntry(const std::string& file, uint64_t bytes, int64_t lastUsed)
+{
+    RenderCacheIndexEntry e;
+    e.file = file;
+    e.bytes = bytes;
+    e.lastUsed = lastUsed;
+    e.properties["Effect"] = "Bars";
+    e.properties["StartMS"] = "1000";
+    e.models["Mega Tree"] = { 40, 3 * 100 * 50 };
+    return e;
+}
+
+TEST(RenderCacheIndex_Tests, Entries_Test) {
+    RenderCacheIndex index;
+    EXPECT_TRUE(index.IsEmpty());
+
+    index.Set(MakeEntry("Bars_Tree_0_1000.cache", 1000, 10));
+    index.Set(MakeEntry("On_Arch_0_0.cache", 500, 20));
+    EXPECT_EQ(1500, index.GetBytes());
+
+    // replacing an entry replaces its size
+    index.Set(MakeEntry("Bars_Tree_0_1000.cache", 700, 30));
+    EXPECT_EQ(1200, index.GetBytes());
+
+    index.Touch("On_Arch_0_0.cache", 50);
+    index.Touch("On_Arch_0_0.cache", 40);
+    RenderCacheIndexEntry e;
+    ASSERT_TRUE(index.Get("On_Arch_0_0.cache", e));
+    EXPECT_EQ(50, e.lastUsed);
+
+    index.Remove("On_Arch_0_0.cache");
+    index.Remove("Missing.cache");
+    EXPECT_FALSE(index.Get("On_Arch_0_0.cache", e));
+    EXPECT_EQ(700, index.GetBytes());
+    EXPECT_EQ(1, index.GetEntries().size());
+}
+
+TEST(RenderCacheIndex_Tests, SaveLoad_Test) {
+    RenderCacheIndex index;
+    index.Set(MakeEntry("Bars_Tree_0_1000.cache", 1000, 10));
+    index.Set(MakeEntry("On_Arch_0_0.cache", 500, 20));
+
+    std::stringstream ss;
+    ASSERT_TRUE(index.Write(ss));
+    std::string data = ss.str();
+
+    RenderCacheIndex loaded;
+    std::stringstream in1(data);
+    ASSERT_TRUE(loaded.Read(in1));
+    EXPECT_EQ(1500, loaded.GetBytes());
+    RenderCacheIndexEntry e;
+    ASSERT_TRUE(loaded.Get("Bars_Tree_0_1000.cache", e));
+    EXPECT_EQ(10, e.lastUsed);
+    EXPECT_EQ("1000", e.properties["StartMS"]);
+    EXPECT_EQ(40, e.models["Mega Tree"].first);
+    EXPECT_EQ(15000, e.models["Mega Tree"].second);
+
+    // a truncated index is ignored completely
+    std::stringstream in2(data.substr(0, data.size() - 4));
+    EXPECT_FALSE(loaded.Read(in2));
+    EXPECT_TRUE(loaded.IsEmpty());
+}
+
+TEST(RenderCacheIndex_Tests, Evict_Test) {
+    std::vector<RenderCacheEvictionCandidate> candidates = { { 30, 100 }, { 10, 200 }, { 20, 300 }, { 40, 400 } };
+
+    EXPECT_TRUE(RenderCacheIndex::SelectEvictions(candidates, 1000, 1000).empty());
+
+    // oldest first until it fits
+    auto evict = RenderCacheIndex::SelectEvictions(candidates, 1000, 600);
+    ASSERT_EQ(2, evict.size());
+    EXPECT_EQ(1, evict[0]);
+    EXPECT_EQ(2, evict[1]);
+
+    // cant get under budget so everything goes
+    evict = RenderCacheIndex::SelectEvictions(candidates, 1500, 100);
+    EXPECT_EQ(4, evict.size());
+}
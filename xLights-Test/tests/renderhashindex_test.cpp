@@ -0,0 +1,123 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "../xLights/RenderHashIndex.h"
+
+static RenderHashFrames MakeFrames(const std::string& model, int frames, uint64_t hash)
+{
+    RenderHashFrames res;
+    res.model = model;
+    res.hashes.resize(frames, hash);
+    for (int f = 0; f < frames; f++) {
+        res.restart.push_back(f);
+    }
+    return res;
+}
+
+static int CountStale(const std::vector<bool>& stale)
+{
+    return (int)std::count(stale.begin(), stale.end(), true);
+}
+
+TEST(RenderHashIndex_Tests, Stale_Test) {
+    RenderHashIndex index;
+    std::vector<RenderHashFrames> models = { MakeFrames("Tree", 100, 5), MakeFrames("Arch", 100, 7), MakeFrames("Star", 100, 9) };
+
+    // nothing rendered yet
+    auto stale = index.FindStale(models);
+    EXPECT_EQ(100, CountStale(stale[0]));
+
+    index.Reset(300, 100, 50, 1, 42);
+    EXPECT_TRUE(index.IsValidFor(300, 100, 50, 1, 42));
+    EXPECT_FALSE(index.IsValidFor(300, 100, 50, 2, 42));
+    for (const auto& it : models) {
+        index.Set(it.model, it.hashes);
+    }
+    stale = index.FindStale(models);
+    EXPECT_EQ(0, CountStale(stale[0]) + CountStale(stale[1]) + CountStale(stale[2]));
+
+    // an effect from 40-59 changed which started at frame 30
+    for (int f = 40; f < 60; f++) {
+        models[0].hashes[f] = 6;
+        models[0].restart[f] = 30;
+    }
+    // the arch shares channels with the tree
+    models[0].overlaps.push_back(1);
+    models[1].overlaps.push_back(0);
+    stale = index.FindStale(models);
+    EXPECT_EQ(30, CountStale(stale[0]));
+    EXPECT_FALSE(stale[0][29]);
+    EXPECT_TRUE(stale[0][30]);
+    EXPECT_TRUE(stale[0][59]);
+    EXPECT_FALSE(stale[0][60]);
+    EXPECT_EQ(30, CountStale(stale[1]));
+    EXPECT_TRUE(stale[1][30]);
+    EXPECT_EQ(0, CountStale(stale[2]));
+
+    // the arch has an effect running from frame 20 so it has to render from there which brings the tree along
+    for (int f = 20; f < 50; f++) {
+        models[1].restart[f] = 20;
+    }
+    stale = index.FindStale(models);
+    EXPECT_EQ(40, CountStale(stale[0]));
+    EXPECT_TRUE(stale[0][20]);
+    EXPECT_EQ(40, CountStale(stale[1]));
+
+    // rendered somewhere else
+    index.Set("Tree", models[0].hashes);
+    index.Invalidate("Star", 90, 200);
+    stale = index.FindStale(models);
+    EXPECT_EQ(0, CountStale(stale[0]));
+    EXPECT_EQ(10, CountStale(stale[2]));
+    EXPECT_TRUE(stale[2][99]);
+}
+
+TEST(RenderHashIndex_Tests, SaveLoad_Test) {
+    RenderHashIndex index;
+    index.Reset(300, 100, 50, 1, 42);
+    std::vector<uint64_t> hashes(100, 5);
+    for (int f = 10; f < 20; f++) {
+        hashes[f] = f;
+    }
+    index.Set("Mega Tree", hashes);
+    index.Set("Arch", std::vector<uint64_t>(100, 3));
+
+    std::stringstream ss;
+    ASSERT_TRUE(index.Write(ss, "Song.fseq:1000:1"));
+    std::string data = ss.str();
+
+    RenderHashIndex loaded;
+    std::stringstream in1(data);
+    EXPECT_TRUE(loaded.Read(in1, "Song.fseq:1000:1", 300, 100, 50, 7));
+    EXPECT_TRUE(loaded.IsValidFor(300, 100, 50, 7, 42));
+
+    RenderHashFrames tree;
+    tree.model = "Mega Tree";
+    tree.hashes = hashes;
+    auto stale = loaded.FindStale({ tree });
+    EXPECT_EQ(0, CountStale(stale[0]));
+    tree.hashes[15] = 1;
+    stale = loaded.FindStale({ tree });
+    EXPECT_EQ(1, CountStale(stale[0]));
+
+    // a different fseq or size is no use
+    std::stringstream in2(data);
+    EXPECT_FALSE(loaded.Read(in2, "Song.fseq:1000:2", 300, 100, 50, 7));
+    EXPECT_FALSE(loaded.IsValidFor(300, 100, 50, 7, 42));
+    std::stringstream in3(data);
+    EXPECT_FALSE(loaded.Read(in3, "Song.fseq:1000:1", 300, 101, 50, 7));
+    std::stringstream in4(data.substr(0, data.size() - 4));
+    EXPECT_FALSE(loaded.Read(in4, "Song.fseq:1000:1", 300, 100, 50, 7));
+}
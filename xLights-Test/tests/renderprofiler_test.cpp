@@ -0,0 +1,99 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <sstream>
+#include <thread>
+
+#include "../xLights/RenderProfiler.h"
+
+static void AddTiming(const std::string& model, int layer, const std::string& effect, int startMS, RenderProfileCategory category, int frame, int us)
+{
+    RenderProfiler& profiler = RenderProfiler::Instance();
+    auto start = std::chrono::steady_clock::now();
+    profiler.Record(profiler.GetKey(model, layer, effect, startMS), category, frame, start, start + std::chrono::microseconds(us));
+}
+
+TEST(RenderProfiler_Tests, Summary_Test) {
+    RenderProfiler& profiler = RenderProfiler::Instance();
+    profiler.Clear();
+    EXPECT_FALSE(profiler.HasData());
+
+    // two render threads rendering the same effect
+    std::thread t1([]() {
+        AddTiming("Tree", 0, "Plasma", 0, RenderProfileCategory::Render, 10, 3000);
+        AddTiming("Tree", 0, "Plasma", 0, RenderProfileCategory::RenderCache, 10, 100);
+    });
+    std::thread t2([]() {
+        AddTiming("Tree", 0, "Plasma", 0, RenderProfileCategory::Render, 20, 5000);
+    });
+    t1.join();
+    t2.join();
+    AddTiming("Tree", 1, "On", 0, RenderProfileCategory::Render, 5, 200);
+    AddTiming("Arch", 0, "Plasma", 1000, RenderProfileCategory::Render, 25, 1000);
+    AddTiming("Tree", -1, "Blend", 0, RenderProfileCategory::Blend, 10, 400);
+    EXPECT_TRUE(profiler.HasData());
+
+    auto effects = profiler.GetSummary(RenderProfileGrouping::Effect);
+    ASSERT_EQ(4, (int)effects.size());
+    EXPECT_EQ("Tree", effects[0].model);
+    EXPECT_EQ("Plasma", effects[0].effect);
+    EXPECT_EQ(0, effects[0].layer);
+    EXPECT_EQ(10, effects[0].startFrame);
+    EXPECT_EQ(20, effects[0].endFrame);
+    EXPECT_EQ(3, effects[0].calls);
+    EXPECT_EQ(8000, effects[0].timeUS[(int)RenderProfileCategory::Render]);
+    EXPECT_EQ(100, effects[0].timeUS[(int)RenderProfileCategory::RenderCache]);
+    EXPECT_EQ(8100, effects[0].TotalUS());
+    EXPECT_EQ("Arch", effects[1].model);
+
+    auto types = profiler.GetSummary(RenderProfileGrouping::EffectType);
+    ASSERT_EQ(3, (int)types.size());
+    EXPECT_EQ("Plasma", types[0].effect);
+    EXPECT_EQ(9100, types[0].TotalUS());
+    EXPECT_EQ(10, types[0].startFrame);
+    EXPECT_EQ(25, types[0].endFrame);
+
+    auto models = profiler.GetSummary(RenderProfileGrouping::Model);
+    ASSERT_EQ(2, (int)models.size());
+    EXPECT_EQ("Tree", models[0].model);
+    EXPECT_EQ(8700, models[0].TotalUS());
+    EXPECT_EQ(400, models[0].timeUS[(int)RenderProfileCategory::Blend]);
+
+    profiler.Clear();
+    EXPECT_FALSE(profiler.HasData());
+    EXPECT_EQ(0, (int)profiler.GetSummary(RenderProfileGrouping::Effect).size());
+}
+
+TEST(RenderProfiler_Tests, Export_Test) {
+    RenderProfiler& profiler = RenderProfiler::Instance();
+    profiler.Clear();
+    AddTiming("Mega \"Tree\"", 2, "Shader", 0, RenderProfileCategory::Render, 7, 1500);
+    AddTiming("Mega \"Tree\"", -1, "Wait", 0, RenderProfileCategory::Wait, 7, 50);
+
+    std::ostringstream csv;
+    profiler.WriteCSV(csv, RenderProfileGrouping::Effect);
+    std::string c = csv.str();
+    EXPECT_EQ(0, (int)c.find("Model,Layer,Effect,Start Frame,End Frame,Calls,Render ms,Render Cache ms,Blend ms,Wait ms,Total ms\n"));
+    EXPECT_NE(std::string::npos, c.find("\"Mega \"\"Tree\"\"\",3,Shader,7,7,1,1.5,0,0,0,1.5\n"));
+    EXPECT_NE(std::string::npos, c.find("\"Mega \"\"Tree\"\"\",,Wait,7,7,1,0,0,0,0.05,0.05\n"));
+
+    std::ostringstream trace;
+    profiler.WriteChromeTrace(trace);
+    std::string t = trace.str();
+    EXPECT_EQ(0, (int)t.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, t.find("\"name\":\"Shader\",\"cat\":\"Render\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, t.find("\"dur\":1500"));
+    EXPECT_NE(std::string::npos, t.find("\"model\":\"Mega \\\"Tree\\\"\",\"layer\":3,\"frame\":7"));
+    EXPECT_NE(std::string::npos, t.find("\"cat\":\"Wait\""));
+
+    profiler.Clear();
+}
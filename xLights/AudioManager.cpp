@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <map>
 #include <sstream>
 #include <vector>
 
@@ -66,6 +67,39 @@ SDLManager __sdlManager;
 
 #define PCMFUDGE 32768
 
+// number of midi notes in each frames spectrum
+#define SPECTRUM_NOTES 127
+// max, min, spread then the spectrum
+#define FRAMEDATA_VALUES (3 + SPECTRUM_NOTES)
+// views of each frames data ... high, low, spread, vu and notes
+#define FRAMEDATA_VIEWS 5
+
+// Building a kiss fft plan costs more than running it so they are kept and reused for every transform of the same size.
+// A plan also holds scratch space used while transforming so each thread keeps its own.
+static kiss_fftr_cfg GetFFTPlan(int nfft)
+{
+    struct FFTPlans
+    {
+        std::map<int, kiss_fftr_cfg> plans;
+        ~FFTPlans()
+        {
+            for (const auto& it : plans) {
+                kiss_fftr_free(it.second);
+            }
+        }
+    };
+    thread_local FFTPlans cache;
+
+    auto it = cache.plans.find(nfft);
+    if (it != cache.plans.end()) return it->second;
+
+    kiss_fftr_cfg cfg = kiss_fftr_alloc(nfft, 0 /*is_inverse_fft*/, nullptr, nullptr);
+    if (cfg != nullptr) {
+        cache.plans[nfft] = cfg;
+    }
+    return cfg;
+}
+
 void fill_audio(void* udata, Uint8* stream, int len)
 {
     // SDL 2.0
@@ -451,9 +485,8 @@ void AudioData::RestorePos()
         kiss_fftr_cfg cfg;
         kiss_fft_cpx* out = (kiss_fft_cpx*)malloc(sizeof(kiss_fft_cpx) * (outcount));
         if (out != nullptr) {
-            if ((cfg = kiss_fftr_alloc(outcount, 0 /*is_inverse_fft*/, nullptr, nullptr)) != nullptr) {
+            if ((cfg = GetFFTPlan(outcount)) != nullptr) {
                 kiss_fftr(cfg, in, out);
-                free(cfg);
             }
 
             for (j = 0; j < 127; j++) {
@@ -666,9 +699,8 @@ void AudioData::RestorePos()
         kiss_fftr_cfg cfg;
         kiss_fft_cpx* out = (kiss_fft_cpx*)malloc(sizeof(kiss_fft_cpx) * (outcount));
         if (out != nullptr) {
-            if ((cfg = kiss_fftr_alloc(outcount, 0 /*is_inverse_fft*/, nullptr, nullptr)) != nullptr) {
+            if ((cfg = GetFFTPlan(outcount)) != nullptr) {
                 kiss_fftr(cfg, in, out);
-                free(cfg);
             }
 
             for (j = 0; j < 127; j++) {
@@ -1317,58 +1349,56 @@ AudioManager::AudioManager(const std::string& audio_file, int intervalMS, const
     AddAudioDeviceChangeListener([this]() {AudioDeviceChanged();});
 }
 
-std::list<float> AudioManager::CalculateSpectrumAnalysis(const float* in, int n, float& max, int id) const
+// fills res with the level of each of the SPECTRUM_NOTES midi notes
+void AudioManager::CalculateSpectrumAnalysis(const float* in, int n, float& max, float* res) const
 {
-	std::list<float> res;
 	int outcount = n / 2 + 1;
-	kiss_fftr_cfg cfg;
-	kiss_fft_cpx* out = (kiss_fft_cpx*)malloc(sizeof(kiss_fft_cpx) * (outcount));
-	if (out != nullptr)
+	thread_local std::vector<kiss_fft_cpx> out;
+	out.resize(outcount);
+
+	kiss_fftr_cfg cfg = GetFFTPlan(n);
+	if (cfg != nullptr)
 	{
-		if ((cfg = kiss_fftr_alloc(n, 0/*is_inverse_fft*/, nullptr, nullptr)) != nullptr)
-		{
-			kiss_fftr(cfg, in, out);
-			free(cfg);
-		}
+		kiss_fftr(cfg, in, out.data());
+	}
+	else
+	{
+		memset(out.data(), 0x00, sizeof(kiss_fft_cpx) * outcount);
+	}
 
-		for (int j = 0; j < 127; j++)
-		{
-            // choose the right bucket for this MIDI note
-            double freq = 440.0 * exp2f(((double)j - 69.0) / 12.0);
-            int start = freq * (double)n / (double)_rate;
-            double freqnext = 440.0 * exp2f(((double)j + 1.0 - 69.0) / 12.0);
-            int end = freqnext * (double)n / (double)_rate;
+	for (int j = 0; j < SPECTRUM_NOTES; j++)
+	{
+        // choose the right bucket for this MIDI note
+        double freq = 440.0 * exp2f(((double)j - 69.0) / 12.0);
+        int start = freq * (double)n / (double)_rate;
+        double freqnext = 440.0 * exp2f(((double)j + 1.0 - 69.0) / 12.0);
+        int end = freqnext * (double)n / (double)_rate;
 
-            float val = 0.0;
+        float val = 0.0;
 
-            // got through all buckets up to the next note and take the maximums
-            if (end < outcount-1)
+        // got through all buckets up to the next note and take the maximums
+        if (end < outcount-1)
+        {
+            for (int k = start; k <= end; k++)
             {
-                for (int k = start; k <= end; k++)
-                {
-                    kiss_fft_cpx* cur = out + k;
-                    val = std::max(val, sqrtf(cur->r * cur->r + cur->i * cur->i));
-                    //float valscaled = valnew * scaling;
-                }
+                const kiss_fft_cpx* cur = &out[k];
+                val = std::max(val, sqrtf(cur->r * cur->r + cur->i * cur->i));
+                //float valscaled = valnew * scaling;
             }
+        }
 
-			float db = log10(val);
-			if (db < 0.0)
-			{
-				db = 0.0;
-			}
-
-			res.push_back(db);
-			if (db > max)
-			{
-				max = db;
-			}
+		float db = log10(val);
+		if (db < 0.0)
+		{
+			db = 0.0;
 		}
 
-		free(out);
+		res[j] = db;
+		if (db > max)
+		{
+			max = db;
+		}
 	}
-
-	return res;
 }
 
 void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManagerProgressCallback fn)
@@ -1492,8 +1522,11 @@ void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManager
                     sframe++;
                 }
                 int eframe = currentend / _intervalMS;
+                if (eframe >= (int)_frameDataNotes.size()) {
+                    _frameDataNotes.resize(eframe + 1);
+                }
                 while (sframe <= eframe) {
-                    _frameData[sframe][4].push_back(features[0][j].values[0]);
+                    _frameDataNotes[sframe].push_back(features[0][j].values[0]);
                     sframe++;
                 }
             }
@@ -1504,11 +1537,11 @@ void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManager
             {
                 logger_pianodata.debug("Piano data calculated:");
                 logger_pianodata.debug("Time MS, Keys");
-                for (size_t i = 0; i < _frameData.size(); i++)
+                for (size_t i = 0; i < _frameDataNotes.size(); i++)
                 {
                     long ms = i * _intervalMS;
                     std::string keys = "";
-                    for (const auto& it2 : _frameData[i][4])
+                    for (const auto& it2 : _frameDataNotes[i])
                     {
                         keys += " " + std::string(wxString::Format("%f", it2).c_str());
                     }
@@ -1526,10 +1559,19 @@ void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManager
         // delete pt;
     }
 
+    SetFrameDataNotes();
     _polyphonicTranscriptionDone = true;
     logger_base.info("DoPolyphonicTranscription: Polyphonic transcription completed in %ld.", sw.Time());
 }
 
+// point the notes views at the notes storage ... needed whenever the notes change as that may move them
+void AudioManager::SetFrameDataNotes()
+{
+    for (size_t i = 0; i < _frameDataNotes.size() && (i + 1) * FRAMEDATA_VIEWS <= _frameData.size(); i++) {
+        _frameData[i * FRAMEDATA_VIEWS + 4] = FrameDataSpan(_frameDataNotes[i].data(), _frameDataNotes[i].size());
+    }
+}
+
 // Frame Data Extraction Functions
 // process audio data and build data for each frame
 void AudioManager::DoPrepareFrameData()
@@ -1555,6 +1597,11 @@ void AudioManager::DoPrepareFrameData()
 		return;
 	}
 
+    // any notes were found using the old interval so the transcription needs to be redone if they are wanted
+    if (_frameDataPreparedForInterval != -1 && _frameDataPreparedForInterval != _intervalMS) {
+        _frameDataNotes.clear();
+        _polyphonicTranscriptionDone = false;
+    }
     _frameDataPreparedForInterval = _intervalMS;
 
     // wait for the data to load
@@ -1573,6 +1620,7 @@ void AudioManager::DoPrepareFrameData()
     }
 
     _frameData.clear();
+    _frameDataValues.clear();
 
 	// samples per frame
 	int samplesperframe = _rate * _intervalMS / 1000;
@@ -1595,82 +1643,62 @@ void AudioManager::DoPrepareFrameData()
 	_bigmin = 1;
 	_bigspectogrammax = -1;
 
-	size_t step = 2048;
-	float *pdata[2];
+	const int step = 2048;
 
-	int pos = 0;
-	std::list<float> spectrogram;
+    // the data is all loaded so read it directly rather than checking it is loaded for every sample
+    FilteredAudioData* raw = GetFilteredAudioData(AUDIOSAMPLETYPE::RAW, -1, -1);
+    const float* rawData = raw == nullptr ? nullptr : raw->data0;
 
-	// process each frome of the song
+	// the spectrogram has a fixed window which does not match our time slices exactly. Each frame takes the
+	// maximum of the windows which start before the frame ends and frames without a window of their own reuse
+	// the last frame which had some. Work out which windows belong to each frame up front so the windows and
+	// the frames can then be processed in parallel.
+	std::vector<int> firstWindow(frames + 1);
+	std::vector<int> spectrumFrame(frames, -1);
+	int windows = 0;
+	int lastFrameWithWindows = -1;
 	for (int i = 0; i < frames; i++)
 	{
-		std::vector<std::list<float>> aFrameData;
-		aFrameData.resize(5); // preallocate the spots we will need
-
-		// accumulators
-		float max = -100.0;
-		float min = 100.0;
-		float spread = -100;
-
-		// clear the data if we are about to get new data ... dont clear it if we wont
-		// this happens because the spectrogram function has a fixed window based on the parameters we set and it
-		// does not match our time slices exactly so we have to select which one to use
-		if (pos < i * samplesperframe + samplesperframe  && pos + step < totalsamples)
+		firstWindow[i] = windows;
+		while ((long)windows * step < (long)i * samplesperframe + samplesperframe && (long)windows * step + step < totalsamples)
 		{
-			spectrogram.clear();
+			windows++;
 		}
-
-		// only get the data if we are not ahead of the music
-		while (pos < i * samplesperframe + samplesperframe && pos + step < totalsamples)
+		if (windows > firstWindow[i])
 		{
-			std::list<float> subspectrogram;
-			pdata[0] = GetRawLeftDataPtr(pos);
-            wxASSERT(pdata[0] != nullptr);
-			pdata[1] = GetRawRightDataPtr(pos);
-			float max2 = 0;
-
-			if (pdata[0] == nullptr)
-			{
-				subspectrogram.clear();
-			}
-			else
-			{
-				subspectrogram = CalculateSpectrumAnalysis(pdata[0], step, max2, i);
-			}
+			lastFrameWithWindows = i;
+		}
+		spectrumFrame[i] = lastFrameWithWindows;
+	}
+	firstWindow[frames] = windows;
+
+	std::vector<float> spectrogram((size_t)windows * SPECTRUM_NOTES);
+	std::vector<float> windowMax(windows, 0.0f);
+	std::vector<uint8_t> windowValid(windows, 0);
+	parallel_for(0, windows, [&](int w) {
+		long pos = (long)w * step;
+		if (rawData != nullptr && pos <= _trackSize)
+		{
+			CalculateSpectrumAnalysis(&rawData[pos], step, windowMax[w], &spectrogram[(size_t)w * SPECTRUM_NOTES]);
+			windowValid[w] = 1;
+		}
+	}, 16);
 
-			// and keep track of the larges value so we can normalise it
-			if (max2 > _bigspectogrammax)
-			{
-				_bigspectogrammax = max2;
-			}
-			pos += step;
+	_frameDataValues.resize((size_t)frames * FRAMEDATA_VALUES);
+	std::vector<int> spectrumSize(frames, 0);
+	parallel_for(0, frames, [&](int i) {
+		float* values = &_frameDataValues[(size_t)i * FRAMEDATA_VALUES];
 
-			// either take the newly calculated values or if we are merging two results take the maximum of each value
-			if (spectrogram.size() == 0)
-			{
-				spectrogram = subspectrogram;
-			}
-			else
-			{
-				if (subspectrogram.size() > 0)
-				{
-					std::list<float>::iterator sub = subspectrogram.begin();
-					for (std::list<float>::iterator fr = spectrogram.begin(); fr != spectrogram.end(); ++fr)
-					{
-						if (*sub > *fr)
-						{
-							*fr = *sub;
-						}
-						++sub;
-					}
-				}
-			}
-		}
+		// accumulators
+		float max = -100.0;
+		float min = 100.0;
+		float spread = -100;
 
 		// now do the raw data analysis for the frame
 		for (int j = 0; j < samplesperframe; j++)
 		{
-			float data = GetRawLeftData(i * samplesperframe + j);
+			long offset = (long)i * samplesperframe + j;
+			float data = (rawData != nullptr && offset <= _trackSize) ? rawData[offset] : 0;
 
 			// Max data
 			if (data > max)
@@ -1690,33 +1718,59 @@ void AudioManager::DoPrepareFrameData()
 				spread = max - min;
 			}
 		}
+		values[0] = max;
+		values[1] = min;
+		values[2] = spread;
+
+		// merge the windows for this frame taking the maximum of each value
+		int sf = spectrumFrame[i];
+		if (sf >= 0)
+		{
+			float* spectrum = &values[3];
+			for (int w = firstWindow[sf]; w < firstWindow[sf + 1]; w++)
+			{
+				if (!windowValid[w]) continue;
+
+				const float* sub = &spectrogram[(size_t)w * SPECTRUM_NOTES];
+				if (spectrumSize[i] == 0)
+				{
+					memcpy(spectrum, sub, sizeof(float) * SPECTRUM_NOTES);
+					spectrumSize[i] = SPECTRUM_NOTES;
+				}
+				else
+				{
+					for (int k = 0; k < SPECTRUM_NOTES; k++)
+					{
+						spectrum[k] = std::max(spectrum[k], sub[k]);
+					}
+				}
+			}
+		}
+	}, 50);
 
-		if (max > _bigmax)
+	for (int w = 0; w < windows; w++)
+	{
+		// and keep track of the larges value so we can normalise it
+		if (windowMax[w] > _bigspectogrammax)
 		{
-			_bigmax = max;
+			_bigspectogrammax = windowMax[w];
 		}
-		if (min < _bigmin)
+	}
+	for (int i = 0; i < frames; i++)
+	{
+		const float* values = &_frameDataValues[(size_t)i * FRAMEDATA_VALUES];
+		if (values[0] > _bigmax)
 		{
-			_bigmin = min;
+			_bigmax = values[0];
 		}
-		if (spread > _bigspread)
+		if (values[1] < _bigmin)
 		{
-			_bigspread = spread;
+			_bigmin = values[1];
+		}
+		if (values[2] > _bigspread)
+		{
+			_bigspread = values[2];
 		}
-
-		// Now save the results for the frame
-		std::list<float> maxlist;
-		maxlist.push_back(max);
-		std::list<float> minlist;
-		minlist.push_back(min);
-		std::list<float> spreadlist;
-		spreadlist.push_back(spread);
-		aFrameData[0] = maxlist;
-		aFrameData[1] = minlist;
-		aFrameData[2] = spreadlist;
-		aFrameData[3] = spectrogram;
-
-		_frameData.push_back(aFrameData);
 	}
 
 	// normalise data ... basically scale the data so the highest value is the scale value.
@@ -1725,26 +1779,26 @@ void AudioManager::DoPrepareFrameData()
 	float bigminscale = 1 / (_bigmin * scale);
 	float bigspreadscale = 1 / (_bigspread * scale);
 	float bigspectrogramscale = 1 / (_bigspectogrammax * scale);
-	for (std::vector<std::vector<std::list<float>>>::iterator itframe = _frameData.begin(); itframe != _frameData.end(); ++itframe)
+	_frameDataNotes.resize(frames);
+	_frameData.resize((size_t)frames * FRAMEDATA_VIEWS);
+	for (int i = 0; i < frames; i++)
 	{
-		std::list<float>* fl = &(*itframe)[0];
-		std::list<float>::iterator f = fl->begin();
-		*f = (*f * bigmaxscale);
-
-		fl = &(*itframe)[1];
-		f = fl->begin();
-		*f = (*f * bigminscale);
-
-		fl = &(*itframe)[2];
-		f = fl->begin();
-		*f = (*f * bigspreadscale);
-
-		fl = &(*itframe)[3];
-		for (std::list<float>::iterator ff = fl->begin(); ff != fl->end(); ++ff)
+		float* values = &_frameDataValues[(size_t)i * FRAMEDATA_VALUES];
+		values[0] *= bigmaxscale;
+		values[1] *= bigminscale;
+		values[2] *= bigspreadscale;
+		for (int k = 0; k < spectrumSize[i]; k++)
 		{
-			*ff = *ff * bigspectrogramscale;
+			values[3 + k] *= bigspectrogramscale;
 		}
+
+		FrameDataSpan* views = &_frameData[(size_t)i * FRAMEDATA_VIEWS];
+		views[0] = FrameDataSpan(&values[0], 1);
+		views[1] = FrameDataSpan(&values[1], 1);
+		views[2] = FrameDataSpan(&values[2], 1);
+		views[3] = FrameDataSpan(&values[3], spectrumSize[i]);
 	}
+	SetFrameDataNotes();
 
 	// flag the fact that the data is all ready
 	_frameDataPrepared = true;
@@ -1786,10 +1840,10 @@ void ProgressFunction(wxProgressDialog* pd, int p)
 }
 
 // Get the pre-prepared data for this frame
-const std::list<float>* AudioManager::GetFrameData(int frame, FRAMEDATATYPE fdt, std::string timing)
+const FrameDataSpan* AudioManager::GetFrameData(int frame, FRAMEDATATYPE fdt, std::string timing)
 {
     log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-    std::list<float>* rc = nullptr;
+    const FrameDataSpan* rc = nullptr;
 
     // Grab the lock so we can safely access the frame data
     std::shared_lock<std::shared_timed_mutex> lock(_mutex);
@@ -1821,49 +1875,37 @@ const std::list<float>* AudioManager::GetFrameData(int frame, FRAMEDATATYPE fdt,
     }
 
     // now we can grab the data we need
-    try
+    if (frame >= 0 && frame < (int)(_frameData.size() / FRAMEDATA_VIEWS))
     {
-        if (frame < (int)_frameData.size())
-        {
-            std::vector<std::list<float>>* framedata = &_frameData[frame];
+        const FrameDataSpan* framedata = &_frameData[(size_t)frame * FRAMEDATA_VIEWS];
 
-            if (framedata == nullptr)
-            {
-                logger_base.crit("AudioManager::GetFrameData framedata is nullptr ... this is going to crash.");
-            }
-
-            switch (fdt)
-            {
-            case FRAMEDATA_HIGH:
-                rc = &framedata->at(0);
-                break;
-            case FRAMEDATA_LOW:
-                rc = &framedata->at(1);
-                break;
-            case FRAMEDATA_SPREAD:
-                rc = &framedata->at(2);
-                break;
-            case FRAMEDATA_VU:
-                rc = &framedata->at(3);
-                break;
-            case FRAMEDATA_ISTIMINGMARK:
-                // we dont need to do anything here
-                break;
-            case FRAMEDATA_NOTES:
-                rc = &framedata->at(4);
-                break;
-            }
+        switch (fdt)
+        {
+        case FRAMEDATA_HIGH:
+            rc = &framedata[0];
+            break;
+        case FRAMEDATA_LOW:
+            rc = &framedata[1];
+            break;
+        case FRAMEDATA_SPREAD:
+            rc = &framedata[2];
+            break;
+        case FRAMEDATA_VU:
+            rc = &framedata[3];
+            break;
+        case FRAMEDATA_ISTIMINGMARK:
+            // we dont need to do anything here
+            break;
+        case FRAMEDATA_NOTES:
+            rc = &framedata[4];
+            break;
         }
     }
-    catch (...)
-    {
-        rc = nullptr;
-    }
 
     return rc;
 }
 
-const std::list<float>* AudioManager::GetFrameData(FRAMEDATATYPE fdt, std::string timing, long ms)
+const FrameDataSpan* AudioManager::GetFrameData(FRAMEDATATYPE fdt, std::string timing, long ms)
 {
     int frame = ms / _intervalMS;
     return GetFrameData(frame, fdt, timing);
@@ -2115,20 +2157,11 @@ AudioManager::~AudioManager()
             sdl->Stop();
             sdl->RemoveAudio(_sdlid);
         }
-        free(_pcmdata);
+        _pcmBuffer.Free();
         _pcmdata = nullptr;
     }
 
     while (_filtered.size() > 0) {
-        if (_filtered.back()->data0) {
-            free(_filtered.back()->data0);
-        }
-        if (_filtered.back()->data1) {
-            free(_filtered.back()->data1);
-        }
-        if (_filtered.back()->pcmdata) {
-            free(_filtered.back()->pcmdata);
-        }
         delete _filtered.back();
         _filtered.pop_back();
     }
@@ -2139,14 +2172,10 @@ AudioManager::~AudioManager()
     // Grab the lock so we know the background process isnt running
     std::shared_lock<std::shared_timed_mutex> lock(_mutex);
 
-	if (_data[1] != _data[0] && _data[1] != nullptr) {
-		free(_data[1]);
-		_data[1] = nullptr;
-	}
-	if (_data[0] != nullptr) {
-		free(_data[0]);
-		_data[0] = nullptr;
-	}
+    _dataBuffer[1].Free();
+    _dataBuffer[0].Free();
+    _data[1] = nullptr;
+    _data[0] = nullptr;
     logger_base.debug("AudioManager::~AudioManager Done");
 }
 
@@ -2193,7 +2222,7 @@ int AudioManager::OpenMediaFile()
             sdl->RemoveAudio(_sdlid);
         }
         _sdlid = -1;
-		free(_pcmdata);
+		_pcmBuffer.Free();
 		_pcmdata = nullptr;
 	}
 
@@ -2298,22 +2327,14 @@ int AudioManager::OpenMediaFile()
     }
 
 	// Check if we have read this before ... if so dump the old data
-	if (_data[1] != nullptr && _data[1] != _data[0])
-	{
-		free(_data[1]);
-		_data[1] = nullptr;
-	}
-	if (_data[0] != nullptr)
-	{
-		free(_data[0]);
-		_data[0] = nullptr;
-	}
+    _dataBuffer[1].Free();
+    _dataBuffer[0].Free();
+    _data[1] = nullptr;
+    _data[0] = nullptr;
     _loadedData = 0;
 
     long size = sizeof(float)*(_trackSize + _extra);
-	_data[0] = (float*)calloc(size, 1);
-
-    if (_data[0] == nullptr)
+    if (!_dataBuffer[0].Allocate(size))
     {
         avformat_close_input(&formatContext);
         formatContext = nullptr;
@@ -2323,11 +2344,10 @@ int AudioManager::OpenMediaFile()
         return 1;
     }
 
-    memset(_data[0], 0x00, size);
+    _data[0] = _dataBuffer[0].As<float>();
 	if (_channels == 2)
 	{
-		_data[1] = (float*)calloc(size, 1);
-        if (_data[1] == nullptr)
+        if (!_dataBuffer[1].Allocate(size))
         {
             avformat_close_input(&formatContext);
             formatContext = nullptr;
@@ -2336,7 +2356,7 @@ int AudioManager::OpenMediaFile()
             wxASSERT(false);
             return 1;
         }
-        memset(_data[1], 0x00, size);
+        _data[1] = _dataBuffer[1].As<float>();
 	}
 	else
 	{
@@ -2388,14 +2408,15 @@ void AudioManager::LoadTrackData(AVFormatContext* formatContext, AVCodecContext*
     }
 
     _pcmdatasize = _trackSize * out_channels * 2;
-    _pcmdata = (Uint8*)calloc(_pcmdatasize + PCMFUDGE, 1); // PCMFUDGE is a fudge because some ogg files dont read consistently
-    if (_pcmdata == nullptr) {
-        _pcmdatasize = 0;
+    // PCMFUDGE is a fudge because some ogg files dont read consistently
+    if (!_pcmBuffer.Allocate(_pcmdatasize + PCMFUDGE)) {
         logger_base.error("Error allocating memory for pcm data: %ld", (long)_pcmdatasize + PCMFUDGE);
+        _pcmdatasize = 0;
         _ok = false;
         av_frame_free(&frame);
         return;
     }
+    _pcmdata = _pcmBuffer.As<Uint8>();
 
     ExtractMP3Tags(formatContext);
 
@@ -2849,13 +2870,14 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
         //save original pcm
         FilteredAudioData *fad = new FilteredAudioData();
         long datasize = sizeof(float) * (_trackSize + _extra);
-        fad->data0 = (float*)malloc(datasize);
+        if (!fad->Allocate(datasize, _data[1] != nullptr, _pcmdatasize + PCMFUDGE)) {
+            delete fad;
+            return;
+        }
         memcpy(fad->data0, _data[0], datasize);
         if (_data[1] != nullptr) {
-            fad->data1 = (float*)malloc(datasize);
             memcpy(fad->data1, _data[1], datasize);
         }
-        fad->pcmdata = (int16_t*)calloc(_pcmdatasize + PCMFUDGE, 1);
         memcpy(fad->pcmdata, _pcmdata, _pcmdatasize);
         fad->lowNote = 0;
         fad->highNote = 0;
@@ -2873,11 +2895,11 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
             if (fad == nullptr) {
                 fad = new FilteredAudioData();
                 long datasize = sizeof(float) * (_trackSize + _extra);
-                fad->data0 = (float*)malloc(datasize);
-                if (_data[1] != nullptr) {
-                    fad->data1 = (float*)malloc(datasize);
+                if (!fad->Allocate(datasize, _data[1] != nullptr, _pcmdatasize + PCMFUDGE)) {
+                    delete fad;
+                    fad = nullptr;
+                    break;
                 }
-                fad->pcmdata = (int16_t*)calloc(_pcmdatasize + PCMFUDGE, 1);
 
                 for (int i = 0; i < _trackSize; ++i) {
                     float v = _data[0][i];
@@ -2924,11 +2946,11 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
             fad = new FilteredAudioData();
 
             long datasize = sizeof(float) * (_trackSize + _extra);
-            fad->data0 = (float*)malloc(datasize);
-            if (_data[1] != nullptr) {
-                fad->data1 = (float*)malloc(datasize);
+            if (!fad->Allocate(datasize, _data[1] != nullptr, _pcmdatasize + PCMFUDGE)) {
+                delete fad;
+                fad = nullptr;
+                break;
             }
-            fad->pcmdata = (int16_t*)calloc(_pcmdatasize + PCMFUDGE, 1);
 
             //Normalize f_c and w_c so that pi is equal to the Nyquist angular frequency
             float f1_c = lowHz / _rate;
@@ -3010,6 +3032,19 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
     }
 }
 
+bool FilteredAudioData::Allocate(long datasize, bool stereo, long pcmsize)
+{
+    if (!data0Buffer.Allocate(datasize) || (stereo && !data1Buffer.Allocate(datasize)) || !pcmBuffer.Allocate(pcmsize)) {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        logger_base.error("Unable to allocate memory for filtered audio data.");
+        return false;
+    }
+    data0 = data0Buffer.As<float>();
+    data1 = stereo ? data1Buffer.As<float>() : nullptr;
+    pcmdata = pcmBuffer.As<int16_t>();
+    return true;
+}
+
 FilteredAudioData* AudioManager::GetFilteredAudioData(AUDIOSAMPLETYPE type, int lowNote, int highNote)
 {
     while (_filtered.size() == 0) {
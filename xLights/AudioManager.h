@@ -36,6 +36,7 @@ extern "C"
 }
 
 #include "vamp-hostsdk/PluginLoader.h"
+#include "MappedBuffer.h"
 #include <wx/progdlg.h>
 
 class AudioManager;
@@ -86,6 +87,27 @@ typedef enum FRAMEDATATYPE {
 	FRAMEDATA_NOTES
 } FRAMEDATATYPE;
 
+// A read only view of one frames worth of prepared audio data. It points into storage owned by the AudioManager so it is
+// only valid until the frame data is next prepared.
+class FrameDataSpan
+{
+    const float* _data = nullptr;
+    size_t _size = 0;
+
+public:
+    FrameDataSpan() {}
+    FrameDataSpan(const float* data, size_t size) : _data(data), _size(size) {}
+
+    const float* begin() const { return _data; }
+    const float* end() const { return _data + _size; }
+    const float* cbegin() const { return _data; }
+    const float* cend() const { return _data + _size; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    float front() const { return *_data; }
+    float operator[](size_t index) const { return _data[index]; }
+};
+
 typedef enum MEDIAPLAYINGSTATE {
 	PLAYING,
 	PAUSED,
@@ -247,6 +269,11 @@ typedef struct FilteredAudioData
     float* data0 = nullptr;
     float* data1 = nullptr;
     int16_t* pcmdata = nullptr;
+    // own the memory data0, data1 and pcmdata point into
+    MappedBuffer data0Buffer;
+    MappedBuffer data1Buffer;
+    MappedBuffer pcmBuffer;
+    bool Allocate(long datasize, bool stereo, long pcmsize);
 } FilteredAudioData;
 
 class AudioManager
@@ -254,7 +281,12 @@ class AudioManager
     std::shared_timed_mutex _mutex;
     std::shared_timed_mutex _mutexAudioLoad;
     long _loadedData = 0;
-    std::vector<std::vector<std::list<float>>> _frameData;
+    // prepared frame data ... the values for every frame live in one contiguous array and _frameData holds the
+    // views of them handed out by GetFrameData. Notes are added later by the polyphonic transcription so they get
+    // their own storage.
+    std::vector<float> _frameDataValues;
+    std::vector<std::vector<float>> _frameDataNotes;
+    std::vector<FrameDataSpan> _frameData;
 	std::string _audio_file;
 	xLightsVamp _vamp;
 	long _rate = 44100;
@@ -266,6 +298,10 @@ class AudioManager
 	int _state = 0;
 	float *_data[2]; // audio data
 	Uint8* _pcmdata = nullptr;
+    // own the memory _data and _pcmdata point into. Long tracks end up file backed so the decoded audio
+    // doesnt all have to stay resident
+    MappedBuffer _dataBuffer[2];
+    MappedBuffer _pcmBuffer;
 	long _pcmdatasize = 0;
 	std::string _title;
 	std::string _artist;
@@ -299,7 +335,8 @@ class AudioManager
     static int decodebitrateindex(int bitrateindex, int version, int layertype);
 	int decodesamplerateindex(int samplerateindex, int version) const;
     static int decodesideinfosize(int version, int mono);
-	std::list<float> CalculateSpectrumAnalysis(const float* in, int n, float& max, int id) const;
+	void CalculateSpectrumAnalysis(const float* in, int n, float& max, float* res) const;
+    void SetFrameDataNotes();
 
     void LoadAudioFromFrame( AVFormatContext* formatContext, AVCodecContext* codecContext, AVPacket* decodingPacket, AVFrame* frame, SwrContext* au_convert_ctx,
                              bool receivedEOF, int out_channels, uint8_t* out_buffer, long& read, int& lastpct );
@@ -362,8 +399,8 @@ public:
     void SetStepBlock(int step, int block);
 	void SetFrameInterval(int intervalMS);
 	int GetFrameInterval() const { return _intervalMS; }
-	const std::list<float>* GetFrameData(int frame, FRAMEDATATYPE fdt, std::string timing);
-	const std::list<float>* GetFrameData(FRAMEDATATYPE fdt, std::string timing, long ms);
+	const FrameDataSpan* GetFrameData(int frame, FRAMEDATATYPE fdt, std::string timing);
+	const FrameDataSpan* GetFrameData(FRAMEDATATYPE fdt, std::string timing, long ms);
 	void DoPrepareFrameData();
 	void DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManagerProgressCallback progresscallback);
 	bool IsPolyphonicTranscriptionDone() const { return _polyphonicTranscriptionDone; };
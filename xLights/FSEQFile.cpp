@@ -2,8 +2,14 @@
 #define _FILE_OFFSET_BITS 64
 #define __STDC_FORMAT_MACROS
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -40,6 +46,13 @@ int gettimeofday(struct timeval* tp, struct timezone* tzp) {
 #include <unistd.h>
 #endif
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
 #include "FSEQFile.h"
 
 #if defined(PLATFORM_OSX)
@@ -384,6 +397,7 @@ FSEQFile::FSEQFile(const std::string& fn, FILE* file, const std::vector<uint8_t>
     }
 }
 FSEQFile::~FSEQFile() {
+    unmapFile();
     if (m_seqFile) {
         fclose(m_seqFile);
     }
@@ -433,6 +447,79 @@ void FSEQFile::preload(uint64_t pos, uint64_t size) {
 #endif
 }
 
+bool FSEQFile::mapFile() {
+    if (m_mappedData != nullptr) {
+        return true;
+    }
+    if (!m_seqFile || m_seqFileSize == 0) {
+        return false;
+    }
+#ifdef _WIN32
+    HANDLE fh = (HANDLE)_get_osfhandle(_fileno(m_seqFile));
+    HANDLE mh = CreateFileMapping(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mh == nullptr) {
+        LogErr(VB_SEQUENCE, "Could not map %s, error %d.  Falling back to reading the file.\n", m_filename.c_str(), (int)GetLastError());
+        return false;
+    }
+    void* data = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        LogErr(VB_SEQUENCE, "Could not map %s, error %d.  Falling back to reading the file.\n", m_filename.c_str(), (int)GetLastError());
+        CloseHandle(mh);
+        return false;
+    }
+    m_mapHandle = mh;
+#else
+    if ((uint64_t)(size_t)m_seqFileSize != m_seqFileSize) {
+        // too big for the address space, 32 bit platforms
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)m_seqFileSize, PROT_READ, MAP_SHARED, fileno(m_seqFile), 0);
+    if (data == MAP_FAILED) {
+        LogErr(VB_SEQUENCE, "Could not map %s, error %d.  Falling back to reading the file.\n", m_filename.c_str(), errno);
+        return false;
+    }
+    // playback walks through the file front to back, let the kernel read ahead aggressively
+    // and drop pages behind us
+    madvise(data, (size_t)m_seqFileSize, MADV_SEQUENTIAL);
+#endif
+    m_mappedData = (uint8_t*)data;
+    m_mappedSize = m_seqFileSize;
+    LogDebug(VB_SEQUENCE, "Mapped %s, %" PRIu64 " bytes.\n", m_filename.c_str(), m_mappedSize);
+    return true;
+}
+
+void FSEQFile::unmapFile() {
+    if (m_mappedData == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_mappedData);
+    CloseHandle((HANDLE)m_mapHandle);
+    m_mapHandle = nullptr;
+#else
+    munmap(m_mappedData, (size_t)m_mappedSize);
+#endif
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+}
+
+void FSEQFile::adviseWillNeed(uint64_t pos, uint64_t size) {
+    if (m_mappedData == nullptr) {
+        preload(pos, size);
+        return;
+    }
+#ifndef _WIN32
+    if (pos >= m_mappedSize) {
+        return;
+    }
+    size = std::min(size, m_mappedSize - pos);
+    // madvise needs a page aligned address
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    uint64_t start = pos - (pos % page);
+    madvise(m_mappedData + start, (size_t)(size + pos - start), MADV_WILLNEED);
+#endif
+}
+
 inline bool isRecognizedStringVariableHeader(uint8_t a, uint8_t b) {
     // mf - media filename
     // sp - sequence producer
@@ -676,6 +763,41 @@ public:
     std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
 };
 
+// Frame data that points straight into a memory mapped file rather than owning a copy
+class MappedFrameData : public FSEQFile::FrameData {
+public:
+    MappedFrameData(uint32_t frame,
+                    const uint8_t* data,
+                    const std::vector<std::pair<uint32_t, uint32_t>>& ranges,
+                    bool sparse) :
+        FrameData(frame),
+        m_data(data),
+        m_ranges(ranges),
+        m_sparse(sparse) {
+    }
+    virtual ~MappedFrameData() {}
+
+    virtual bool readFrame(uint8_t* data, uint32_t maxChannels) override {
+        // sparse files store the ranges back to back, otherwise the frame is in channel order
+        uint32_t offset = 0;
+        for (auto& rng : m_ranges) {
+            if (rng.first < maxChannels) {
+                uint32_t toCopy = std::min(rng.second, maxChannels - rng.first);
+                memcpy(&data[rng.first], &m_data[m_sparse ? offset : rng.first], toCopy);
+            }
+            offset += rng.second;
+        }
+        return true;
+    }
+
+    const uint8_t* m_data;
+    std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
+    bool m_sparse;
+};
+
+// how much of the file to ask the kernel to read in when starting at a frame
+static const uint64_t FSEQ_MAPPED_PRELOAD_SIZE = 4 * 1024 * 1024;
+
 void V1FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& ranges, uint32_t startFrame) {
     m_rangesToRead = ranges;
     m_dataBlockSize = 0;
@@ -688,12 +810,28 @@ void V1FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& r
         }
         m_dataBlockSize += toRead;
     }
+    if (m_memoryMap && mapFile()) {
+        uint64_t offset = m_seqChannelCount;
+        offset *= startFrame;
+        adviseWillNeed(offset + m_seqChanDataOffset, FSEQ_MAPPED_PRELOAD_SIZE);
+        return;
+    }
     FrameData* f = getFrame(startFrame);
     if (f) {
         delete f;
     }
 }
 
+const uint8_t* V1FSEQFile::getMappedFrame(uint32_t frame) {
+    if (frame >= m_seqNumFrames) {
+        return nullptr;
+    }
+    uint64_t offset = m_seqChannelCount;
+    offset *= frame;
+    offset += m_seqChanDataOffset;
+    return getMappedData(offset, m_seqChannelCount);
+}
+
 FrameData* V1FSEQFile::getFrame(uint32_t frame) {
     if (m_rangesToRead.empty()) {
         std::vector<std::pair<uint32_t, uint32_t>> range;
@@ -704,6 +842,11 @@ FrameData* V1FSEQFile::getFrame(uint32_t frame) {
     offset *= frame;
     offset += m_seqChanDataOffset;
 
+    const uint8_t* mapped = getMappedData(offset, m_seqChannelCount);
+    if (mapped != nullptr) {
+        return new MappedFrameData(frame, mapped, m_rangesToRead, false);
+    }
+
     UncompressedFrameData* data = new UncompressedFrameData(frame, m_dataBlockSize, m_rangesToRead);
     if (seek(offset, SEEK_SET)) {
         LogErr(VB_SEQUENCE, "Failed to seek to proper offset for channel data for frame %d! %" PRIu64 "\n", frame, offset);
@@ -744,6 +887,10 @@ uint32_t V1FSEQFile::getMaxChannel() const {
 static const int V2FSEQ_HEADER_SIZE = 32;
 static const int V2FSEQ_SPARSE_RANGE_SIZE = 6;
 static const int V2FSEQ_COMPRESSION_BLOCK_SIZE = 8;
+// compression type for zstd blocks stored as one zstd frame per channel group
+static const int V2FSEQ_ZSTD_CHANNEL_GROUPS = 3;
+// smaller groups cost more in zstd frame overhead and lost context than skipping them saves
+static const uint32_t V2FSEQ_MIN_CHANNEL_GROUP_SIZE = 256;
 #if !defined(NO_ZLIB) || !defined(NO_ZSTD)
 static const int V2FSEQ_OUT_BUFFER_SIZE = 1024 * 1024;          // 1MB output buffer
 static const int V2FSEQ_OUT_BUFFER_FLUSH_SIZE = 900 * 1024;     // 90% full, flush it
@@ -780,6 +927,16 @@ public:
     void preload(uint64_t pos, uint64_t size) {
         m_file->preload(pos, size);
     }
+    // maps the file if memory mapping has been enabled
+    bool mapFile() {
+        return m_file->m_memoryMap && m_file->mapFile();
+    }
+    void adviseWillNeed(uint64_t pos, uint64_t size) {
+        m_file->adviseWillNeed(pos, size);
+    }
+    const uint8_t* getMappedData(uint64_t pos, uint64_t size) const {
+        return m_file->getMappedData(pos, size);
+    }
 
     virtual void prepareRead(uint32_t frame) {}
 
@@ -815,12 +972,29 @@ public:
     virtual uint8_t getCompressionType() override { return 0; }
     virtual std::string GetType() const override { return "No Compression"; }
     virtual void prepareRead(uint32_t frame) override {
+        if (mapFile()) {
+            uint64_t offset = m_file->getChannelCount();
+            offset *= frame;
+            adviseWillNeed(offset + m_seqChanDataOffset, FSEQ_MAPPED_PRELOAD_SIZE);
+            return;
+        }
         FrameData* f = getFrame(frame);
         if (f) {
             delete f;
         }
     }
+    // the stored frame inside the mapped file, sparse files hold just the ranges back to back
+    const uint8_t* getMappedFrame(uint32_t frame) const {
+        uint64_t offset = m_file->getChannelCount();
+        offset *= frame;
+        offset += m_seqChanDataOffset;
+        return getMappedData(offset, m_file->getChannelCount());
+    }
     virtual FrameData* getFrame(uint32_t frame) override {
+        const uint8_t* mapped = getMappedFrame(frame);
+        if (mapped != nullptr) {
+            return new MappedFrameData(frame, mapped, m_file->m_rangesToRead, !m_file->m_sparseRanges.empty());
+        }
         UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
         uint64_t offset = m_file->getChannelCount();
         offset *= frame;
@@ -960,7 +1134,272 @@ public:
     uint32_t m_maxBlocks;
 };
 
+// Decodes the block after the one being played on a background thread so crossing a
+// block boundary during playback is just a buffer swap.  Only one block is decoded ahead.
+class V2BlockPrefetcher {
+public:
+    typedef std::function<void(uint32_t block, std::vector<uint8_t>& out)> DECODE_FN;
+
+    V2BlockPrefetcher(DECODE_FN decode) :
+        m_decode(decode) {
+        m_thread = std::thread([this]() { run(); });
+    }
+    ~V2BlockPrefetcher() {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_signal.notify_all();
+        m_thread.join();
+    }
+
+    // start decoding block unless it is already decoded or underway
+    void request(uint32_t block) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_block == block && m_state != EMPTY) {
+            return;
+        }
+        if (m_state == DECODING) {
+            // cant abandon a decode part way through, the caller will have to decode it itself
+            return;
+        }
+        m_block = block;
+        m_state = PENDING;
+        m_signal.notify_all();
+    }
+
+    // swaps the decoded block into out.  Returns false if the block was not requested, the caller
+    // then has to decode it itself.  If the block is being decoded right now waits for it as that
+    // is always quicker than starting again
+    bool take(uint32_t block, std::vector<uint8_t>& out) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_block != block || m_state == EMPTY) {
+            return false;
+        }
+        if (m_state == PENDING) {
+            m_state = EMPTY;
+            return false;
+        }
+        while (m_state == DECODING) {
+            m_signal.wait(lock);
+        }
+        // out gets the decoded block and we keep the old buffer to decode into next time
+        std::swap(out, m_data);
+        m_state = EMPTY;
+        return true;
+    }
+
+private:
+    enum State { EMPTY, PENDING, DECODING, READY };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (true) {
+            while (m_state != PENDING && !m_stop) {
+                m_signal.wait(lock);
+            }
+            if (m_stop) {
+                break;
+            }
+            m_state = DECODING;
+            uint32_t block = m_block;
+            lock.unlock();
+            m_decode(block, m_data);
+            lock.lock();
+            m_state = READY;
+            m_signal.notify_all();
+        }
+    }
+
+    DECODE_FN m_decode;
+    std::thread m_thread;
+    std::mutex m_lock;
+    std::condition_variable m_signal;
+    std::vector<uint8_t> m_data;
+    uint32_t m_block = 0;
+    State m_state = EMPTY;
+    bool m_stop = false;
+};
+
 #ifndef NO_ZSTD
+// Compresses complete V2 blocks on a set of worker threads.
+// Each block is compressed independently into a complete zstd frame, exactly what the
+// streaming compressor produces for a block, so readers cannot tell the difference.
+// Blocks are handed back in the order they were submitted so they can be written in order.
+class V2ZSTDBlockCompressor {
+public:
+    class Block {
+    public:
+        uint32_t startFrame = 0;
+        int level = 0;
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> compressed;
+        bool done = false;
+    };
+
+    // groups is the first channel of each channel group, empty to compress blocks as a single frame
+    V2ZSTDBlockCompressor(int threads, const std::vector<uint32_t>& groups, uint32_t frameSize) :
+        m_groups(groups),
+        m_frameSize(frameSize) {
+        for (int x = 0; x < threads; x++) {
+            m_threads.push_back(std::thread([this]() { run(); }));
+        }
+        m_maxInFlight = threads * 2;
+    }
+    ~V2ZSTDBlockCompressor() {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_work.notify_all();
+        for (auto& t : m_threads) {
+            t.join();
+        }
+    }
+
+    void submit(uint32_t startFrame, int level, std::vector<uint8_t>&& data) {
+        Block* b = new Block();
+        b->startFrame = startFrame;
+        b->level = level;
+        b->data = std::move(data);
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_blocks.push_back(std::unique_ptr<Block>(b));
+            m_todo.push_back(b);
+        }
+        m_work.notify_one();
+    }
+
+    // hands completed blocks to writer in submission order.  If more than maxPending blocks
+    // are still outstanding, waits for them so memory use stays bounded
+    void write(const std::function<void(Block&)>& writer, size_t maxPending) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (!m_blocks.empty()) {
+            if (!m_blocks.front()->done) {
+                if (m_blocks.size() <= maxPending) {
+                    return;
+                }
+                m_done.wait(lock);
+                continue;
+            }
+            std::unique_ptr<Block> b = std::move(m_blocks.front());
+            m_blocks.pop_front();
+            lock.unlock();
+            writer(*b);
+            lock.lock();
+        }
+    }
+
+    size_t maxInFlight() const { return m_maxInFlight; }
+
+private:
+    void run() {
+        ZSTD_CCtx* cctx = ZSTD_createCCtx();
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (true) {
+            while (m_todo.empty() && !m_stop) {
+                m_work.wait(lock);
+            }
+            if (m_todo.empty()) {
+                break;
+            }
+            Block* b = m_todo.front();
+            m_todo.pop_front();
+            lock.unlock();
+
+            if (m_groups.empty()) {
+                b->compressed.resize(ZSTD_compressBound(b->data.size()));
+                size_t sz = ZSTD_compressCCtx(cctx, &b->compressed[0], b->compressed.size(), &b->data[0], b->data.size(), b->level);
+                if (ZSTD_isError(sz)) {
+                    LogErr(VB_SEQUENCE, "Failed to compress block starting at frame %d: %s. Storing it uncompressed.\n", (int)b->startFrame, ZSTD_getErrorName(sz));
+                    b->compressed.clear();
+                    appendRawFrame(b->data.data(), b->data.size(), b->compressed);
+                } else {
+                    b->compressed.resize(sz);
+                }
+            } else {
+                compressGroups(cctx, *b);
+            }
+            b->data.clear();
+            b->data.shrink_to_fit();
+
+            lock.lock();
+            b->done = true;
+            m_done.notify_all();
+        }
+        lock.unlock();
+        ZSTD_freeCCtx(cctx);
+    }
+
+    // appends a zstd frame holding data in raw (stored) blocks.  Used when compression fails so
+    // the block is still readable and the frame offsets stay correct.
+    static void appendRawFrame(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+        static const size_t maxBlock = 128 * 1024;
+        const uint8_t header[] = {
+            0x28, 0xB5, 0x2F, 0xFD, // magic
+            0xC0,                   // 8 byte content size, not single segment, no checksum or dictionary
+            0x38                    // 128KB window ... enough for a max size block
+        };
+        out.insert(out.end(), header, header + sizeof(header));
+        uint64_t contentSize = size;
+        for (int x = 0; x < 8; x++) {
+            out.push_back((contentSize >> (x * 8)) & 0xFF);
+        }
+        size_t pos = 0;
+        do {
+            size_t len = std::min(maxBlock, size - pos);
+            uint32_t bh = (uint32_t)(len << 3) | (pos + len == size ? 1 : 0); // raw block type is 0
+            out.push_back(bh & 0xFF);
+            out.push_back((bh >> 8) & 0xFF);
+            out.push_back((bh >> 16) & 0xFF);
+            if (len > 0) {
+                out.insert(out.end(), data + pos, data + pos + len);
+            }
+            pos += len;
+        } while (pos < size);
+    }
+
+    // writes each channel group for all the frames in the block as its own zstd frame, group
+    // after group, so a reader can skip the groups it does not need
+    void compressGroups(ZSTD_CCtx* cctx, Block& b) {
+        uint32_t frames = b.data.size() / m_frameSize;
+        std::vector<uint8_t> group;
+        size_t pos = 0;
+        b.compressed.resize(ZSTD_compressBound(b.data.size()) + m_groups.size() * ZSTD_compressBound(0));
+        for (size_t g = 0; g < m_groups.size(); g++) {
+            uint32_t start = m_groups[g];
+            uint32_t size = (g + 1 < m_groups.size() ? m_groups[g + 1] : m_frameSize) - start;
+            group.resize((size_t)size * frames);
+            for (uint32_t f = 0; f < frames; f++) {
+                memcpy(&group[(size_t)f * size], &b.data[(size_t)f * m_frameSize + start], size);
+            }
+            size_t sz = ZSTD_compressCCtx(cctx, &b.compressed[pos], b.compressed.size() - pos, group.empty() ? nullptr : &group[0], group.size(), b.level);
+            if (ZSTD_isError(sz)) {
+                LogErr(VB_SEQUENCE, "Failed to compress channel group %d of block starting at frame %d: %s. Storing it uncompressed.\n", (int)g, (int)b.startFrame, ZSTD_getErrorName(sz));
+                b.compressed.resize(pos);
+                appendRawFrame(group.data(), group.size(), b.compressed);
+                pos = b.compressed.size();
+                // keep room for the groups still to come
+                b.compressed.resize(pos + ZSTD_compressBound(b.data.size()) + m_groups.size() * ZSTD_compressBound(0));
+                continue;
+            }
+            pos += sz;
+        }
+        b.compressed.resize(pos);
+    }
+
+    std::vector<uint32_t> m_groups;
+    uint32_t m_frameSize;
+    std::vector<std::thread> m_threads;
+    std::mutex m_lock;
+    std::condition_variable m_work;
+    std::condition_variable m_done;
+    std::deque<std::unique_ptr<Block>> m_blocks;
+    std::deque<Block*> m_todo;
+    size_t m_maxInFlight = 2;
+    bool m_stop = false;
+};
+
 class V2ZSTDCompressionHandler : public V2CompressedHandler {
 public:
     V2ZSTDCompressionHandler(V2FSEQFile* f) :
@@ -980,6 +1419,15 @@ public:
         if (m_inBuffer.src != nullptr) {
             free((void*)m_inBuffer.src);
         }
+        if (m_prefetcher) {
+            delete m_prefetcher;
+        }
+        if (m_prefetchDctx) {
+            ZSTD_freeDStream(m_prefetchDctx);
+        }
+        if (m_blockCompressor) {
+            delete m_blockCompressor;
+        }
         if (m_cctx) {
             ZSTD_freeCStream(m_cctx);
         }
@@ -987,13 +1435,174 @@ public:
             ZSTD_freeDStream(m_dctx);
         }
     }
-    virtual uint8_t getCompressionType() override { return 1; }
-    virtual std::string GetType() const override { return "Compressed ZSTD"; }
+    virtual uint8_t getCompressionType() override { return m_file->m_channelGroups.empty() ? 1 : V2FSEQ_ZSTD_CHANNEL_GROUPS; }
+    virtual std::string GetType() const override { return m_file->m_channelGroups.empty() ? "Compressed ZSTD" : "Compressed ZSTD Channel Groups"; }
+
+    uint32_t findBlock(uint32_t frame) const {
+        uint32_t block = 0;
+        while (block + 2 < m_file->m_frameOffsets.size() && frame >= m_file->m_frameOffsets[block + 1].first) {
+            block++;
+        }
+        return block;
+    }
+    // Decodes a whole block.  Runs on the prefetch thread or, if the prefetcher was not ahead of
+    // playback, the calling thread so all file access is under m_ioLock
+    void decodeBlock(uint32_t block, std::vector<uint8_t>& in, std::vector<uint8_t>& out, ZSTD_DStream* dctx) {
+        uint64_t len = m_file->m_frameOffsets[block + 1].second;
+        len -= m_file->m_frameOffsets[block].second;
+        uint64_t max = m_file->getNumFrames() * m_file->getChannelCount();
+        if (len > max) {
+            len = max;
+        }
+        in.resize(len);
+        {
+            std::unique_lock<std::mutex> lock(m_ioLock);
+            seek(m_file->m_frameOffsets[block].second, SEEK_SET);
+            uint64_t bread = read(&in[0], len);
+            if (bread != len) {
+                LogErr(VB_SEQUENCE, "Failed to read channel data for block %d!   Needed to read %" PRIu64 " but read %d\n", (int)block, len, (int)bread);
+            }
+        }
+        uint32_t endFrame = std::min(m_file->m_frameOffsets[block + 1].first, m_file->getNumFrames());
+        out.resize((uint64_t)(endFrame - m_file->m_frameOffsets[block].first) * m_file->getChannelCount());
+
+        if (!m_file->m_channelGroups.empty()) {
+            decodeChannelGroups(block, in, out, endFrame - m_file->m_frameOffsets[block].first, dctx);
+            return;
+        }
+
+        ZSTD_initDStream(dctx);
+        ZSTD_inBuffer_s input = { &in[0], (size_t)len, 0 };
+        ZSTD_outBuffer_s output = { out.empty() ? nullptr : &out[0], out.size(), 0 };
+        while (input.pos < input.size && output.pos < output.size) {
+            size_t r = ZSTD_decompressStream(dctx, &output, &input);
+            if (ZSTD_isError(r)) {
+                LogErr(VB_SEQUENCE, "Failed to decompress block %d: %s\n", (int)block, ZSTD_getErrorName(r));
+                break;
+            }
+            if (r == 0) {
+                break;
+            }
+        }
+    }
+    bool isGroupNeeded(uint32_t start, uint32_t end) const {
+        if (m_file->m_rangesToRead.empty()) {
+            return true;
+        }
+        for (auto& rng : m_file->m_rangesToRead) {
+            if (rng.first < end && rng.first + rng.second > start) {
+                return true;
+            }
+        }
+        return false;
+    }
+    // Each channel group is a separate zstd frame holding that group for every frame in the block.
+    // Groups that do not overlap the ranges being read are skipped without decompressing them and
+    // the rest are decompressed straight into their place in the frame ordered output
+    void decodeChannelGroups(uint32_t block, std::vector<uint8_t>& in, std::vector<uint8_t>& out, uint32_t frames, ZSTD_DStream* dctx) {
+        const std::vector<uint32_t>& groups = m_file->m_channelGroups;
+        uint32_t frameSize = m_file->getChannelCount();
+        size_t pos = 0;
+        for (size_t g = 0; g < groups.size(); g++) {
+            if (pos >= in.size()) {
+                LogErr(VB_SEQUENCE, "Block %d is missing channel group %d.\n", (int)block, (int)g);
+                return;
+            }
+            size_t csize = ZSTD_findFrameCompressedSize(&in[pos], in.size() - pos);
+            if (ZSTD_isError(csize)) {
+                LogErr(VB_SEQUENCE, "Failed to find channel group %d in block %d: %s\n", (int)g, (int)block, ZSTD_getErrorName(csize));
+                return;
+            }
+            uint32_t start = groups[g];
+            uint32_t size = (g + 1 < groups.size() ? groups[g + 1] : frameSize) - start;
+            if (size > 0 && isGroupNeeded(start, start + size)) {
+                ZSTD_initDStream(dctx);
+                ZSTD_inBuffer_s input = { &in[pos], csize, 0 };
+                for (uint32_t f = 0; f < frames; f++) {
+                    ZSTD_outBuffer_s output = { &out[(size_t)f * frameSize + start], size, 0 };
+                    while (output.pos < output.size) {
+                        size_t r = ZSTD_decompressStream(dctx, &output, &input);
+                        if (ZSTD_isError(r) || (r == 0 && output.pos < output.size)) {
+                            LogErr(VB_SEQUENCE, "Failed to decompress channel group %d in block %d.\n", (int)g, (int)block);
+                            f = frames;
+                            break;
+                        }
+                    }
+                }
+            }
+            pos += csize;
+        }
+    }
+    // getFrame when read ahead is on or the file is stored in channel groups.  The block being played
+    // is decoded in one go (normally by the prefetch thread) and the following block is queued as soon
+    // as we move into a block
+    FrameData* getFrameFromBlock(uint32_t frame) {
+        if (m_prefetcher == nullptr && m_file->m_readAhead) {
+            m_prefetchDctx = ZSTD_createDStream();
+            m_prefetcher = new V2BlockPrefetcher([this](uint32_t block, std::vector<uint8_t>& out) {
+                decodeBlock(block, m_prefetchIn, out, m_prefetchDctx);
+            });
+        }
+        if (m_prefetchBlock >= m_file->m_frameOffsets.size() || (frame < m_file->m_frameOffsets[m_prefetchBlock].first) || (frame >= m_file->m_frameOffsets[m_prefetchBlock + 1].first)) {
+            uint32_t block = findBlock(frame);
+            if (m_prefetcher == nullptr || !m_prefetcher->take(block, m_prefetchOut)) {
+                if (m_prefetcher != nullptr) {
+                    LogDebug(VB_SEQUENCE, "  Read ahead missed block %d, decoding it now.\n", (int)block);
+                    m_file->m_readAheadMisses++;
+                }
+                if (m_dctx == nullptr) {
+                    m_dctx = ZSTD_createDStream();
+                }
+                decodeBlock(block, m_syncIn, m_prefetchOut, m_dctx);
+            }
+            m_prefetchBlock = block;
+            if (m_prefetcher != nullptr && block + 2 < m_file->m_frameOffsets.size()) {
+                m_prefetcher->request(block + 1);
+            }
+        }
+        uint64_t fidx = frame - m_file->m_frameOffsets[m_prefetchBlock].first;
+        fidx *= m_file->getChannelCount();
+        if (fidx + m_file->getChannelCount() > m_prefetchOut.size()) {
+            LogErr(VB_SEQUENCE, "Frame %d not in decoded block %d.\n", (int)frame, (int)m_prefetchBlock);
+            return new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
+        }
+        return createFrameData(frame, &m_prefetchOut[fidx]);
+    }
+    UncompressedFrameData* createFrameData(uint32_t frame, const uint8_t* fdata) {
+        UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
+        if (!m_file->m_sparseRanges.empty()) {
+            memcpy(data->m_data, fdata, m_file->getChannelCount());
+        } else {
+            uint32_t sz = 0;
+            //read the ranges into the buffer
+            for (auto& rng : data->m_ranges) {
+                if (rng.first < m_file->getChannelCount()) {
+                    memcpy(&data->m_data[sz], &fdata[rng.first], rng.second);
+                    sz += rng.second;
+                }
+            }
+        }
+        return data;
+    }
+    virtual void prepareRead(uint32_t frame) override {
+        if (m_file->m_readAhead && m_file->m_frameOffsets.size() > 1) {
+            // get the first block decoding before playback asks for it
+            if (m_prefetcher == nullptr) {
+                delete getFrameFromBlock(frame);
+            } else {
+                m_prefetcher->request(findBlock(frame));
+            }
+        }
+    }
 
     virtual FrameData *getFrame(uint32_t frame) override {
 
         if (m_file == nullptr) LogDebug(VB_SEQUENCE, " getFrame m_file unexpectantly null.\n");
 
+        if (m_file->m_readAhead || !m_file->m_channelGroups.empty()) {
+            return getFrameFromBlock(frame);
+        }
+
         if (m_curBlock >= m_file->m_frameOffsets.size() || (frame < m_file->m_frameOffsets[m_curBlock].first) || (frame >= m_file->m_frameOffsets[m_curBlock + 1].first)) {
             //frame is not in the current block
             m_curBlock = 0;
@@ -1073,30 +1682,15 @@ public:
 
         fidx *= m_file->getChannelCount();
         uint8_t* fdata = (uint8_t*)m_outBuffer.dst;
-        UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
 
         // This stops the crash on load ... but it is not the root cause.
         // But better to not load completely than crashing
         if (fidx < 0) {
             // this is not going to end well ... best to give up here
             LogErr(VB_SEQUENCE, "Frame index calculated as a negative number. Aborting frame %d load.\n", (int)frame);
-            return data;
-        }
-
-        if (!m_file->m_sparseRanges.empty()) {
-            memcpy(data->m_data, &fdata[fidx], m_file->getChannelCount());
-        } else {
-            uint32_t sz = 0;
-            //read the ranges into the buffer
-            for (auto& rng : data->m_ranges) {
-                if (rng.first < m_file->getChannelCount()) {
-                    uint64_t start = fidx + rng.first;
-                    memcpy(&data->m_data[sz], &fdata[start], rng.second);
-                    sz += rng.second;
-                }
-            }
+            return new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
         }
-        return data;
+        return createFrameData(frame, &fdata[fidx]);
     }
     void compressData(ZSTD_CStream* m_cctx, ZSTD_inBuffer_s& input, ZSTD_outBuffer_s& output) {
         ZSTD_compressStream(m_cctx, &output, &input);
@@ -1117,30 +1711,92 @@ public:
             count += input.pos;
         }
     }
+    int getCompressionLevel(uint32_t frame) const {
+        int clevel = m_file->m_compressionLevel == -99 ? 2 : m_file->m_compressionLevel;
+        if (clevel < -25 || clevel > 25) {
+            clevel = 2;
+        }
+        if (frame == 0 && (ZSTD_versionNumber() > 10305)) {
+            // first frame needs to be grabbed as fast as possible
+            // or remotes may be off by a few frames at start.  Thus,
+            // if using recent zstd, we'll use the negative levels
+            // for the first block so the decompression can
+            // be as fast as possible
+            clevel = -10;
+        }
+        if (ZSTD_versionNumber() <= 10305 && clevel < 0) {
+            clevel = 0;
+        }
+        return clevel;
+    }
+    void writeCompressedBlocks(size_t maxPending) {
+        m_blockCompressor->write([this](V2ZSTDBlockCompressor::Block& b) {
+            m_file->m_frameOffsets.push_back(std::pair<uint32_t, uint64_t>(b.startFrame, tell()));
+            if (!b.compressed.empty()) {
+                write(&b.compressed[0], b.compressed.size());
+            }
+        }, maxPending);
+    }
+    void submitBlock() {
+        m_blockCompressor->submit(m_blockStartFrame, getCompressionLevel(m_blockStartFrame), std::move(m_blockData));
+        m_blockData = std::vector<uint8_t>();
+        writeCompressedBlocks(m_blockCompressor->maxInFlight());
+    }
+    // Gathers whole blocks and compresses them on the block compressor threads
+    void addFrameParallel(uint32_t frame, const uint8_t* data) {
+        uint32_t frameSize = m_file->getChannelCount();
+        if (!m_file->m_sparseRanges.empty()) {
+            frameSize = 0;
+            for (auto& a : m_file->m_sparseRanges) {
+                frameSize += a.second;
+            }
+        }
+        if (m_curFrameInBlock == 0) {
+            m_blockStartFrame = frame;
+            m_blockData.reserve((size_t)std::max(m_framesPerBlock, (uint32_t)10) * frameSize);
+        }
+        if (m_file->m_sparseRanges.empty()) {
+            m_blockData.insert(m_blockData.end(), data, data + frameSize);
+        } else {
+            for (auto& a : m_file->m_sparseRanges) {
+                m_blockData.insert(m_blockData.end(), &data[a.first], &data[a.first] + a.second);
+            }
+        }
+
+        m_curFrameInBlock++;
+        // same block boundaries as the streaming compressor
+        if ((m_curBlock == 0 && m_curFrameInBlock == 10) || (m_curFrameInBlock >= m_framesPerBlock && (m_curBlock + 1) < m_maxBlocks)) {
+            submitBlock();
+            m_curFrameInBlock = 0;
+            m_curBlock++;
+        }
+    }
     virtual void addFrame(uint32_t frame, const uint8_t* data) override {
+        // channel grouped blocks can only be written a whole block at a time
+        if ((m_file->m_compressionThreads > 1 && !m_file->m_useZstdWorkers) || !m_file->m_channelGroups.empty()) {
+            if (m_blockCompressor == nullptr) {
+                m_blockCompressor = new V2ZSTDBlockCompressor(std::max(m_file->m_compressionThreads, 1), m_file->m_channelGroups, m_file->getChannelCount());
+            }
+            addFrameParallel(frame, data);
+            return;
+        }
         if (m_cctx == nullptr) {
             m_cctx = ZSTD_createCStream();
+#if ZSTD_VERSION_NUMBER >= 10400
+            if (m_file->m_compressionThreads > 1) {
+                // only works if the library was built with ZSTD_MULTITHREAD, otherwise we stay single threaded
+                size_t r = ZSTD_CCtx_setParameter(m_cctx, ZSTD_c_nbWorkers, m_file->m_compressionThreads);
+                if (ZSTD_isError(r)) {
+                    LogDebug(VB_SEQUENCE, "  ZSTD multithreading not available: %s.\n", ZSTD_getErrorName(r));
+                }
+            }
+#endif
         }
         if (m_curFrameInBlock == 0) {
             uint64_t offset = tell();
             //LogDebug(VB_SEQUENCE, "  Preparing to create a compressed block of data starting at frame %d, offset  %" PRIu64 ".\n", frame, offset);
             m_file->m_frameOffsets.push_back(std::pair<uint32_t, uint64_t>(frame, offset));
-            int clevel = m_file->m_compressionLevel == -99 ? 2 : m_file->m_compressionLevel;
-            if (clevel < -25 || clevel > 25) {
-                clevel = 2;
-            }
-            if (frame == 0 && (ZSTD_versionNumber() > 10305)) {
-                // first frame needs to be grabbed as fast as possible
-                // or remotes may be off by a few frames at start.  Thus,
-                // if using recent zstd, we'll use the negative levels
-                // for the first block so the decompression can
-                // be as fast as possible
-                clevel = -10;
-            }
-            if (ZSTD_versionNumber() <= 10305 && clevel < 0) {
-                clevel = 0;
-            }
-            ZSTD_initCStream(m_cctx, clevel);
+            ZSTD_initCStream(m_cctx, getCompressionLevel(frame));
         }
 
         uint8_t* curData = (uint8_t*)data;
@@ -1185,6 +1841,17 @@ public:
         }
     }
     virtual void finalize() override {
+        if (m_blockCompressor) {
+            if (m_curFrameInBlock) {
+                submitBlock();
+                LogDebug(VB_SEQUENCE, "  Finalized last block of data.  Frames in block: %d.\n", m_curFrameInBlock);
+                m_curFrameInBlock = 0;
+                m_curBlock++;
+            }
+            writeCompressedBlocks(0);
+            V2CompressedHandler::finalize();
+            return;
+        }
         if (m_curFrameInBlock) {
             while (ZSTD_endStream(m_cctx, &m_outBuffer) > 0) {
                 write(m_outBuffer.dst, m_outBuffer.pos);
@@ -1203,6 +1870,19 @@ public:
     ZSTD_DStream* m_dctx = nullptr;
     ZSTD_outBuffer_s m_outBuffer;
     ZSTD_inBuffer_s m_inBuffer;
+
+    // read ahead
+    V2BlockPrefetcher* m_prefetcher = nullptr;
+    ZSTD_DStream* m_prefetchDctx = nullptr;
+    std::mutex m_ioLock;
+    std::vector<uint8_t> m_prefetchIn;
+    std::vector<uint8_t> m_syncIn;
+    std::vector<uint8_t> m_prefetchOut;
+    uint32_t m_prefetchBlock = 99999;
+
+    V2ZSTDBlockCompressor* m_blockCompressor = nullptr;
+    std::vector<uint8_t> m_blockData;
+    uint32_t m_blockStartFrame = 0;
 };
 #endif
 
@@ -1420,6 +2100,54 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, CompressionType ct, int cl) :
 
     createHandler();
 }
+void V2FSEQFile::setupChannelGroups() {
+    m_channelGroups.clear();
+    // a group header copied from another file would describe the wrong layout
+    m_variableHeaders.erase(std::remove_if(m_variableHeaders.begin(), m_variableHeaders.end(), [](const VariableHeader& h) {
+                                return h.code[0] == 'c' && h.code[1] == 'g';
+                            }),
+                            m_variableHeaders.end());
+    if (m_channelGroupRanges.empty()) {
+        return;
+    }
+    if (m_compressionType != CompressionType::zstd || !m_sparseRanges.empty()) {
+        LogDebug(VB_SEQUENCE, "Channel groups are only supported for non sparse zstd files, ignoring.\n");
+        return;
+    }
+
+    // every range boundary starts a new group, channels outside the ranges get groups of their own
+    std::vector<uint32_t> starts;
+    starts.push_back(0);
+    for (auto& a : m_channelGroupRanges) {
+        if (a.first < m_seqChannelCount) {
+            starts.push_back(a.first);
+        }
+        if (a.first + a.second < m_seqChannelCount) {
+            starts.push_back(a.first + a.second);
+        }
+    }
+    std::sort(starts.begin(), starts.end());
+    for (auto s : starts) {
+        if (m_channelGroups.empty() || s - m_channelGroups.back() >= V2FSEQ_MIN_CHANNEL_GROUP_SIZE) {
+            m_channelGroups.push_back(s);
+        }
+    }
+    if (m_channelGroups.size() < 2) {
+        m_channelGroups.clear();
+        return;
+    }
+
+    // cg - channel groups, the 4 byte first channel of each group
+    VariableHeader header;
+    header.code[0] = 'c';
+    header.code[1] = 'g';
+    header.data.resize(m_channelGroups.size() * 4);
+    for (size_t x = 0; x < m_channelGroups.size(); x++) {
+        write4ByteUInt(&header.data[x * 4], m_channelGroups[x]);
+    }
+    m_variableHeaders.push_back(header);
+}
+
 void V2FSEQFile::writeHeader() {
     if (!m_sparseRanges.empty()) {
         //make sure the sparse ranges fit, and then
@@ -1442,6 +2170,8 @@ void V2FSEQFile::writeHeader() {
         }
     }
 
+    setupChannelGroups();
+
     // Additional file format documentation available at:
     // https://github.com/FalconChristmas/fpp/blob/master/docs/FSEQ_Sequence_File_Format.txt#L17
 
@@ -1621,6 +2351,9 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
         case 2:
             m_compressionType = CompressionType::zlib;
             break;
+        case V2FSEQ_ZSTD_CHANNEL_GROUPS:
+            m_compressionType = CompressionType::zstd;
+            break;
         default:
             LogErr(VB_SEQUENCE, "Unknown compression type: %d\n", (int)header[20]);
         }
@@ -1702,6 +2435,25 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
         // This will loop and continue reading until it hits padding or m_seqChanDataOffset
         // As long as readPos == headerSize prior to this call, the read is a success
         parseVariableHeaders(header, readPos);
+
+        if ((header[20] & 0xF) == V2FSEQ_ZSTD_CHANNEL_GROUPS) {
+            for (auto& h : m_variableHeaders) {
+                if (h.code[0] == 'c' && h.code[1] == 'g') {
+                    for (size_t x = 0; x + 4 <= h.data.size(); x += 4) {
+                        uint32_t start = read4ByteUInt(&h.data[x]);
+                        if (start >= m_seqChannelCount || (!m_channelGroups.empty() && start <= m_channelGroups.back()) || (m_channelGroups.empty() && start != 0)) {
+                            LogErr(VB_SEQUENCE, "Invalid channel group start %d.\n", (int)start);
+                            m_channelGroups.clear();
+                            break;
+                        }
+                        m_channelGroups.push_back(start);
+                    }
+                }
+            }
+            if (m_channelGroups.empty()) {
+                LogErr(VB_SEQUENCE, "FSEQ file corrupt: stored in channel groups but the groups are missing.\n");
+            }
+        }
     }
 
     createHandler();
@@ -1726,6 +2478,7 @@ void V2FSEQFile::dumpInfo(bool indent) {
     //    LogDebug(VB_SEQUENCE, "%s      %d              : %" PRIu64 "\n", ind, a.first, a.second);
     //}
     LogDebug(VB_SEQUENCE, "%snumRanges             : %d\n", ind, m_sparseRanges.size());
+    LogDebug(VB_SEQUENCE, "%snumChannelGroups      : %d\n", ind, m_channelGroups.size());
     // Commented out to declutter the logs ... we can add it back in if we start seeing issues
     //for (auto &a : m_sparseRanges) {
     //    LogDebug(VB_SEQUENCE, "%s      Start: %d    Len: %d\n", ind, a.first, a.second);
@@ -1769,6 +2522,15 @@ void V2FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& r
     }
     m_handler->prepareRead(startFrame);
 }
+const uint8_t* V2FSEQFile::getMappedFrame(uint32_t frame) {
+    if (m_compressionType != CompressionType::none || !m_sparseRanges.empty() || frame >= m_seqNumFrames) {
+        return nullptr;
+    }
+    uint64_t offset = m_seqChannelCount;
+    offset *= frame;
+    offset += m_seqChanDataOffset;
+    return getMappedData(offset, m_seqChannelCount);
+}
 FrameData* V2FSEQFile::getFrame(uint32_t frame) {
     if (m_rangesToRead.empty()) {
         std::vector<std::pair<uint32_t, uint32_t>> range;
@@ -1780,11 +2542,13 @@ FrameData* V2FSEQFile::getFrame(uint32_t frame) {
     }
     if (m_handler != nullptr) {
         FrameData* fd = nullptr;
+        uint64_t start = GetTime();
         try {
             fd = m_handler->getFrame(frame);
         } catch (...) {
             LogErr(VB_SEQUENCE, "Error getting frame from handler %s.\n", m_handler->GetType().c_str());
         }
+        recordFrameReadTime(GetTime() - start);
         return fd;
     }
     return nullptr;
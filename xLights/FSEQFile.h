@@ -72,8 +72,34 @@ public:
     //It may not be used right away and will be deleted at some point in the future
     virtual FrameData *getFrame(uint32_t frame) = 0;
 
+    //For playback, decode the next block on a background thread so getFrame does not stall
+    //at block boundaries.  Must be called before prepareRead.
+    virtual void enableReadAhead(bool enable) {}
+
+    //worst case time a getFrame call has taken and the number of times read ahead
+    //did not have the needed block ready
+    uint64_t getMaxFrameReadTimeUS() const { return m_maxFrameReadUS; }
+    virtual uint32_t getReadAheadMisses() const { return 0; }
+    virtual void resetReadStatistics() { m_maxFrameReadUS = 0; }
+
+    //Map uncompressed files into memory so frames are read straight from the page cache
+    //rather than with a seek/read per frame.  Must be called before prepareRead.
+    void enableMemoryMap(bool enable) { m_memoryMap = enable; }
+    bool isMemoryMapped() const { return m_mappedData != nullptr; }
+    //pointer to the whole frame, channel 0 first, inside the mapped file.  Returns nullptr if
+    //the file is not mapped or the frame is not stored that way (compressed or sparse files)
+    //in which case use getFrame.  Only valid until the file is deleted.
+    virtual const uint8_t* getMappedFrame(uint32_t frame) { return nullptr; }
+
     //For writing to the fseq file
     virtual void enableMinorVersionFeatures(uint8_t ver) {}
+    //compress blocks on multiple threads while writing (V2 zstd only), useZstdWorkers uses
+    //zstd's own worker threads instead of compressing separate blocks in parallel
+    virtual void enableMultiThreadedCompression(int threads, bool useZstdWorkers = false) {}
+    //store each block as a separate zstd frame per channel group (V2 zstd, not sparse, typically
+    //one group per controller) so a reader only decompresses the groups holding the channels it
+    //needs.  Older readers cannot read files written this way.
+    virtual void enableChannelGroups(const std::vector<std::pair<uint32_t, uint32_t>>& groups) {}
     virtual void initializeFromFSEQ(const FSEQFile& fseq);
     virtual void writeHeader() = 0;
     virtual void addFrame(uint32_t frame,
@@ -123,6 +149,27 @@ protected:
     uint64_t write(const void * ptr, uint64_t size);
     uint64_t read(void *ptr, uint64_t size);
     void preload(uint64_t pos, uint64_t size);
+    bool mapFile();
+    void unmapFile();
+    void adviseWillNeed(uint64_t pos, uint64_t size);
+    const uint8_t* getMappedData(uint64_t pos, uint64_t size) const {
+        if (m_mappedData == nullptr || pos + size > m_mappedSize) {
+            return nullptr;
+        }
+        return m_mappedData + pos;
+    }
+    void recordFrameReadTime(uint64_t us) {
+        if (us > m_maxFrameReadUS) {
+            m_maxFrameReadUS = us;
+        }
+    }
+    uint64_t      m_maxFrameReadUS = 0;
+    bool          m_memoryMap = false;
+    uint8_t*      m_mappedData = nullptr;
+    uint64_t      m_mappedSize = 0;
+#ifdef _WIN32
+    void*         m_mapHandle = nullptr;
+#endif
 
 private:
     FILE* volatile  m_seqFile;
@@ -140,6 +187,7 @@ public:
 
     virtual void prepareRead(const std::vector<std::pair<uint32_t, uint32_t>> &ranges, uint32_t startFrame = 0) override;
     virtual FrameData *getFrame(uint32_t frame) override;
+    virtual const uint8_t* getMappedFrame(uint32_t frame) override;
 
     virtual void writeHeader() override;
     virtual void addFrame(uint32_t frame,
@@ -167,6 +215,7 @@ public:
 
     virtual void prepareRead(const std::vector<std::pair<uint32_t, uint32_t>> &ranges, uint32_t startFrame = 0) override;
     virtual FrameData *getFrame(uint32_t frame) override;
+    virtual const uint8_t* getMappedFrame(uint32_t frame) override;
 
     virtual void writeHeader() override;
     virtual void addFrame(uint32_t frame,
@@ -177,6 +226,22 @@ public:
 
     virtual uint32_t getMaxChannel() const override;
 
+    virtual void enableReadAhead(bool enable) override { m_readAhead = enable; }
+    virtual uint32_t getReadAheadMisses() const override { return m_readAheadMisses; }
+    virtual void resetReadStatistics() override {
+        FSEQFile::resetReadStatistics();
+        m_readAheadMisses = 0;
+    }
+
+    virtual void enableMultiThreadedCompression(int threads, bool useZstdWorkers = false) override {
+        m_compressionThreads = threads;
+        m_useZstdWorkers = useZstdWorkers;
+    }
+
+    virtual void enableChannelGroups(const std::vector<std::pair<uint32_t, uint32_t>>& groups) override {
+        m_channelGroupRanges = groups;
+    }
+
     virtual void enableMinorVersionFeatures(uint8_t ver) override {
         m_seqVersionMinor = ver;
         if (ver == 0) {
@@ -189,14 +254,23 @@ public:
 
     CompressionType m_compressionType;
     int             m_compressionLevel;
+    int             m_compressionThreads = 1;
+    bool            m_useZstdWorkers = false;
+    bool            m_readAhead = false;
+    uint32_t        m_readAheadMisses = 0;
     std::vector<std::pair<uint32_t, uint32_t>> m_sparseRanges;
     std::vector<std::pair<uint32_t, uint32_t>> m_rangesToRead;
     std::vector<std::pair<uint32_t, uint64_t>> m_frameOffsets;
+    //first channel of each group when blocks are stored per channel group, empty otherwise
+    std::vector<uint32_t> m_channelGroups;
     uint32_t m_dataBlockSize;
     bool m_allowExtendedBlocks;
 private:
 
     void createHandler();
+    void setupChannelGroups();
+
+    std::vector<std::pair<uint32_t, uint32_t>> m_channelGroupRanges;
 
     V2Handler *m_handler;
     friend class V2Handler;
@@ -0,0 +1,130 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "FastTrig.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FAST_TRIG_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FAST_TRIG_NEON
+#endif
+
+namespace FastTrig
+{
+#if defined(FAST_TRIG_SSE2)
+    // same steps as Reduce and FastSin, 4 at a time
+    static inline __m128 Reduce4(__m128 x)
+    {
+        __m128 half = _mm_or_ps(_mm_set1_ps(0.5f), _mm_and_ps(x, _mm_set1_ps(-0.0f)));
+        __m128 k = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.0f / TWO_PI)), half)));
+        return _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(6.28125f))), _mm_mul_ps(k, _mm_set1_ps(1.9353071795864769e-3f)));
+    }
+    static inline __m128 Sin4(__m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        x = Reduce4(x);
+        __m128 sign = _mm_and_ps(x, signMask);
+        __m128 ax = _mm_andnot_ps(signMask, x);
+        ax = _mm_min_ps(ax, _mm_sub_ps(_mm_set1_ps(PI), ax));
+        x = _mm_or_ps(ax, sign);
+
+        __m128 x2 = _mm_mul_ps(x, x);
+        __m128 p = _mm_add_ps(_mm_set1_ps(2.7557319e-6f), _mm_mul_ps(x2, _mm_set1_ps(-2.5052108e-8f)));
+        p = _mm_add_ps(_mm_set1_ps(-1.9841270e-4f), _mm_mul_ps(x2, p));
+        p = _mm_add_ps(_mm_set1_ps(8.3333333e-3f), _mm_mul_ps(x2, p));
+        p = _mm_add_ps(_mm_set1_ps(-1.6666667e-1f), _mm_mul_ps(x2, p));
+        p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, p));
+        return _mm_mul_ps(x, p);
+    }
+#elif defined(FAST_TRIG_NEON)
+    static inline float32x4_t Reduce4(float32x4_t x)
+    {
+        float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000))));
+        float32x4_t k = vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(x, 1.0f / TWO_PI), half)));
+        return vsubq_f32(vsubq_f32(x, vmulq_n_f32(k, 6.28125f)), vmulq_n_f32(k, 1.9353071795864769e-3f));
+    }
+    static inline float32x4_t Sin4(float32x4_t x)
+    {
+        const uint32x4_t signMask = vdupq_n_u32(0x80000000);
+
+        x = Reduce4(x);
+        uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(x), signMask);
+        float32x4_t ax = vabsq_f32(x);
+        ax = vminq_f32(ax, vsubq_f32(vdupq_n_f32(PI), ax));
+        x = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(ax), sign));
+
+        float32x4_t x2 = vmulq_f32(x, x);
+        float32x4_t p = vaddq_f32(vdupq_n_f32(2.7557319e-6f), vmulq_n_f32(x2, -2.5052108e-8f));
+        p = vaddq_f32(vdupq_n_f32(-1.9841270e-4f), vmulq_f32(x2, p));
+        p = vaddq_f32(vdupq_n_f32(8.3333333e-3f), vmulq_f32(x2, p));
+        p = vaddq_f32(vdupq_n_f32(-1.6666667e-1f), vmulq_f32(x2, p));
+        p = vaddq_f32(vdupq_n_f32(1.0f), vmulq_f32(x2, p));
+        return vmulq_f32(x, p);
+    }
+#endif
+
+    void Sin(float* values, int count)
+    {
+        int i = 0;
+#if defined(FAST_TRIG_SSE2)
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(values + i, Sin4(_mm_loadu_ps(values + i)));
+        }
+#elif defined(FAST_TRIG_NEON)
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(values + i, Sin4(vld1q_f32(values + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+            values[i] = FastSin(values[i]);
+        }
+    }
+
+    void Cos(float* values, int count)
+    {
+        int i = 0;
+#if defined(FAST_TRIG_SSE2)
+        const __m128 hp = _mm_set1_ps(HALF_PI);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(values + i, Sin4(_mm_add_ps(Reduce4(_mm_loadu_ps(values + i)), hp)));
+        }
+#elif defined(FAST_TRIG_NEON)
+        const float32x4_t hp = vdupq_n_f32(HALF_PI);
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(values + i, Sin4(vaddq_f32(Reduce4(vld1q_f32(values + i)), hp)));
+        }
+#endif
+        for (; i < count; ++i) {
+            values[i] = FastCos(values[i]);
+        }
+    }
+
+    void Sqrt(float* values, int count)
+    {
+        int i = 0;
+#if defined(FAST_TRIG_SSE2)
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(values + i, _mm_sqrt_ps(_mm_loadu_ps(values + i)));
+        }
+#elif defined(FAST_TRIG_NEON)
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(values + i, vsqrtq_f32(vld1q_f32(values + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+            values[i] = std::sqrt(values[i]);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+
+// Fast trig over arrays of floats for the per pixel math in effects like Plasma, Butterfly and Warp.
+//
+// The array functions process 4 values at a time with SSE2 or NEON where available and fall back to the
+// scalar versions otherwise. Results are much closer to sinf/cosf than the RenderBuffer::sin lookup table
+// these replace.
+namespace FastTrig
+{
+    constexpr float PI = 3.14159265358979f;
+    constexpr float TWO_PI = 6.28318530717959f;
+    constexpr float HALF_PI = 1.57079632679490f;
+
+    // reduce to [-pi, pi] ... 2pi is split in two so the reduction stays accurate for larger values
+    inline float Reduce(float x)
+    {
+        float k = (float)(int32_t)(x * (1.0f / TWO_PI) + (x >= 0 ? 0.5f : -0.5f));
+        return (x - k * 6.28125f) - k * 1.9353071795864769e-3f;
+    }
+
+    inline float FastSin(float x)
+    {
+        x = Reduce(x);
+
+        // sin(x) == sin(pi - x) so fold to [-pi/2, pi/2]
+        if (x > HALF_PI) {
+            x = PI - x;
+        } else if (x < -HALF_PI) {
+            x = -PI - x;
+        }
+
+        float x2 = x * x;
+        return x * (1.0f + x2 * (-1.6666667e-1f + x2 * (8.3333333e-3f + x2 * (-1.9841270e-4f + x2 * (2.7557319e-6f + x2 * -2.5052108e-8f)))));
+    }
+    inline float FastCos(float x)
+    {
+        return FastSin(Reduce(x) + HALF_PI);
+    }
+
+    // values[i] = sin(values[i])
+    void Sin(float* values, int count);
+    // values[i] = cos(values[i])
+    void Cos(float* values, int count);
+    // values[i] = sqrt(values[i])
+    void Sqrt(float* values, int count);
+}
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <map>
+#include <thread>
 
 #include <wx/app.h>
 #include <wx/arrstr.h>
@@ -1634,6 +1635,7 @@ void FileConverter::WriteFalconPiFile(ConvertParameters& params)
     int vMajor = 2;
     int clevel = 2;
     bool allowSparse = false;
+    bool controllerGroups = false;
     FSEQFile::CompressionType ctype = FSEQFile::CompressionType::zstd;
     switch (fType) {
         case 1:
@@ -1649,6 +1651,9 @@ void FileConverter::WriteFalconPiFile(ConvertParameters& params)
         case 5:
             allowSparse = true;
             break;
+        case 6:
+            controllerGroups = true;
+            break;
         default:
             break;
     }
@@ -1662,6 +1667,18 @@ void FileConverter::WriteFalconPiFile(ConvertParameters& params)
     wxUint16 stepTime = params.seq_data.FrameTime();
     if (vMajor == 2) {
         file->enableMinorVersionFeatures(2);
+        // blocks are independent so compress them on all the cores rather than just the save thread
+        file->enableMultiThreadedCompression(std::max(1u, std::thread::hardware_concurrency()));
+        if (controllerGroups && params._outputManager != nullptr) {
+            // one group per controller so xSchedule only decompresses the controllers it is playing to
+            std::vector<std::pair<uint32_t, uint32_t>> groups;
+            for (const auto& it : params._outputManager->GetControllers()) {
+                if (it->GetStartChannel() > 0 && it->GetChannels() > 0) {
+                    groups.push_back(std::pair<uint32_t, uint32_t>(it->GetStartChannel() - 1, it->GetChannels()));
+                }
+            }
+            file->enableChannelGroups(groups);
+        }
     }
     file->setChannelCount(stepSize);
     file->setStepTime(stepTime);
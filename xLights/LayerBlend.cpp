@@ -0,0 +1,581 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "LayerBlend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAYER_BLEND_SSE2
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LAYER_BLEND_NEON
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// The block functions below are written as straight loops over the colour planes with no branches so the compiler
+// can vectorise them for whatever instruction set we are built for. The saturating add/subtract have no portable
+// form the compilers reliably spot so those use SSE2/NEON directly.
+
+#pragma region Prepare
+void LayerBlendParams::Prepare()
+{
+    static const int n = 0;  //increase to change the curve of the crossfade
+
+    if (!effectMixVaries) {
+        emt = effectMixThreshold;
+        if ((emt > 0.000001) && (emt < 0.99999)) {
+            emtNot = 1 - effectMixThreshold;
+            //make cross-fade linear
+            emt = cos((M_PI / 4) * (pow(2 * emt - 1, 2 * n + 1) + 1));
+            emtNot = cos((M_PI / 4) * (pow(2 * emtNot - 1, 2 * n + 1) + 1));
+        } else {
+            emtNot = effectMixThreshold;
+            emt = 1 - effectMixThreshold;
+        }
+    } else {
+        emt = effectMixThreshold;
+        emtNot = 1 - effectMixThreshold;
+    }
+
+    // HSV value is just max(r,g,b)/255 so the threshold tests can be done on the raw channel bytes
+    valueThreshold = -1;
+    for (int i = 0; i < 256; ++i) {
+        if (i / 255.0 > effectMixThreshold) break;
+        valueThreshold = i;
+    }
+}
+#pragma endregion
+
+#pragma region Single Pixel
+void MixPixel(const LayerBlendParams& params, int x, int y, xlColor& fg, xlColor& bg)
+{
+    float effectMixThreshold = params.effectMixThreshold;
+    switch (params.mixType)
+    {
+    case MixTypes::Mix_Normal:
+        fg.alpha = fg.alpha * params.fadeFactor * (1.0 - effectMixThreshold);
+        bg.AlphaBlendForgroundOnto(fg);
+        break;
+    case MixTypes::Mix_Effect1:
+    case MixTypes::Mix_Effect2:
+    {
+        double emt = params.emt;
+        double emtNot = params.emtNot;
+        if (params.mixType == MixTypes::Mix_Effect2) {
+            fg.Set(fg.Red()*(emtNot),fg.Green()*(emtNot), fg.Blue()*(emtNot));
+            bg.Set(bg.Red()*(emt),bg.Green()*(emt), bg.Blue()*(emt));
+        } else {
+            fg.Set(fg.Red()*(emt),fg.Green()*(emt), fg.Blue()*(emt));
+            bg.Set(bg.Red()*(emtNot),bg.Green()*(emtNot), bg.Blue()*(emtNot));
+        }
+        bg.Set(fg.Red()+bg.Red(), fg.Green()+bg.Green(), fg.Blue()+bg.Blue());
+        break;
+    }
+    case MixTypes::Mix_Mask1:
+    {
+        // first masks second
+        HSVValue hsv0 = fg.asHSV();
+        if (hsv0.value > effectMixThreshold) {
+            bg.Set(0, 0, 0);
+        }
+        break;
+    }
+    case MixTypes::Mix_Mask2:
+    {
+        // second masks first
+        HSVValue hsv1 = bg.asHSV();
+        if (hsv1.value <= effectMixThreshold) {
+            bg = fg;
+        } else {
+            bg.Set(0, 0, 0);
+        }
+        break;
+    }
+    case MixTypes::Mix_Unmask1:
+    {
+        // first unmasks second
+        HSVValue hsv0 = fg.asHSV();
+        if (hsv0.value > effectMixThreshold) {
+            HSVValue hsv1 = bg.asHSV();
+            hsv1.value = hsv0.value;
+            bg = hsv1;
+        } else {
+            bg.Set(0, 0, 0);
+        }
+        break;
+    }
+    case MixTypes::Mix_TrueUnmask1:
+    {
+        // first unmasks second
+        HSVValue hsv0 = fg.asHSV();
+        if (hsv0.value <= effectMixThreshold) {
+            bg.Set(0, 0, 0);
+        }
+        break;
+    }
+    case MixTypes::Mix_Unmask2:
+    {
+        // second unmasks first
+        HSVValue hsv1 = bg.asHSV();
+        if (hsv1.value > effectMixThreshold) {
+            HSVValue hsv0 = fg.asHSV();
+            // if effect 2 is non black
+            hsv0.value = hsv1.value;
+            bg = hsv0;
+        } else {
+            bg.Set(0, 0, 0);
+        }
+        break;
+    }
+    case MixTypes::Mix_TrueUnmask2:
+    {
+        // second unmasks first
+        HSVValue hsv1 = bg.asHSV();
+        if (hsv1.value > effectMixThreshold) {
+            // if effect 2 is non black
+            bg = fg;
+        } else {
+            bg.Set(0, 0, 0);
+        }
+        break;
+    }
+    case MixTypes::Mix_Shadow_1on2:
+    {
+        // Effect 1 shadows onto effect 2
+        HSVValue hsv0 = fg.asHSV();
+        HSVValue hsv1 = bg.asHSV();
+        //   if (hsv0.value > effectMixThreshold[layer]) {
+        // if effect 1 is non black
+        //  to shadow we will shift the hue on the primary layer using the hue and brightness from the
+        //  other layer
+        if(hsv0.value>0.0) hsv1.hue = hsv1.hue + (hsv0.value*(hsv1.hue-hsv0.hue))/5.0;
+        // hsv1.value = hsv0.value;
+        //hsv1.saturation = hsv0.saturation;
+        bg = hsv1;
+        //   }
+        break;
+    }
+    case MixTypes::Mix_Shadow_2on1:
+    {
+        // Effect 2 shadows onto effect 1
+        HSVValue hsv0 = fg.asHSV();
+        HSVValue hsv1 = bg.asHSV();
+        // if effect 1 is non black
+        if(hsv1.value>0.0) {
+            hsv0.hue = hsv0.hue + (hsv1.value*(hsv0.hue-hsv1.hue))/2.0;
+        }
+        bg = hsv0;
+        break;
+    }
+    case MixTypes::Mix_Layered:
+    {
+        HSVValue hsv1 = bg.asHSV();
+        if (hsv1.value <= effectMixThreshold) {
+            bg = fg;
+        }
+        break;
+    }
+    case MixTypes::Mix_Average:
+        // only average when both colors are non-black
+        if (bg == xlBLACK) {
+            bg = fg;
+        } else if (fg != xlBLACK) {
+            bg.Set((fg.Red() + bg.Red()) / 2, (fg.Green() + bg.Green()) / 2, (fg.Blue() + bg.Blue()) / 2, (fg.alpha + bg.alpha) / 2);
+        }
+        break;
+    case MixTypes::Mix_BottomTop:
+        bg = y < params.bufferHt/2 ? fg : bg;
+        break;
+    case MixTypes::Mix_LeftRight:
+        bg = x < params.bufferWi/2 ? fg : bg;
+        break;
+    case MixTypes::Mix_1_reveals_2:
+    {
+        HSVValue hsv0 = fg.asHSV();
+        bg = hsv0.value > effectMixThreshold ? fg : bg; // if effect 1 is non black
+        break;
+    }
+    case MixTypes::Mix_2_reveals_1:
+    {
+        HSVValue hsv1 = bg.asHSV();
+        bg = hsv1.value > effectMixThreshold ? bg : fg; // if effect 2 is non black
+        break;
+    }
+    case MixTypes::Mix_Highlight:
+    {
+        bool effect1HasColor = (fg.red > 0 || fg.green > 0 || fg.blue > 0);
+        bool effect2HasColor = (bg.red > 0 || bg.green > 0 || bg.blue > 0);
+        HSVValue hsv1 = bg.asHSV();
+
+        if (effect1HasColor && (effect2HasColor || hsv1.value > effectMixThreshold)) {
+            bg = fg;
+        }
+    } break;
+    case MixTypes::Mix_Highlight_Vibrant:
+    {
+        HSVValue hsv1 = bg.asHSV();
+        if (hsv1.value > effectMixThreshold) {
+
+            int r = fg.red + bg.red;
+            int g = fg.green + bg.green;
+            int b = fg.blue + bg.blue;
+
+            if (r > 255)
+                r = 255;
+            if (g > 255)
+                g = 255;
+            if (b > 255)
+                b = 255;
+
+            bg.Set(r, g, b);
+        }
+    } break;
+    case MixTypes::Mix_Additive:
+        {
+            int r = fg.red + bg.red;
+            int g = fg.green + bg.green;
+            int b = fg.blue + bg.blue;
+            if (r > 255) r = 255;
+            if (g > 255) g = 255;
+            if (b > 255) b = 255;
+            bg.Set(r, g, b);
+        }
+        break;
+    case MixTypes::Mix_Subtractive:
+        {
+            int r = bg.red - fg.red;
+            int g = bg.green - fg.green;
+            int b = bg.blue - fg.blue;
+            if (r < 0)
+                r = 0;
+            if (g < 0) g = 0;
+            if (b < 0) b = 0;
+            bg.Set(r, g, b);
+        }
+        break;
+
+    case MixTypes::Mix_Min:
+        {
+            float alpha = (float)fg.alpha / 255.0;
+            int r = std::min(fg.red, bg.red) * alpha;
+            int g = std::min(fg.green, bg.green) * alpha;
+            int b = std::min(fg.blue, bg.blue) * alpha;
+            bg.Set(r, g, b);
+        }
+        break;
+    case MixTypes::Mix_Max:
+        {
+            float alpha = (float)fg.alpha / 255.0;
+            int r = std::max(fg.red, bg.red) * alpha;
+            int g = std::max(fg.green, bg.green) * alpha;
+            int b = std::max(fg.blue, bg.blue) * alpha;
+            bg.Set(r, g, b);
+        }
+        break;
+    case MixTypes::Mix_AsBrightness:
+        {
+        float alpha = (float)fg.alpha / 255.0;
+        int r = fg.red * bg.red / 255 * alpha;
+        int g = fg.green * bg.green / 255 * alpha;
+        int b = fg.blue * bg.blue / 255 * alpha;
+        bg.Set(r, g, b);
+    }
+        break;
+    }
+}
+#pragma endregion
+
+#pragma region Block Helpers
+static inline uint8_t MaxChannel(const ColorPlanes& c, int i)
+{
+    return std::max(c.red[i], std::max(c.green[i], c.blue[i]));
+}
+
+static inline bool IsBlack(const ColorPlanes& c, int i)
+{
+    return (c.red[i] | c.green[i] | c.blue[i]) == 0;
+}
+
+// bg = take ? fg : bg for all four channels
+static inline void Select(bool take, const ColorPlanes& fg, ColorPlanes& bg, int i)
+{
+    bg.red[i] = take ? fg.red[i] : bg.red[i];
+    bg.green[i] = take ? fg.green[i] : bg.green[i];
+    bg.blue[i] = take ? fg.blue[i] : bg.blue[i];
+    bg.alpha[i] = take ? fg.alpha[i] : bg.alpha[i];
+}
+
+// same as xlColor::Set(0, 0, 0) which also makes the colour opaque
+static inline void Blacken(bool black, ColorPlanes& bg, int i)
+{
+    bg.red[i] = black ? 0 : bg.red[i];
+    bg.green[i] = black ? 0 : bg.green[i];
+    bg.blue[i] = black ? 0 : bg.blue[i];
+    bg.alpha[i] = black ? 255 : bg.alpha[i];
+}
+
+// the modes which set the result with xlColor::Set(r, g, b) always leave it opaque
+static inline void Opaque(ColorPlanes& bg, int count)
+{
+    memset(bg.alpha, 0xFF, count);
+}
+
+// b = min(a + b, 255)
+static void AddSaturate(const uint8_t* a, uint8_t* b, int count)
+{
+    int i = 0;
+#if defined(LAYER_BLEND_SSE2)
+    for (; i + 16 <= count; i += 16) {
+        __m128i va = _mm_load_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_load_si128((const __m128i*)(b + i));
+        _mm_store_si128((__m128i*)(b + i), _mm_adds_epu8(va, vb));
+    }
+#elif defined(LAYER_BLEND_NEON)
+    for (; i + 16 <= count; i += 16) {
+        vst1q_u8(b + i, vqaddq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        b[i] = std::min(a[i] + b[i], 255);
+    }
+}
+
+// b = max(b - a, 0)
+static void SubtractSaturate(const uint8_t* a, uint8_t* b, int count)
+{
+    int i = 0;
+#if defined(LAYER_BLEND_SSE2)
+    for (; i + 16 <= count; i += 16) {
+        __m128i va = _mm_load_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_load_si128((const __m128i*)(b + i));
+        _mm_store_si128((__m128i*)(b + i), _mm_subs_epu8(vb, va));
+    }
+#elif defined(LAYER_BLEND_NEON)
+    for (; i + 16 <= count; i += 16) {
+        vst1q_u8(b + i, vqsubq_u8(vld1q_u8(b + i), vld1q_u8(a + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        b[i] = std::max(b[i] - a[i], 0);
+    }
+}
+#pragma endregion
+
+#pragma region Block Functions
+static void BlendNormal(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    const float effectMixThreshold = params.effectMixThreshold;
+    for (int i = 0; i < count; ++i) {
+        uint8_t fa = fg.alpha[i] * params.fadeFactor * (1.0 - effectMixThreshold);
+        // alpha 0 and 255 fall out of the blend exactly so they need no special handling
+        float a = fa;
+        a /= 255;
+        bg.red[i] = (uint8_t)(fg.red[i] * a + bg.red[i] * (1.0f - a));
+        bg.green[i] = (uint8_t)(fg.green[i] * a + bg.green[i] * (1.0f - a));
+        bg.blue[i] = (uint8_t)(fg.blue[i] * a + bg.blue[i] * (1.0f - a));
+        bg.alpha[i] = fa == 255 ? 255 : bg.alpha[i];
+    }
+}
+
+static void BlendEffect(const ColorPlanes& fg, ColorPlanes& bg, int count, double fgf, double bgf)
+{
+    for (int i = 0; i < count; ++i) {
+        // the sum deliberately wraps the same way xlColor::Set does
+        bg.red[i] = (uint8_t)((uint8_t)(fg.red[i] * fgf) + (uint8_t)(bg.red[i] * bgf));
+        bg.green[i] = (uint8_t)((uint8_t)(fg.green[i] * fgf) + (uint8_t)(bg.green[i] * bgf));
+        bg.blue[i] = (uint8_t)((uint8_t)(fg.blue[i] * fgf) + (uint8_t)(bg.blue[i] * bgf));
+    }
+    Opaque(bg, count);
+}
+
+static void BlendEffect1(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    BlendEffect(fg, bg, count, params.emt, params.emtNot);
+}
+
+static void BlendEffect2(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    BlendEffect(fg, bg, count, params.emtNot, params.emt);
+}
+
+static void BlendMask1(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        Blacken(MaxChannel(fg, i) > params.valueThreshold, bg, i);
+    }
+}
+
+static void BlendMask2(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        bool show = MaxChannel(bg, i) <= params.valueThreshold;
+        Blacken(!show, bg, i);
+        Select(show, fg, bg, i);
+    }
+}
+
+static void BlendTrueUnmask1(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        Blacken(MaxChannel(fg, i) <= params.valueThreshold, bg, i);
+    }
+}
+
+static void BlendTrueUnmask2(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        bool show = MaxChannel(bg, i) > params.valueThreshold;
+        Blacken(!show, bg, i);
+        Select(show, fg, bg, i);
+    }
+}
+
+static void BlendLayered(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        Select(MaxChannel(bg, i) <= params.valueThreshold, fg, bg, i);
+    }
+}
+
+static void Blend1Reveals2(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        Select(MaxChannel(fg, i) > params.valueThreshold, fg, bg, i);
+    }
+}
+
+static void Blend2Reveals1(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        Select(MaxChannel(bg, i) <= params.valueThreshold, fg, bg, i);
+    }
+}
+
+static void BlendHighlight(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        bool effect1HasColor = !IsBlack(fg, i);
+        bool effect2HasColor = !IsBlack(bg, i);
+        Select(effect1HasColor && (effect2HasColor || MaxChannel(bg, i) > params.valueThreshold), fg, bg, i);
+    }
+}
+
+static void BlendHighlightVibrant(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        bool add = MaxChannel(bg, i) > params.valueThreshold;
+        bg.red[i] = add ? (uint8_t)std::min(fg.red[i] + bg.red[i], 255) : bg.red[i];
+        bg.green[i] = add ? (uint8_t)std::min(fg.green[i] + bg.green[i], 255) : bg.green[i];
+        bg.blue[i] = add ? (uint8_t)std::min(fg.blue[i] + bg.blue[i], 255) : bg.blue[i];
+        bg.alpha[i] = add ? 255 : bg.alpha[i];
+    }
+}
+
+static void BlendAverage(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        // only average when both colors are non-black
+        bool bgBlack = IsBlack(bg, i);
+        bool average = !bgBlack && !IsBlack(fg, i);
+        uint8_t r = average ? (uint8_t)((fg.red[i] + bg.red[i]) / 2) : bg.red[i];
+        uint8_t g = average ? (uint8_t)((fg.green[i] + bg.green[i]) / 2) : bg.green[i];
+        uint8_t b = average ? (uint8_t)((fg.blue[i] + bg.blue[i]) / 2) : bg.blue[i];
+        uint8_t a = average ? (uint8_t)((fg.alpha[i] + bg.alpha[i]) / 2) : bg.alpha[i];
+        bg.red[i] = bgBlack ? fg.red[i] : r;
+        bg.green[i] = bgBlack ? fg.green[i] : g;
+        bg.blue[i] = bgBlack ? fg.blue[i] : b;
+        bg.alpha[i] = bgBlack ? fg.alpha[i] : a;
+    }
+}
+
+static void BlendAdditive(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    AddSaturate(fg.red, bg.red, count);
+    AddSaturate(fg.green, bg.green, count);
+    AddSaturate(fg.blue, bg.blue, count);
+    Opaque(bg, count);
+}
+
+static void BlendSubtractive(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    SubtractSaturate(fg.red, bg.red, count);
+    SubtractSaturate(fg.green, bg.green, count);
+    SubtractSaturate(fg.blue, bg.blue, count);
+    Opaque(bg, count);
+}
+
+static void BlendMin(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        float alpha = (float)fg.alpha[i] / 255.0;
+        bg.red[i] = (uint8_t)(int)(std::min(fg.red[i], bg.red[i]) * alpha);
+        bg.green[i] = (uint8_t)(int)(std::min(fg.green[i], bg.green[i]) * alpha);
+        bg.blue[i] = (uint8_t)(int)(std::min(fg.blue[i], bg.blue[i]) * alpha);
+    }
+    Opaque(bg, count);
+}
+
+static void BlendMax(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        float alpha = (float)fg.alpha[i] / 255.0;
+        bg.red[i] = (uint8_t)(int)(std::max(fg.red[i], bg.red[i]) * alpha);
+        bg.green[i] = (uint8_t)(int)(std::max(fg.green[i], bg.green[i]) * alpha);
+        bg.blue[i] = (uint8_t)(int)(std::max(fg.blue[i], bg.blue[i]) * alpha);
+    }
+    Opaque(bg, count);
+}
+
+static void BlendAsBrightness(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        float alpha = (float)fg.alpha[i] / 255.0;
+        bg.red[i] = (uint8_t)(int)(fg.red[i] * bg.red[i] / 255 * alpha);
+        bg.green[i] = (uint8_t)(int)(fg.green[i] * bg.green[i] / 255 * alpha);
+        bg.blue[i] = (uint8_t)(int)(fg.blue[i] * bg.blue[i] / 255 * alpha);
+    }
+    Opaque(bg, count);
+}
+
+LAYER_BLEND_FN GetLayerBlendFunction(MixTypes mixType)
+{
+    switch (mixType) {
+    case MixTypes::Mix_Normal: return BlendNormal;
+    case MixTypes::Mix_Effect1: return BlendEffect1;
+    case MixTypes::Mix_Effect2: return BlendEffect2;
+    case MixTypes::Mix_Mask1: return BlendMask1;
+    case MixTypes::Mix_Mask2: return BlendMask2;
+    case MixTypes::Mix_TrueUnmask1: return BlendTrueUnmask1;
+    case MixTypes::Mix_TrueUnmask2: return BlendTrueUnmask2;
+    case MixTypes::Mix_1_reveals_2: return Blend1Reveals2;
+    case MixTypes::Mix_2_reveals_1: return Blend2Reveals1;
+    case MixTypes::Mix_Layered: return BlendLayered;
+    case MixTypes::Mix_Average: return BlendAverage;
+    case MixTypes::Mix_Highlight: return BlendHighlight;
+    case MixTypes::Mix_Highlight_Vibrant: return BlendHighlightVibrant;
+    case MixTypes::Mix_Additive: return BlendAdditive;
+    case MixTypes::Mix_Subtractive: return BlendSubtractive;
+    case MixTypes::Mix_Min: return BlendMin;
+    case MixTypes::Mix_Max: return BlendMax;
+    case MixTypes::Mix_AsBrightness: return BlendAsBrightness;
+    default:
+        // these need the node position or a full HSV round trip
+        return nullptr;
+    }
+}
+#pragma endregion
@@ -0,0 +1,96 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+
+#include "Color.h"
+
+ /**
+ * \brief enumeration of the different techniques used in layering effects
+ */
+
+enum class MixTypes
+{
+    Mix_Normal,  /** Layered with Alpha channel considered **/
+    Mix_Effect1, /**<  Effect 1 only */
+    Mix_Effect2, /**<  Effect 2 only */
+    Mix_Mask1,   /**<  Effect 2 color shows where Effect 1 is black */
+    Mix_Mask2,   /**<  Effect 1 color shows where Effect 2 is black */
+    Mix_Unmask1, /**<  Effect 2 color shows where Effect 1 is not black but with no fade ... black becomes white*/
+    Mix_Unmask2, /**<  Effect 1 color shows where Effect 2 is not black but with no fade ... black becomes white*/
+    Mix_TrueUnmask1, /**<  Effect 2 color shows where Effect 1 is not black */
+    Mix_TrueUnmask2, /**<  Effect 1 color shows where Effect 2 is black */
+    Mix_1_reveals_2,  /**<  Effect 2 color only shows if Effect 1 is black  1 reveals 2 */
+    Mix_2_reveals_1,  /**<  Effect 1 color only shows if Effect 2 is black */
+    Mix_Layered, /**<  Effect 1 is back ground and shows only when effect 2 is black */
+    Mix_Average, /**<  Average color value between effects per pixel */
+    Mix_BottomTop,
+    Mix_LeftRight,
+    Mix_Shadow_1on2, /**< Take value and saturation from Effect 1 and put them onto effect 2, leave hue alone on effect 2 */
+    Mix_Shadow_2on1, /**< Take value and saturation from Effect 3 and put them onto effect 2, leave hue alone on effect 1 */
+    Mix_Additive,
+    Mix_Subtractive,
+    Mix_AsBrightness,
+    Mix_Max,
+    Mix_Min,
+    Mix_Highlight,
+    Mix_Highlight_Vibrant
+};
+
+// number of nodes mixed at a time by the block blend functions
+#define LAYER_BLEND_BLOCK 256
+
+// The per frame settings of a layer needed to mix it onto the layers below
+struct LayerBlendParams
+{
+    MixTypes mixType = MixTypes::Mix_Effect1;
+    double fadeFactor = 1.0;
+    float effectMixThreshold = 0.0f;
+    bool effectMixVaries = false;
+    int bufferWi = 0;
+    int bufferHt = 0;
+
+    // derived by Prepare so the block functions dont recalculate them for every node
+    double emt = 0.0;
+    double emtNot = 0.0;
+    int valueThreshold = -1; // largest max(r,g,b) whose HSV value is <= effectMixThreshold
+
+    void Prepare();
+};
+
+// A block of node colours stored one channel per array so the block blend functions work on contiguous bytes
+struct ColorPlanes
+{
+    alignas(16) uint8_t red[LAYER_BLEND_BLOCK];
+    alignas(16) uint8_t green[LAYER_BLEND_BLOCK];
+    alignas(16) uint8_t blue[LAYER_BLEND_BLOCK];
+    alignas(16) uint8_t alpha[LAYER_BLEND_BLOCK];
+
+    void Set(int i, const xlColor& c) {
+        red[i] = c.red;
+        green[i] = c.green;
+        blue[i] = c.blue;
+        alpha[i] = c.alpha;
+    }
+    xlColor Get(int i) const {
+        return xlColor(red[i], green[i], blue[i], alpha[i]);
+    }
+};
+
+// mixes the fg block onto the bg block ... bg ends up holding the result
+typedef void (*LAYER_BLEND_FN)(const LayerBlendParams& params, const ColorPlanes& fg, ColorPlanes& bg, int count);
+
+// returns nullptr for the mix types which need the node position or a full HSV conversion. Those must go through MixPixel.
+LAYER_BLEND_FN GetLayerBlendFunction(MixTypes mixType);
+
+// mixes a single pixel. This is the reference behaviour the block functions must reproduce exactly.
+void MixPixel(const LayerBlendParams& params, int x, int y, xlColor& fg, xlColor& bg);
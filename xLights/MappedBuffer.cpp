@@ -0,0 +1,127 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "MappedBuffer.h"
+
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool MappedBuffer::Allocate(size_t size, size_t mapThreshold)
+{
+    Free();
+    if (size == 0) return true;
+
+    if (size >= mapThreshold && Map(size)) {
+        _mapped = true;
+    } else {
+        _data = (uint8_t*)calloc(size, 1);
+        if (_data == nullptr) return false;
+    }
+    _size = size;
+    return true;
+}
+
+#ifdef _WIN32
+bool MappedBuffer::Map(size_t size)
+{
+    char path[MAX_PATH];
+    char file[MAX_PATH];
+    if (GetTempPathA(sizeof(path), path) == 0 || GetTempFileNameA(path, "xla", 0, file) == 0) return false;
+
+    HANDLE fh = CreateFileA(file, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+
+    // the mapping extends the file to size and it reads back as zeros
+    HANDLE mh = CreateFileMapping(fh, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xFFFFFFFF), nullptr);
+    if (mh == nullptr) {
+        CloseHandle(fh);
+        return false;
+    }
+    void* data = MapViewOfFile(mh, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data == nullptr) {
+        CloseHandle(mh);
+        CloseHandle(fh);
+        return false;
+    }
+    _fileHandle = fh;
+    _mapHandle = mh;
+    _data = (uint8_t*)data;
+    return true;
+}
+
+void MappedBuffer::Free()
+{
+    if (_mapped) {
+        UnmapViewOfFile(_data);
+        CloseHandle((HANDLE)_mapHandle);
+        CloseHandle((HANDLE)_fileHandle);
+        _mapHandle = nullptr;
+        _fileHandle = nullptr;
+    } else if (_data != nullptr) {
+        free(_data);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+#else
+bool MappedBuffer::Map(size_t size)
+{
+    const char* tmp = getenv("TMPDIR");
+    std::string file = std::string(tmp != nullptr && *tmp != 0 ? tmp : "/tmp") + "/xlightsXXXXXX";
+    int fd = mkstemp(&file[0]);
+    if (fd < 0) return false;
+
+    // nobody else needs to see it and this way it goes away even if we crash
+    unlink(file.c_str());
+
+    // the space has to be reserved up front ... a sparse file on a full disk (or tmpfs) would SIGBUS when we first
+    // touch a page rather than letting us fall back to the heap here
+#ifdef __APPLE__
+    fstore_t store = { F_ALLOCATEALL, F_PEOFPOSMODE, 0, (off_t)size, 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1 || ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return false;
+    }
+#else
+    if (posix_fallocate(fd, 0, (off_t)size) != 0) {
+        close(fd);
+        return false;
+    }
+#endif
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    _data = (uint8_t*)data;
+    return true;
+}
+
+void MappedBuffer::Free()
+{
+    if (_mapped) {
+        munmap(_data, _size);
+    } else if (_data != nullptr) {
+        free(_data);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+#endif
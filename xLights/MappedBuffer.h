@@ -0,0 +1,50 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+// A zero filled block of memory which once it is big enough is backed by a temporary file mapped into memory.
+//
+// Pages of a mapped buffer can be written out and dropped by the OS when memory is short rather than having to
+// stay resident like a heap allocation, so long audio tracks dont need their whole decoded length in RAM. The
+// file is deleted when the buffer is freed (or straight away where the OS allows it).
+class MappedBuffer
+{
+    uint8_t* _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mapHandle = nullptr;
+#endif
+
+    bool Map(size_t size);
+
+public:
+    static const size_t DEFAULT_MAP_THRESHOLD = 64 * 1024 * 1024;
+
+    MappedBuffer() {}
+    ~MappedBuffer() { Free(); }
+    MappedBuffer(const MappedBuffer&) = delete;
+    MappedBuffer& operator=(const MappedBuffer&) = delete;
+
+    // anything of at least mapThreshold bytes is mapped, falling back to the heap if that fails
+    bool Allocate(size_t size, size_t mapThreshold = DEFAULT_MAP_THRESHOLD);
+    void Free();
+
+    uint8_t* Data() const { return _data; }
+    template<class T>
+    T* As() const { return (T*)_data; }
+    size_t Size() const { return _size; }
+    bool IsMapped() const { return _mapped; }
+};
@@ -13,6 +13,7 @@
 #include "Parallel.h"
 #include <thread>
 #include <algorithm>
+#include <memory>
 
 #include "JobPool.h"
 
@@ -51,49 +52,200 @@ int ParallelJobPool::calcSteps(int minStep, int total) {
 ParallelJobPool ParallelJobPool::POOL("parallel_tasks");
 
 
-class ParallelJob : public Job {
-    int max;
-    std::function<void(int)>& func;
-    std::atomic_int &doneCount;
-    std::atomic_int &iteration;
-    const int calcSteps;
-    const int blockSize;
+// The block of iterations owned by one participant.  begin and end are packed into a single
+// atomic so the owner taking blocks off the front and thieves splitting off the back can race
+// without a lock.  Indexes only ever move towards each other so there is no ABA problem.
+class StealableRange {
+    std::atomic<uint64_t> range;
+
+    static uint64_t Pack(int begin, int end) { return ((uint64_t)(uint32_t)begin << 32) | (uint64_t)(uint32_t)end; }
+    static int Begin(uint64_t r) { return (int)(uint32_t)(r >> 32); }
+    static int End(uint64_t r) { return (int)(uint32_t)r; }
 public:
-    ParallelJob(int m, std::function<void(int)>& f,
-                std::atomic_int &dc,
-                std::atomic_int &it,
-                int cs,
-                int bs)
-        : max(m), func(f), iteration(it), doneCount(dc), calcSteps(cs), blockSize(bs) {}
-    virtual ~ParallelJob() {};
-    virtual void Process() override {
-        try {
-            int x;
-            if (blockSize > 1) {
-                while ((x = iteration.fetch_add(blockSize, std::memory_order_relaxed)) < max) {
-                    int newM = std::min(x + blockSize, max);
-                    while (x < newM) {
-                        func(x);
-                        x++;
-                    }
-                }
-            } else {
-                while ((x = iteration.fetch_add(1, std::memory_order_relaxed)) < max) {
-                    func(x);
-                }
+    StealableRange() : range(0) {}
+
+    void Set(int begin, int end) {
+        range.store(Pack(begin, end), std::memory_order_release);
+    }
+    int Remaining() const {
+        uint64_t r = range.load(std::memory_order_acquire);
+        return End(r) - Begin(r);
+    }
+    // owner takes the next block from the front
+    bool Take(int blockSize, int &begin, int &end) {
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (true) {
+            int b = Begin(r);
+            int e = End(r);
+            if (b >= e) {
+                return false;
+            }
+            int ne = std::min(b + blockSize, e);
+            if (range.compare_exchange_weak(r, Pack(ne, e), std::memory_order_acq_rel)) {
+                begin = b;
+                end = ne;
+                return true;
+            }
+        }
+    }
+    // thief takes the back half
+    bool Steal(int blockSize, int &begin, int &end) {
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (true) {
+            int b = Begin(r);
+            int e = End(r);
+            int left = e - b;
+            if (left <= 0) {
+                return false;
+            }
+            int take = std::max(left / 2, std::min(blockSize, left));
+            int nb = e - take;
+            if (range.compare_exchange_weak(r, Pack(b, nb), std::memory_order_acq_rel)) {
+                begin = nb;
+                end = e;
+                return true;
             }
+        }
+    }
+};
+
+// Shared by every thread working on one RunRanges call.  It is reference counted as jobs
+// that only get picked up after all the work is done may still be sitting in the pool queue.
+class ParallelRangeTask {
+    const std::function<void(int, int)> &func;
+    std::unique_ptr<StealableRange[]> ranges;
+    const int participants;
+    const int blockSize;
+    std::atomic_int nextSlot;
+
+    std::mutex lock;
+    std::condition_variable signal;
+    int active = 0;
+    bool closed = false;
+
+    void Execute(int begin, int end) {
+        try {
+            func(begin, end);
         } catch (...) {
             //nothing
         }
-        int newDoneCount = ++doneCount;
-        if (newDoneCount >= calcSteps) {
-            ParallelJobPool::POOL.poolSignal.notify_all();
+    }
+    bool StealInto(int slot) {
+        // take from whoever has the most left
+        while (true) {
+            int victim = -1;
+            int most = 0;
+            for (int x = 1; x < participants; x++) {
+                int v = (slot + x) % participants;
+                int r = ranges[v].Remaining();
+                if (r > most) {
+                    most = r;
+                    victim = v;
+                }
+            }
+            if (victim == -1) {
+                return false;
+            }
+            int begin, end;
+            if (ranges[victim].Steal(blockSize, begin, end)) {
+                ranges[slot].Set(begin, end);
+                return true;
+            }
+        }
+    }
+public:
+    ParallelRangeTask(int start, int max, const std::function<void(int, int)> &f, int p, int bs)
+        : func(f), ranges(new StealableRange[p]), participants(p), blockSize(bs), nextSlot(1) {
+        int64_t total = max - start;
+        for (int x = 0; x < participants; x++) {
+            ranges[x].Set(start + (int)(total * x / participants), start + (int)(total * (x + 1) / participants));
+        }
+    }
+
+    // returns false if the work is already finished and the caller must not touch func
+    bool Enter() {
+        std::unique_lock<std::mutex> l(lock);
+        if (closed) {
+            return false;
+        }
+        ++active;
+        return true;
+    }
+    void Leave() {
+        std::unique_lock<std::mutex> l(lock);
+        if (--active == 0 && closed) {
+            signal.notify_all();
+        }
+    }
+    // stops any late starters and blocks until everyone currently working is done
+    void Close() {
+        std::unique_lock<std::mutex> l(lock);
+        closed = true;
+        while (active > 0) {
+            signal.wait(l);
+        }
+    }
+
+    int NextSlot() {
+        return nextSlot.fetch_add(1) % participants;
+    }
+    void Run(int slot) {
+        int begin, end;
+        while (true) {
+            if (ranges[slot].Take(blockSize, begin, end)) {
+                Execute(begin, end);
+            } else if (!StealInto(slot)) {
+                return;
+            }
+        }
+    }
+};
+
+class ParallelRangeJob : public Job {
+    std::shared_ptr<ParallelRangeTask> task;
+public:
+    ParallelRangeJob(std::shared_ptr<ParallelRangeTask> &t) : task(t) {}
+    virtual ~ParallelRangeJob() {};
+    virtual void Process() override {
+        if (task->Enter()) {
+            task->Run(task->NextSlot());
+            task->Leave();
         }
     };
     virtual bool DeleteWhenComplete() override { return true; };
     virtual bool SetThreadName() override { return false; }
 };
 
+void ParallelJobPool::RunRanges(int start, int max, const std::function<void(int, int)>& f, int minStep) {
+    int steps = calcSteps(minStep, max - start);
+    if (steps <= 1) {
+        if (max > start) {
+            f(start, max);
+        }
+        return;
+    }
+
+    // do about 5% at a time, reduces contention on the ranges yet keeps unit of
+    // work small enough to allow work stealing for faster cores/threads
+    int blockSize = (max - start) / (steps * 20);
+    if (blockSize < 1) blockSize = 1;
+
+    auto task = std::make_shared<ParallelRangeTask>(start, max, f, steps, blockSize);
+    for (int x = 0; x < steps - 1; x++) {
+        PushJob(new ParallelRangeJob(task));
+    }
+    task->Enter();
+    task->Run(0);
+    task->Leave();
+    // everything is done or being done by threads that have already started, jobs that
+    // have not started yet will find the task closed and just exit
+    task->Close();
+}
+
+void parallel_for_range(int min, int max, std::function<void(int, int)>&& func, int minStep, ParallelJobPool *pool) {
+    pool->RunRanges(min, max, func, minStep);
+}
+
 void parallel_for(int min, int max, std::function<void(int)>&& func, int minStep, ParallelJobPool *pool) {
     int calcSteps = pool->calcSteps(minStep, max - min);
     if (calcSteps <= 1) {
@@ -101,22 +253,10 @@ void parallel_for(int min, int max, std::function<void(int)>&& func, int minStep
             func(x);
         }
     } else {
-        std::function<void(int)> f(func);
-        std::atomic_int doneCount = 0;
-        std::atomic_int iteration(min);
-        
-        // do about 5% at a time, reduces contention on the atomic_int yet keeps unit of
-        // work small enough to allow work stealing for faster cores/threads
-        int blockSize = (max - min) / (calcSteps * 20);
-        if (blockSize < 1) blockSize = 1;
-        for (int x = 0; x < calcSteps-1; x++) {
-            pool->PushJob(new ParallelJob(max, f, doneCount, iteration, calcSteps, blockSize));
-        }
-        ParallelJob(max, f, doneCount, iteration, calcSteps, blockSize).Process();
-        std::unique_lock<std::mutex> lock(pool->poolLock);
-        while (doneCount < calcSteps) {
-            pool->poolSignal.wait_for(lock, std::chrono::nanoseconds(1000000));
-        }
+        pool->RunRanges(min, max, [&func](int begin, int end) {
+            for (int x = begin; x < end; x++) {
+                func(x);
+            }
+        }, minStep);
     }
 }
-
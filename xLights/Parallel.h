@@ -14,6 +14,7 @@
 #include <list>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "JobPool.h"
 
@@ -26,9 +27,14 @@ public:
     
     int calcSteps(int minStep, int size);
     static void SetPJPMaxThreadCount(int maxThreads) { POOL.SetMaxThreadCount(maxThreads); }
-    
-    std::mutex poolLock;
-    std::condition_variable poolSignal;
+
+    /**
+     * Splits [start, max) into one contiguous range per participating thread and calls f(begin, end) with
+     * blocks of the range.  Threads that run out of work steal half of the remaining work of the busiest
+     * thread so a slow block doesnt hold everyone up.  The calling thread takes part and then blocks
+     * (no spinning) until every block has been processed.
+     */
+    void RunRanges(int start, int max, const std::function<void(int, int)>& f, int minStep);
 };
 
 
@@ -41,6 +47,39 @@ public:
  */
 void parallel_for(int start, int max, std::function<void(int)>&& f, int minStep = 1, ParallelJobPool *pool = &ParallelJobPool::POOL);
 
+/**
+ * Same as above but f is given blocks of iterations.  Use this for very cheap loop bodies (per node pixel
+ * copies and the like) where the cost of a std::function call per iteration would swamp the work:
+ * parallel_for_range(start, max, [&] (int begin, int end) { for (int x = begin; x < end; ++x) {} });
+ */
+void parallel_for_range(int start, int max, std::function<void(int, int)>&& f, int minStep = 1, ParallelJobPool *pool = &ParallelJobPool::POOL);
+
+
+/**
+ * Traditional for loop:
+ * std::vector<T> v;
+ * for(int idx = 0; idx < v.size(); ++idx) { T &t = v[idx]; ... use t ...}
+ *
+ * would convert to:
+ * std::function<void(T&, int)> f = [&](T &t, int idx) { ... use t and idx...}
+ * parallel_for(v, f);
+ */
+template <typename T>
+void parallel_for(std::vector<T> &v, std::function<void(T&, int)>& f, int minStep = 1) {
+    int size = v.size();
+    if (ParallelJobPool::POOL.calcSteps(minStep, size) <= 1) {
+        for (int idx = 0; idx < size; idx++) {
+            f(v[idx], idx);
+        }
+    } else {
+        ParallelJobPool::POOL.RunRanges(0, size, [&v, &f](int begin, int end) {
+            for (int idx = begin; idx < end; idx++) {
+                f(v[idx], idx);
+            }
+        }, minStep);
+    }
+}
+
 
 /**
  * Traditional for loop:
@@ -55,44 +94,6 @@ void parallel_for(int start, int max, std::function<void(int)>&& f, int minStep
  */
 template <typename T>
 void parallel_for(std::list<T> &list, std::function<void(T&, int)>& f, int minStep = 1) {
-    class ParallelListJob : public Job {
-        std::atomic_int &doneCount;
-        std::function<void(T&, int)>& func;
-        std::mutex &lock;
-        std::atomic_int &index;
-        typename std::list<T>::iterator &iterator;
-        const int max;
-    public:
-        ParallelListJob(std::atomic_int &dc,
-                        std::function<void(T&, int)>& f,
-                        typename std::list<T>::iterator &it,
-                        std::mutex &l,
-                        std::atomic_int &idx,
-                        int m)
-            : Job(), doneCount(dc), func(f), iterator(it), lock(l), index(idx), max(m) {}
-        void Process() {
-            try {
-                while (true) {
-                    lock.lock();
-                    int idx = index.fetch_add(1);
-                    if (idx < max) {
-                        T &t = *iterator;
-                        ++iterator;
-                        lock.unlock();
-                        func(t, idx);
-                    } else {
-                        lock.unlock();
-                        doneCount++;
-                        return;
-                    }
-                }
-            } catch (...) {
-                //nothing
-                doneCount++;
-            }
-        }
-    };
-    
     int size = list.size();
     int calcSteps = ParallelJobPool::POOL.calcSteps(minStep, size);
     if (calcSteps == 1) {
@@ -102,18 +103,17 @@ void parallel_for(std::list<T> &list, std::function<void(T&, int)>& f, int minSt
             idx++;
         }
     } else {
-        std::atomic_int doneCount(0);
-        std::mutex lock;
-        std::atomic_int idx(0);
-        typename std::list<T>::iterator it = list.begin();
-        
-        for (int x = 0; x < calcSteps-1; x++) {
-            ParallelJobPool::POOL.PushJob(new ParallelListJob(doneCount, f, it, lock, idx, size));
-        }
-        ParallelListJob(doneCount, f, it, lock, idx, size).Process();
-        while (doneCount < calcSteps) {
-            std::this_thread::yield();
+        // a list cannot be split into ranges so grab the element addresses up front, one walk of the
+        // list is far cheaper than taking a lock for every element
+        std::vector<T*> items;
+        items.reserve(size);
+        for (auto &a : list) {
+            items.push_back(&a);
         }
+        ParallelJobPool::POOL.RunRanges(0, size, [&items, &f](int begin, int end) {
+            for (int idx = begin; idx < end; idx++) {
+                f(*items[idx], idx);
+            }
+        }, minStep);
     }
 }
-
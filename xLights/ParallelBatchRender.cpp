@@ -0,0 +1,176 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "ParallelBatchRender.h"
+
+#include <wx/app.h>
+#include <wx/filename.h>
+#include <wx/process.h>
+#include <wx/stdpaths.h>
+#include <wx/textfile.h>
+#include <wx/utils.h>
+
+#include <algorithm>
+
+#include <log4cpp/Category.hh>
+
+#include "ExternalHooks.h"
+
+class ParallelBatchRenderProcess : public wxProcess
+{
+    ParallelBatchRender* _batch;
+
+public:
+    ParallelBatchRenderProcess(ParallelBatchRender* batch, int worker) :
+        wxProcess(), _batch(batch), Worker(worker) {}
+
+    virtual void OnTerminate(int pid, int status) override
+    {
+        _batch->ProcessDone(this, status);
+        delete this;
+    }
+
+    const int Worker;
+    long Pid = 0;
+};
+
+ParallelBatchRender::ParallelBatchRender(const wxString& showDir, const wxString& mediaDir, const wxArrayString& sequences, int jobs, int threads, const wxString& report) :
+    _showDir(showDir), _mediaDir(mediaDir), _report(report), _threads(threads)
+{
+    _work = Partition(sequences, jobs);
+}
+
+std::vector<wxArrayString> ParallelBatchRender::Partition(const wxArrayString& sequences, int jobs)
+{
+    std::vector<std::pair<wxULongLong, wxString>> bySize;
+    for (const auto& it : sequences) {
+        wxULongLong size = FileExists(it) ? wxFileName::GetSize(it) : wxULongLong(0);
+        if (size == wxInvalidSize) size = 0;
+        bySize.push_back({ size, it });
+    }
+    std::stable_sort(bySize.begin(), bySize.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+
+    jobs = std::max(1, std::min(jobs, (int)sequences.size()));
+    std::vector<wxArrayString> res(jobs);
+    std::vector<wxULongLong> load(jobs, 0);
+
+    // the sequence file size is a reasonable guess at how long it will take to render so give the next biggest
+    // sequence to the least loaded process
+    for (const auto& it : bySize) {
+        int least = (int)(std::min_element(load.begin(), load.end()) - load.begin());
+        res[least].push_back(it.second);
+        load[least] += it.first;
+    }
+    return res;
+}
+
+wxString ParallelBatchRender::GetWorkerReport(int worker) const
+{
+    if (_report.IsEmpty()) return wxEmptyString;
+    return _report + wxString::Format(".%d", worker);
+}
+
+bool ParallelBatchRender::Start()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _sw.Start();
+
+    wxString exe = wxStandardPaths::Get().GetExecutablePath();
+    int threadsPerProcess = _threads > 0 ? std::max(1, _threads / (int)_work.size()) : 0;
+
+    logger_base.info("Parallel batch render of %d processes with %d threads each.", (int)_work.size(), threadsPerProcess);
+    printf("Rendering with %d processes\n", (int)_work.size());
+
+    for (int i = 0; i < (int)_work.size(); i++) {
+        wxString cmd = "\"" + exe + "\" -r";
+        if (!_showDir.IsEmpty()) cmd += " -s \"" + _showDir + "\"";
+        if (!_mediaDir.IsEmpty()) cmd += " -m \"" + _mediaDir + "\"";
+        if (threadsPerProcess > 0) cmd += wxString::Format(" -t %d", threadsPerProcess);
+        if (!_report.IsEmpty()) {
+            wxRemoveFile(GetWorkerReport(i));
+            cmd += " -rp \"" + GetWorkerReport(i) + "\"";
+        }
+        for (const auto& it : _work[i]) {
+            cmd += " \"" + it + "\"";
+        }
+
+        auto process = new ParallelBatchRenderProcess(this, i);
+        process->Pid = wxExecute(cmd, wxEXEC_ASYNC, process);
+        if (process->Pid <= 0) {
+            logger_base.error("Unable to start render process: %s", (const char*)cmd.c_str());
+            printf("Unable to start render process for %d sequences\n", (int)_work[i].size());
+            _failed += (int)_work[i].size();
+            delete process;
+        } else {
+            logger_base.info("Started render process %ld: %s", process->Pid, (const char*)cmd.c_str());
+            _running.push_back(process);
+        }
+    }
+    return !_running.empty();
+}
+
+void ParallelBatchRender::ProcessDone(ParallelBatchRenderProcess* process, int status)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    logger_base.info("Render process %ld finished with status %d.", process->Pid, status);
+    printf("Render process %d of %d done\n", process->Worker + 1, (int)_work.size());
+    if (status != 0) {
+        _failed += (int)_work[process->Worker].size();
+    }
+    _running.remove(process);
+
+    if (_running.empty()) {
+        CombineReports();
+        logger_base.info("Parallel batch render done in %ldms.", _sw.Time());
+        printf("Done All Files\n");
+        wxTheApp->ExitMainLoop();
+    }
+}
+
+void ParallelBatchRender::CombineReports()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_report.IsEmpty()) return;
+
+    wxTextFile out(_report);
+    if (FileExists(_report)) {
+        out.Open();
+        out.Clear();
+    } else {
+        out.Create();
+    }
+
+    bool header = false;
+    for (int i = 0; i < (int)_work.size(); i++) {
+        wxTextFile in(GetWorkerReport(i));
+        if (!FileExists(GetWorkerReport(i)) || !in.Open()) {
+            logger_base.warn("Render process %d did not write a timing report.", i);
+            continue;
+        }
+        for (size_t l = 0; l < in.GetLineCount(); l++) {
+            // each report starts with the same header
+            if (l == 0) {
+                if (header) continue;
+                header = true;
+            }
+            out.AddLine(in.GetLine(l));
+        }
+        in.Close();
+        wxRemoveFile(GetWorkerReport(i));
+    }
+    out.AddLine(wxString::Format("All Sequences,,,,,%.3f,%d processes %d failed", (double)_sw.Time() / 1000.0, (int)_work.size(), _failed));
+    out.Write();
+    out.Close();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+#include <wx/stopwatch.h>
+
+#include <list>
+#include <vector>
+
+class ParallelBatchRenderProcess;
+
+// Command line batch render of many sequences at once without a main window.
+//
+// The sequences are split across a number of xLights render (-r) processes. Each of these loads the show folder
+// once and renders its share of the sequences one after the other so the model and output setup is shared by all
+// the sequences it renders. The biggest sequences are handed out first to keep the processes finishing at about
+// the same time. The thread budget is divided between the processes and each writes its own timing report which
+// are combined into one report once they are all done.
+class ParallelBatchRender
+{
+    wxString _showDir;
+    wxString _mediaDir;
+    wxString _report;
+    int _threads = 0;
+    std::vector<wxArrayString> _work;
+    std::list<ParallelBatchRenderProcess*> _running;
+    wxStopWatch _sw;
+    int _failed = 0;
+
+    wxString GetWorkerReport(int worker) const;
+    void CombineReports();
+
+public:
+    ParallelBatchRender(const wxString& showDir, const wxString& mediaDir, const wxArrayString& sequences, int jobs, int threads, const wxString& report);
+    virtual ~ParallelBatchRender() {}
+
+    // splits the sequences into at most jobs lists with roughly the same total size
+    static std::vector<wxArrayString> Partition(const wxArrayString& sequences, int jobs);
+
+    // launches the render processes ... returns false if none could be started
+    bool Start();
+
+    void ProcessDone(ParallelBatchRenderProcess* process, int status);
+    int GetFailedCount() const { return _failed; }
+};
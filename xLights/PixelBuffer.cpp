@@ -1139,8 +1139,6 @@ double ColourDistance(xlColor e1, xlColor e2)
 
 void PixelBufferClass::mixColors(const wxCoord &x, const wxCoord &y, xlColor &fg, xlColor &bg, int layerNum)
 {
-    static const int n = 0;  //increase to change the curve of the crossfade
-
     LayerInfo *layer = layers[layerNum];
     if (!layer->buffer.allowAlpha && layer->fadeFactor != 1.0) {
         //need to fade the first here as we're not mixing anything
@@ -1163,253 +1161,122 @@ void PixelBufferClass::mixColors(const wxCoord &x, const wxCoord &y, xlColor &fg
         }
     }
 
-    float effectMixThreshold = layer->outputEffectMixThreshold;
-    switch (layer->mixType)
-    {
-    case MixTypes::Mix_Normal:
-        fg.alpha = fg.alpha * layer->fadeFactor * (1.0 - effectMixThreshold);
-        bg.AlphaBlendForgroundOnto(fg);
-        break;
-    case MixTypes::Mix_Effect1:
-    case MixTypes::Mix_Effect2:
-    {
-        double emt, emtNot;
-        if (!layer->effectMixVaries) {
-            emt = effectMixThreshold;
-            if ((emt > 0.000001) && (emt < 0.99999)) {
-                emtNot = 1 - effectMixThreshold;
-                //make cross-fade linear
-                emt = cos((M_PI/4)*(pow(2*emt-1,2*n+1)+1));
-                emtNot = cos((M_PI/4)*(pow(2*emtNot-1,2*n+1)+1));
-            } else {
-                emtNot = effectMixThreshold;
-                emt = 1 - effectMixThreshold;
-            }
-        } else {
-            emt = effectMixThreshold;
-            emtNot = 1 - effectMixThreshold;
-        }
+    MixPixel(layer->blendParams, x, y, fg, bg);
+}
 
-        if (layer->mixType == MixTypes::Mix_Effect2) {
-            fg.Set(fg.Red()*(emtNot),fg.Green()*(emtNot), fg.Blue()*(emtNot));
-            bg.Set(bg.Red()*(emt),bg.Green()*(emt), bg.Blue()*(emt));
-        } else {
-            fg.Set(fg.Red()*(emt),fg.Green()*(emt), fg.Blue()*(emt));
-            bg.Set(bg.Red()*(emtNot),bg.Green()*(emtNot), bg.Blue()*(emtNot));
-        }
-        bg.Set(fg.Red()+bg.Red(), fg.Green()+bg.Green(), fg.Blue()+bg.Blue());
-        break;
-    }
-    case MixTypes::Mix_Mask1:
-    {
-        // first masks second
-        HSVValue hsv0 = fg.asHSV();
-        if (hsv0.value > effectMixThreshold) {
-            bg.Set(0, 0, 0);
-        }
-        break;
-    }
-    case MixTypes::Mix_Mask2:
-    {
-        // second masks first
-        HSVValue hsv1 = bg.asHSV();
-        if (hsv1.value <= effectMixThreshold) {
-            bg = fg;
-        } else {
-            bg.Set(0, 0, 0);
-        }
-        break;
-    }
-    case MixTypes::Mix_Unmask1:
-    {
-        // first unmasks second
-        HSVValue hsv0 = fg.asHSV();
-        if (hsv0.value > effectMixThreshold) {
-            HSVValue hsv1 = bg.asHSV();
-            hsv1.value = hsv0.value;
-            bg = hsv1;
-        } else {
-            bg.Set(0, 0, 0);
-        }
-        break;
+// the colour a layer contributes to a node after its masks, HSV adjustments, sparkles and brightness/contrast
+void PixelBufferClass::GetNodeLayerColor(LayerInfo* thelayer, int node, uint32_t& sparkle, xlColor& color, int& x, int& y)
+{
+    auto &coord = thelayer->buffer.Nodes[node]->Coords[0];
+    x = coord.bufX;
+    y = coord.bufY;
+
+    if (thelayer->isMasked(x, y)
+        || x < 0
+        || y < 0
+        || x >= thelayer->BufferWi
+        || y >= thelayer->BufferHt
+        ) {
+        color.Set(0, 0, 0, 0);
+    } else {
+        thelayer->buffer.GetPixel(x, y, color);
     }
-    case MixTypes::Mix_TrueUnmask1:
-    {
-        // first unmasks second
-        HSVValue hsv0 = fg.asHSV();
-        if (hsv0.value <= effectMixThreshold) {
-            bg.Set(0, 0, 0);
+
+    // adjust for HSV adjustments
+    if (thelayer->needsHSVAdjust) {
+        HSVValue hsv = color.asHSV();
+
+        if (thelayer->outputHueAdjust != 0) {
+            hsv.hue += thelayer->outputHueAdjust;
+            if (hsv.hue < 0) {
+                hsv.hue += 1.0;
+            } else if (hsv.hue > 1) {
+                hsv.hue -= 1.0;
+            }
         }
-        break;
-    }
-    case MixTypes::Mix_Unmask2:
-    {
-        // second unmasks first
-        HSVValue hsv1 = bg.asHSV();
-        if (hsv1.value > effectMixThreshold) {
-            HSVValue hsv0 = fg.asHSV();
-            // if effect 2 is non black
-            hsv0.value = hsv1.value;
-            bg = hsv0;
-        } else {
-            bg.Set(0, 0, 0);
+
+        if (thelayer->outputSaturationAdjust != 0) {
+            hsv.saturation += thelayer->outputSaturationAdjust;
+            if (hsv.saturation < 0) {
+                hsv.saturation = 0.0;
+            } else if (hsv.saturation > 1) {
+                hsv.saturation = 1.0;
+            }
         }
-        break;
-    }
-    case MixTypes::Mix_TrueUnmask2:
-    {
-        // second unmasks first
-        HSVValue hsv1 = bg.asHSV();
-        if (hsv1.value > effectMixThreshold) {
-            // if effect 2 is non black
-            bg = fg;
-        } else {
-            bg.Set(0, 0, 0);
+
+        if (thelayer->outputValueAdjust != 0) {
+            hsv.value += thelayer->outputValueAdjust;
+            if (hsv.value < 0) {
+                hsv.value = 0.0;
+            } else if (hsv.value > 1) {
+                hsv.value = 1.0;
+            }
         }
-        break;
+
+        unsigned char alpha = color.Alpha();
+        color = hsv;
+        color.alpha = alpha;
     }
-    case MixTypes::Mix_Shadow_1on2:
-    {
-        // Effect 1 shadows onto effect 2
-        HSVValue hsv0 = fg.asHSV();
-        HSVValue hsv1 = bg.asHSV();
-        //   if (hsv0.value > effectMixThreshold[layer]) {
-        // if effect 1 is non black
-        //  to shadow we will shift the hue on the primary layer using the hue and brightness from the
-        //  other layer
-        if(hsv0.value>0.0) hsv1.hue = hsv1.hue + (hsv0.value*(hsv1.hue-hsv0.hue))/5.0;
-        // hsv1.value = hsv0.value;
-        //hsv1.saturation = hsv0.saturation;
-        bg = hsv1;
-        //   }
-        break;
-    }
-    case MixTypes::Mix_Shadow_2on1:
-    {
-        // Effect 2 shadows onto effect 1
-        HSVValue hsv0 = fg.asHSV();
-        HSVValue hsv1 = bg.asHSV();
-        // if effect 1 is non black
-        if(hsv1.value>0.0) {
-            hsv0.hue = hsv0.hue + (hsv1.value*(hsv0.hue-hsv1.hue))/2.0;
+
+    // add sparkles
+    if (color != xlBLACK &&
+        (thelayer->use_music_sparkle_count ||
+            thelayer->sparkle_count > 0 ||
+            thelayer->outputSparkleCount > 0)) {
+
+        int sc = thelayer->outputSparkleCount;
+        switch (sparkle % (208 - sc))
+        {
+        case 1:
+        case 7:
+            // too dim
+            //color.Set("#444444");
+            break;
+        case 2:
+        case 6:
+            color = thelayer->sparklesColour.ApplyBrightness(0.53f);
+            break;
+        case 3:
+        case 5:
+            color = thelayer->sparklesColour.ApplyBrightness(0.75f);
+            break;
+        case 4:
+            color = thelayer->sparklesColour;
+            break;
+        default:
+            break;
         }
-        bg = hsv0;
-        break;
+        sparkle++;
     }
-    case MixTypes::Mix_Layered:
-    {
-        HSVValue hsv1 = bg.asHSV();
-        if (hsv1.value <= effectMixThreshold) {
-            bg = fg;
-        }
-        break;
-    }
-    case MixTypes::Mix_Average:
-        // only average when both colors are non-black
-        if (bg == xlBLACK) {
-            bg = fg;
-        } else if (fg != xlBLACK) {
-            bg.Set((fg.Red() + bg.Red()) / 2, (fg.Green() + bg.Green()) / 2, (fg.Blue() + bg.Blue()) / 2, (fg.alpha + bg.alpha) / 2);
-        }
-        break;
-    case MixTypes::Mix_BottomTop:
-        bg = y < layer->BufferHt/2 ? fg : bg;
-        break;
-    case MixTypes::Mix_LeftRight:
-        bg = x < layer->BufferWi/2 ? fg : bg;
-        break;
-    case MixTypes::Mix_1_reveals_2:
-    {
-        HSVValue hsv0 = fg.asHSV();
-        bg = hsv0.value > effectMixThreshold ? fg : bg; // if effect 1 is non black
-        break;
-    }
-    case MixTypes::Mix_2_reveals_1:
-    {
-        HSVValue hsv1 = bg.asHSV();
-        bg = hsv1.value > effectMixThreshold ? bg : fg; // if effect 2 is non black
-        break;
-    }
-    case MixTypes::Mix_Highlight:
-    {
-        bool effect1HasColor = (fg.red > 0 || fg.green > 0 || fg.blue > 0);
-        bool effect2HasColor = (bg.red > 0 || bg.green > 0 || bg.blue > 0);
-        HSVValue hsv1 = bg.asHSV();
+    int b = thelayer->outputBrightnessAdjust;
+    if (thelayer->contrast != 0) {
+        //contrast is not 0, can handle brightness change at same time
+        HSVValue hsv = color.asHSV();
+        hsv.value = hsv.value * ((double)b / 100.0);
 
-        if (effect1HasColor && (effect2HasColor || hsv1.value > effectMixThreshold)) {
-            bg = fg;
+        // Apply Contrast
+        if (hsv.value < 0.5) {
+            // reduce brightness when below 0.5 in the V value or increase if > 0.5
+            hsv.value = hsv.value - (hsv.value* ((double)thelayer->contrast / 100.0));
+        } else {
+            hsv.value = hsv.value + (hsv.value* ((double)thelayer->contrast / 100.0));
         }
-    } break;
-    case MixTypes::Mix_Highlight_Vibrant:
-    {
-        HSVValue hsv1 = bg.asHSV();
-        if (hsv1.value > effectMixThreshold) {
-            
-            int r = fg.red + bg.red;
-            int g = fg.green + bg.green;
-            int b = fg.blue + bg.blue;
-
-            if (r > 255)
-                r = 255;
-            if (g > 255)
-                g = 255;
-            if (b > 255)
-                b = 255;
 
-            bg.Set(r, g, b);
-        }
-    } break;
-    case MixTypes::Mix_Additive:
-        {
-            int r = fg.red + bg.red;
-            int g = fg.green + bg.green;
-            int b = fg.blue + bg.blue;
-            if (r > 255) r = 255;
-            if (g > 255) g = 255;
-            if (b > 255) b = 255;
-            bg.Set(r, g, b);
-        }
-        break;
-    case MixTypes::Mix_Subtractive:
-        {
-            int r = bg.red - fg.red;
-            int g = bg.green - fg.green;
-            int b = bg.blue - fg.blue;
-            if (r < 0)
-                r = 0;
-            if (g < 0) g = 0;
-            if (b < 0) b = 0;
-            bg.Set(r, g, b);
-        }
-        break;
-
-    case MixTypes::Mix_Min:
-        {
-            float alpha = (float)fg.alpha / 255.0;
-            int r = std::min(fg.red, bg.red) * alpha;
-            int g = std::min(fg.green, bg.green) * alpha;
-            int b = std::min(fg.blue, bg.blue) * alpha;
-            bg.Set(r, g, b);
-        }
-        break;
-    case MixTypes::Mix_Max:
-        {
-            float alpha = (float)fg.alpha / 255.0;
-            int r = std::max(fg.red, bg.red) * alpha;
-            int g = std::max(fg.green, bg.green) * alpha;
-            int b = std::max(fg.blue, bg.blue) * alpha;
-            bg.Set(r, g, b);
-        }
-        break;
-    case MixTypes::Mix_AsBrightness:
-        {
-        float alpha = (float)fg.alpha / 255.0;
-        int r = fg.red * bg.red / 255 * alpha;
-        int g = fg.green * bg.green / 255 * alpha;
-        int b = fg.blue * bg.blue / 255 * alpha;
-        bg.Set(r, g, b);
-    }
-        break;
+        if (hsv.value < 0.0) hsv.value = 0.0;
+        if (hsv.value > 1.0) hsv.value = 1.0;
+        unsigned char alpha = color.Alpha();
+        color = hsv;
+        color.alpha = alpha;
+    } else if (b != 100) {
+        //just brightness
+        float ba = b;
+        ba /= 100.0f;
+        float f = color.red * ba;
+        color.red = std::min((int)f, 255);
+        f = color.green * ba;
+        color.green = std::min((int)f, 255);
+        f = color.blue * ba;
+        color.blue = std::min((int)f, 255);
     }
 }
 
@@ -1426,121 +1293,67 @@ void PixelBufferClass::GetMixedColor(int node, const std::vector<bool> & validLa
             if (node >= thelayer->buffer.Nodes.size()) {
                 //logger_base.crit("PixelBufferClass::GetMixedColor thelayer->buffer.Nodes does not contain node %d as it is only %d in size ... this was going to crash.", node, thelayer->buffer.Nodes.size());
             } else {
-                auto &coord = thelayer->buffer.Nodes[node]->Coords[0];
-                int x = coord.bufX;
-                int y = coord.bufY;
-
-                if (thelayer->isMasked(x, y)
-                    || x < 0
-                    || y < 0
-                    || x >= thelayer->BufferWi
-                    || y >= thelayer->BufferHt
-                    ) {
-                    color.Set(0, 0, 0, 0);
-                } else {
-                    thelayer->buffer.GetPixel(x, y, color);
-                }
+                int x, y;
+                GetNodeLayerColor(thelayer, node, sparkle, color, x, y);
 
-                // adjust for HSV adjustments
-                if (thelayer->needsHSVAdjust) {
+                if (cnt > 0) {
+                    mixColors(x, y, color, c, layer);
+                } else if (thelayer->fadeFactor != 1.0) {
+                    //need to fade the first here as we're not mixing anything
                     HSVValue hsv = color.asHSV();
-
-                    if (thelayer->outputHueAdjust != 0) {
-                        hsv.hue += thelayer->outputHueAdjust;
-                        if (hsv.hue < 0) {
-                            hsv.hue += 1.0;
-                        } else if (hsv.hue > 1) {
-                            hsv.hue -= 1.0;
-                        }
-                    }
-
-                    if (thelayer->outputSaturationAdjust != 0) {
-                        hsv.saturation += thelayer->outputSaturationAdjust;
-                        if (hsv.saturation < 0) {
-                            hsv.saturation = 0.0;
-                        } else if (hsv.saturation > 1) {
-                            hsv.saturation = 1.0;
-                        }
-                    }
-
-                    if (thelayer->outputValueAdjust != 0) {
-                        hsv.value += thelayer->outputValueAdjust;
-                        if (hsv.value < 0) {
-                            hsv.value = 0.0;
-                        } else if (hsv.value > 1) {
-                            hsv.value = 1.0;
-                        }
+                    hsv.value *= thelayer->fadeFactor;
+                    if (color.alpha != 255) {
+                        hsv.value *= color.alpha;
+                        hsv.value /= 255.0f;
                     }
-
-                    unsigned char alpha = color.Alpha();
-                    color = hsv;
-                    color.alpha = alpha;
+                    c = hsv;
+                } else {
+                    c.AlphaBlendForgroundOnto(color);
                 }
 
-                // add sparkles
-                if (color != xlBLACK &&
-                    (thelayer->use_music_sparkle_count ||
-                        thelayer->sparkle_count > 0 ||
-                        thelayer->outputSparkleCount > 0)) {
+                cnt++;
+            }
+        }
+    }
+    // set color for physical output
+    layers[saveLayer]->buffer.Nodes[node]->SetColor(c);
+}
 
-                    int sc = thelayer->outputSparkleCount;
-                    switch (sparkle % (208 - sc))
-                    {
-                    case 1:
-                    case 7:
-                        // too dim
-                        //color.Set("#444444");
-                        break;
-                    case 2:
-                    case 6:
-                        color = thelayer->sparklesColour.ApplyBrightness(0.53f);
-                        break;
-                    case 3:
-                    case 5:
-                        color = thelayer->sparklesColour.ApplyBrightness(0.75f);
-                        break;
-                    case 4:
-                        color = thelayer->sparklesColour;
-                        break;
-                    default:
-                        break;
-                    }
-                    sparkle++;
-                }
-                int b = thelayer->outputBrightnessAdjust;
-                if (thelayer->contrast != 0) {
-                    //contrast is not 0, can handle brightness change at same time
-                    HSVValue hsv = color.asHSV();
-                    hsv.value = hsv.value * ((double)b / 100.0);
+// Mixes a run of nodes a layer at a time. Each layers colours are gathered into planes and where the mix type
+// allows it the whole block is blended in one go rather than node by node.
+void PixelBufferClass::MixNodeBlock(int start, int end, const std::vector<int>& mixLayers, int saveLayer)
+{
+    const int count = end - start;
+    std::vector<NodeBaseClassPtr>& Nodes = layers[saveLayer]->buffer.Nodes;
+    std::vector<NodeBaseClassPtr>& sparkleNodes = layers[0]->buffer.Nodes;
 
-                    // Apply Contrast
-                    if (hsv.value < 0.5) {
-                        // reduce brightness when below 0.5 in the V value or increase if > 0.5
-                        hsv.value = hsv.value - (hsv.value* ((double)thelayer->contrast / 100.0));
-                    } else {
-                        hsv.value = hsv.value + (hsv.value* ((double)thelayer->contrast / 100.0));
-                    }
+    ColorPlanes fg;
+    ColorPlanes bg;
+    int xs[LAYER_BLEND_BLOCK];
+    int ys[LAYER_BLEND_BLOCK];
+    bool visible[LAYER_BLEND_BLOCK];
+    for (int i = 0; i < count; ++i) {
+        visible[i] = Nodes[start + i]->IsVisible();
+        bg.Set(i, xlBLACK);
+    }
 
-                    if (hsv.value < 0.0) hsv.value = 0.0;
-                    if (hsv.value > 1.0) hsv.value = 1.0;
-                    unsigned char alpha = color.Alpha();
-                    color = hsv;
-                    color.alpha = alpha;
-                } else if (b != 100) {
-                    //just brightness
-                    float ba = b;
-                    ba /= 100.0f;
-                    float f = color.red * ba;
-                    color.red = std::min((int)f, 255);
-                    f = color.green * ba;
-                    color.green = std::min((int)f, 255);
-                    f = color.blue * ba;
-                    color.blue = std::min((int)f, 255);
-                }
+    xlColor color;
+    for (size_t l = 0; l < mixLayers.size(); ++l) {
+        int layer = mixLayers[l];
+        LayerInfo* thelayer = layers[layer];
+
+        for (int i = 0; i < count; ++i) {
+            if (!visible[i]) {
+                // unmapped pixel ... dont disturb its sparkle state
+                color.Set(0, 0, 0, 0);
+                xs[i] = ys[i] = 0;
+            } else {
+                GetNodeLayerColor(thelayer, start + i, sparkleNodes[start + i]->sparkle, color, xs[i], ys[i]);
+            }
 
-                if (cnt > 0) {
-                    mixColors(x, y, color, c, layer);
-                } else if (thelayer->fadeFactor != 1.0) {
+            if (l == 0) {
+                xlColor c(xlBLACK);
+                if (thelayer->fadeFactor != 1.0) {
                     //need to fade the first here as we're not mixing anything
                     HSVValue hsv = color.asHSV();
                     hsv.value *= thelayer->fadeFactor;
@@ -1552,13 +1365,31 @@ void PixelBufferClass::GetMixedColor(int node, const std::vector<bool> & validLa
                 } else {
                     c.AlphaBlendForgroundOnto(color);
                 }
+                bg.Set(i, c);
+            } else {
+                fg.Set(i, color);
+            }
+        }
+        if (l == 0) continue;
 
-                cnt++;
+        // fading a layer which ignores alpha and chroma keying are done per node in mixColors
+        LAYER_BLEND_FN blend = GetLayerBlendFunction(thelayer->mixType);
+        if (blend != nullptr && !thelayer->isChromaKey && (thelayer->buffer.allowAlpha || thelayer->fadeFactor == 1.0)) {
+            blend(thelayer->blendParams, fg, bg, count);
+        } else {
+            for (int i = 0; i < count; ++i) {
+                xlColor f = fg.Get(i);
+                xlColor b = bg.Get(i);
+                mixColors(xs[i], ys[i], f, b, layer);
+                bg.Set(i, b);
             }
         }
     }
+
     // set color for physical output
-    layers[saveLayer]->buffer.Nodes[node]->SetColor(c);
+    for (int i = 0; i < count; ++i) {
+        Nodes[start + i]->SetColor(visible[i] ? bg.Get(i) : xlBLACK);
+    }
 }
 
 void PixelBufferClass::GetMixedColor(int lx, int ly, xlColor& c, const std::vector<bool> & validLayers, int EffectPeriod)
@@ -3025,7 +2856,7 @@ void PixelBufferClass::CalcOutput(int EffectPeriod, const std::vector<bool> & va
         if (layers[ii]->use_music_sparkle_count &&
             layers[ii]->buffer.GetMedia() != nullptr) {
             float f = 0.0;
-            std::list<float> const * const pf = layers[ii]->buffer.GetMedia()->GetFrameData(layers[ii]->buffer.curPeriod, FRAMEDATA_HIGH, "");
+            const FrameDataSpan* const pf = layers[ii]->buffer.GetMedia()->GetFrameData(layers[ii]->buffer.curPeriod, FRAMEDATA_HIGH, "");
             if (pf != nullptr) {
                 f = *pf->cbegin();
             }
@@ -3121,16 +2952,36 @@ void PixelBufferClass::CalcOutput(int EffectPeriod, const std::vector<bool> & va
     }
     */
 
-    std::vector<NodeBaseClassPtr> &Nodes = layers[saveLayer]->buffer.Nodes;
-    parallel_for(0, NodeCount, [this, &Nodes, &validLayers, saveLayer, EffectPeriod] (int i) {
-        if (!Nodes[i]->IsVisible()) {
-            // unmapped pixel - set to black
-            Nodes[i]->SetColor(xlBLACK);
-        } else {
-            // get blend of two effects
-            GetMixedColor(i, validLayers, EffectPeriod, saveLayer);
+    // when every layer covers every node we can mix whole blocks of nodes a layer at a time
+    std::vector<int> mixLayers;
+    bool blockMix = true;
+    for (int layer = numLayers - 1; layer >= 0; layer--) {
+        if (validLayers[layer]) {
+            mixLayers.push_back(layer);
+            if (layers[layer]->buffer.Nodes.size() < NodeCount) {
+                blockMix = false;
+            }
         }
-    }, blockSize);
+    }
+
+    std::vector<NodeBaseClassPtr> &Nodes = layers[saveLayer]->buffer.Nodes;
+    if (blockMix) {
+        parallel_for_range(0, NodeCount, [this, &mixLayers, saveLayer] (int begin, int end) {
+            for (int start = begin; start < end; start += LAYER_BLEND_BLOCK) {
+                MixNodeBlock(start, std::min(end, start + LAYER_BLEND_BLOCK), mixLayers, saveLayer);
+            }
+        }, blockSize);
+    } else {
+        parallel_for(0, NodeCount, [this, &Nodes, &validLayers, saveLayer, EffectPeriod] (int i) {
+            if (!Nodes[i]->IsVisible()) {
+                // unmapped pixel - set to black
+                Nodes[i]->SetColor(xlBLACK);
+            } else {
+                // get blend of two effects
+                GetMixedColor(i, validLayers, EffectPeriod, saveLayer);
+            }
+        }, blockSize);
+    }
 }
 
 static int DecodeType(const std::string &type)
@@ -3874,6 +3725,14 @@ void PixelBufferClass::LayerInfo::calculateNodeOutputParams(int EffectPeriod) {
     if (outputEffectMixThreshold < 0) {
         outputEffectMixThreshold = 0;
     }
+
+    blendParams.mixType = mixType;
+    blendParams.fadeFactor = fadeFactor;
+    blendParams.effectMixThreshold = outputEffectMixThreshold;
+    blendParams.effectMixVaries = effectMixVaries;
+    blendParams.bufferWi = BufferWi;
+    blendParams.bufferHt = BufferHt;
+    blendParams.Prepare();
 }
 
 
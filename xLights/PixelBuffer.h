@@ -19,38 +19,7 @@
 #include "RenderUtils.h"
 #include "GPURenderUtils.h"
 #include "Color.h"
-
- /**
- * \brief enumeration of the different techniques used in layering effects
- */
-
-enum class MixTypes
-{
-    Mix_Normal,  /** Layered with Alpha channel considered **/
-    Mix_Effect1, /**<  Effect 1 only */
-    Mix_Effect2, /**<  Effect 2 only */
-    Mix_Mask1,   /**<  Effect 2 color shows where Effect 1 is black */
-    Mix_Mask2,   /**<  Effect 1 color shows where Effect 2 is black */
-    Mix_Unmask1, /**<  Effect 2 color shows where Effect 1 is not black but with no fade ... black becomes white*/
-    Mix_Unmask2, /**<  Effect 1 color shows where Effect 2 is not black but with no fade ... black becomes white*/
-    Mix_TrueUnmask1, /**<  Effect 2 color shows where Effect 1 is not black */
-    Mix_TrueUnmask2, /**<  Effect 1 color shows where Effect 2 is black */
-    Mix_1_reveals_2,  /**<  Effect 2 color only shows if Effect 1 is black  1 reveals 2 */
-    Mix_2_reveals_1,  /**<  Effect 1 color only shows if Effect 2 is black */
-    Mix_Layered, /**<  Effect 1 is back ground and shows only when effect 2 is black */
-    Mix_Average, /**<  Average color value between effects per pixel */
-    Mix_BottomTop,
-    Mix_LeftRight,
-    Mix_Shadow_1on2, /**< Take value and saturation from Effect 1 and put them onto effect 2, leave hue alone on effect 2 */
-    Mix_Shadow_2on1, /**< Take value and saturation from Effect 3 and put them onto effect 2, leave hue alone on effect 1 */
-    Mix_Additive,
-    Mix_Subtractive,
-    Mix_AsBrightness,
-    Mix_Max,
-    Mix_Min,
-    Mix_Highlight,
-    Mix_Highlight_Vibrant
-};
+#include "LayerBlend.h"
 
 class Effect;
 class SequenceElements;
@@ -208,6 +177,7 @@ private:
         int   outputSparkleCount = 0;
         int   outputBrightnessAdjust = 0;
         float outputEffectMixThreshold;
+        LayerBlendParams blendParams;
         
         void calculateNodeOutputParams(int effectPeriod);
 
@@ -239,6 +209,8 @@ private:
     void RotateZAndZoom(RenderBuffer &buffer, GPURenderUtils::RotoZoomSettings &settings);
     
     void GetMixedColor(int node, const std::vector<bool> & validLayers, int EffectPeriod, int saveLayer);
+    void GetNodeLayerColor(LayerInfo* thelayer, int node, uint32_t& sparkle, xlColor& color, int& x, int& y);
+    void MixNodeBlock(int start, int end, const std::vector<int>& mixLayers, int saveLayer);
 
     std::string modelName;
     std::string lastBufferType;
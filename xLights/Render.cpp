@@ -12,6 +12,8 @@
 #include <condition_variable>
 #include <map>
 #include <memory>
+#include <chrono>
+#include <algorithm>
 
 #include "xLightsMain.h"
 #include "xLightsXmlFile.h"
@@ -27,6 +29,8 @@
 #include "Parallel.h"
 #include "ExternalHooks.h"
 #include "GPURenderUtils.h"
+#include "RenderProfiler.h"
+#include "xLightsVersion.h"
 
 #include <log4cpp/Category.hh>
 
@@ -87,19 +91,26 @@ public:
     bool suppress{ false };
 };
 
-class NextRenderer {
+// A node in the render dependency graph.
+// A model that shares channels with models above it in the master view must not render a frame until every one of
+// those models has finished writing that frame.  Each node knows the nodes it depends on so the frames it is allowed
+// to render is just the lowest frame completed by any of them.  When a node completes a frame it only wakes the nodes
+// that depend on it and the wakeup is done under their lock so a waiting node can never miss it.
+class RenderDependency {
 public:
 
-    NextRenderer() : nextLock(), nextSignal(), previousFrameDone(-1) {
+    RenderDependency() : nextLock(), nextSignal(), frameDone(-1), waitCount(0), waitTimeUS(0) {
     }
 
-    virtual ~NextRenderer() {}
+    virtual ~RenderDependency() {}
 
-    bool addNext(NextRenderer *n) {
-        for (const auto& i : next) {
-            if (i == n) return false;
+    // returns false if we already depended on previous
+    bool addDependency(RenderDependency *previous) {
+        for (const auto& i : dependencies) {
+            if (i == previous) return false;
         }
-        next.push_back(n);
+        dependencies.push_back(previous);
+        previous->next.push_back(this);
         return true;
     }
 
@@ -107,86 +118,66 @@ public:
         return !next.empty();
     }
 
+    size_t GetDependencyCount() const {
+        return dependencies.size();
+    }
+
     void FrameDone(int frame) {
+        frameDone = frame;
         for (const auto& i : next) {
-            i->setPreviousFrameDone(frame);
+            i->notifyFrameDone();
         }
     }
 
-    virtual void setPreviousFrameDone(int i) {
-        previousFrameDone = i;
-        nextSignal.notify_all();
+    // the highest frame every node we depend on has completed
+    int readyFrame() const {
+        int ready = END_OF_RENDER_FRAME;
+        for (const auto& i : dependencies) {
+            ready = std::min(ready, (int)i->frameDone);
+        }
+        return ready;
     }
 
     int waitForFrame(int frame) {
-        if (frame > previousFrameDone) {
+        int ready = readyFrame();
+        if (frame > ready) {
+            auto start = std::chrono::steady_clock::now();
             std::unique_lock<std::mutex> lock(nextLock);
-            while (frame > previousFrameDone) {
-                nextSignal.wait_for(lock, std::chrono::milliseconds(10));
+            while (frame > (ready = readyFrame())) {
+                nextSignal.wait(lock);
             }
+            ++waitCount;
+            waitTimeUS += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
         }
-        return previousFrameDone;
-    }
-
-    bool checkIfDone(int frame, int timeout = 5) {
-        return previousFrameDone >= frame;
-    }
-
-    int GetPreviousFrameDone() const {
-        return previousFrameDone;
-    }
-
-protected:
-    std::mutex nextLock;
-    std::condition_variable nextSignal;
-    std::atomic_int previousFrameDone;
-private:
-    std::vector<NextRenderer *> next;
-};
-
-class AggregatorRenderer: public NextRenderer {
-public:
-
-    AggregatorRenderer(int numFrames) : NextRenderer(), finalFrame(numFrames + 19), data(numFrames + 20) {
-        for (int x = 0; x < (numFrames + 20); ++x) {
-            data[x] = 0;
-        }
-        max = 0;
+        return ready;
     }
 
-    virtual ~AggregatorRenderer() {
+    bool checkIfDone(int frame) const {
+        return readyFrame() >= frame;
     }
 
-    void incNumAggregated() {
-        ++max;
+    int GetWaitCount() const {
+        return waitCount;
     }
 
-    int getNumAggregated() const
-    {
-        return max;
+    long GetWaitTimeMS() const {
+        return (long)(waitTimeUS / 1000);
     }
 
-    virtual void setPreviousFrameDone(int frame) {
-        if (max <= 1) {
-            previousFrameDone = frame;
-            FrameDone(frame);
-            return;
-        }
-        int idx = frame;
-        if (idx == END_OF_RENDER_FRAME) {
-            idx = finalFrame;
-        }
-        int i = data[idx].fetch_add(1);
-        if (i == (max - 1)) {
-            previousFrameDone = frame;
-            FrameDone(previousFrameDone);
-        }
+protected:
+    void notifyFrameDone() {
+        std::unique_lock<std::mutex> lock(nextLock);
+        nextSignal.notify_all();
     }
 
+    std::mutex nextLock;
+    std::condition_variable nextSignal;
+    std::atomic_int frameDone;
+    std::atomic_int waitCount;
+    std::atomic<int64_t> waitTimeUS;
 private:
-    std::vector<std::atomic_int> data;
-    int max;
-    const int finalFrame;
+    std::vector<RenderDependency *> dependencies;
+    std::vector<RenderDependency *> next;
 };
 
 class SNPair {
@@ -214,10 +205,10 @@ public:
 };
 
 
-class RenderJob: public Job, public NextRenderer {
+class RenderJob: public Job, public RenderDependency {
 public:
     RenderJob(ModelElement *row, SequenceData &data, xLightsFrame *xframe, bool zeroBased = false)
-        : Job(), NextRenderer(), rowToRender(row), seqData(&data), xLights(xframe),
+        : Job(), RenderDependency(), rowToRender(row), seqData(&data), xLights(xframe),
             gauge(nullptr), currentFrame(0), renderLog(log4cpp::Category::getInstance(std::string("log_render"))),
             supportsModelBlending(false), abort(false), statusMap(nullptr)
     {
@@ -323,6 +314,8 @@ public:
     int GetCurrentFrame() const { return currentFrame;}
     int GetEndFrame() const { return endFrame;}
     int GetStartFrame() const { return startFrame;}
+    long GetTotalTimeMS() const { return totalTimeMS; }
+    long GetRenderTimeMS() const { return std::max(0L, (long)totalTimeMS - GetWaitTimeMS()); }
 
     const std::string GetName() const override {
         return name;
@@ -542,6 +535,11 @@ public:
         supportsModelBlending = true;
     }
 
+    // only the frames set in the mask are rendered, the rest of the existing data is left alone
+    void SetFrameMask(const std::vector<bool>& mask) {
+        frameMask = mask;
+    }
+
     int GetEffectFrame(Effect* ef, int frame, int frameTime)
     {
         return frame - (ef->GetStartTimeMS() / frameTime);
@@ -678,7 +676,10 @@ public:
                     RenderBuffer& rb = buffer->BufferForLayer(layer, -1);
 
                     // I have to calc the output here to apply blend, rotozoom and transitions
-                    buffer->CalcOutput(frame, vl, layer);
+                    {
+                        RenderProfileTimer timer(RenderProfileCategory::Blend, buffer->GetModelName(), -1, RenderProfiler::CategoryName(RenderProfileCategory::Blend), 0, frame);
+                        buffer->CalcOutput(frame, vl, layer);
+                    }
                     std::vector<uint8_t> done(rb.GetPixelCount());
                     rb.CopyNodeColorsToPixels(done);
                     // now fill in any spaces in the buffer that don't have nodes mapped to them
@@ -717,7 +718,10 @@ public:
                 buffer->SetColors(numLayers, &((*seqData)[frame][0]));
                 info.validLayers[numLayers] = true;
             }
-            buffer->CalcOutput(frame, info.validLayers);
+            {
+                RenderProfileTimer timer(RenderProfileCategory::Blend, buffer->GetModelName(), -1, RenderProfiler::CategoryName(RenderProfileCategory::Blend), 0, frame);
+                buffer->CalcOutput(frame, info.validLayers);
+            }
             buffer->GetColors(&((*seqData)[frame][0]), rangeRestriction);
         }
 
@@ -737,6 +741,7 @@ public:
         //make sure we can do this frame
         if (frame >= maxFrameBeforeCheck) {
             SetWaitingStatus(frame);
+            RenderProfileTimer timer(RenderProfileCategory::Wait, name, -1, RenderProfiler::CategoryName(RenderProfileCategory::Wait), 0, frame);
             maxFrameBeforeCheck = waitForFrame(frame);
             SetGenericStatus("%s: Processing frame %d ", frame, true, true);
         }
@@ -759,6 +764,7 @@ public:
             return;
         }
         SetGenericStatus("Got lock on rendering thread for %s", 0);
+        auto renderStart = std::chrono::steady_clock::now();
 
         rowToRender->GetAndResetDirtyRange(origChangeCount, ss, es);
         if (ss != -1) {
@@ -780,6 +786,10 @@ public:
         }
         if (startFrame < 0) startFrame = 0;
         if (endFrame > (int)seqData->NumFrames()) endFrame = seqData->NumFrames() - 1;
+        if (seqData == &xLights->_seqData) {
+            // whatever was rendered here before is about to be replaced
+            xLights->GetRenderHashIndex().Invalidate(name, startFrame, endFrame);
+        }
 
         EffectLayerInfo mainModelInfo(numLayers);
         std::map<SNPair, Effect*> nodeEffects;
@@ -788,17 +798,22 @@ public:
         std::map<SNPair, int> nodeEffectIdxs;
 
         try {
-            //for (int layer = 0; layer < numLayers; ++layer) {
-            for (int layer = numLayers - 1; layer >= 0; --layer) {
-                SetGenericStatus("Finding starting effect for %s, startFrame %d, and layer %d ", (int)startFrame, layer, false, true);
-                EffectLayer *elayer = rowToRender->GetEffectLayer(layer);
-                std::unique_lock<std::recursive_mutex> elock(elayer->GetLock());
-                mainModelInfo.currentEffects[layer] = findEffectForFrame(elayer, startFrame, mainModelInfo.currentEffectIdxs[layer]);
-                SetGenericStatus("Initializing starting effect for %s, startFrame %d, and layer %d ", (int)startFrame, layer, false, true);
-                initialize(layer, startFrame, mainModelInfo.currentEffects[layer], mainModelInfo.settingsMaps[layer], mainBuffer);
-                mainModelInfo.effectStates[layer] = true;
-            }
+            auto initializeLayers = [this, &mainModelInfo](int start) {
+                //for (int layer = 0; layer < numLayers; ++layer) {
+                for (int layer = numLayers - 1; layer >= 0; --layer) {
+                    SetGenericStatus("Finding starting effect for %s, startFrame %d, and layer %d ", start, layer, false, true);
+                    EffectLayer *elayer = rowToRender->GetEffectLayer(layer);
+                    std::unique_lock<std::recursive_mutex> elock(elayer->GetLock());
+                    mainModelInfo.currentEffects[layer] = findEffectForFrame(elayer, start, mainModelInfo.currentEffectIdxs[layer]);
+                    SetGenericStatus("Initializing starting effect for %s, startFrame %d, and layer %d ", start, layer, false, true);
+                    initialize(layer, start, mainModelInfo.currentEffects[layer], mainModelInfo.settingsMaps[layer], mainBuffer);
+                    mainModelInfo.effectStates[layer] = true;
+                }
+            };
+            initializeLayers(startFrame);
 
+            // set when frames have been skipped so the effects need to start over
+            bool restart = false;
             for (int frame = startFrame; frame <= endFrame; ++frame) {
                 currentFrame = frame;
                 SetGenericStatus("%s: Starting frame %d ", frame, true, true);
@@ -820,6 +835,21 @@ public:
                     break;
                 }
 
+                if (!frameMask.empty() && (frame >= (int)frameMask.size() || !frameMask[frame])) {
+                    restart = true;
+                    if (HasNext()) {
+                        FrameDone(frame);
+                    }
+                    continue;
+                }
+                if (restart) {
+                    // pick up the effects as if the render had started on this frame
+                    initializeLayers(frame);
+                    for (const auto& a : subModelInfos) {
+                        std::fill(a->currentEffects.begin(), a->currentEffects.end(), nullptr);
+                    }
+                }
+
                 bool cleared = ProcessFrame(frame, rowToRender, mainModelInfo, mainBuffer, -1, supportsModelBlending);
                 if (!subModelInfos.empty()) {
                     maybeWaitForFrame(frame);
@@ -861,7 +891,7 @@ public:
                         }
                         std::unique_lock<std::recursive_mutex> nlayerLock(nlayer->GetLock());
                         Effect *el = findEffectForFrame(nlayer, frame, nodeEffectIdxs[node]);
-                        if (el != nodeEffects[node] || frame == startFrame) {
+                        if (el != nodeEffects[node] || frame == startFrame || restart) {
                             nodeEffects[node] = el;
                             SetInializingStatus(frame, -1, -1, strand, inode);
                             initialize(0, frame, el, nodeSettingsMaps[node], buffer);
@@ -878,11 +908,15 @@ public:
                             //copy to output
                             std::vector<bool> valid(2, true);
                             buffer->SetColors(1, &((*seqData)[frame][0]));
-                            buffer->CalcOutput(frame, valid);
+                            {
+                                RenderProfileTimer timer(RenderProfileCategory::Blend, buffer->GetModelName(), -1, RenderProfiler::CategoryName(RenderProfileCategory::Blend), 0, frame);
+                                buffer->CalcOutput(frame, valid);
+                            }
                             buffer->GetColors(&((*seqData)[frame][0]), rangeRestriction);
                         }
                     }
                 }
+                restart = false;
                 //mainBuffer->ApplyDimmingCurves(&((*seqData)[frame][0]));
                 if (HasNext()) {
                     SetGenericStatus("%s: Notifying next renderer of frame %d done", frame, true);
@@ -916,6 +950,11 @@ public:
             xLights->CallAfter(&xLightsFrame::RenderDone);
         }
         rowToRender->CleanupAfterRender();
+
+        totalTimeMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - renderStart).count();
+        renderLog.debug("Model %s frames %d-%d: %ldms total, %ldms rendering, %ldms waiting on %d models (%d waits).",
+                        (const char*)name.c_str(), (int)startFrame, (int)endFrame, (long)totalTimeMS,
+                        GetRenderTimeMS(), GetWaitTimeMS(), (int)GetDependencyCount(), GetWaitCount());
         currentFrame = END_OF_RENDER_FRAME;
         //printf("Done rendering %lx (next %lx)\n", (unsigned long)this, (unsigned long)next);
 		renderLog.debug("Rendering thread exiting.");
@@ -1007,6 +1046,7 @@ private:
     xLightsFrame *xLights;
     SequenceData *seqData;
     std::vector<bool> rangeRestriction;
+    std::vector<bool> frameMask;
     bool supportsModelBlending;
     RenderEvent renderEvent;
 
@@ -1025,6 +1065,7 @@ private:
     wxGauge *gauge;
     std::atomic_int currentFrame;
     std::atomic_bool abort;
+    std::atomic<long> totalTimeMS = 0;
 
     std::vector<EffectLayerInfo *> subModelInfos;
 
@@ -1092,7 +1133,6 @@ public:
         startFrame = 0;
         endFrame = 0;
         jobs = nullptr;
-        aggregators = nullptr;
         renderProgressDialog = nullptr;
     };
     std::function<void(bool)> callback;
@@ -1100,7 +1140,6 @@ public:
     int startFrame;
     int endFrame;
     RenderJob **jobs;
-    AggregatorRenderer **aggregators;
     RenderProgressDialog *renderProgressDialog;
     std::list<Model *> restriction;
 };
@@ -1147,6 +1186,33 @@ void xLightsFrame::LogRenderStatus()
     logger_base.debug("*************************************");
 }
 
+// Summary of where the render time went ... models that spend most of their time waiting on models they overlap
+// point at groups that serialise the render
+static void LogRenderTimes(RenderProgressInfo *rpi) {
+    static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+    if (!logger_render.isDebugEnabled()) {
+        return;
+    }
+
+    std::vector<RenderJob*> jobs;
+    long rendering = 0;
+    long waiting = 0;
+    for (int row = 0; row < rpi->numRows; ++row) {
+        if (rpi->jobs[row] != nullptr) {
+            jobs.push_back(rpi->jobs[row]);
+            rendering += rpi->jobs[row]->GetRenderTimeMS();
+            waiting += rpi->jobs[row]->GetWaitTimeMS();
+        }
+    }
+    logger_render.debug("Render of %d models: %ldms rendering, %ldms waiting on other models.", (int)jobs.size(), rendering, waiting);
+
+    std::sort(jobs.begin(), jobs.end(), [](RenderJob *a, RenderJob *b) { return a->GetWaitTimeMS() > b->GetWaitTimeMS(); });
+    for (size_t i = 0; i < jobs.size() && i < 10 && jobs[i]->GetWaitTimeMS() > 0; ++i) {
+        logger_render.debug("    %s: %ldms rendering, %ldms waiting on %d models.", (const char *)jobs[i]->GetName().c_str(),
+                            jobs[i]->GetRenderTimeMS(), jobs[i]->GetWaitTimeMS(), (int)jobs[i]->GetDependencyCount());
+    }
+}
+
 static bool HasEffects(ModelElement *me) {
     if (me->HasEffects()) {
         return true;
@@ -1253,11 +1319,11 @@ void xLightsFrame::UpdateRenderStatus() {
         }
 
         if (done) {
+            LogRenderTimes(rpi);
             for (size_t row = 0; row < rpi->numRows; ++row) {
                 if (rpi->jobs[row]) {
                     delete rpi->jobs[row];
                 }
-                delete rpi->aggregators[row];
             }
             if (rpi->renderProgressDialog) {
                 delete rpi->renderProgressDialog;
@@ -1267,7 +1333,6 @@ void xLightsFrame::UpdateRenderStatus() {
             _appProgress->Reset();
             RenderDone();
             delete []rpi->jobs;
-            delete []rpi->aggregators;
             rpi->callback(abortedRenderJobs > 0);
             delete rpi;
             rpi = nullptr;
@@ -1424,7 +1489,8 @@ void xLightsFrame::Render(SequenceElements& seqElements,
                           const std::list<Model *> &restrictToModels,
                           int startFrame, int endFrame,
                           bool progressDialog, bool clear,
-                          std::function<void(bool)>&& callback)
+                          std::function<void(bool)>&& callback,
+                          const RenderFrameMasks* frameMasks)
 {
     abortedRenderJobs = 0;
 
@@ -1449,13 +1515,12 @@ void xLightsFrame::Render(SequenceElements& seqElements,
     }
     int numRows = models.size();
     RenderJob **jobs = new RenderJob*[numRows];
-    AggregatorRenderer **aggregators = new AggregatorRenderer*[numRows];
+    std::vector<std::vector<int>> dependencies(numRows);
     std::vector<std::set<int>> channelMaps(seqData.NumChannels());
 
     size_t row = 0;
     for (auto it = models.begin(); it != models.end(); ++it, ++row) {
         jobs[row] = nullptr;
-        aggregators[row] = new AggregatorRenderer(seqData.NumFrames());
 
         Element *rowEl = seqElements.GetElement((*it)->GetName());
 
@@ -1480,6 +1545,12 @@ void xLightsFrame::Render(SequenceElements& seqElements,
 
                     job->setRenderRange(startFrame, endFrame);
                     job->SetRangeRestriction(ranges);
+                    if (frameMasks != nullptr) {
+                        auto mask = frameMasks->find((*it)->GetName());
+                        if (mask != frameMasks->end()) {
+                            job->SetFrameMask(mask->second);
+                        }
+                    }
                     if (seqElements.SupportsModelBlending()) {
                         job->SetModelBlending();
                     }
@@ -1490,7 +1561,6 @@ void xLightsFrame::Render(SequenceElements& seqElements,
                     }
 
                     jobs[row] = job;
-                    aggregators[row]->addNext(job);
                     size_t cn = buffer->GetChanCountPerNode();
                     for (size_t node = 0; node < buffer->GetNodeCount(); ++node) {
                         uint32_t start = buffer->NodeStartChannel(node);
@@ -1500,8 +1570,8 @@ void xLightsFrame::Render(SequenceElements& seqElements,
                                 for (const auto i : channelMaps[cnum]) {
                                     int idx = i;
                                     if (idx != row) {
-                                        if (jobs[idx]->addNext(aggregators[row])) {
-                                            aggregators[row]->incNumAggregated();
+                                        if (job->addDependency(jobs[idx])) {
+                                            dependencies[row].push_back(idx);
                                         }
                                     }
                                 }
@@ -1514,7 +1584,7 @@ void xLightsFrame::Render(SequenceElements& seqElements,
         }
     }
 
-    logger_render.debug("Aggregators created.");
+    logger_render.debug("Render dependencies created.");
 
     channelMaps.clear();
     RenderProgressDialog *renderProgressDialog = nullptr;
@@ -1522,7 +1592,26 @@ void xLightsFrame::Render(SequenceElements& seqElements,
         renderProgressDialog = new RenderProgressDialog(this);
     }
     unsigned int count = 0;
-    if (clear) {
+    if (clear && frameMasks != nullptr) {
+        // only clear the frames each model is going to render
+        for (const auto& it : restrictToModels) {
+            auto mask = frameMasks->find(it->GetName());
+            if (mask == frameMasks->end()) continue;
+            RenderTreeData data(it);
+            for (int f = startFrame; f <= endFrame && f < (int)mask->second.size(); f++) {
+                if (mask->second[f]) {
+                    for (const auto& r : data.ranges) {
+                        seqData[f].Zero(r.start, r.end - r.start + 1);
+                    }
+                }
+            }
+        }
+    } else if (clear) {
+        if (&seqData == &_seqData) {
+            for (const auto& it : models) {
+                _renderHashIndex.Invalidate(it->GetName(), startFrame, endFrame);
+            }
+        }
         for (int f = startFrame; f <= endFrame; f++) {
             for (const auto& it : ranges) {
                 seqData[f].Zero(it.start, it.end - it.start + 1);
@@ -1532,16 +1621,53 @@ void xLightsFrame::Render(SequenceElements& seqElements,
 
     logger_render.debug("Data cleared.");
 
+    // work out where each job sits in the dependency graph.  Dependencies are always on rows above so one pass
+    // each way is enough.  level is the longest chain of models a job waits on and chain is the longest chain
+    // of models waiting on it
+    std::vector<int> level(numRows, 0);
+    std::vector<int> chain(numRows, 0);
+    size_t edges = 0;
+    for (row = 0; row < numRows; ++row) {
+        for (const auto d : dependencies[row]) {
+            level[row] = std::max(level[row], level[d] + 1);
+        }
+        edges += dependencies[row].size();
+    }
+    for (int r = numRows - 1; r >= 0; --r) {
+        for (const auto d : dependencies[r]) {
+            chain[d] = std::max(chain[d], chain[r] + 1);
+        }
+    }
+
+    // jobs are queued in dependency order so a job can never sit in the pool queue behind a job that is waiting
+    // on it, and within a level the jobs with the longest chain waiting on them go first
+    std::vector<int> order;
     for (row = 0; row < numRows; ++row) {
         if (jobs[row]) {
-            if (aggregators[row]->getNumAggregated() == 0) {
-                //start all the jobs that don't depend on anything above them
-                //get them rendering while we setup the rest
-                jobs[row]->setPreviousFrameDone(END_OF_RENDER_FRAME);
-                jobPool.PushJob(jobs[row]);
-                ++count;
-            }
-            if (progressDialog) {
+            order.push_back(row);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&level, &chain](int a, int b) {
+        if (level[a] != level[b]) {
+            return level[a] < level[b];
+        }
+        return chain[a] > chain[b];
+    });
+    logger_render.debug("Render graph %d jobs, %d dependencies, %d levels.", (int)order.size(), (int)edges,
+                        order.empty() ? 0 : level[order.back()] + 1);
+
+    //start all the jobs that don't depend on anything above them
+    //get them rendering while we setup the rest
+    auto next = order.begin();
+    while (next != order.end() && level[*next] == 0) {
+        jobPool.PushJob(jobs[*next]);
+        ++count;
+        ++next;
+    }
+
+    if (progressDialog) {
+        for (row = 0; row < numRows; ++row) {
+            if (jobs[row]) {
                 wxStaticText *label = new wxStaticText(renderProgressDialog->scrolledWindow, wxID_ANY, jobs[row]->GetName());
                 renderProgressDialog->scrolledWindowSizer->Add(label,1, wxALL |wxEXPAND,3);
                 wxGauge *g = new wxGauge(renderProgressDialog->scrolledWindow, wxID_ANY, 100);
@@ -1554,12 +1680,10 @@ void xLightsFrame::Render(SequenceElements& seqElements,
     }
 
     logger_render.debug("Job pool start size %d.", (int)jobPool.size());
-    for (row = 0; row < numRows; ++row) {
-        if (jobs[row] && aggregators[row]->getNumAggregated() != 0) {
-            //now start the rest
-            jobPool.PushJob(jobs[row]);
-            ++count;
-        }
+    //now start the rest
+    for (; next != order.end(); ++next) {
+        jobPool.PushJob(jobs[*next]);
+        ++count;
     }
     logger_base.debug("Job pool new size %d.", (int)jobPool.size());
 
@@ -1578,7 +1702,6 @@ void xLightsFrame::Render(SequenceElements& seqElements,
         pi->jobs = jobs;
         pi->renderProgressDialog = renderProgressDialog;
         pi->restriction = restrictToModels;
-        pi->aggregators = aggregators;
 
         renderProgressInfo.push_back(pi);
         RenderStatusTimer.Start(100, false);
@@ -1741,24 +1864,22 @@ bool xLightsFrame::AbortRender(int maxTimeMS, int* numThreadsAborted)
     return renderProgressInfo.empty();
 }
 
-void xLightsFrame::RenderGridToSeqData(std::function<void(bool)>&& callback) {
+void xLightsFrame::RenderGridToSeqData(std::function<void(bool)>&& callback, bool force) {
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     BuildRenderTree();
-    if (renderTree.data.empty()) {
+    if (renderTree.data.empty() || _sequenceElements.GetElementCount() == 0) {
         //nothing to do....
+        if (IsEffectOnlySequenceData()) {
+            ClearSequenceData();
+        }
         callback(false);
         return;
     }
 
     logger_base.debug("Render tree built. %d entries.", renderTree.data.size());
 
-    const int numRows = _sequenceElements.GetElementCount();
-    if (numRows == 0) {
-        callback(false);
-        return;
-    }
     std::list<Model *> models;
     for (const auto& it : renderTree.data) {
         models.push_back(it->model);
@@ -1771,6 +1892,13 @@ void xLightsFrame::RenderGridToSeqData(std::function<void(bool)>&& callback) {
             }
         }
     }
+    if (!force && IsEffectOnlySequenceData()) {
+        // nothing else has been written to the sequence data so only what has changed needs rendering
+        RenderStaleModels(std::move(callback));
+        return;
+    }
+    _renderHashIndex.Clear();
+
     std::list<Model*> restricts;
 
     logger_base.debug("Rendering %d models %d frames.", models.size(), _seqData.NumFrames());
@@ -1795,6 +1923,242 @@ void xLightsFrame::RenderGridToSeqData(std::function<void(bool)>&& callback) {
 #endif
 }
 
+static void HashXml(wxXmlNode* node, uint64_t& h)
+{
+    if (node == nullptr) return;
+    h = RenderHashIndex::Hash(node->GetName().ToStdString(), h);
+    h = RenderHashIndex::Hash(node->GetContent().ToStdString(), h);
+    for (auto a = node->GetAttributes(); a != nullptr; a = a->GetNext()) {
+        h = RenderHashIndex::Hash(a->GetName().ToStdString(), h);
+        h = RenderHashIndex::Hash(a->GetValue().ToStdString(), h);
+    }
+    for (auto c = node->GetChildren(); c != nullptr; c = c->GetNext()) {
+        HashXml(c, h);
+    }
+}
+
+// the model setup ... groups depend on the setup of all the models in them
+static uint64_t HashModel(xLightsFrame* frame, const Model* model, int depth = 0)
+{
+    uint64_t h = RenderHashIndex::Hash(model->GetName());
+    if (depth > 10) return h;
+    HashXml(model->GetModelXml(), h);
+    h = RenderHashIndex::Mix(h, model->GetFirstChannel());
+    h = RenderHashIndex::Mix(h, model->GetLastChannel());
+
+    const ModelGroup* grp = dynamic_cast<const ModelGroup*>(model);
+    if (grp != nullptr) {
+        for (const auto& it : grp->ModelNames()) {
+            Model* m = frame->GetModel(it);
+            if (m != nullptr) {
+                h = RenderHashIndex::Mix(h, HashModel(frame, m, depth + 1));
+            }
+        }
+    }
+    return h;
+}
+
+static uint64_t HashEffect(Effect* ef, SequenceElements* seqElements, bool followDuplicate = true)
+{
+    uint64_t h = RenderHashIndex::Hash(ef->GetEffectName());
+    h = RenderHashIndex::Hash(ef->GetSettingsAsString(), h);
+    h = RenderHashIndex::Hash(ef->GetPaletteAsString(), h);
+    h = RenderHashIndex::Mix(h, ef->GetStartTimeMS());
+    h = RenderHashIndex::Mix(h, ef->GetEndTimeMS());
+    h = RenderHashIndex::Mix(h, ef->IsRenderDisabled() ? 1 : 0);
+    RenderableEffect* re = seqElements->GetEffectManager().GetEffect(ef->GetEffectIndex());
+    h = RenderHashIndex::Mix(h, re == nullptr ? 0 : re->GetRenderVersion());
+
+    if (followDuplicate && ef->GetEffectIndex() == EffectManager::eff_DUPLICATE) {
+        // depends on whatever is on the layer being duplicated
+        Element* e = seqElements->GetElement(ef->GetSetting("E_CHOICE_Duplicate_Model"));
+        EffectLayer* layer = e == nullptr ? nullptr : e->GetEffectLayer(ef->GetSettings().GetInt("E_SPINCTRL_Duplicate_Layer") - 1);
+        if (layer != nullptr) {
+            std::unique_lock<std::recursive_mutex> lock(layer->GetLock());
+            for (int i = 0; i < layer->GetEffectCount(); ++i) {
+                h = RenderHashIndex::Mix(h, HashEffect(layer->GetEffect(i), seqElements, false));
+            }
+        }
+    }
+    return h;
+}
+
+// Fills in a hash for every frame of a model covering everything its rendered output depends on ... the model setup
+// and the effects on the model, its submodels, strands and nodes. Persistent effects build on the frames of the
+// effect before them so they pick up its hash as well. restart is the frame a render has to begin on to get the same
+// result for each frame which is the start of the earliest effect in play.
+static void HashModelFrames(xLightsFrame* frame, ModelElement* me, const Model* model, uint64_t context, int numFrames, int frameTime, RenderHashFrames& res)
+{
+    std::vector<uint64_t> sums(numFrames, 0);
+    res.restart.resize(numFrames);
+    for (int f = 0; f < numFrames; f++) {
+        res.restart[f] = f;
+    }
+
+    auto hashLayer = [&](EffectLayer* layer, const std::string& id) {
+        if (layer == nullptr) return;
+        uint64_t layerHash = RenderHashIndex::Hash(id);
+        uint64_t prevHash = 0;
+        int prevEnd = -2;
+        int chainStart = 0;
+
+        std::unique_lock<std::recursive_mutex> lock(layer->GetLock());
+        for (int e = 0; e < layer->GetEffectCount(); ++e) {
+            Effect* ef = layer->GetEffect(e);
+            int s = (ef->GetStartTimeMS() + frameTime - 1) / frameTime;
+            int en = std::min(numFrames, (ef->GetEndTimeMS() + frameTime - 1) / frameTime) - 1;
+            if (en < s) continue;
+
+            uint64_t h = HashEffect(ef, me->GetSequenceElements());
+            if (ef->IsPersistent() && prevEnd >= s - 1) {
+                h = RenderHashIndex::Mix(h, prevHash);
+            } else {
+                chainStart = s;
+            }
+            prevHash = h;
+            prevEnd = en;
+
+            h = RenderHashIndex::Mix(h, layerHash);
+            for (int f = s; f <= en; f++) {
+                sums[f] += h;
+                res.restart[f] = std::min(res.restart[f], chainStart);
+            }
+        }
+    };
+
+    if (me != nullptr) {
+        for (size_t l = 0; l < me->GetEffectLayerCount(); ++l) {
+            hashLayer(me->GetEffectLayer(l), std::to_string(l));
+        }
+        for (int x = 0; x < me->GetSubModelAndStrandCount(); ++x) {
+            SubModelElement* se = me->GetSubModel(x);
+            for (size_t l = 0; l < se->GetEffectLayerCount(); ++l) {
+                hashLayer(se->GetEffectLayer(l), se->GetFullName() + "/" + std::to_string(l));
+            }
+            if (se->GetType() == ElementType::ELEMENT_TYPE_STRAND) {
+                StrandElement* ste = (StrandElement*)se;
+                for (int n = 0; n < ste->GetNodeLayerCount(); ++n) {
+                    hashLayer(ste->GetNodeLayer(n), se->GetFullName() + "/node" + std::to_string(n));
+                }
+            }
+        }
+    }
+
+    uint64_t modelHash = RenderHashIndex::Mix(context, HashModel(frame, model));
+    res.hashes.resize(numFrames);
+    for (int f = 0; f < numFrames; f++) {
+        res.hashes[f] = RenderHashIndex::Mix(modelHash, sums[f]);
+        if (res.hashes[f] == 0) res.hashes[f] = 1;
+    }
+}
+
+void xLightsFrame::RenderStaleModels(std::function<void(bool)>&& callback)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    wxStopWatch sw;
+
+    const int numFrames = _seqData.NumFrames();
+    const int frameTime = _seqData.FrameTime();
+
+    // things every model depends on ... the xLights version, the audio and timing tracks
+    uint64_t context = RenderHashIndex::Hash(xlights_version_string.ToStdString(), RenderHashIndex::HASH_SEED);
+    context = RenderHashIndex::Mix(context, frameTime);
+    context = RenderHashIndex::Mix(context, _sequenceElements.SupportsModelBlending() ? 1 : 0);
+    wxString media = CurrentSeqXmlFile->GetMediaFile();
+    context = RenderHashIndex::Hash(media.ToStdString(), context);
+    if (!media.IsEmpty() && FileExists(media)) {
+        wxFileName fn(media);
+        context = RenderHashIndex::Mix(context, fn.GetSize().GetValue());
+        context = RenderHashIndex::Mix(context, fn.GetModificationTime().GetTicks());
+    }
+    for (size_t i = 0; i < _sequenceElements.GetElementCount(MASTER_VIEW); ++i) {
+        Element* e = _sequenceElements.GetElement(i, MASTER_VIEW);
+        if (e == nullptr || e->GetType() != ElementType::ELEMENT_TYPE_TIMING) continue;
+        context = RenderHashIndex::Hash(e->GetName(), context);
+        for (size_t l = 0; l < e->GetEffectLayerCount(); ++l) {
+            EffectLayer* layer = e->GetEffectLayer(l);
+            std::unique_lock<std::recursive_mutex> lock(layer->GetLock());
+            for (int x = 0; x < layer->GetEffectCount(); ++x) {
+                Effect* ef = layer->GetEffect(x);
+                context = RenderHashIndex::Hash(ef->GetEffectName(), context);
+                context = RenderHashIndex::Mix(context, ef->GetStartTimeMS());
+                context = RenderHashIndex::Mix(context, ef->GetEndTimeMS());
+            }
+        }
+    }
+
+    // which models are in the sequence and where their channels are ... if this changes everything is rendered
+    uint64_t layout = RenderHashIndex::Mix(RenderHashIndex::HASH_SEED, _seqData.NumChannels());
+    std::map<const Model*, int> modelIdx;
+    std::vector<RenderHashFrames> frames(renderTree.data.size());
+    int idx = 0;
+    for (const auto& it : renderTree.data) {
+        modelIdx[it->model] = idx;
+        frames[idx++].model = it->model->GetName();
+        layout = RenderHashIndex::Hash(it->model->GetName(), layout);
+        for (const auto& r : it->ranges) {
+            layout = RenderHashIndex::Mix(layout, r.start);
+            layout = RenderHashIndex::Mix(layout, r.end);
+        }
+    }
+    idx = 0;
+    for (const auto& it : renderTree.data) {
+        auto& f = frames[idx++];
+        for (const auto& o : it->renderOrder) {
+            if (o != it->model && modelIdx.find(o) != modelIdx.end()) {
+                f.overlaps.push_back(modelIdx[o]);
+            }
+        }
+        ModelElement* me = dynamic_cast<ModelElement*>(_sequenceElements.GetElement(it->model->GetName()));
+        HashModelFrames(this, me, it->model, context, numFrames, frameTime, f);
+    }
+
+    bool full = !_renderHashIndex.IsValidFor(_seqData.NumChannels(), numFrames, frameTime, _seqData.GetGeneration(), layout);
+    std::list<Model*> models;
+    std::list<Model*> restricts;
+    RenderFrameMasks masks;
+    if (full) {
+        logger_base.debug("No usable render hashes, rendering %d models %d frames.", (int)renderTree.data.size(), numFrames);
+        ClearSequenceData();
+        _renderHashIndex.Reset(_seqData.NumChannels(), numFrames, frameTime, _seqData.GetGeneration(), layout);
+        for (const auto& it : renderTree.data) {
+            models.push_back(it->model);
+        }
+    } else {
+        auto stale = _renderHashIndex.FindStale(frames);
+        size_t staleFrames = 0;
+        idx = 0;
+        for (const auto& it : renderTree.data) {
+            size_t count = std::count(stale[idx].begin(), stale[idx].end(), true);
+            if (count > 0) {
+                models.push_back(it->model);
+                masks[it->model->GetName()] = std::move(stale[idx]);
+                staleFrames += count;
+            }
+            idx++;
+        }
+        restricts = models;
+        logger_base.debug("Render hashes checked in %ldms, %d of %d models and %d of %d model frames have changed.",
+                          sw.Time(), (int)models.size(), (int)renderTree.data.size(), (int)staleFrames, (int)(renderTree.data.size() * numFrames));
+        if (models.empty()) {
+            callback(false);
+            return;
+        }
+    }
+
+    unsigned int changeCount = _sequenceElements.GetChangeCount();
+    auto done = [this, frames = std::move(frames), changeCount, callback = std::move(callback)](bool aborted) {
+        // if anything changed while rendering we cant be sure what the hashes were for so they stay invalidated
+        if (!aborted && changeCount == _sequenceElements.GetChangeCount()) {
+            for (const auto& it : frames) {
+                _renderHashIndex.Set(it.model, it.hashes);
+            }
+        }
+        callback(aborted);
+    };
+    Render(_sequenceElements, _seqData, models, restricts, 0, numFrames - 1, true, !full, std::move(done), full ? nullptr : &masks);
+}
+
 void xLightsFrame::RenderEffectForModel(const std::string &model, int startms, int endms, bool clear) {
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -1961,7 +2325,7 @@ bool xLightsFrame::DoExportModel(unsigned int startFrame, unsigned int endFrame,
     SetStatusText(wxString::Format("Starting Export for %s - %s", format, Out3));
     wxYield();
 
-    NextRenderer wait;
+    RenderDependency wait;
     Element* el = _sequenceElements.GetElement(model);
     if (el == nullptr)
         return false;
@@ -1974,8 +2338,7 @@ bool xLightsFrame::DoExportModel(unsigned int startFrame, unsigned int endFrame,
     if (doRender) {
         // always render the whole model
         job->setRenderRange(0, _seqData.NumFrames());
-        job->setPreviousFrameDone(END_OF_RENDER_FRAME);
-        job->addNext(&wait);
+        wait.addDependency(job);
         jobPool.PushJob(job);
         //wait to complete
         while (!wait.checkIfDone(_seqData.NumFrames())) {
@@ -2228,13 +2591,23 @@ bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
 
                             wxStopWatch sw;
                             if (effectObj != nullptr && reff->SupportsRenderCache(SettingsMap)) {
-                                if (!effectObj->GetFrame(*rb, _renderCache)) {
-                                    reff->Render(effectObj, SettingsMap, *rb);
-                                    GPURenderUtils::waitForRenderCompletion(rb);
+                                bool cached = false;
+                                {
+                                    RenderProfileTimer timer(RenderProfileCategory::RenderCache, buffer.GetModelName(), layer, reff->Name(), effectObj->GetStartTimeMS(), rb->curPeriod);
+                                    cached = effectObj->GetFrame(*rb, _renderCache);
+                                }
+                                if (!cached) {
+                                    {
+                                        RenderProfileTimer timer(RenderProfileCategory::Render, buffer.GetModelName(), layer, reff->Name(), effectObj->GetStartTimeMS(), rb->curPeriod);
+                                        reff->Render(effectObj, SettingsMap, *rb);
+                                        GPURenderUtils::waitForRenderCompletion(rb);
+                                    }
+                                    RenderProfileTimer timer(RenderProfileCategory::RenderCache, buffer.GetModelName(), layer, reff->Name(), effectObj->GetStartTimeMS(), rb->curPeriod);
                                     effectObj->AddFrame(*rb, _renderCache);
                                 }
                             }
                             else {
+                                RenderProfileTimer timer(RenderProfileCategory::Render, buffer.GetModelName(), layer, reff->Name(), effectObj->GetStartTimeMS(), rb->curPeriod);
                                 reff->Render(effectObj, SettingsMap, *rb);
                             }
 
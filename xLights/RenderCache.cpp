@@ -17,22 +17,213 @@
 
 #include <wx/filename.h>
 #include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/process.h>
+#include <wx/utils.h>
 #include <functional>
+#include <memory>
+#include <set>
+#include <unordered_set>
+#include <zstd.h>
 #include "xLightsVersion.h"
 #include "UtilFunctions.h"
 #include "TraceLog.h"
 #include "ExternalHooks.h"
+#include "RenderHashIndex.h"
 
+// cache files are a header followed by each frame compressed on its own so any frame can be read back directly
+static const char RENDER_CACHE_MAGIC[4] = { 'X', 'L', 'R', 'C' };
+static const uint32_t RENDER_CACHE_VERSION = 2;
+static const int RENDER_CACHE_ZSTD_LEVEL = 1;
+static const size_t RENDER_CACHE_IO_SIZE = 256 * 1024;
 
-#ifdef __WXOSX__
-#include <sys/mman.h>
-#define USE_MMAP_RENDERCACHE
-#endif
+#pragma region Cache Files
 
+class RenderCacheReader
+{
+    wxFile& _file;
+    std::vector<uint8_t> _buffer;
+    size_t _pos = 0;
+
+public:
+    RenderCacheReader(wxFile& file) : _file(file) {}
+
+    bool Read(void* data, size_t len)
+    {
+        uint8_t* out = (uint8_t*)data;
+        size_t n = std::min(_buffer.size() - _pos, len);
+        if (n > 0) {
+            memcpy(out, _buffer.data() + _pos, n);
+            _pos += n;
+            out += n;
+            len -= n;
+        }
+        if (len == 0) return true;
+
+        if (len >= RENDER_CACHE_IO_SIZE) {
+            return _file.Read(out, len) == (ssize_t)len;
+        }
+        _buffer.resize(RENDER_CACHE_IO_SIZE);
+        ssize_t read = _file.Read(_buffer.data(), _buffer.size());
+        if (read == wxInvalidOffset || read < (ssize_t)len) {
+            _buffer.clear();
+            _pos = 0;
+            return false;
+        }
+        _buffer.resize(read);
+        memcpy(out, _buffer.data(), len);
+        _pos = len;
+        return true;
+    }
+    template<class T>
+    bool ReadValue(T& v)
+    {
+        return Read(&v, sizeof(v));
+    }
+    bool ReadString(std::string& s)
+    {
+        uint32_t len = 0;
+        if (!ReadValue(len) || len > 1024 * 1024) return false;
+        s.resize(len);
+        return len == 0 || Read(&s[0], len);
+    }
+};
+
+class RenderCacheWriter
+{
+    wxFile& _file;
+    std::vector<uint8_t> _buffer;
+    bool _ok = true;
 
+public:
+    RenderCacheWriter(wxFile& file) : _file(file) {}
+
+    void Write(const void* data, size_t len)
+    {
+        if (_buffer.size() + len > RENDER_CACHE_IO_SIZE) {
+            Flush();
+        }
+        if (len >= RENDER_CACHE_IO_SIZE) {
+            _ok = _ok && _file.Write(data, len) == len;
+            return;
+        }
+        _buffer.insert(_buffer.end(), (const uint8_t*)data, (const uint8_t*)data + len);
+    }
+    template<class T>
+    void WriteValue(T v)
+    {
+        Write(&v, sizeof(v));
+    }
+    void WriteString(const std::string& s)
+    {
+        WriteValue((uint32_t)s.size());
+        Write(s.data(), s.size());
+    }
+    bool Flush()
+    {
+        if (!_buffer.empty()) {
+            _ok = _ok && _file.Write(_buffer.data(), _buffer.size()) == _buffer.size();
+            _buffer.clear();
+        }
+        return _ok;
+    }
+};
+
+typedef std::map<std::string, std::pair<uint32_t, uint64_t>> RenderCacheModels;
+
+enum class RenderCacheHeader {
+    VALID,
+    OTHER_VERSION, // written by an older or newer xLights, it may still be using it
+    CORRUPT
+};
+
+static RenderCacheHeader ReadRenderCacheHeader(RenderCacheReader& reader, std::map<std::string, std::string>& properties, RenderCacheModels& models)
+{
+    char magic[sizeof(RENDER_CACHE_MAGIC)];
+    uint32_t version = 0;
+    if (!reader.Read(magic, sizeof(magic))) return RenderCacheHeader::CORRUPT;
+    // the original format had no magic, it started straight in with the properties
+    if (memcmp(magic, RENDER_CACHE_MAGIC, sizeof(magic)) != 0) return RenderCacheHeader::OTHER_VERSION;
+    if (!reader.ReadValue(version)) return RenderCacheHeader::CORRUPT;
+    if (version != RENDER_CACHE_VERSION) return RenderCacheHeader::OTHER_VERSION;
+
+    uint32_t count = 0;
+    if (!reader.ReadValue(count)) return RenderCacheHeader::CORRUPT;
+    for (uint32_t i = 0; i < count; i++) {
+        std::string key;
+        std::string value;
+        if (!reader.ReadString(key) || !reader.ReadString(value)) return RenderCacheHeader::CORRUPT;
+        properties[key] = value;
+    }
+
+    if (!reader.ReadValue(count)) return RenderCacheHeader::CORRUPT;
+    for (uint32_t i = 0; i < count; i++) {
+        std::string model;
+        uint32_t frames = 0;
+        uint64_t frameSize = 0;
+        if (!reader.ReadString(model) || !reader.ReadValue(frames) || !reader.ReadValue(frameSize)) return RenderCacheHeader::CORRUPT;
+        models[model] = { frames, frameSize };
+    }
+
+    // IsMatch needs all of these
+    for (const auto& p : { "Effect", "Element", "EffectLayer", "StartMS", "EndMS", "Frames", "Models" }) {
+        if (properties.find(p) == properties.end()) return RenderCacheHeader::CORRUPT;
+    }
+    return RenderCacheHeader::VALID;
+}
+
+static bool CompressFrame(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> ctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    thread_local std::vector<uint8_t> scratch;
+
+    scratch.resize(ZSTD_compressBound(size));
+    size_t len = ZSTD_compressCCtx(ctx.get(), scratch.data(), scratch.size(), data, size, RENDER_CACHE_ZSTD_LEVEL);
+    if (ZSTD_isError(len)) return false;
+    out.assign(scratch.begin(), scratch.begin() + len);
+    return true;
+}
+
+static bool DecompressFrame(const std::vector<uint8_t>& frame, uint8_t* data, size_t size)
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> ctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    return ZSTD_decompressDCtx(ctx.get(), data, size, frame.data(), frame.size()) == size;
+}
+
+#pragma endregion Cache Files
 
 #pragma region RenderCache
 
+// Each instance with a sequence open drops a marker file in its cache folder so other instances (including batch
+// render workers) leave the folder alone when trimming the cache. The name carries the host and process id so a
+// marker left behind by a crash can be spotted and cleaned up.
+static wxString GetInUseFile(const wxString& folder)
+{
+    return wxString::Format("%s%c%s.%lu.inuse", folder, wxFileName::GetPathSeparator(), wxGetHostName(), wxGetProcessId());
+}
+
+static bool IsFolderInUse(const wxString& folder)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxArrayString files;
+    GetAllFilesInDir(folder, files, "*.inuse");
+    bool inUse = false;
+    for (const auto& it : files) {
+        wxString name = wxFileName(it).GetName(); // host.pid
+        wxString host = name.BeforeLast('.');
+        unsigned long pid = 0;
+        if (host == wxGetHostName() && name.AfterLast('.').ToULong(&pid) && pid != wxGetProcessId() && !wxProcess::Exists(pid)) {
+            logger_base.debug("Removing stale render cache marker %s.", (const char*)it.c_str());
+            wxRemoveFile(it);
+        } else {
+            // another machine sharing the folder we cant check so assume it is still there
+            inUse = true;
+        }
+    }
+    return inUse;
+}
+
 class RenderCacheLoadThread : public wxThread
 {
 public:
@@ -54,32 +245,47 @@ private:
 
         wxString cacheFolder = _cache->GetCacheFolder();
 
-        wxDir dir(cacheFolder);
         wxArrayString files;
         GetAllFilesInDir(cacheFolder, files, "*.cache");
 
+        // The index lets us skip opening every file. It is removed while the sequence is open and written again
+        // when it is closed so if we crash it just gets rebuilt from the files.
+        RenderCacheIndex index;
+        wxString indexFile = cacheFolder + wxFileName::GetPathSeparator() + RenderCacheIndex::FILENAME;
+        bool indexed = false;
+        if (FileExists(indexFile)) {
+            indexed = index.Load(indexFile.ToStdString());
+            wxRemoveFile(indexFile);
+        }
+
+        int unindexed = 0;
         for (const auto& it : files) {
-            // allow up to 3 times physical memory
-            // This means the render cache will be swapped out ... but I think that is still better than re-rendering
-            // Abandon loading render cache if we use too much memory
-            if (IsExcessiveMemoryUsage(3.0)) {
-                logger_base.warn("Render cache loading abandoned due to too much memory use.");
-                break;
+            RenderCacheIndexEntry entry;
+            RenderCacheItem* rci = nullptr;
+            if (indexed && index.Get(wxFileName(it).GetFullName().ToStdString(), entry)) {
+                rci = new RenderCacheItem(_cache, it.ToStdString(), entry);
+            } else {
+                rci = new RenderCacheItem(_cache, it.ToStdString());
+                unindexed++;
             }
 
-            auto rci = new RenderCacheItem(_cache, it);
-            if (rci != nullptr && !rci->IsPurged()) {
+            if (!rci->IsPurged()) {
                 _cache->AddCacheItem(rci);
+            } else if (rci->IsOtherVersion()) {
+                // no use to us but another version of xLights sharing the folder may still want it
+                delete rci;
+                logger_base.debug("Skipping cache item %s from another version.", (const char*)it.c_str());
             } else {
-                if (rci != nullptr) {
-                    delete rci;
-                }
-                logger_base.warn("Failed to load cache item %s.", (const char*)it.c_str());
+                delete rci;
+                logger_base.warn("Failed to load cache item %s, removing it.", (const char*)it.c_str());
+                wxRemoveFile(it);
             }
         }
 
-        logger_base.debug("Cache contained %d files.", (int)files.size());
+        logger_base.debug("Cache contained %d files, %d were not in the index.", (int)files.size(), unindexed);
+        _cache->EnforceMaxSize();
         TraceLog::ClearTraceMessages();
+        _cache->LoadDone();
         return nullptr;
     }
 };
@@ -101,18 +307,32 @@ void RenderCache::LoadCache()
     if (IsEnabled())
     {
         wxASSERT(GetBitness() != "32bit");
+        _loading = true;
         new RenderCacheLoadThread(this);
     }
 }
 
+// called by the load thread while it still holds the load mutex
+void RenderCache::LoadDone()
+{
+    _loading = false;
+    _loadDone.notify_all();
+}
+
+void RenderCache::WaitForLoad()
+{
+    if (_loading) {
+        std::unique_lock<std::mutex> lock(_loadMutex);
+        _loadDone.wait(lock, [this] { return !_loading; });
+    }
+}
+
 void RenderCache::AddCacheItem(RenderCacheItem* rci)
 {
     if (rci != nullptr) {
         static log4cpp::Category& logger_rcache = log4cpp::Category::getInstance(std::string("log_rendercache"));
         logger_rcache.info("RenderCache item added " + rci->Description());
-        PerEffectCache *cache = GetPerEffectCache(rci->EffectName());
-        std::unique_lock<std::shared_mutex> lock(cache->lock);
-        cache->cache.push_back(rci);
+        _items.Add(rci);
     }
 }
 
@@ -133,6 +353,10 @@ void RenderCache::SetSequence(const std::string& path, const std::string& sequen
                 {
                     logger_base.debug("Render cache disabled but NOT removing folder %s as this is the 32 bt version.", (const char *)_cacheFolder.c_str());
                 }
+                else if (IsFolderInUse(_cacheFolder))
+                {
+                    logger_base.debug("Render cache disabled but NOT removing folder %s as it is open elsewhere.", (const char *)_cacheFolder.c_str());
+                }
                 else
                 {
                     logger_base.debug("Render cache disabled so removing folder %s.", (const char *)_cacheFolder.c_str());
@@ -164,21 +388,19 @@ void RenderCache::SetSequence(const std::string& path, const std::string& sequen
             logger_base.debug("Opening render cache folder %s.", (const char *)_cacheFolder.c_str());
         }
 
+        wxFile inUse;
+        if (!inUse.Create(GetInUseFile(_cacheFolder), true)) {
+            logger_base.warn("Unable to create render cache marker in %s.", (const char *)_cacheFolder.c_str());
+        }
+
         LoadCache();
     }
 }
 
 void RenderCache::RemoveItem(RenderCacheItem *item) {
     static log4cpp::Category& logger_rcache = log4cpp::Category::getInstance(std::string("log_rendercache"));
-    PerEffectCache *c = GetPerEffectCache(item->EffectName());
-    std::unique_lock<std::shared_mutex> lock(c->lock);
-    auto &l = c->cache;
-    for (auto it = l.begin(); it != l.end(); ++it) {
-        if (item == *it) {
-            logger_rcache.info("RenderCache item removed " + (*it)->Description());
-            l.erase(it);
-            break;
-        }
+    if (_items.Remove(item)) {
+        logger_rcache.info("RenderCache item removed " + item->Description());
     }
     delete item;
 }
@@ -221,14 +443,109 @@ bool RenderCache::IsEffectOkForCaching(Effect* effect) const
 
     return true;
 }
-RenderCache::PerEffectCache* RenderCache::GetPerEffectCache(const std::string &s) {
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    PerEffectCache *r = _cache[s];
-    if (r == nullptr) {
-        r = new PerEffectCache();
-        _cache[s] = r;
+
+RenderCache::ItemTable::ItemTable()
+{
+    Clear();
+}
+
+void RenderCache::ItemTable::Insert(Table* table, RenderCacheItem* item)
+{
+    size_t i = item->GetKey() & table->mask;
+    while (table->slots[i].key.load(std::memory_order_relaxed) != 0) {
+        i = (i + 1) & table->mask;
     }
-    return r;
+    // item first so a reader that sees the key sees the item
+    table->slots[i].item.store(item, std::memory_order_relaxed);
+    table->slots[i].key.store(item->GetKey(), std::memory_order_release);
+    table->used++;
+}
+
+void RenderCache::ItemTable::Add(RenderCacheItem* item)
+{
+    std::unique_lock<std::mutex> lock(_writeLock);
+    Table* table = _table.load();
+    if ((table->used + 1) * 2 > table->mask + 1) {
+        // size for what is still in there ... taken items leave their slot behind
+        size_t live = 0;
+        for (size_t i = 0; i <= table->mask; i++) {
+            if (table->slots[i].item.load() != nullptr) live++;
+        }
+        size_t size = 16;
+        while (size < (live + 1) * 4) {
+            size *= 2;
+        }
+        auto grown = std::make_unique<Table>(size);
+        for (size_t i = 0; i <= table->mask; i++) {
+            // take it so a reader still on the old table cant also get it
+            RenderCacheItem* it = table->slots[i].item.exchange(nullptr);
+            if (it != nullptr) {
+                Insert(grown.get(), it);
+            }
+        }
+        table = grown.get();
+        _tables.push_back(std::move(grown));
+        _table.store(table, std::memory_order_release);
+    }
+    Insert(table, item);
+}
+
+RenderCacheItem* RenderCache::ItemTable::Take(uint64_t key)
+{
+    Table* table = _table.load(std::memory_order_acquire);
+    size_t i = key & table->mask;
+    for (size_t n = 0; n <= table->mask; n++) {
+        Slot& slot = table->slots[i];
+        uint64_t k = slot.key.load(std::memory_order_acquire);
+        if (k == 0) break;
+        if (k == key) {
+            RenderCacheItem* item = slot.item.load(std::memory_order_acquire);
+            if (item != nullptr && slot.item.compare_exchange_strong(item, nullptr)) {
+                return item;
+            }
+        }
+        i = (i + 1) & table->mask;
+    }
+    return nullptr;
+}
+
+bool RenderCache::ItemTable::Remove(RenderCacheItem* item)
+{
+    std::unique_lock<std::mutex> lock(_writeLock);
+    Table* table = _table.load();
+    size_t i = item->GetKey() & table->mask;
+    for (size_t n = 0; n <= table->mask; n++) {
+        Slot& slot = table->slots[i];
+        if (slot.key.load() == 0) break;
+        RenderCacheItem* expected = item;
+        if (slot.item.compare_exchange_strong(expected, nullptr)) {
+            return true;
+        }
+        i = (i + 1) & table->mask;
+    }
+    return false;
+}
+
+std::vector<RenderCacheItem*> RenderCache::ItemTable::GetItems()
+{
+    std::unique_lock<std::mutex> lock(_writeLock);
+    std::vector<RenderCacheItem*> res;
+    Table* table = _table.load();
+    for (size_t i = 0; i <= table->mask; i++) {
+        RenderCacheItem* item = table->slots[i].item.load();
+        if (item != nullptr) {
+            res.push_back(item);
+        }
+    }
+    return res;
+}
+
+void RenderCache::ItemTable::Clear()
+{
+    std::unique_lock<std::mutex> lock(_writeLock);
+    _tables.clear();
+    _tables.push_back(std::make_unique<Table>(16));
+    _table.store(_tables.back().get());
 }
 
 RenderCacheItem* RenderCache::GetItem(Effect* effect, RenderBuffer* buffer)
@@ -239,23 +556,12 @@ RenderCacheItem* RenderCache::GetItem(Effect* effect, RenderBuffer* buffer)
 
     if (!IsEffectOkForCaching(effect)) return nullptr;
 
-    {
-        // wait for the cache to finish loading
-        std::unique_lock<std::mutex> lock(_loadMutex);
-    }
+    WaitForLoad();
 
-    PerEffectCache *cache = GetPerEffectCache(effect->GetEffectName());
-    std::shared_lock<std::shared_mutex> lock(cache->lock);
-    auto &l = cache->cache;
-    for (auto it = l.begin(); it != l.end(); ++it) {
-        if ((*it)->IsMatch(effect, buffer)) {
-            RenderCacheItem *item = *it;
-            //release the readlock
-            lock.unlock();
-            
-            //grab the write lock
-            std::unique_lock<std::shared_mutex> ulock(cache->lock);
-            l.erase(it);
+    RenderCacheItem* item = _items.Take(RenderCacheItem::GetKey(effect));
+    if (item != nullptr) {
+        // the key covers everything bar the buffer size so this only fails if the model changed size
+        if (item->IsMatch(effect, buffer)) {
             logger_rcache.info("RenderCache GetItem found an existing render cache item for effect %s on model %s on layer %d at start time %dms.",
                 (const char*)effect->GetEffectName().c_str(),
                 (const char*)buffer->GetModelName().c_str(),
@@ -263,8 +569,8 @@ RenderCacheItem* RenderCache::GetItem(Effect* effect, RenderBuffer* buffer)
                 effect->GetStartTimeMS());
             return item;
         }
+        _items.Add(item);
     }
-    lock.unlock();
 
     logger_rcache.info("RenderCache GetItem created a new render cache item for effect %s on model %s on layer %d at start time %dms.",
         (const char*)effect->GetEffectName().c_str(),
@@ -283,22 +589,20 @@ void RenderCache::Close()
 
     logger_base.debug("Closing render cache folder %s.", (const char *)_cacheFolder.c_str());
 
-    {
-        // wait for the cache to finish loading
-        std::unique_lock<std::mutex> lock(_loadMutex);
-    }
+    WaitForLoad();
 
     logger_base.debug("    Got lock.");
 
+    EnforceMaxSize();
     Purge(nullptr, false);
-    _cacheFolder = "";
-
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    for (auto &a : _cache) {
-        delete a.second;
-        a.second = nullptr;
+    SaveIndex();
+    _index.Clear();
+    {
+        wxLogNull logNo; //kludge: avoid user error messahe
+        wxRemoveFile(GetInUseFile(_cacheFolder));
     }
-    _cache.clear();
+    _cacheFolder = "";
+    _items.Clear();
     logger_base.debug("    Closed.");
 }
 
@@ -346,9 +650,10 @@ static void purgeCache(Element *em, bool del) {
     });
 }
 
-static bool findMatch(Element *em, RenderCacheItem* item) {
-    return doOnEffects(em, [item] (Effect* e) {
-        return item->IsMatch(e, nullptr);
+static void getKeys(Element *em, std::unordered_set<uint64_t>& keys) {
+    doOnEffects(em, [&keys] (Effect* e) {
+        keys.insert(RenderCacheItem::GetKey(e));
+        return false;
     });
 }
 
@@ -362,30 +667,15 @@ void RenderCache::CleanupCache(SequenceElements* sequenceElements)
     // Because effects are removed from the cache then if you go from cache enabled to cache disabled this wont actually
     // clean out all the cache items ... as we dont know about them.
     int deleted = 0;
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    for (auto &l : _cache) {
-        if (l.second != nullptr) {
-            std::unique_lock<std::shared_mutex> ulock(l.second->lock);
-            auto it = l.second->cache.begin();
-            while (it != l.second->cache.end()) {
-                bool found = false;
-
-                for (int i = 0; i < sequenceElements->GetElementCount() && !found; i++) {
-                    Element* em = sequenceElements->GetElement(i);
-                    found = findMatch(em, *it);
-                }
-
-                if (!found) {
-                    auto todelete = it;
-                    ++it;
-                    ulock.unlock();
-                    (*todelete)->Delete();
-                    ulock.lock();
-                    deleted++;
-                } else {
-                    ++it;
-                }
-            }
+    std::unordered_set<uint64_t> keys;
+    for (int i = 0; i < sequenceElements->GetElementCount(); i++) {
+        Element* em = sequenceElements->GetElement(i);
+        getKeys(em, keys);
+    }
+    for (auto item : _items.GetItems()) {
+        if (keys.find(item->GetKey()) == keys.end() && _items.Remove(item)) {
+            item->Delete();
+            deleted++;
         }
     }
     logger_base.debug("    Cleaned up %d items in the cache.", deleted);
@@ -407,23 +697,13 @@ void RenderCache::Purge(SequenceElements* sequenceElements, bool dodelete)
         logger_base.debug("Purging render cache folder %s.", (const char *)_cacheFolder.c_str());
     }
 
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    for (auto &it : _cache) {
-        if (it.second != nullptr) {
-            auto& l = it.second;
-            std::unique_lock<std::shared_mutex> ulock(l->lock);
-            while (l->cache.size() > 0) {
-                auto frnt = l->cache.front();
-                if (dodelete) {
-                    ulock.unlock();
-                    frnt->Delete();
-                    ulock.lock();
-                } else {
-                    frnt->Save();
-                    delete frnt;
-                    l->cache.pop_front();
-                }
-            }
+    for (auto item : _items.GetItems()) {
+        if (!_items.Remove(item)) continue;
+        if (dodelete) {
+            item->Delete();
+        } else {
+            item->Save();
+            delete item;
         }
     }
 
@@ -434,12 +714,154 @@ void RenderCache::Purge(SequenceElements* sequenceElements, bool dodelete)
         }
     }
 }
-bool RenderCache::UseMMap() const {
-#ifdef USE_MMAP_RENDERCACHE
-    return true;
-#else
-    return false;
-#endif
+// the index is keyed on the file name within the cache folder ... anything else belongs to a sequence which has
+// since been closed
+static std::string GetIndexKey(const std::string& cacheFolder, const std::string& cacheFile)
+{
+    if (cacheFolder == "" || cacheFile.size() <= cacheFolder.size() + 1 || cacheFile.compare(0, cacheFolder.size(), cacheFolder) != 0) {
+        return "";
+    }
+    return cacheFile.substr(cacheFolder.size() + 1);
+}
+
+void RenderCache::UpdateIndex(const RenderCacheIndexEntry& entry, const std::string& cacheFile)
+{
+    std::string key = GetIndexKey(_cacheFolder, cacheFile);
+    if (key == "") return;
+
+    RenderCacheIndexEntry e = entry;
+    e.file = key;
+    _index.Set(e);
+}
+
+void RenderCache::RemoveFromIndex(const std::string& cacheFile)
+{
+    std::string key = GetIndexKey(_cacheFolder, cacheFile);
+    if (key != "") {
+        _index.Remove(key);
+    }
+}
+
+void RenderCache::TouchIndex(const std::string& cacheFile)
+{
+    std::string key = GetIndexKey(_cacheFolder, cacheFile);
+    if (key != "") {
+        _index.Touch(key, wxDateTime::Now().GetTicks());
+    }
+}
+
+bool RenderCache::GetIndexEntry(const std::string& cacheFile, RenderCacheIndexEntry& entry) const
+{
+    std::string key = GetIndexKey(_cacheFolder, cacheFile);
+    return key != "" && _index.Get(key, entry);
+}
+
+void RenderCache::SaveIndex()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_cacheFolder == "" || !wxDir::Exists(_cacheFolder)) return;
+
+    wxString indexFile = _cacheFolder + wxFileName::GetPathSeparator() + RenderCacheIndex::FILENAME;
+    if (_index.IsEmpty()) {
+        if (FileExists(indexFile)) {
+            wxRemoveFile(indexFile);
+        }
+    } else if (!_index.Save(indexFile.ToStdString())) {
+        logger_base.warn("Unable to save render cache index %s.", (const char*)indexFile.c_str());
+    }
+}
+
+void RenderCache::EnforceMaxSize()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_maxSize == 0 || _cacheFolder == "") return;
+
+    struct Evictable {
+        RenderCacheItem* item = nullptr; // an item of this sequence
+        std::string folder;              // or a file in another sequence's folder
+        std::string file;                // or if blank the whole folder
+    };
+    std::vector<RenderCacheEvictionCandidate> candidates;
+    std::vector<Evictable> evictables;
+    uint64_t total = _index.GetBytes();
+
+    // every item of this sequence still in the table is a candidate ... when this runs after loading that is all
+    // of them as no effect has picked any up yet
+    for (auto item : _items.GetItems()) {
+        RenderCacheIndexEntry entry;
+        if (GetIndexEntry(item->Description(), entry)) {
+            candidates.push_back({ entry.lastUsed, entry.bytes });
+            evictables.push_back({ item, "", "" });
+        }
+    }
+
+    // and anything belonging to the other sequences
+    wxFileName cf = wxFileName::DirName(_cacheFolder);
+    wxString current = cf.GetDirs().Last();
+    cf.RemoveLastDir();
+    wxString root = cf.GetPath();
+    std::map<std::string, std::unique_ptr<RenderCacheIndex>> others;
+
+    wxDir dir(root);
+    wxString name;
+    bool cont = dir.IsOpened() && dir.GetFirst(&name, wxEmptyString, wxDIR_DIRS);
+    while (cont) {
+        std::string folder = (root + wxFileName::GetPathSeparator() + name).ToStdString();
+        if (name != current && IsFolderInUse(folder)) {
+            logger_base.debug("Render cache %s is open elsewhere so it is left alone.", (const char*)folder.c_str());
+        } else if (name != current) {
+            wxString indexFile = folder + wxFileName::GetPathSeparator() + RenderCacheIndex::FILENAME;
+            auto index = std::make_unique<RenderCacheIndex>();
+            if (FileExists(indexFile) && index->Load(indexFile.ToStdString())) {
+                total += index->GetBytes();
+                for (const auto& e : index->GetEntries()) {
+                    candidates.push_back({ e.lastUsed, e.bytes });
+                    evictables.push_back({ nullptr, folder, e.file });
+                }
+                others[folder] = std::move(index);
+            } else {
+                // from before there was an index or left by a crash so we can only treat it as a whole
+                uint64_t bytes = wxDir::GetTotalSize(folder).GetValue();
+                total += bytes;
+                candidates.push_back({ wxFileName::DirName(folder).GetModificationTime().GetTicks(), bytes });
+                evictables.push_back({ nullptr, folder, "" });
+            }
+        }
+        cont = dir.GetNext(&name);
+    }
+
+    auto evict = RenderCacheIndex::SelectEvictions(candidates, total, _maxSize);
+    if (evict.empty()) return;
+
+    logger_base.debug("Render cache is %lluMB which is over the %lluMB limit. Removing %d least recently used items.",
+        (unsigned long long)(total / (1024 * 1024)), (unsigned long long)(_maxSize / (1024 * 1024)), (int)evict.size());
+
+    wxLogNull logNo; //kludge: avoid user error messahe
+    std::set<std::string> changed;
+    for (const auto i : evict) {
+        const auto& e = evictables[i];
+        if (e.item != nullptr) {
+            if (_items.Remove(e.item)) {
+                e.item->Delete();
+            }
+        } else if (e.file == "") {
+            wxDir::Remove(e.folder, wxPATH_RMDIR_RECURSIVE);
+        } else {
+            wxRemoveFile(e.folder + wxFileName::GetPathSeparator() + e.file);
+            others[e.folder]->Remove(e.file);
+            changed.insert(e.folder);
+        }
+    }
+    for (const auto& it : changed) {
+        wxString indexFile = it + wxFileName::GetPathSeparator() + RenderCacheIndex::FILENAME;
+        if (others[it]->IsEmpty()) {
+            wxRemoveFile(indexFile);
+        } else {
+            others[it]->Save(indexFile.ToStdString());
+        }
+    }
 }
 
 
@@ -455,22 +877,10 @@ void RenderCacheItem::PurgeFrames()
 {
     _purged = true;
     for (auto& it : _frames) {
-        for (int x = it.second.size() - 1; x >= 0; --x) {
-            if (it.second[x] != nullptr) {
-                if (!_mmap) {
-                    free(it.second[x]);
-                }
-                it.second[x] = nullptr;
-            }
+        for (auto& f : it.second) {
+            std::vector<uint8_t>().swap(f);
         }
     }
-#ifdef USE_MMAP_RENDERCACHE
-    if (_mmap) {
-        munmap(_mmap, _mmapSize);
-        _mmap = nullptr;
-        _mmapSize = 0;
-    }
-#endif
 }
 
 std::string RenderCacheItem::GetModelName(RenderBuffer* buffer)
@@ -489,12 +899,53 @@ std::string RenderCacheItem::GetModelName(RenderBuffer* buffer)
     }
 }
 
+// The properties are combined in any order as the item has the settings and palette merged in one map. Frames
+// and Models are left out as they describe what is cached rather than the effect.
+static uint64_t GetKeyPart(const std::string& name, const std::string& value)
+{
+    return RenderHashIndex::Mix(RenderHashIndex::Hash(name), RenderHashIndex::Hash(value));
+}
+
+static uint64_t FinishKey(uint64_t parts)
+{
+    // 0 marks an empty slot in the item table
+    uint64_t key = RenderHashIndex::Mix(RenderHashIndex::HASH_SEED, parts);
+    return key == 0 ? 1 : key;
+}
+
+uint64_t RenderCacheItem::GetKey(Effect* effect)
+{
+    EffectLayer* el = effect->GetParentEffectLayer();
+    uint64_t parts = GetKeyPart("Effect", effect->GetEffectName()) +
+                     GetKeyPart("Element", el->GetParentElement()->GetFullName()) +
+                     GetKeyPart("EffectLayer", std::to_string(el->GetLayerNumber())) +
+                     GetKeyPart("StartMS", std::to_string(effect->GetStartTimeMS())) +
+                     GetKeyPart("EndMS", std::to_string(effect->GetEndTimeMS()));
+    for (const auto& it : effect->GetSettings()) {
+        parts += GetKeyPart(it.first, it.second);
+    }
+    for (const auto& it : effect->GetPaletteMap()) {
+        parts += GetKeyPart(it.first, it.second);
+    }
+    return FinishKey(parts);
+}
+
+void RenderCacheItem::UpdateKey()
+{
+    uint64_t parts = 0;
+    for (const auto& it : _properties) {
+        if (it.first != "Frames" && it.first != "Models") {
+            parts += GetKeyPart(it.first, it.second);
+        }
+    }
+    _key = FinishKey(parts);
+}
+
 RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer) : _renderCache(renderCache)
 {
-    _mmap = nullptr;
-    _mmapSize = 0;
     _purged = false;
     _dirty = true;
+    _loaded = true;
     std::string mname = GetModelName(buffer);
     wxASSERT(mname != "");
     _frameSize[mname] = sizeof(xlColor) * buffer->GetPixelCount();
@@ -527,6 +978,7 @@ RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, Rende
     {
         _properties[it.first] = it.second;
     }
+    UpdateKey();
 }
 
 bool RenderCacheItem::IsMatch(Effect* effect, RenderBuffer* buffer)
@@ -605,6 +1057,7 @@ void RenderCacheItem::Delete()
             logger_base.warn("Unable to remove cache file " + _cacheFile);
         } else {
             logger_rcache.info("RenderCache removed file " + _cacheFile);
+            _renderCache->RemoveFromIndex(_cacheFile);
         }
     }
     PurgeFrames();
@@ -627,10 +1080,6 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
     if (_purged) {
         return;
     }
-    if (_mmap) {
-        // need to undo the mmap so we can append frames
-        unmmap();
-    }
     // allow up to 3 times physical memory
     // This means the render cache will be swapped out ... but I think that is still better than re-rendering
     if (IsExcessiveMemoryUsage(3.0)) {
@@ -662,38 +1111,24 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
         return;
     }
 
-    if (_frames.find(mname) == _frames.end()) {
-        std::vector<unsigned char *> n;
-        _frames[mname] = n;
-    }
-
-    if (frame >= _frames.at(mname).size()) {
+    auto& modelFrames = _frames[mname];
+    if (frame >= modelFrames.size()) {
         int maxframe = std::max(frame+1,buffer->curEffEndPer - buffer->curEffStartPer + 1);
-        _frames.at(mname).resize(maxframe);
+        modelFrames.resize(maxframe);
     }
 
-    unsigned char* frameBuffer = (unsigned char *)malloc(_frameSize.at(mname));
-    if (frameBuffer == nullptr) {
-        logger_base.warn("RenderCacheItem::AddFrame failed to allocate frameBuffer.");
+    if (!CompressFrame((const uint8_t*)buffer->GetPixels(), _frameSize.at(mname), modelFrames[frame])) {
+        logger_base.warn("RenderCacheItem::AddFrame failed to compress frame.");
         PurgeFrames();
-        wxASSERT(false);
         return;
     }
-    memcpy(frameBuffer, buffer->GetPixels(), _frameSize.at(mname));
-
-    if (_frames.at(mname)[frame] != nullptr) {
-        free(_frames.at(mname)[frame]);
-        _frames.at(mname)[frame] = nullptr;
-    }
-
-    _frames.at(mname)[frame] = frameBuffer;
     _dirty = true;
 
     if (buffer->curPeriod == buffer->curEffEndPer) {
-        // if multi models in this cache then only call save when none of them have null pointers at the end
+        // if multi models in this cache then only call save when none of them have missing frames at the end
         for (const auto& itm : _frames) {
-            if (itm.second.size() == 0 || itm.second.back() == nullptr) {
-                //logger_base.warn("RenderCacheItem::AddFrame save abandoned due to null frame.");
+            if (itm.second.size() == 0 || itm.second.back().empty()) {
+                //logger_base.warn("RenderCacheItem::AddFrame save abandoned due to missing frame.");
                 return;
             }
         }
@@ -704,50 +1139,62 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
 bool RenderCacheItem::GetFrame(RenderBuffer* buffer)
 {
     static log4cpp::Category& logger_rcache = log4cpp::Category::getInstance(std::string("log_rendercache"));
+    if (!_loaded) {
+        Load();
+    }
+
     std::string mname = GetModelName(buffer);
-    if (_frameSize.find(mname) == _frameSize.end()) {
+    auto it = _frames.find(mname);
+    if (it == _frames.end() || _frameSize.find(mname) == _frameSize.end()) {
         logger_rcache.info("RenderCache::GetFrame on model " + mname + " failed due to number of frames difference.");
         return false;
     }
 
-    auto modelFrames = _frames[mname];
+    const auto& modelFrames = it->second;
     if (_frameSize.at(mname) != (sizeof(xlColor) * buffer->GetPixelCount())) {
         logger_rcache.info("RenderCache::GetFrame on model " + mname + " failed due to frame size difference.");
         return false;
     }
 
     int frame = buffer->curPeriod - buffer->curEffStartPer;
-    if (frame < modelFrames.size() && modelFrames[frame]) {
-        // its in memory ... read it from there
-        unsigned char* pc = modelFrames[frame];
-        memcpy(buffer->GetPixels(), pc, _frameSize.at(mname));
-        return true;
+    if (frame < modelFrames.size() && !modelFrames[frame].empty()) {
+        if (DecompressFrame(modelFrames[frame], (uint8_t*)buffer->GetPixels(), _frameSize.at(mname))) {
+            return true;
+        }
+        logger_rcache.info("RenderCache::GetFrame %d on model %s failed to decompress.", frame, (const char*)mname.c_str());
+        return false;
     }
 
     logger_rcache.info("RenderCache::GetFrame %d on model %s failed due to fall through.", frame, (const char*)mname.c_str());
     return false;
 }
 
+RenderCacheIndexEntry RenderCacheItem::MakeIndexEntry(uint64_t bytes, int64_t lastUsed) const
+{
+    RenderCacheIndexEntry entry;
+    entry.bytes = bytes;
+    entry.lastUsed = lastUsed;
+    entry.properties = _properties;
+    for (const auto& it : _frames) {
+        entry.models[it.first] = { (uint32_t)it.second.size(), (uint64_t)_frameSize.at(it.first) };
+    }
+    return entry;
+}
+
 void RenderCacheItem::Save()
 {
     if (_purged) return;
     if (!_dirty) return;
-    
-    if (_mmap) {
-        return;
-    }
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     //logger_base.debug("Saving render cache file %s.", (const char *)_cacheFile.c_str());
 
-    char zero = 0x00;
-
     // check all the data is there
     for (const auto& itm : _frames) {
         for (const auto& it : itm.second) {
             // we are missing data
             //wxASSERT(false);
-            if (it == nullptr) return;
+            if (it.empty()) return;
         }
     }
 
@@ -755,40 +1202,44 @@ void RenderCacheItem::Save()
 
     if (file.Create(_cacheFile, true)) {
         _properties["Models"] = wxString::Format("%d", (int)_frames.size());
+
+        RenderCacheWriter writer(file);
+        writer.Write(RENDER_CACHE_MAGIC, sizeof(RENDER_CACHE_MAGIC));
+        writer.WriteValue(RENDER_CACHE_VERSION);
+
         // write the header fields
+        writer.WriteValue((uint32_t)_properties.size());
         for (const auto& it : _properties) {
-            file.Write(it.first);
-            file.Write(&zero, 1);
-            file.Write(it.second);
-            file.Write(&zero, 1);
+            writer.WriteString(it.first);
+            writer.WriteString(it.second);
         }
-
-        file.Write("RC_HEADEREND");
-        file.Write(&zero, 1);
-
+        writer.WriteValue((uint32_t)_frames.size());
         for (const auto& it : _frames) {
-            file.Write(it.first);
-            file.Write(&zero, 1);
-            file.Write(wxString::Format("%d", (int)it.second.size()));
-            file.Write(&zero, 1);
-            file.Write(wxString::Format("%ld", _frameSize.at(it.first)));
-            file.Write(&zero, 1);
-        }
-        _firstFrameOffset = file.Tell();
-        
+            writer.WriteString(it.first);
+            writer.WriteValue((uint32_t)it.second.size());
+            writer.WriteValue((uint64_t)_frameSize.at(it.first));
+        }
+
         // write the frames
         for (const auto& itm : _frames) {
             for (const auto& it : itm.second) {
-                wxASSERT(it != nullptr);
-                if (it != nullptr) {
-                    file.Write(it, _frameSize.at(itm.first));
-                }
+                writer.WriteValue((uint32_t)it.size());
+                writer.Write(it.data(), it.size());
             }
         }
 
+        bool ok = writer.Flush();
+        uint64_t bytes = file.Tell();
         file.Close();
-        
-        remmap();
+
+        if (ok) {
+            _dirty = false;
+            _renderCache->UpdateIndex(MakeIndexEntry(bytes, wxDateTime::Now().GetTicks()), _cacheFile);
+        } else {
+            logger_base.warn("    Failed to write file.");
+            wxRemoveFile(_cacheFile);
+            _renderCache->RemoveFromIndex(_cacheFile);
+        }
     } else {
         logger_base.warn("    Failed to create file.");
     }
@@ -798,149 +1249,126 @@ bool RenderCacheItem::IsDone(RenderBuffer* buffer) const
 {
     int frame = buffer->curPeriod - buffer->curEffStartPer;
     std::string mname = GetModelName(buffer);
-    auto modelFrames = _frames.at(mname);
-    return modelFrames[frame];
+    const auto& modelFrames = _frames.at(mname);
+    return !modelFrames[frame].empty();
 }
 
+// only reads the header ... the frames are read when first needed
 RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const std::string& filename) : _renderCache(renderCache)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
-    _mmap = nullptr;
-    _mmapSize = 0;
     _cacheFile = filename;
     wxFileName fn(_cacheFile);
     _effectName = fn.GetName();
     int idx = _effectName.find('_');
     _effectName = _effectName.substr(0, idx);
-    _purged = false;
+    _purged = true;
     _dirty = false;
+    _loaded = false;
 
     wxFile file;
 
     if (file.Open(_cacheFile)) {
-        char headerBuffer[8192];
-        memset(headerBuffer, 0x00, sizeof(headerBuffer));
-        file.Read(headerBuffer, sizeof(headerBuffer));
-
-        char* ps = headerBuffer;
-
-        while (strcmp(ps, "RC_HEADEREND") != 0) {
-            std::string key(ps);
-            ps += strlen(ps) + 1;
-            std::string value(ps);
-            ps += strlen(ps) + 1;
-
-            if (key == "") {
-                // file looks corrupt
-                logger_base.debug("Cache file %s appears corrupt.", (const char*)filename.c_str());
-                _purged = true;
-                return;
-            } else {
-                _properties[key] = value;
-            }
+        RenderCacheReader reader(file);
+        RenderCacheModels models;
+        switch (ReadRenderCacheHeader(reader, _properties, models)) {
+        case RenderCacheHeader::VALID:
+            break;
+        case RenderCacheHeader::OTHER_VERSION:
+            _otherVersion = true;
+            logger_base.debug("Cache file %s is from another version of xLights.", (const char*)filename.c_str());
+            return;
+        case RenderCacheHeader::CORRUPT:
+            logger_base.debug("Cache file %s appears corrupt.", (const char*)filename.c_str());
+            return;
         }
-        ps += strlen(ps) + 1;
-
-        int models = wxAtoi(_properties["Models"]);
-
-        for (int i = 0; i < models; i++) {
-            std::string model(ps);
-            ps += strlen(ps) + 1;
-            std::string frames(ps);
-            ps += strlen(ps) + 1;
-            int fs = wxAtoi(frames);
-            std::string frameSize(ps);
-            ps += strlen(ps) + 1;
-            long fsz = wxAtol(frameSize);
-
-            std::vector<unsigned char *> n;
-            _frames[model] = n;
-            _frames.at(model).resize(fs);
-            _frameSize[model] = fsz;
-        }
-
-        _firstFrameOffset = ps - headerBuffer;
-#ifdef USE_MMAP_RENDERCACHE
-        if (renderCache->UseMMap()) {
-            file.Seek(0);
-            _mmapSize = file.Length();
-            _mmap = (uint8_t*)mmap(nullptr, _mmapSize, PROT_READ, MAP_PRIVATE, file.fd(), 0);
-            
-            size_t cur = _firstFrameOffset;
-            for (auto& itm : _frames) {
-                for (int i = 0; i < itm.second.size(); i++) {
-                    itm.second[i] = &_mmap[cur];
-                    cur += _frameSize.at(itm.first);
-                }
-            }
-        } else
-#endif
-        {
-            file.Seek(_firstFrameOffset);
-            for (auto& itm : _frames) {
-                for (int i = 0; i < itm.second.size(); i++) {
-                    uint8_t* frameBuffer = (uint8_t *)malloc(_frameSize.at(itm.first));
-                    
-                    if (frameBuffer == nullptr) {
-                        file.Close();
-                        PurgeFrames();
-                        logger_base.debug("Render Cache Item file %s fails due to memory allocation issue.", (const char*)filename.c_str());
-                        return;
-                    }
-                    
-                    file.Read(frameBuffer, _frameSize.at(itm.first));
-                    itm.second[i] = frameBuffer;
-                }
-            }
+
+        for (const auto& it : models) {
+            _frames[it.first].resize(it.second.first);
+            _frameSize[it.first] = (long)it.second.second;
         }
+        _purged = false;
+        UpdateKey();
+
+        renderCache->UpdateIndex(MakeIndexEntry(file.Length(), fn.GetModificationTime().GetTicks()), _cacheFile);
         file.Close();
     }
 }
 
-void RenderCacheItem::unmmap() {
-#ifdef USE_MMAP_RENDERCACHE
-    if (_mmap) {
-        for (auto& it : _frames) {
-            for (int x = it.second.size() - 1; x >= 0; --x) {
-                if (it.second[x]) {
-                    uint8_t* frameBuffer = (uint8_t *)malloc(_frameSize.at(it.first));
-                    memcpy(frameBuffer, it.second[x], _frameSize.at(it.first));
-                    it.second[x] = frameBuffer;
-                }
-            }
-        }
-        munmap(_mmap, _mmapSize);
-        _mmap = nullptr;
-        _mmapSize = 0;
+RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const std::string& filename, const RenderCacheIndexEntry& entry) : _renderCache(renderCache)
+{
+    _cacheFile = filename;
+    wxFileName fn(_cacheFile);
+    _effectName = fn.GetName();
+    int idx = _effectName.find('_');
+    _effectName = _effectName.substr(0, idx);
+    _purged = false;
+    _dirty = false;
+    _loaded = false;
+    _properties = entry.properties;
+
+    for (const auto& it : entry.models) {
+        _frames[it.first].resize(it.second.first);
+        _frameSize[it.first] = (long)it.second.second;
     }
-#endif
+    UpdateKey();
+
+    renderCache->UpdateIndex(entry, _cacheFile);
 }
-void RenderCacheItem::remmap() {
-#ifdef USE_MMAP_RENDERCACHE
-    if (_mmap) return;
-    if (!_renderCache->UseMMap()) return;
+
+void RenderCacheItem::Load()
+{
+    static log4cpp::Category& logger_rcache = log4cpp::Category::getInstance(std::string("log_rendercache"));
+
+    // whatever happens we only try once, anything we dont get just gets rendered
+    _loaded = true;
+    _renderCache->TouchIndex(_cacheFile);
 
     wxFile file;
-    if (file.Open(_cacheFile)) {
-        file.Seek(0);
-        _mmapSize = file.Length();
-        _mmap = (uint8_t*)mmap(nullptr, _mmapSize, PROT_READ, MAP_PRIVATE, file.fd(), 0);
-        
-        size_t cur = _firstFrameOffset;
-        for (auto& itm : _frames) {
-            for (int i = 0; i < itm.second.size(); i++) {
-                if (itm.second[i]) {
-                    free(itm.second[i]);
-                    itm.second[i] = nullptr;
-                }
-                itm.second[i] = &_mmap[cur];
-                cur += _frameSize.at(itm.first);
+    if (!file.Open(_cacheFile)) {
+        logger_rcache.info("RenderCache unable to open " + _cacheFile);
+        return;
+    }
+
+    RenderCacheReader reader(file);
+    std::map<std::string, std::string> properties;
+    RenderCacheModels models;
+    bool ok = ReadRenderCacheHeader(reader, properties, models) == RenderCacheHeader::VALID && properties == _properties && models.size() == _frames.size();
+    for (const auto& it : models) {
+        ok = ok && _frames.find(it.first) != _frames.end() && _frames.at(it.first).size() == it.second.first && _frameSize.at(it.first) == (long)it.second.second;
+    }
+    if (!ok) {
+        logger_rcache.info("RenderCache file " + _cacheFile + " does not match the index.");
+        return;
+    }
+
+    for (auto& itm : _frames) {
+        size_t maxSize = ZSTD_compressBound(_frameSize.at(itm.first));
+        for (auto& it : itm.second) {
+            uint32_t len = 0;
+            if (!reader.ReadValue(len) || len > maxSize) {
+                ok = false;
+                break;
+            }
+            it.resize(len);
+            if (!reader.Read(it.data(), len)) {
+                ok = false;
+                break;
             }
         }
+        if (!ok) break;
     }
-#endif
-}
+    file.Close();
 
+    if (!ok) {
+        logger_rcache.info("RenderCache file " + _cacheFile + " is truncated.");
+        for (auto& it : _frames) {
+            for (auto& f : it.second) {
+                std::vector<uint8_t>().swap(f);
+            }
+        }
+    }
+}
 
 #pragma endregion RenderCacheItem
@@ -15,7 +15,11 @@
 #include <map>
 #include <vector>
 #include <mutex>
-#include <shared_mutex>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+
+#include "RenderCacheIndex.h"
 
 
 class Effect;
@@ -30,55 +34,86 @@ class RenderCacheItem
     std::string _cacheFile;
     std::string _effectName;
     std::map<std::string, std::string> _properties;
-    std::map<std::string, std::vector<uint8_t *>> _frames;
+    std::map<std::string, std::vector<std::vector<uint8_t>>> _frames; // zstd compressed, empty if not rendered
     std::map<std::string, long> _frameSize;
     bool _purged;
     bool _dirty;
+    bool _loaded; // false until the frames have been read from the cache file
+    bool _otherVersion = false; // the file is from another version of xLights so it was not loaded
+    uint64_t _key = 0;
     static std::string GetModelName(RenderBuffer* buffer);
+    void Load();
+    RenderCacheIndexEntry MakeIndexEntry(uint64_t bytes, int64_t lastUsed) const;
+    void UpdateKey();
 
-    
-    void unmmap();
-    void remmap();
-    uint8_t *_mmap;
-    size_t _mmapSize;
-    size_t _firstFrameOffset;
-    
 public:
     RenderCacheItem(RenderCache* renderCache, const std::string& file);
+    RenderCacheItem(RenderCache* renderCache, const std::string& file, const RenderCacheIndexEntry& entry);
     RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer);
     virtual ~RenderCacheItem();
     bool GetFrame(RenderBuffer* buffer);
     void AddFrame(RenderBuffer* buffer);
     void PurgeFrames();
     bool IsPurged() const { return _purged; }
+    bool IsOtherVersion() const { return _otherVersion; }
     bool IsMatch(Effect* effect, RenderBuffer* buffer);
     void Delete();
     void Save();
     bool IsDone(RenderBuffer* buffer) const;
     const std::string& Description() const { return _cacheFile; }
     const std::string& EffectName() const { return _effectName; }
+    // hash of everything IsMatch compares bar the buffer, same for an effect and the item cached for it
+    uint64_t GetKey() const { return _key; }
+    static uint64_t GetKey(Effect* effect);
 };
 
 class RenderCache
 {
-    class PerEffectCache {
+    // The items not yet picked up by an effect keyed on RenderCacheItem::GetKey.
+    //
+    // Open addressed with atomic slots so finding and taking an item while rendering is lock free, adding and
+    // removing take the write lock. Slots are never reused so a slot's key never changes once set. Tables
+    // replaced when growing are kept until Clear as a render thread may still be probing them.
+    class ItemTable {
+        struct Slot {
+            std::atomic<uint64_t> key{ 0 };
+            std::atomic<RenderCacheItem*> item{ nullptr };
+        };
+        struct Table {
+            Table(size_t size) : slots(new Slot[size]), mask(size - 1) {}
+            std::unique_ptr<Slot[]> slots;
+            size_t mask;
+            size_t used = 0;
+        };
+        std::mutex _writeLock;
+        std::atomic<Table*> _table{ nullptr };
+        std::list<std::unique_ptr<Table>> _tables;
+
+        void Insert(Table* table, RenderCacheItem* item);
+
     public:
-        PerEffectCache() {}
-        ~PerEffectCache() {}
-        std::list<RenderCacheItem*> cache;
-        std::shared_mutex lock;
+        ItemTable();
+        void Add(RenderCacheItem* item);
+        RenderCacheItem* Take(uint64_t key);
+        bool Remove(RenderCacheItem* item);
+        std::vector<RenderCacheItem*> GetItems();
+        // only when nothing can be looking at the table
+        void Clear();
     };
-    
-    std::recursive_mutex  _cacheLock;
+
 	std::string _cacheFolder;
-	std::map<std::string, PerEffectCache*> _cache;
+    ItemTable _items;
     std::string _enabled; // Disabled | Locked Only | Enabled
     std::mutex _loadMutex;
+    std::condition_variable _loadDone;
+    std::atomic<bool> _loading{ false };
+    RenderCacheIndex _index;
+    uint64_t _maxSize = 0; // bytes across all sequences, 0 is unlimited
 
     void Close();
     void LoadCache();
-    
-    PerEffectCache* GetPerEffectCache(const std::string &s);
+    void SaveIndex();
+    void WaitForLoad();
 
     public:
 		RenderCache();
@@ -92,9 +127,17 @@ class RenderCache
         void Purge(SequenceElements* sequenceElements, bool dodelete);
         void Enable(std::string enabled) { _enabled = enabled; }
         std::mutex& GetLoadMutex() { return _loadMutex; }
+        void LoadDone();
         void AddCacheItem(RenderCacheItem* rci);
         bool IsEffectOkForCaching(Effect* effect) const;
-    
-    
-        bool UseMMap() const;
+        void SetMaxSize(uint64_t bytes) { _maxSize = bytes; }
+        uint64_t GetMaxSize() const { return _maxSize; }
+        // drops the least recently used items from all the sequence caches until they fit in the max size
+        void EnforceMaxSize();
+
+        // keeps the index in step with the cache files of the current sequence
+        void UpdateIndex(const RenderCacheIndexEntry& entry, const std::string& cacheFile);
+        void RemoveFromIndex(const std::string& cacheFile);
+        void TouchIndex(const std::string& cacheFile);
+        bool GetIndexEntry(const std::string& cacheFile, RenderCacheIndexEntry& entry) const;
 };
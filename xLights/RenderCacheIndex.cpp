@@ -0,0 +1,224 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "RenderCacheIndex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+static const char RENDER_CACHE_INDEX_MAGIC[4] = { 'X', 'L', 'R', 'I' };
+static const uint32_t RENDER_CACHE_INDEX_VERSION = 1;
+
+const std::string RenderCacheIndex::FILENAME = "RenderCache.index";
+
+void RenderCacheIndex::Clear()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _entries.clear();
+    _bytes = 0;
+}
+
+void RenderCacheIndex::Set(const RenderCacheIndexEntry& entry)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _entries.find(entry.file);
+    if (it != _entries.end()) {
+        _bytes -= it->second.bytes;
+    }
+    _entries[entry.file] = entry;
+    _bytes += entry.bytes;
+}
+
+void RenderCacheIndex::Remove(const std::string& file)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _entries.find(file);
+    if (it != _entries.end()) {
+        _bytes -= it->second.bytes;
+        _entries.erase(it);
+    }
+}
+
+void RenderCacheIndex::Touch(const std::string& file, int64_t when)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _entries.find(file);
+    if (it != _entries.end()) {
+        it->second.lastUsed = std::max(it->second.lastUsed, when);
+    }
+}
+
+bool RenderCacheIndex::Get(const std::string& file, RenderCacheIndexEntry& entry) const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _entries.find(file);
+    if (it == _entries.end()) return false;
+    entry = it->second;
+    return true;
+}
+
+std::vector<RenderCacheIndexEntry> RenderCacheIndex::GetEntries() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    std::vector<RenderCacheIndexEntry> res;
+    res.reserve(_entries.size());
+    for (const auto& it : _entries) {
+        res.push_back(it.second);
+    }
+    return res;
+}
+
+uint64_t RenderCacheIndex::GetBytes() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _bytes;
+}
+
+bool RenderCacheIndex::IsEmpty() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _entries.empty();
+}
+
+template<class T>
+static void WriteValue(std::ostream& out, T v)
+{
+    out.write((const char*)&v, sizeof(v));
+}
+
+template<class T>
+static bool ReadValue(std::istream& in, T& v)
+{
+    in.read((char*)&v, sizeof(v));
+    return in.good();
+}
+
+static void WriteString(std::ostream& out, const std::string& s)
+{
+    WriteValue(out, (uint32_t)s.size());
+    out.write(s.data(), s.size());
+}
+
+static bool ReadString(std::istream& in, std::string& s)
+{
+    uint32_t len = 0;
+    if (!ReadValue(in, len) || len > 1024 * 1024) return false;
+    s.resize(len);
+    in.read(&s[0], len);
+    return in.good();
+}
+
+bool RenderCacheIndex::Write(std::ostream& out) const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    out.write(RENDER_CACHE_INDEX_MAGIC, sizeof(RENDER_CACHE_INDEX_MAGIC));
+    WriteValue(out, RENDER_CACHE_INDEX_VERSION);
+    WriteValue(out, (uint32_t)_entries.size());
+    for (const auto& it : _entries) {
+        const auto& e = it.second;
+        WriteString(out, e.file);
+        WriteValue(out, e.bytes);
+        WriteValue(out, e.lastUsed);
+        WriteValue(out, (uint32_t)e.properties.size());
+        for (const auto& p : e.properties) {
+            WriteString(out, p.first);
+            WriteString(out, p.second);
+        }
+        WriteValue(out, (uint32_t)e.models.size());
+        for (const auto& m : e.models) {
+            WriteString(out, m.first);
+            WriteValue(out, m.second.first);
+            WriteValue(out, m.second.second);
+        }
+    }
+    return out.good();
+}
+
+bool RenderCacheIndex::Read(std::istream& in)
+{
+    Clear();
+
+    char magic[sizeof(RENDER_CACHE_INDEX_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in.good() || !std::equal(magic, magic + sizeof(magic), RENDER_CACHE_INDEX_MAGIC)) return false;
+
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!ReadValue(in, version) || version != RENDER_CACHE_INDEX_VERSION) return false;
+    if (!ReadValue(in, count)) return false;
+
+    std::map<std::string, RenderCacheIndexEntry> entries;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        RenderCacheIndexEntry e;
+        uint32_t props = 0;
+        uint32_t models = 0;
+        if (!ReadString(in, e.file) || !ReadValue(in, e.bytes) || !ReadValue(in, e.lastUsed) || !ReadValue(in, props)) return false;
+        for (uint32_t p = 0; p < props; p++) {
+            std::string key;
+            std::string value;
+            if (!ReadString(in, key) || !ReadString(in, value)) return false;
+            e.properties[key] = value;
+        }
+        if (!ReadValue(in, models)) return false;
+        for (uint32_t m = 0; m < models; m++) {
+            std::string name;
+            uint32_t frames = 0;
+            uint64_t frameSize = 0;
+            if (!ReadString(in, name) || !ReadValue(in, frames) || !ReadValue(in, frameSize)) return false;
+            e.models[name] = { frames, frameSize };
+        }
+        bytes += e.bytes;
+        entries[e.file] = std::move(e);
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    _entries = std::move(entries);
+    _bytes = bytes;
+    return true;
+}
+
+bool RenderCacheIndex::Save(const std::string& filename) const
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    return Write(out);
+}
+
+bool RenderCacheIndex::Load(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        Clear();
+        return false;
+    }
+    return Read(in);
+}
+
+std::vector<size_t> RenderCacheIndex::SelectEvictions(const std::vector<RenderCacheEvictionCandidate>& candidates, uint64_t total, uint64_t budget)
+{
+    std::vector<size_t> res;
+    if (total <= budget) return res;
+
+    std::vector<size_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&candidates](size_t a, size_t b) {
+        return candidates[a].lastUsed < candidates[b].lastUsed;
+    });
+
+    for (const auto i : order) {
+        if (total <= budget) break;
+        res.push_back(i);
+        total -= std::min(total, candidates[i].bytes);
+    }
+    return res;
+}
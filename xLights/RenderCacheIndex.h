@@ -0,0 +1,66 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// what the render cache needs to know about a cache file without opening it
+struct RenderCacheIndexEntry
+{
+    std::string file;      // file name within the cache folder
+    uint64_t bytes = 0;    // size of the file
+    int64_t lastUsed = 0;  // seconds since the epoch
+    std::map<std::string, std::string> properties;
+    std::map<std::string, std::pair<uint32_t, uint64_t>> models; // model -> frames, frame size
+};
+
+// something that could be removed to bring the render cache back under budget
+struct RenderCacheEvictionCandidate
+{
+    int64_t lastUsed = 0;
+    uint64_t bytes = 0;
+};
+
+// The index of all the items in a sequence's render cache folder.
+//
+// It is written when the sequence is closed so opening the sequence again only has to read this one file rather
+// than every item in the folder.
+class RenderCacheIndex
+{
+    mutable std::mutex _lock;
+    std::map<std::string, RenderCacheIndexEntry> _entries;
+    uint64_t _bytes = 0;
+
+public:
+    static const std::string FILENAME;
+
+    void Clear();
+    void Set(const RenderCacheIndexEntry& entry);
+    void Remove(const std::string& file);
+    void Touch(const std::string& file, int64_t when);
+    bool Get(const std::string& file, RenderCacheIndexEntry& entry) const;
+    std::vector<RenderCacheIndexEntry> GetEntries() const;
+    uint64_t GetBytes() const;
+    bool IsEmpty() const;
+
+    bool Write(std::ostream& out) const;
+    bool Read(std::istream& in);
+    bool Save(const std::string& filename) const;
+    bool Load(const std::string& filename);
+
+    // the candidates to remove, least recently used first, to get total down to budget
+    static std::vector<size_t> SelectEvictions(const std::vector<RenderCacheEvictionCandidate>& candidates, uint64_t total, uint64_t budget);
+};
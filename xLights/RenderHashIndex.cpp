@@ -0,0 +1,273 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "RenderHashIndex.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+
+static const char RENDER_HASH_MAGIC[4] = { 'X', 'L', 'R', 'H' };
+static const uint32_t RENDER_HASH_VERSION = 1;
+
+uint64_t RenderHashIndex::Hash(const std::string& s, uint64_t h)
+{
+    // FNV-1a
+    for (const auto c : s) {
+        h ^= (uint8_t)c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t RenderHashIndex::Mix(uint64_t h, uint64_t v)
+{
+    uint64_t x = h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+void RenderHashIndex::Clear()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _valid = false;
+    _hashes.clear();
+}
+
+void RenderHashIndex::Reset(uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation, uint64_t layout)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _hashes.clear();
+    _channels = channels;
+    _frames = frames;
+    _frameTime = frameTime;
+    _generation = generation;
+    _layout = layout;
+    _valid = true;
+}
+
+bool RenderHashIndex::IsValidFor(uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation, uint64_t layout) const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _valid && _channels == channels && _frames == frames && _frameTime == frameTime && _generation == generation && _layout == layout;
+}
+
+bool RenderHashIndex::IsValidFor(uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation) const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _valid && _channels == channels && _frames == frames && _frameTime == frameTime && _generation == generation;
+}
+
+void RenderHashIndex::Set(const std::string& model, const std::vector<uint64_t>& hashes)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_valid) {
+        _hashes[model] = hashes;
+    }
+}
+
+void RenderHashIndex::Invalidate(const std::string& model, int startFrame, int endFrame)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _hashes.find(model);
+    if (it == _hashes.end()) return;
+
+    startFrame = std::max(0, startFrame);
+    endFrame = std::min((int)it->second.size() - 1, endFrame);
+    for (int f = startFrame; f <= endFrame; f++) {
+        // 0 is never a real hash
+        it->second[f] = 0;
+    }
+}
+
+std::vector<std::vector<bool>> RenderHashIndex::FindStale(const std::vector<RenderHashFrames>& models) const
+{
+    std::vector<std::vector<bool>> stale(models.size());
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        for (size_t m = 0; m < models.size(); m++) {
+            const auto& hashes = models[m].hashes;
+            stale[m].resize(hashes.size(), true);
+
+            auto it = _valid ? _hashes.find(models[m].model) : _hashes.end();
+            if (it == _hashes.end()) continue;
+            const auto& old = it->second;
+            for (size_t f = 0; f < hashes.size() && f < old.size(); f++) {
+                stale[m][f] = hashes[f] != old[f];
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        // effects carry state from frame to frame so a changed frame has to be rendered from where the render
+        // would have started it
+        for (size_t m = 0; m < models.size(); m++) {
+            const auto& restart = models[m].restart;
+            int from = INT_MAX;
+            for (int f = (int)stale[m].size() - 1; f >= 0; f--) {
+                if (!stale[m][f]) {
+                    if (f < from) continue;
+                    stale[m][f] = true;
+                    changed = true;
+                }
+                from = std::min(from, f < (int)restart.size() ? restart[f] : f);
+            }
+        }
+
+        // models sharing channels all need to be rendered for a frame to come out the same
+        for (size_t m = 0; m < models.size(); m++) {
+            for (const auto o : models[m].overlaps) {
+                auto& to = stale[o];
+                for (size_t f = 0; f < stale[m].size() && f < to.size(); f++) {
+                    if (stale[m][f] && !to[f]) {
+                        to[f] = true;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+    return stale;
+}
+
+template<class T>
+static void WriteValue(std::ostream& out, T v)
+{
+    out.write((const char*)&v, sizeof(v));
+}
+
+template<class T>
+static bool ReadValue(std::istream& in, T& v)
+{
+    in.read((char*)&v, sizeof(v));
+    return in.good();
+}
+
+static void WriteString(std::ostream& out, const std::string& s)
+{
+    WriteValue(out, (uint32_t)s.size());
+    out.write(s.data(), s.size());
+}
+
+static bool ReadString(std::istream& in, std::string& s)
+{
+    uint32_t len = 0;
+    if (!ReadValue(in, len) || len > 1024 * 1024) return false;
+    s.resize(len);
+    in.read(&s[0], len);
+    return in.good();
+}
+
+bool RenderHashIndex::Write(std::ostream& out, const std::string& signature) const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    if (!_valid) return false;
+
+    out.write(RENDER_HASH_MAGIC, sizeof(RENDER_HASH_MAGIC));
+    WriteValue(out, RENDER_HASH_VERSION);
+    WriteValue(out, _channels);
+    WriteValue(out, _frames);
+    WriteValue(out, _frameTime);
+    WriteValue(out, _layout);
+    WriteString(out, signature);
+    WriteValue(out, (uint32_t)_hashes.size());
+    for (const auto& it : _hashes) {
+        WriteString(out, it.first);
+
+        // hashes only change at effect boundaries so store them as runs
+        std::vector<std::pair<uint32_t, uint64_t>> runs;
+        for (const auto h : it.second) {
+            if (runs.empty() || runs.back().second != h) {
+                runs.push_back({ 1, h });
+            } else {
+                runs.back().first++;
+            }
+        }
+        WriteValue(out, (uint32_t)runs.size());
+        for (const auto& r : runs) {
+            WriteValue(out, r.first);
+            WriteValue(out, r.second);
+        }
+    }
+    return out.good();
+}
+
+bool RenderHashIndex::Read(std::istream& in, const std::string& signature, uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation)
+{
+    Clear();
+
+    char magic[sizeof(RENDER_HASH_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in.good() || !std::equal(magic, magic + sizeof(magic), RENDER_HASH_MAGIC)) return false;
+
+    uint32_t version = 0;
+    uint32_t ch = 0;
+    uint32_t fr = 0;
+    uint32_t ft = 0;
+    uint64_t layout = 0;
+    std::string sig;
+    if (!ReadValue(in, version) || version != RENDER_HASH_VERSION) return false;
+    if (!ReadValue(in, ch) || !ReadValue(in, fr) || !ReadValue(in, ft) || !ReadValue(in, layout)) return false;
+    if (!ReadString(in, sig)) return false;
+
+    // only any use if it describes the data we have
+    if (sig != signature || ch != channels || fr != frames || ft != frameTime) return false;
+
+    std::map<std::string, std::vector<uint64_t>> hashes;
+    uint32_t count = 0;
+    if (!ReadValue(in, count)) return false;
+    for (uint32_t m = 0; m < count; m++) {
+        std::string name;
+        uint32_t runs = 0;
+        if (!ReadString(in, name) || !ReadValue(in, runs)) return false;
+        auto& h = hashes[name];
+        h.reserve(frames);
+        for (uint32_t r = 0; r < runs; r++) {
+            uint32_t len = 0;
+            uint64_t value = 0;
+            if (!ReadValue(in, len) || !ReadValue(in, value) || h.size() + len > frames) return false;
+            h.insert(h.end(), len, value);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    _channels = ch;
+    _frames = fr;
+    _frameTime = ft;
+    _layout = layout;
+    _generation = generation;
+    _hashes = std::move(hashes);
+    _valid = true;
+    return true;
+}
+
+bool RenderHashIndex::Save(const std::string& filename, const std::string& signature) const
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    return Write(out, signature);
+}
+
+bool RenderHashIndex::Load(const std::string& filename, const std::string& signature, uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        Clear();
+        return false;
+    }
+    return Read(in, signature, channels, frames, frameTime, generation);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// per model masks of the frames to render ... keyed on model name
+typedef std::map<std::string, std::vector<bool>> RenderFrameMasks;
+
+// everything needed about a model to work out which of its frames need rendering
+struct RenderHashFrames
+{
+    std::string model;
+    std::vector<uint64_t> hashes; // per frame hash of everything the model output depends on
+    std::vector<int> restart;     // per frame, the frame a render has to start from to reproduce it
+    std::vector<int> overlaps;    // models sharing channels with this one
+};
+
+// Per model, per frame hashes of the inputs to the render that produced the current sequence data.
+//
+// Comparing these with hashes of the current effects gives the (model, frame) cells which are out of date so a
+// render all only needs to redo those. The index is saved next to the sequence when the fseq is written and is
+// only trusted on load if it was written alongside the fseq that got loaded.
+class RenderHashIndex
+{
+    mutable std::mutex _lock;
+    bool _valid = false;
+    uint32_t _channels = 0;
+    uint32_t _frames = 0;
+    uint32_t _frameTime = 0;
+    uint32_t _generation = 0;
+    uint64_t _layout = 0;
+    std::map<std::string, std::vector<uint64_t>> _hashes;
+
+public:
+    static const uint64_t HASH_SEED = 14695981039346656037ULL;
+
+    static uint64_t Hash(const std::string& s, uint64_t h = HASH_SEED);
+    static uint64_t Mix(uint64_t h, uint64_t v);
+
+    void Clear();
+    // starts a fresh index for sequence data of this size and layout
+    void Reset(uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation, uint64_t layout);
+    bool IsValidFor(uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation, uint64_t layout) const;
+    bool IsValidFor(uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation) const;
+
+    void Set(const std::string& model, const std::vector<uint64_t>& hashes);
+    // forget what was rendered for these frames so they get rendered again next time
+    void Invalidate(const std::string& model, int startFrame, int endFrame);
+
+    // the frames of each model that need rendering. This includes the frames leading up to a changed frame that
+    // the render has to start from and any frame of a model that shares channels with a model being rendered
+    std::vector<std::vector<bool>> FindStale(const std::vector<RenderHashFrames>& models) const;
+
+    bool Write(std::ostream& out, const std::string& signature) const;
+    bool Read(std::istream& in, const std::string& signature, uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation);
+    bool Save(const std::string& filename, const std::string& signature) const;
+    bool Load(const std::string& filename, const std::string& signature, uint32_t channels, uint32_t frames, uint32_t frameTime, uint32_t generation);
+};
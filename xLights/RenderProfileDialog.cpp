@@ -0,0 +1,195 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "RenderProfileDialog.h"
+#include "RenderProfiler.h"
+
+//(*InternalHeaders(RenderProfileDialog)
+#include <wx/intl.h>
+#include <wx/string.h>
+//*)
+
+#include <wx/filedlg.h>
+#include <wx/msgdlg.h>
+
+//(*IdInit(RenderProfileDialog)
+const long RenderProfileDialog::ID_STATICTEXT1 = wxNewId();
+const long RenderProfileDialog::ID_CHOICE1 = wxNewId();
+const long RenderProfileDialog::ID_STATICTEXT2 = wxNewId();
+const long RenderProfileDialog::ID_LISTCTRL1 = wxNewId();
+const long RenderProfileDialog::ID_BUTTON1 = wxNewId();
+const long RenderProfileDialog::ID_BUTTON2 = wxNewId();
+const long RenderProfileDialog::ID_BUTTON3 = wxNewId();
+const long RenderProfileDialog::ID_BUTTON4 = wxNewId();
+//*)
+
+BEGIN_EVENT_TABLE(RenderProfileDialog,wxDialog)
+	//(*EventTable(RenderProfileDialog)
+	//*)
+END_EVENT_TABLE()
+
+RenderProfileDialog::RenderProfileDialog(wxWindow* parent, wxWindowID id, const wxPoint& pos, const wxSize& size)
+{
+	//(*Initialize(RenderProfileDialog)
+	wxFlexGridSizer* FlexGridSizer1;
+	wxFlexGridSizer* FlexGridSizer2;
+	wxFlexGridSizer* FlexGridSizer3;
+
+	Create(parent, id, _("Render Profile"), wxDefaultPosition, wxDefaultSize, wxDEFAULT_DIALOG_STYLE|wxRESIZE_BORDER|wxMAXIMIZE_BOX, _T("id"));
+	SetClientSize(wxDefaultSize);
+	Move(wxDefaultPosition);
+	FlexGridSizer1 = new wxFlexGridSizer(0, 1, 0, 0);
+	FlexGridSizer1->AddGrowableCol(0);
+	FlexGridSizer1->AddGrowableRow(1);
+	FlexGridSizer2 = new wxFlexGridSizer(0, 3, 0, 0);
+	FlexGridSizer2->AddGrowableCol(2);
+	StaticText1 = new wxStaticText(this, ID_STATICTEXT1, _("Group By:"), wxDefaultPosition, wxDefaultSize, 0, _T("ID_STATICTEXT1"));
+	FlexGridSizer2->Add(StaticText1, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	Choice_Grouping = new wxChoice(this, ID_CHOICE1, wxDefaultPosition, wxDefaultSize, 0, 0, 0, wxDefaultValidator, _T("ID_CHOICE1"));
+	Choice_Grouping->SetSelection( Choice_Grouping->Append(_("Effect")) );
+	Choice_Grouping->Append(_("Effect Type"));
+	Choice_Grouping->Append(_("Model"));
+	FlexGridSizer2->Add(Choice_Grouping, 1, wxALL|wxEXPAND, 5);
+	StaticText_Total = new wxStaticText(this, ID_STATICTEXT2, wxEmptyString, wxDefaultPosition, wxDefaultSize, 0, _T("ID_STATICTEXT2"));
+	FlexGridSizer2->Add(StaticText_Total, 1, wxALL|wxEXPAND, 5);
+	FlexGridSizer1->Add(FlexGridSizer2, 1, wxALL|wxEXPAND, 2);
+	ListCtrl_Profile = new wxListCtrl(this, ID_LISTCTRL1, wxDefaultPosition, wxSize(900,400), wxLC_REPORT|wxLC_SINGLE_SEL, wxDefaultValidator, _T("ID_LISTCTRL1"));
+	FlexGridSizer1->Add(ListCtrl_Profile, 1, wxALL|wxEXPAND, 2);
+	FlexGridSizer3 = new wxFlexGridSizer(0, 4, 0, 0);
+	Button_ExportTrace = new wxButton(this, ID_BUTTON1, _("Export Trace"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_BUTTON1"));
+	FlexGridSizer3->Add(Button_ExportTrace, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	Button_ExportCSV = new wxButton(this, ID_BUTTON2, _("Export CSV"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_BUTTON2"));
+	FlexGridSizer3->Add(Button_ExportCSV, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	Button_Clear = new wxButton(this, ID_BUTTON3, _("Clear"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_BUTTON3"));
+	FlexGridSizer3->Add(Button_Clear, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	Button_Close = new wxButton(this, ID_BUTTON4, _("Close"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_BUTTON4"));
+	FlexGridSizer3->Add(Button_Close, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	FlexGridSizer1->Add(FlexGridSizer3, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
+	SetSizer(FlexGridSizer1);
+	FlexGridSizer1->Fit(this);
+	FlexGridSizer1->SetSizeHints(this);
+
+	Connect(ID_CHOICE1,wxEVT_COMMAND_CHOICE_SELECTED,(wxObjectEventFunction)&RenderProfileDialog::OnChoice_GroupingSelect);
+	Connect(ID_BUTTON1,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&RenderProfileDialog::OnButton_ExportTraceClick);
+	Connect(ID_BUTTON2,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&RenderProfileDialog::OnButton_ExportCSVClick);
+	Connect(ID_BUTTON3,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&RenderProfileDialog::OnButton_ClearClick);
+	Connect(ID_BUTTON4,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&RenderProfileDialog::OnButton_CloseClick);
+	//*)
+
+    ListCtrl_Profile->AppendColumn("Model");
+    ListCtrl_Profile->AppendColumn("Layer", wxLIST_FORMAT_RIGHT);
+    ListCtrl_Profile->AppendColumn("Effect");
+    ListCtrl_Profile->AppendColumn("Frames", wxLIST_FORMAT_RIGHT);
+    ListCtrl_Profile->AppendColumn("Calls", wxLIST_FORMAT_RIGHT);
+    for (int i = 0; i < (int)RenderProfileCategory::COUNT; ++i) {
+        ListCtrl_Profile->AppendColumn(wxString(RenderProfiler::CategoryName((RenderProfileCategory)i)) + " ms", wxLIST_FORMAT_RIGHT);
+    }
+    ListCtrl_Profile->AppendColumn("Total ms", wxLIST_FORMAT_RIGHT);
+    ListCtrl_Profile->AppendColumn("% of Total", wxLIST_FORMAT_RIGHT);
+
+    LoadList();
+}
+
+RenderProfileDialog::~RenderProfileDialog()
+{
+	//(*Destroy(RenderProfileDialog)
+	//*)
+}
+
+RenderProfileGrouping RenderProfileDialog::GetGrouping() const
+{
+    switch (Choice_Grouping->GetSelection()) {
+    case 1:
+        return RenderProfileGrouping::EffectType;
+    case 2:
+        return RenderProfileGrouping::Model;
+    default:
+        break;
+    }
+    return RenderProfileGrouping::Effect;
+}
+
+// slowest first so the few effects costing most of the render are at the top
+void RenderProfileDialog::LoadList()
+{
+    ListCtrl_Profile->Freeze();
+    ListCtrl_Profile->DeleteAllItems();
+
+    auto rows = RenderProfiler::Instance().GetSummary(GetGrouping());
+
+    int64_t total = 0;
+    for (const auto& it : rows) {
+        total += it.TotalUS();
+    }
+
+    for (const auto& it : rows) {
+        long item = ListCtrl_Profile->InsertItem(ListCtrl_Profile->GetItemCount(), it.model);
+        int col = 1;
+        ListCtrl_Profile->SetItem(item, col++, it.layer >= 0 ? wxString::Format("%d", it.layer + 1) : wxString());
+        ListCtrl_Profile->SetItem(item, col++, it.effect);
+        ListCtrl_Profile->SetItem(item, col++, wxString::Format("%d-%d", it.startFrame, it.endFrame));
+        ListCtrl_Profile->SetItem(item, col++, wxString::Format("%ld", it.calls));
+        for (int i = 0; i < (int)RenderProfileCategory::COUNT; ++i) {
+            ListCtrl_Profile->SetItem(item, col++, wxString::Format("%.1f", (double)it.timeUS[i] / 1000.0));
+        }
+        ListCtrl_Profile->SetItem(item, col++, wxString::Format("%.1f", (double)it.TotalUS() / 1000.0));
+        ListCtrl_Profile->SetItem(item, col++, wxString::Format("%.1f%%", total == 0 ? 0.0 : 100.0 * (double)it.TotalUS() / (double)total));
+    }
+
+    for (int i = 0; i < ListCtrl_Profile->GetColumnCount(); ++i) {
+        ListCtrl_Profile->SetColumnWidth(i, wxLIST_AUTOSIZE_USEHEADER);
+    }
+    ListCtrl_Profile->Thaw();
+
+    wxString label = wxString::Format("Total %.1fms across all render threads.", (double)total / 1000.0);
+    if (!RenderProfiler::Instance().IsEnabled()) {
+        label += " Profiling is not enabled.";
+    }
+    if (RenderProfiler::Instance().GetDroppedTraceSamples() > 0) {
+        label += wxString::Format(" The trace is missing the last %lu timings.", (unsigned long)RenderProfiler::Instance().GetDroppedTraceSamples());
+    }
+    StaticText_Total->SetLabel(label);
+}
+
+void RenderProfileDialog::OnChoice_GroupingSelect(wxCommandEvent& event)
+{
+    LoadList();
+}
+
+void RenderProfileDialog::OnButton_ExportTraceClick(wxCommandEvent& event)
+{
+    wxString filename = wxFileSelector(_("Choose output file"), wxEmptyString, "RenderProfile", wxEmptyString, "Chrome Trace files (*.json)|*.json", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (filename.IsEmpty()) return;
+
+    if (!RenderProfiler::Instance().ExportChromeTrace(filename.ToStdString())) {
+        wxMessageBox("Unable to write " + filename, "Error", wxOK | wxICON_ERROR, this);
+    }
+}
+
+void RenderProfileDialog::OnButton_ExportCSVClick(wxCommandEvent& event)
+{
+    wxString filename = wxFileSelector(_("Choose output file"), wxEmptyString, "RenderProfile", wxEmptyString, "Export files (*.csv)|*.csv", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (filename.IsEmpty()) return;
+
+    if (!RenderProfiler::Instance().ExportCSV(filename.ToStdString(), GetGrouping())) {
+        wxMessageBox("Unable to write " + filename, "Error", wxOK | wxICON_ERROR, this);
+    }
+}
+
+void RenderProfileDialog::OnButton_ClearClick(wxCommandEvent& event)
+{
+    RenderProfiler::Instance().Clear();
+    LoadList();
+}
+
+void RenderProfileDialog::OnButton_CloseClick(wxCommandEvent& event)
+{
+    EndDialog(wxID_CLOSE);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+//(*Headers(RenderProfileDialog)
+#include <wx/button.h>
+#include <wx/choice.h>
+#include <wx/dialog.h>
+#include <wx/listctrl.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+//*)
+
+enum class RenderProfileGrouping;
+
+class RenderProfileDialog: public wxDialog
+{
+    RenderProfileGrouping GetGrouping() const;
+    void LoadList();
+
+	public:
+
+		RenderProfileDialog(wxWindow* parent, wxWindowID id = wxID_ANY, const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxDefaultSize);
+		virtual ~RenderProfileDialog();
+
+		//(*Declarations(RenderProfileDialog)
+		wxButton* Button_Clear;
+		wxButton* Button_Close;
+		wxButton* Button_ExportCSV;
+		wxButton* Button_ExportTrace;
+		wxChoice* Choice_Grouping;
+		wxListCtrl* ListCtrl_Profile;
+		wxStaticText* StaticText1;
+		wxStaticText* StaticText_Total;
+		//*)
+
+	protected:
+
+		//(*Identifiers(RenderProfileDialog)
+		static const long ID_STATICTEXT1;
+		static const long ID_CHOICE1;
+		static const long ID_STATICTEXT2;
+		static const long ID_LISTCTRL1;
+		static const long ID_BUTTON1;
+		static const long ID_BUTTON2;
+		static const long ID_BUTTON3;
+		static const long ID_BUTTON4;
+		//*)
+
+	private:
+
+		//(*Handlers(RenderProfileDialog)
+		void OnChoice_GroupingSelect(wxCommandEvent& event);
+		void OnButton_ExportTraceClick(wxCommandEvent& event);
+		void OnButton_ExportCSVClick(wxCommandEvent& event);
+		void OnButton_ClearClick(wxCommandEvent& event);
+		void OnButton_CloseClick(wxCommandEvent& event);
+		//*)
+
+		DECLARE_EVENT_TABLE()
+};
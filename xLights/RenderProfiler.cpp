@@ -0,0 +1,342 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "RenderProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+#include <log4cpp/Category.hh>
+
+namespace
+{
+    std::string JSONEscape(const std::string& s)
+    {
+        std::string res;
+        res.reserve(s.size());
+        for (char c : s) {
+            switch (c) {
+            case '"':
+                res += "\\\"";
+                break;
+            case '\\':
+                res += "\\\\";
+                break;
+            case '\n':
+                res += "\\n";
+                break;
+            case '\r':
+                res += "\\r";
+                break;
+            case '\t':
+                res += "\\t";
+                break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)c);
+                    res += buf;
+                } else {
+                    res += c;
+                }
+                break;
+            }
+        }
+        return res;
+    }
+
+    std::string CSVEscape(const std::string& s)
+    {
+        if (s.find_first_of(",\"\n") == std::string::npos) return s;
+        std::string res = "\"";
+        for (char c : s) {
+            if (c == '"') res += '"';
+            res += c;
+        }
+        return res + "\"";
+    }
+}
+
+int64_t RenderProfileRow::TotalUS() const
+{
+    int64_t total = 0;
+    for (int i = 0; i < (int)RenderProfileCategory::COUNT; ++i) {
+        total += timeUS[i];
+    }
+    return total;
+}
+
+void RenderProfileRow::Add(const RenderProfileRow& row)
+{
+    if (row.calls == 0) return;
+    if (calls == 0 || row.startFrame < startFrame) startFrame = row.startFrame;
+    if (calls == 0 || row.endFrame > endFrame) endFrame = row.endFrame;
+    calls += row.calls;
+    for (int i = 0; i < (int)RenderProfileCategory::COUNT; ++i) {
+        timeUS[i] += row.timeUS[i];
+    }
+}
+
+RenderProfiler& RenderProfiler::Instance()
+{
+    static RenderProfiler profiler;
+    return profiler;
+}
+
+const char* RenderProfiler::CategoryName(RenderProfileCategory category)
+{
+    switch (category) {
+    case RenderProfileCategory::Render:
+        return "Render";
+    case RenderProfileCategory::RenderCache:
+        return "Render Cache";
+    case RenderProfileCategory::Blend:
+        return "Blend";
+    case RenderProfileCategory::Wait:
+        return "Wait";
+    default:
+        break;
+    }
+    return "";
+}
+
+void RenderProfiler::SetEnabled(bool enabled)
+{
+    static log4cpp::Category& logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+
+    if (enabled && !_enabled && !HasData()) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _epoch = std::chrono::steady_clock::now();
+    }
+    _enabled = enabled;
+    logger_render.info("Render profiling %s.", enabled ? "enabled" : "disabled");
+}
+
+void RenderProfiler::Clear()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (auto& it : _threads) {
+        std::unique_lock<std::mutex> tlock(it->lock);
+        it->samples.clear();
+        it->samples.shrink_to_fit();
+        it->totals.clear();
+        it->keys.clear();
+    }
+    _keys.clear();
+    _keyIndex.clear();
+    _sampleCount = 0;
+    _droppedSamples = 0;
+    _epoch = std::chrono::steady_clock::now();
+}
+
+bool RenderProfiler::HasData() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return !_keys.empty();
+}
+
+RenderProfiler::ThreadData* RenderProfiler::GetThreadData()
+{
+    // the buffers are never freed so the pointer stays valid for the life of the thread
+    thread_local ThreadData* data = nullptr;
+    if (data == nullptr) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _threads.push_back(std::make_unique<ThreadData>());
+        data = _threads.back().get();
+        data->threadIndex = (int)_threads.size();
+    }
+    return data;
+}
+
+uint32_t RenderProfiler::GetKey(const std::string& model, int layer, const std::string& effect, int effectStartMS)
+{
+    ThreadData* data = GetThreadData();
+
+    std::string k = model + '\x1f' + std::to_string(layer) + '\x1f' + effect + '\x1f' + std::to_string(effectStartMS);
+    {
+        std::unique_lock<std::mutex> tlock(data->lock);
+        auto it = data->keys.find(k);
+        if (it != data->keys.end()) return it->second;
+    }
+
+    uint32_t key;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        // another thread may have already added it
+        auto it = _keyIndex.find(k);
+        if (it != _keyIndex.end()) {
+            key = it->second;
+        } else {
+            RenderProfileRow row;
+            row.model = model;
+            row.layer = layer;
+            row.effect = effect;
+            _keys.push_back(row);
+            key = (uint32_t)(_keys.size() - 1);
+            _keyIndex[k] = key;
+        }
+    }
+
+    std::unique_lock<std::mutex> tlock(data->lock);
+    data->keys[k] = key;
+    return key;
+}
+
+void RenderProfiler::Record(uint32_t key, RenderProfileCategory category, int frame, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    ThreadData* data = GetThreadData();
+    int64_t startUS = std::chrono::duration_cast<std::chrono::microseconds>(start - _epoch).count();
+    int64_t durationUS = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::unique_lock<std::mutex> tlock(data->lock);
+    if (data->totals.size() <= key) {
+        data->totals.resize(key + 1);
+    }
+    RenderProfileRow& total = data->totals[key];
+    if (total.calls == 0 || frame < total.startFrame) total.startFrame = frame;
+    if (total.calls == 0 || frame > total.endFrame) total.endFrame = frame;
+    total.calls++;
+    total.timeUS[(int)category] += durationUS;
+
+    if (++_sampleCount <= MAX_TRACE_SAMPLES) {
+        data->samples.push_back({ key, frame, category, startUS, durationUS });
+    } else {
+        ++_droppedSamples;
+    }
+}
+
+// the totals for each key across all the threads
+std::vector<RenderProfileRow> RenderProfiler::GetTotals() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    std::vector<RenderProfileRow> res(_keys.size());
+    for (size_t i = 0; i < _keys.size(); ++i) {
+        res[i].model = _keys[i].model;
+        res[i].layer = _keys[i].layer;
+        res[i].effect = _keys[i].effect;
+    }
+    for (const auto& it : _threads) {
+        std::unique_lock<std::mutex> tlock(it->lock);
+        for (size_t i = 0; i < it->totals.size() && i < res.size(); ++i) {
+            res[i].Add(it->totals[i]);
+        }
+    }
+    return res;
+}
+
+std::vector<RenderProfileRow> RenderProfiler::GetSummary(RenderProfileGrouping grouping) const
+{
+    std::vector<RenderProfileRow> totals = GetTotals();
+    std::vector<RenderProfileRow> res;
+
+    if (grouping == RenderProfileGrouping::Effect) {
+        for (const auto& it : totals) {
+            if (it.calls > 0) res.push_back(it);
+        }
+    } else {
+        std::map<std::string, RenderProfileRow> groups;
+        for (const auto& it : totals) {
+            if (it.calls == 0) continue;
+            const std::string& name = grouping == RenderProfileGrouping::Model ? it.model : it.effect;
+            auto g = groups.find(name);
+            if (g == groups.end()) {
+                RenderProfileRow row;
+                if (grouping == RenderProfileGrouping::Model) {
+                    row.model = name;
+                } else {
+                    row.effect = name;
+                }
+                g = groups.emplace(name, row).first;
+            }
+            g->second.Add(it);
+        }
+        for (const auto& it : groups) {
+            res.push_back(it.second);
+        }
+    }
+
+    std::stable_sort(res.begin(), res.end(), [](const RenderProfileRow& a, const RenderProfileRow& b) {
+        return a.TotalUS() > b.TotalUS();
+    });
+    return res;
+}
+
+void RenderProfiler::WriteChromeTrace(std::ostream& out) const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& it : _threads) {
+        std::unique_lock<std::mutex> tlock(it->lock);
+
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it->threadIndex
+            << ",\"args\":{\"name\":\"Render thread " << it->threadIndex << "\"}}";
+        first = false;
+
+        for (const auto& s : it->samples) {
+            if (s.key >= _keys.size()) continue;
+            const RenderProfileRow& k = _keys[s.key];
+            std::string name = k.effect.empty() ? CategoryName(s.category) : k.effect;
+            out << ",\n{\"name\":\"" << JSONEscape(name) << "\",\"cat\":\"" << CategoryName(s.category)
+                << "\",\"ph\":\"X\",\"ts\":" << s.startUS << ",\"dur\":" << s.durationUS
+                << ",\"pid\":1,\"tid\":" << it->threadIndex
+                << ",\"args\":{\"model\":\"" << JSONEscape(k.model) << "\",\"layer\":" << k.layer + 1 << ",\"frame\":" << s.frame << "}}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void RenderProfiler::WriteCSV(std::ostream& out, RenderProfileGrouping grouping) const
+{
+    out << "Model,Layer,Effect,Start Frame,End Frame,Calls";
+    for (int i = 0; i < (int)RenderProfileCategory::COUNT; ++i) {
+        out << "," << CategoryName((RenderProfileCategory)i) << " ms";
+    }
+    out << ",Total ms\n";
+
+    for (const auto& it : GetSummary(grouping)) {
+        out << CSVEscape(it.model) << ",";
+        if (it.layer >= 0) out << it.layer + 1;
+        out << "," << CSVEscape(it.effect) << "," << it.startFrame << "," << it.endFrame << "," << it.calls;
+        for (int i = 0; i < (int)RenderProfileCategory::COUNT; ++i) {
+            out << "," << (double)it.timeUS[i] / 1000.0;
+        }
+        out << "," << (double)it.TotalUS() / 1000.0 << "\n";
+    }
+}
+
+bool RenderProfiler::ExportChromeTrace(const std::string& filename) const
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        logger_base.error("Unable to create render profile trace file %s.", (const char*)filename.c_str());
+        return false;
+    }
+    WriteChromeTrace(out);
+    return out.good();
+}
+
+bool RenderProfiler::ExportCSV(const std::string& filename, RenderProfileGrouping grouping) const
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        logger_base.error("Unable to create render profile file %s.", (const char*)filename.c_str());
+        return false;
+    }
+    WriteCSV(out, grouping);
+    return out.good();
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// what the render threads were doing during a timed block
+enum class RenderProfileCategory
+{
+    Render,      // RenderableEffect::Render
+    RenderCache, // looking up and storing frames in the render cache
+    Blend,       // CalcOutput mixing the layers down to the model
+    Wait,        // waiting for the models this one depends on to reach the frame
+    COUNT
+};
+
+// how the summary rolls the timings up
+enum class RenderProfileGrouping
+{
+    Effect,     // each effect instance on each model and layer
+    EffectType, // all effects of the same type
+    Model       // everything rendered for a model
+};
+
+struct RenderProfileRow
+{
+    std::string model;
+    int layer = -1;
+    std::string effect;
+    int startFrame = -1;
+    int endFrame = -1;
+    long calls = 0;
+    int64_t timeUS[(int)RenderProfileCategory::COUNT] = {};
+
+    int64_t TotalUS() const;
+    void Add(const RenderProfileRow& row);
+};
+
+// Opt in timing of the render threads. When disabled the only cost is checking the enabled flag.
+// Each thread records into its own buffer so the render threads dont contend with each other. The per effect
+// totals are always complete but only the first MAX_TRACE_SAMPLES timed blocks are kept for the trace export.
+class RenderProfiler
+{
+public:
+    static const size_t MAX_TRACE_SAMPLES = 4000000;
+
+    static RenderProfiler& Instance();
+
+    bool IsEnabled() const { return _enabled; }
+    void SetEnabled(bool enabled);
+    void Clear();
+    bool HasData() const;
+
+    // Identifies what is being timed. Layer is -1 for work done on the whole model where effect is then the
+    // name of the category.
+    uint32_t GetKey(const std::string& model, int layer, const std::string& effect, int effectStartMS);
+    void Record(uint32_t key, RenderProfileCategory category, int frame, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    std::vector<RenderProfileRow> GetSummary(RenderProfileGrouping grouping) const;
+    size_t GetDroppedTraceSamples() const { return _droppedSamples; }
+
+    // Chrome trace event format ... load it in chrome://tracing or https://ui.perfetto.dev
+    void WriteChromeTrace(std::ostream& out) const;
+    void WriteCSV(std::ostream& out, RenderProfileGrouping grouping) const;
+    bool ExportChromeTrace(const std::string& filename) const;
+    bool ExportCSV(const std::string& filename, RenderProfileGrouping grouping) const;
+
+    static const char* CategoryName(RenderProfileCategory category);
+
+    virtual ~RenderProfiler() {}
+
+private:
+    // there is only ever one as the render threads each keep a pointer to their buffer in it
+    RenderProfiler() {}
+
+    struct Sample
+    {
+        uint32_t key;
+        int frame;
+        RenderProfileCategory category;
+        int64_t startUS;
+        int64_t durationUS;
+    };
+
+    struct ThreadData
+    {
+        std::mutex lock;
+        int threadIndex = 0;
+        std::vector<Sample> samples;
+        std::vector<RenderProfileRow> totals; // indexed by key
+        std::unordered_map<std::string, uint32_t> keys;
+    };
+
+    ThreadData* GetThreadData();
+    std::vector<RenderProfileRow> GetTotals() const;
+
+    std::atomic_bool _enabled{ false };
+    std::atomic<size_t> _sampleCount{ 0 };
+    std::atomic<size_t> _droppedSamples{ 0 };
+    std::chrono::steady_clock::time_point _epoch = std::chrono::steady_clock::now();
+
+    mutable std::mutex _lock;
+    std::vector<RenderProfileRow> _keys; // the identifying fields of each key
+    std::unordered_map<std::string, uint32_t> _keyIndex;
+    std::list<std::unique_ptr<ThreadData>> _threads;
+};
+
+// Times the enclosing scope if profiling is enabled
+class RenderProfileTimer
+{
+    uint32_t _key = 0;
+    RenderProfileCategory _category;
+    int _frame;
+    bool _active;
+    std::chrono::steady_clock::time_point _start;
+
+public:
+    RenderProfileTimer(RenderProfileCategory category, const std::string& model, int layer, const std::string& effect, int effectStartMS, int frame) :
+        _category(category), _frame(frame), _active(RenderProfiler::Instance().IsEnabled())
+    {
+        if (_active) {
+            _key = RenderProfiler::Instance().GetKey(model, layer, effect, effectStartMS);
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+    ~RenderProfileTimer()
+    {
+        if (_active) {
+            RenderProfiler::Instance().Record(_key, _category, _frame, _start, std::chrono::steady_clock::now());
+        }
+    }
+};
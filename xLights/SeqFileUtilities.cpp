@@ -45,6 +45,7 @@
 
 #include "SequencePackage.h"
 #include "Vixen3.h"
+#include "VideoFrameCache.h"
 #include "effects/BarsEffect.h"
 #include "effects/ButterflyEffect.h"
 #include "effects/CurtainEffect.h"
@@ -524,6 +525,13 @@ void xLightsFrame::OpenSequence(const wxString& passed_filename, ConvertLogDialo
             _seqData.init(numChan, CurrentSeqXmlFile->GetSequenceDurationMS() / ms, ms);
         }
 
+        // if the fseq is the one we rendered, only what has changed since needs to be rendered again
+        if (loaded_fseq) {
+            LoadRenderHashIndex();
+        } else {
+            _renderHashIndex.Clear();
+        }
+
         logger_base.debug("Initializeing Display Elements");
         displayElementsPanel->Initialize();
 
@@ -624,6 +632,7 @@ bool xLightsFrame::CloseSequence()
 
     _renderCache.CleanupCache(&_sequenceElements);
     _renderCache.SetSequence(renderCacheDirectory, "");
+    VideoFrameCache::GetCache().Clear();
 
     // clear everything to prepare for new sequence
     if (displayElementsPanel != nullptr)
@@ -667,6 +676,7 @@ bool xLightsFrame::CloseSequence()
             mainSequencer->ViewChoice->Clear();
     }
     _seqData.init(0, 0, 50);
+    _renderHashIndex.Clear();
     EnableSequenceControls(true); // let it re-evaluate menu state
     SetStatusText("");
     SetStatusText(CurrentDir, true);
@@ -701,6 +711,66 @@ void xLightsFrame::ClearSequenceData()
     wxASSERT(_seqData.IsValidData());
     for (size_t i = 0; i < _seqData.NumFrames(); ++i)
         _seqData[i].Zero();
+    _renderHashIndex.Clear();
+}
+
+// true if the sequence data is just the rendered effects ... no iseq data layers and not adding to an existing fseq
+bool xLightsFrame::IsEffectOnlySequenceData() const
+{
+    if (CurrentSeqXmlFile == nullptr) return false;
+    DataLayerSet& data_layers = CurrentSeqXmlFile->GetDataLayers();
+    return data_layers.GetNumLayers() == 1 &&
+           data_layers.GetDataLayer(0)->GetName() == "Nutcracker" &&
+           data_layers.GetDataLayer(0)->GetDataSource() != xLightsXmlFile::CANVAS_MODE;
+}
+
+static wxString GetRenderHashFile()
+{
+    wxFileName fn(xLightsFrame::CurrentSeqXmlFile->GetFullPath());
+    fn.SetExt("xrhash");
+    return fn.GetFullPath();
+}
+
+// identifies the fseq and the xLights version the hashes were saved with
+static std::string GetRenderHashSignature(const wxString& fseq)
+{
+    if (!FileExists(fseq)) return "";
+    wxFileName fn(fseq);
+    return wxString::Format("%s:%s:%llu:%lld", xlights_version_string, fn.GetFullName(), (unsigned long long)fn.GetSize().GetValue(), (long long)fn.GetModificationTime().GetTicks()).ToStdString();
+}
+
+void xLightsFrame::LoadRenderHashIndex()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _renderHashIndex.Clear();
+    if (CurrentSeqXmlFile == nullptr || !IsEffectOnlySequenceData() || !FileExists(GetRenderHashFile())) return;
+
+    if (_renderHashIndex.Load(GetRenderHashFile().ToStdString(), GetRenderHashSignature(xlightsFilename),
+                              _seqData.NumChannels(), _seqData.NumFrames(), _seqData.FrameTime(), _seqData.GetGeneration())) {
+        logger_base.debug("Loaded render hashes from %s.", (const char*)GetRenderHashFile().c_str());
+    } else {
+        logger_base.debug("Render hashes in %s dont match the fseq file so will be ignored.", (const char*)GetRenderHashFile().c_str());
+    }
+}
+
+void xLightsFrame::SaveRenderHashIndex()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (CurrentSeqXmlFile == nullptr) return;
+
+    wxString file = GetRenderHashFile();
+    if (IsEffectOnlySequenceData() &&
+        _renderHashIndex.IsValidFor(_seqData.NumChannels(), _seqData.NumFrames(), _seqData.FrameTime(), _seqData.GetGeneration())) {
+        ObtainAccessToURL(file.ToStdString());
+        if (!_renderHashIndex.Save(file.ToStdString(), GetRenderHashSignature(xlightsFilename))) {
+            logger_base.warn("Unable to save render hashes to %s.", (const char*)file.c_str());
+        }
+    } else if (FileExists(file)) {
+        // out of date so get rid of it
+        wxRemoveFile(file);
+    }
 }
 
 void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog)
@@ -719,6 +789,11 @@ void xLightsFrame::RenderIseqData(bool bottom_layers, ConvertLogDialog* plog)
         }
     }
 
+    if (bottom_layers && IsEffectOnlySequenceData()) {
+        // no layers to render and RenderGridToSeqData clears whatever it is going to render
+        return;
+    }
+
     if (bottom_layers) {
         logger_base.debug("xLightsFrame::RenderIseqData clearing sequence data.");
         ClearSequenceData();
@@ -277,6 +277,7 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     Cleanup();
+    ++_generation;
     if (roundto4) {
         _numChannels = roundTo4(numChannels);
     }
@@ -92,6 +92,7 @@ public:
     unsigned int _numChannels;
     unsigned int _numFrames;
     unsigned int _frameTime;
+    unsigned int _generation = 0;
 
     SequenceData(const SequenceData&) = delete;  //make sure we cannot "copy" these
     SequenceData &operator=(const SequenceData& rgb) = delete;
@@ -124,6 +125,8 @@ public:
     unsigned int NumFrames() const { return _numFrames;}
     unsigned int FrameTime() const { return _frameTime;}
     bool IsValidData() const { return !_dataBlocks.empty(); }
+    // changes every time the data is reallocated
+    unsigned int GetGeneration() const { return _generation; }
 
     // encodes contents of SeqData in channel order
     wxString base64_encode();
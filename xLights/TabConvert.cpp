@@ -1495,4 +1495,7 @@ void xLightsFrame::WriteFalconPiFile(const wxString& filename, bool allowSparse)
     }
 
     FileConverter::WriteFalconPiFile(write_params);
+    if (filename == xlightsFilename) {
+        SaveRenderHashIndex();
+    }
 }
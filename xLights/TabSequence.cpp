@@ -13,6 +13,7 @@
 #include <wx/clipbrd.h>
 #include <wx/xml/xml.h>
 #include <wx/config.h>
+#include <wx/file.h>
 
 #include "xLightsMain.h"
 #include "SeqSettingsDialog.h"
@@ -43,6 +44,7 @@
 
 #include "xLightsVersion.h"
 #include "TopEffectsPanel.h"
+#include "xLightsApp.h"
 
 #include <log4cpp/Category.hh>
 
@@ -1144,6 +1146,28 @@ void xLightsFrame::OpenAndCheckSequence(const wxArrayString& origFilenames, bool
     CallAfter(&xLightsFrame::OpenAndCheckSequence, fileNames, exitOnDone);
 }
 
+// one line per sequence in the -rp command line timing report
+static void AppendRenderReport(const wxString& seq, unsigned int frames, unsigned int frameTime, long renderMS, long totalMS, const wxString& status)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    const wxString& report = xLightsApp::renderReport;
+    if (report.IsEmpty()) return;
+
+    wxFile f;
+    bool isNew = !FileExists(report);
+    if (!f.Open(report, wxFile::write_append)) {
+        logger_base.error("Unable to write render report %s.", (const char*)report.c_str());
+        return;
+    }
+    if (isNew) {
+        f.Write("Sequence,Frames,Frame MS,Render Seconds,Save Seconds,Total Seconds,Status\n");
+    }
+    f.Write(wxString::Format("\"%s\",%u,%u,%.3f,%.3f,%.3f,%s\n", seq, frames, frameTime,
+                             (double)renderMS / 1000.0, (double)(totalMS - renderMS) / 1000.0, (double)totalMS / 1000.0, status));
+    f.Close();
+}
+
 void xLightsFrame::OpenRenderAndSaveSequencesF(const wxArrayString& origFileNames, int flags)
 {
     OpenRenderAndSaveSequences(origFileNames, flags & RENDER_EXIT_ON_DONE, flags & RENDER_ALREADY_RETRIED);
@@ -1223,6 +1247,7 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
         GaugeSizer->Layout();
 
         if (!aborted || alreadyRetried) {
+            long renderMS = sw.Time();
             logger_base.info("Saving fseq file.");
             SetStatusText(_("Saving ") + xlightsFilename + _(" ... Writing fseq."));
             WriteFalconPiFile(xlightsFilename);
@@ -1232,6 +1257,7 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
             wxString displayBuff = wxString::Format(_("%s     Updated in %7.3f seconds"), xlightsFilename, elapsedTime);
             logger_base.info("%s", (const char*)displayBuff.c_str());
             CallAfter(&xLightsFrame::SetStatusText, displayBuff, 0);
+            AppendRenderReport(fileNames[0], _seqData.NumFrames(), _seqData.FrameTime(), renderMS, sw.Time(), aborted ? "Aborted" : "Rendered");
             mSavedChangeCount = _sequenceElements.GetChangeCount();
             mLastAutosaveCount = mSavedChangeCount;
 
@@ -1473,7 +1499,7 @@ void xLightsFrame::SaveAsSequence(const std::string& filename)
     UpdateRecentFilesList(false);
 }
 
-void xLightsFrame::RenderAll()
+void xLightsFrame::RenderAll(bool force)
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
@@ -1491,7 +1517,7 @@ void xLightsFrame::RenderAll()
     GaugeSizer->Layout();
     SetStatusText(_("Rendering all layers"));
     SuspendAutoSave(true); // no need to auto save during render all
-    logger_base.debug("Rendering all.");
+    logger_base.debug("Rendering all%s.", force ? " (forced)" : "");
     logger_base.debug("Model blending: %s", CurrentSeqXmlFile->supportsModelBlending() ? "On" : "Off");
     RenderIseqData(true, nullptr); // render ISEQ layers below the Nutcracker layer
     logger_base.info("   iseq below effects done.");
@@ -1513,7 +1539,7 @@ void xLightsFrame::RenderAll()
         _appProgress->SetValue(0);
         _appProgress->Reset();
         GaugeSizer->Layout();
-    });
+    }, force);
 }
 
 static void enableAllChildControls(wxWindow* parent, bool enable)
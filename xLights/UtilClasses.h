@@ -13,11 +13,13 @@
 #include <map>
 #include <string>
 #include <algorithm>
+#include <atomic>
 
 #include <wx/filepicker.h>
 #include "UtilFunctions.h"
 
 class EffectManager;
+class EffectSettingsCache;
 
 
 class MapStringString: public std::map<std::string,std::string> {
@@ -213,13 +215,34 @@ class SettingsMap: public MapStringString {
 public:
     SettingsMap(): MapStringString() {
     }
-    virtual ~SettingsMap() {}
+    // the parsed settings cache is never shared ... each copy builds its own when first used
+    SettingsMap(const SettingsMap& other): MapStringString(other) {
+    }
+    virtual ~SettingsMap();
+
+    SettingsMap& operator=(const SettingsMap& other) {
+        if (this != &other) {
+            ResetCache();
+            MapStringString::operator=(other);
+        }
+        return *this;
+    }
+    void clear() {
+        ResetCache();
+        MapStringString::clear();
+    }
 
     virtual void RemapKey(std::string &n, std::string &value) {
         RemapChangedSettingKey(n, value);
     }
+
+    // parsed value curves and slider values for the effect these settings were loaded from
+    EffectSettingsCache& GetCache() const;
 private:
     static void RemapChangedSettingKey(std::string &n,  std::string &value);
+    void ResetCache();
+
+    mutable std::atomic<EffectSettingsCache*> _cache{ nullptr };
 };
 
 class RangeAccumulator
@@ -0,0 +1,292 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "VideoFrameCache.h"
+#include "VideoReader.h"
+
+#undef min
+#include <algorithm>
+#include <cstring>
+
+#include <log4cpp/Category.hh>
+
+#pragma region VideoFrameScaler
+
+VideoFrameScaler::~VideoFrameScaler()
+{
+    if (_swsCtx != nullptr) {
+        sws_freeContext(_swsCtx);
+        _swsCtx = nullptr;
+    }
+}
+
+const uint8_t* VideoFrameScaler::Scale(const VideoFrame& frame, int width, int height)
+{
+    if (width == frame.width && height == frame.height) {
+        return frame.data.data();
+    }
+    if (width <= 0 || height <= 0 || frame.width <= 0 || frame.height <= 0) {
+        return nullptr;
+    }
+
+    // only rebuilt when one of the sizes changes
+    _swsCtx = sws_getCachedContext(_swsCtx, frame.width, frame.height, AV_PIX_FMT_RGBA,
+                                   width, height, AV_PIX_FMT_RGBA, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    if (_swsCtx == nullptr) {
+        return nullptr;
+    }
+
+    _data.resize((size_t)width * height * 4);
+    const uint8_t* src[4] = { frame.data.data(), nullptr, nullptr, nullptr };
+    int srcStride[4] = { frame.width * 4, 0, 0, 0 };
+    uint8_t* dst[4] = { _data.data(), nullptr, nullptr, nullptr };
+    int dstStride[4] = { width * 4, 0, 0, 0 };
+    sws_scale(_swsCtx, src, srcStride, 0, frame.height, dst, dstStride);
+
+    return _data.data();
+}
+
+void VideoFrameScaler::GetScaledSize(int nativeWidth, int nativeHeight, int maxWidth, int maxHeight, bool keepAspectRatio, int& width, int& height)
+{
+    if (keepAspectRatio && nativeWidth > 0 && nativeHeight > 0) {
+        // if > 0 then video will be shrunk
+        // if < 0 then video will be stretched
+        float shrink = std::min((float)maxWidth / (float)nativeWidth, (float)maxHeight / (float)nativeHeight);
+        height = (int)((float)nativeHeight * shrink);
+        width = (int)((float)nativeWidth * shrink);
+    } else {
+        height = maxHeight;
+        width = maxWidth;
+    }
+}
+
+#pragma endregion
+
+#pragma region VideoFrameCache
+
+VideoFrameCache::Decoder::~Decoder()
+{
+    if (reader != nullptr) {
+        delete reader;
+        reader = nullptr;
+    }
+}
+
+VideoFrameCache& VideoFrameCache::GetCache()
+{
+    static VideoFrameCache cache;
+    return cache;
+}
+
+void VideoFrameCache::SetMaxMemory(size_t bytes)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_maxMemory != bytes) {
+        logger_base.debug("Video frame cache limited to %luMB.", (unsigned long)(bytes / (1024 * 1024)));
+    }
+    _maxMemory = bytes;
+    Evict();
+}
+
+std::shared_ptr<VideoFrameCache::Source> VideoFrameCache::GetSource(const std::string& filename)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _sources.find(filename);
+        if (it != _sources.end()) {
+            return it->second;
+        }
+    }
+
+    // open it outside the lock ... it can be slow and others may be rendering other files
+    auto decoder = std::make_shared<Decoder>();
+    decoder->reader = new VideoReader(filename, 0, 0, false, true, true);
+
+    auto source = std::make_shared<Source>();
+    source->filename = filename;
+    if (decoder->reader->IsValid() && decoder->reader->GetLengthMS() > 0) {
+        source->valid = true;
+        source->lengthMS = decoder->reader->GetLengthMS();
+        source->frameMS = std::max(1, decoder->reader->GetFrameMS());
+        source->width = decoder->reader->GetWidth();
+        source->height = decoder->reader->GetHeight();
+        // read the first frame ... if i dont it thinks the first frame i read is the first frame
+        decoder->reader->GetNextFrame(0);
+        source->decoders.push_back(decoder);
+        logger_base.debug("Video frame cache opened %s %dx%d %dms.", (const char*)filename.c_str(), source->width, source->height, source->lengthMS);
+    } else {
+        logger_base.warn("Video frame cache could not open %s.", (const char*)filename.c_str());
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto res = _sources.emplace(filename, source);
+    return res.first->second; // if someone beat us to it we use theirs and ours is thrown away
+}
+
+bool VideoFrameCache::GetInfo(const std::string& filename, int& lengthMS, int& width, int& height)
+{
+    auto source = GetSource(filename);
+    lengthMS = source->lengthMS;
+    width = source->width;
+    height = source->height;
+    return source->valid;
+}
+
+// must hold _lock
+std::shared_ptr<const VideoFrame> VideoFrameCache::Find(Source* source, long slot)
+{
+    auto it = source->frames.find(slot);
+    if (it == source->frames.end()) {
+        return nullptr;
+    }
+    _lru.splice(_lru.end(), _lru, it->second.lru);
+    return it->second.frame;
+}
+
+// must hold _lock
+std::shared_ptr<VideoFrameCache::Decoder> VideoFrameCache::PickDecoder(Source* source, long timestampMS)
+{
+    // best is the one just behind where we want to be as it wont have to seek
+    std::shared_ptr<Decoder> best;
+    for (const auto& it : source->decoders) {
+        if (it->pos <= timestampMS + source->frameMS && timestampMS - it->pos <= 1000) {
+            if (best == nullptr || it->pos > best->pos) {
+                best = it;
+            }
+        }
+    }
+
+    if (best == nullptr) {
+        if ((int)source->decoders.size() < MAX_DECODERS) {
+            best = std::make_shared<Decoder>();
+            source->decoders.push_back(best);
+        } else {
+            // everyone is somewhere else so take the one used least recently and let it seek
+            for (const auto& it : source->decoders) {
+                if (best == nullptr || it->lastUsed < best->lastUsed) {
+                    best = it;
+                }
+            }
+        }
+    }
+
+    best->lastUsed = ++_clock;
+    best->pos = timestampMS; // so others looking for a nearby frame go here and wait rather than start another
+    return best;
+}
+
+std::shared_ptr<const VideoFrame> VideoFrameCache::GetFrame(const std::string& filename, long timestampMS, bool& atEnd)
+{
+    atEnd = false;
+
+    auto source = GetSource(filename);
+    if (!source->valid) {
+        return nullptr;
+    }
+    if (timestampMS > source->lengthMS) {
+        atEnd = true;
+        return nullptr;
+    }
+
+    long slot = std::max(0L, timestampMS) / source->frameMS;
+    std::shared_ptr<Decoder> decoder;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto frame = Find(source.get(), slot);
+        if (frame != nullptr) {
+            ++_hits;
+            return frame;
+        }
+        decoder = PickDecoder(source.get(), timestampMS);
+    }
+
+    std::unique_lock<std::mutex> decoderLock(decoder->lock);
+
+    // whoever we waited on may have decoded it
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto frame = Find(source.get(), slot);
+        if (frame != nullptr) {
+            ++_hits;
+            return frame;
+        }
+        ++_misses;
+    }
+
+    if (decoder->reader == nullptr) {
+        decoder->reader = new VideoReader(filename, 0, 0, false, true, true);
+        // read the first frame ... if i dont it thinks the first frame i read is the first frame
+        decoder->reader->GetNextFrame(0);
+    }
+
+    AVFrame* image = decoder->reader->GetNextFrame(timestampMS);
+    atEnd = decoder->reader->AtEnd();
+    if (image == nullptr || image->data[0] == nullptr) {
+        return nullptr;
+    }
+
+    auto frame = std::make_shared<VideoFrame>();
+    frame->width = decoder->reader->GetWidth();
+    frame->height = decoder->reader->GetHeight();
+    size_t row = (size_t)frame->width * 4;
+    frame->data.resize(row * frame->height);
+    for (int y = 0; y < frame->height; ++y) {
+        memcpy(frame->data.data() + y * row, image->data[0] + (size_t)y * image->linesize[0], row);
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    // Clear may have been called while we decoded ... then we just hand the frame back
+    auto it = _sources.find(filename);
+    if (it != _sources.end() && it->second == source && source->frames.find(slot) == source->frames.end()) {
+        auto lru = _lru.insert(_lru.end(), std::make_pair(source.get(), slot));
+        source->frames[slot] = { frame, lru };
+        _usedMemory += frame->data.size();
+        Evict();
+    }
+    return frame;
+}
+
+// must hold _lock
+void VideoFrameCache::Evict()
+{
+    while (_usedMemory > _maxMemory && !_lru.empty()) {
+        auto& oldest = _lru.front();
+        auto it = oldest.first->frames.find(oldest.second);
+        if (it != oldest.first->frames.end()) {
+            _usedMemory -= it->second.frame->data.size();
+            oldest.first->frames.erase(it);
+        }
+        _lru.pop_front();
+    }
+}
+
+void VideoFrameCache::Clear()
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (!_sources.empty()) {
+        logger_base.debug("Video frame cache cleared. %d files, %luMB, %llu hits, %llu misses.",
+                          (int)_sources.size(), (unsigned long)(_usedMemory / (1024 * 1024)),
+                          (unsigned long long)_hits, (unsigned long long)_misses);
+    }
+    // decoders still in use are kept alive by whoever is using them
+    _sources.clear();
+    _lru.clear();
+    _usedMemory = 0;
+    _hits = 0;
+    _misses = 0;
+}
+
+#pragma endregion
@@ -0,0 +1,124 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class VideoReader;
+struct SwsContext;
+
+// a decoded frame at the video's native resolution, RGBA top row first
+struct VideoFrame
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> data;
+};
+
+// Scales the shared frames to the size one consumer wants. Each consumer keeps its own so the scaler is only set up
+// when the size changes.
+class VideoFrameScaler
+{
+    SwsContext* _swsCtx = nullptr;
+    std::vector<uint8_t> _data;
+
+public:
+    VideoFrameScaler() {}
+    ~VideoFrameScaler();
+    VideoFrameScaler(const VideoFrameScaler&) = delete;
+    VideoFrameScaler& operator=(const VideoFrameScaler&) = delete;
+
+    // RGBA at width x height, good until the next call
+    const uint8_t* Scale(const VideoFrame& frame, int width, int height);
+
+    // the same sizing VideoReader does for a maximum size
+    static void GetScaledSize(int nativeWidth, int nativeHeight, int maxWidth, int maxHeight, bool keepAspectRatio, int& width, int& height);
+};
+
+// Process wide cache of decoded video frames keyed by file and time.
+//
+// Every effect showing the same clip shares a small set of decoders running at the native resolution so a frame is
+// decoded once however many props show it, each consumer then scales it to its own buffer. Consumers at different
+// points in the clip get their own decoder (up to MAX_DECODERS a file) rather than making one seek back and forth.
+// Once the frames go over the memory budget the least recently used are dropped.
+class VideoFrameCache
+{
+    struct Decoder
+    {
+        std::mutex lock; // held while decoding
+        VideoReader* reader = nullptr;
+        long pos = -1000; // ms of the last frame decoded
+        uint64_t lastUsed = 0;
+        ~Decoder();
+    };
+
+    struct Source;
+    typedef std::list<std::pair<Source*, long>> LRU;
+
+    struct CachedFrame
+    {
+        std::shared_ptr<const VideoFrame> frame;
+        LRU::iterator lru;
+    };
+
+    struct Source
+    {
+        std::string filename;
+        bool valid = false;
+        int lengthMS = 0;
+        int frameMS = 50;
+        int width = 0;
+        int height = 0;
+        std::map<long, CachedFrame> frames; // keyed on the frame number
+        std::list<std::shared_ptr<Decoder>> decoders;
+    };
+
+    std::mutex _lock; // everything bar the decoding
+    std::map<std::string, std::shared_ptr<Source>> _sources;
+    LRU _lru; // front is the oldest
+    size_t _usedMemory = 0;
+    size_t _maxMemory = DEFAULT_MAX_MEMORY;
+    uint64_t _clock = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+
+    std::shared_ptr<Source> GetSource(const std::string& filename);
+    std::shared_ptr<Decoder> PickDecoder(Source* source, long timestampMS);
+    std::shared_ptr<const VideoFrame> Find(Source* source, long slot);
+    void Evict();
+
+public:
+    static const int MAX_DECODERS = 4;
+    static const size_t DEFAULT_MAX_MEMORY = 512 * 1024 * 1024;
+
+    static VideoFrameCache& GetCache();
+
+    VideoFrameCache() {}
+    ~VideoFrameCache() { Clear(); }
+
+    void SetMaxMemory(size_t bytes);
+    size_t GetMaxMemory() const { return _maxMemory; }
+
+    // false if the file cant be opened as a video
+    bool GetInfo(const std::string& filename, int& lengthMS, int& width, int& height);
+
+    // the frame showing at timestampMS, nullptr past the end or if it cant be decoded
+    std::shared_ptr<const VideoFrame> GetFrame(const std::string& filename, long timestampMS, bool& atEnd);
+
+    // drops all the frames and closes the decoders ... anyone still holding a frame keeps it
+    void Clear();
+};
@@ -33,6 +33,7 @@ public:
                 bool wantAlpha = false, bool bgr = false, bool wantsHardwareDecoderType = false);
 	~VideoReader();
 	int GetLengthMS() const { return (int)_lengthMS; };
+    int GetFrameMS() const { return _frameMS; }
 	void Seek(int timestampMS, bool readFrame = true);
 	AVFrame* GetNextFrame(int timestampMS, int gracetime = 0); // grace time is the minimum the video must be ahead before we bother to seek back to a frame
 	bool IsValid() const { return _valid; };
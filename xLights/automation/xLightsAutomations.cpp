@@ -242,7 +242,7 @@ bool xLightsFrame::ProcessAutomation(std::vector<std::string> &paths,
             _outputModelManager.AddImmediateWork(OutputModelManager::WORK_RELOAD_MODEL_FROM_XML, "Automation::renderAll");
             _outputModelManager.AddImmediateWork(OutputModelManager::WORK_MODELS_CHANGE_REQUIRING_RERENDER, "Automation::renderAll");
         }
-        RenderAll();
+        RenderAll(params["force"] == "true");
         while (mRendering) {
             wxYield();
         }
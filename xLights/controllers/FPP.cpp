@@ -1171,8 +1171,8 @@ bool FPP::PrepareUploadSequence(FSEQFile *file,
             tempFileName = file->getFilename();
             return false;
         }
-        if (type == 1 && file->getVersionMajor() == 2) {
-            // Full v2 file, upload directly
+        if (type == 1 && file->getVersionMajor() == 2 && ((V2FSEQFile*)file)->m_channelGroups.empty()) {
+            // Full v2 file, upload directly ... unless it is stored in channel groups which FPP cannot read
             outputFile = file;
             outputFileIsOriginal = true;
             tempFileName = file->getFilename();
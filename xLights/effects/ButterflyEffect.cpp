@@ -23,6 +23,9 @@
 #include "../../include/butterfly-64.xpm"
 
 #include "../Parallel.h"
+#include "../FastTrig.h"
+
+#include <vector>
 
 ButterflyEffect::ButterflyEffect(int i) : RenderableEffect(i, "Butterfly", butterfly_16, butterfly_24, butterfly_32, butterfly_48, butterfly_64)
 {
@@ -96,216 +99,223 @@ void ButterflyEffect::Render(Effect *effect, const SettingsMap &SettingsMap, Ren
     const int frame=(buffer.BufferHt * curState / 200)%maxframe;
     const size_t colorcnt=buffer.GetColorCount();
     const double offset = (ButterflyDirection==1 ? -1 : 1) * double(curState)/200.0;
-    const int xc=buffer.BufferWi/2;
-    const int yc=buffer.BufferHt/2;
+    const int width = buffer.BufferWi;
+    const int height = buffer.BufferHt;
     int block = buffer.BufferHt * buffer.BufferWi > 100 ? 1 : -1;
-    parallel_for(0, buffer.BufferWi, [&buffer, Style, &xc, &yc, &offset, frame, maxframe, Chunks, colorcnt, Skip, ColorScheme, butterFlySpeed](int x) {
-        double  fractpart, intpart;
-        double h=0.0,hue1,hue2;
-        xlColor color;
-        HSVValue hsv;
-        int y, d, x0, y0;
-        double n,x1,y1,f;
-        double rx,ry,cx,cy,v,time,multiplier;
 
-        for (y=0; y<buffer.BufferHt; y++)
-        {
-            switch (Style)
-            {
+    // each row is done as arrays of values so the sin/sqrt can be done 4 pixels at a time
+    if (Style <= 5) {
+        //  http://mathworld.wolfram.com/ButterflyFunction.html
+        const float angleScale = pi2 / float(Style == 5 ? buffer.BufferHt * buffer.BufferWi : buffer.BufferHt + buffer.BufferWi);
+        auto butterflyN = [offset, angleScale](int x, int y) {
+            return (float)(x * x - y * y) * FastTrig::FastSin(offset + (x + y) * angleScale);
+        };
+        auto butterflyH = [Style](float n, int d) {
+            double h = d > 0.001 ? (Style == 4 ? n : std::abs(n)) / d : 0.0;
+            if (Style == 4) {
+                double intpart;
+                h = modf(h, &intpart);
+                if (h < 0) h = 1.0 + h;
+            }
+            return h;
+        };
+
+        double f = (frame < maxframe / 2) ? frame + 1 : maxframe - frame;
+        if (Style == 3) {
+            f = f * 0.1 + double(buffer.BufferHt) / 60.0;
+        }
+        // for style 3 the sin(x1) doesn't depend on the row
+        std::vector<float> sinx1;
+        if (Style == 3) {
+            sinx1.resize(width);
+            for (int x = 0; x < width; x++) {
+                sinx1[x] = (x - buffer.BufferWi / 2.0) / f;
+            }
+            FastTrig::Sin(sinx1.data(), width);
+        }
+
+        parallel_for(0, height, [&](int y) {
+            std::vector<float> h(width);
+            switch (Style) {
                 case 1:
-                    //  http://mathworld.wolfram.com/ButterflyFunction.html
-                    n = std::abs((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                    d = x*x + y*y;
-                    
-                    //  This section is to fix the colors on pixels at {0,1} and {1,0}
-                    x0=x+1;
-                    y0=y+1;
-                    if((x==0 && y==1))
-                    {
-                        n = std::abs((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x*x + y0*y0;
+                case 4:
+                case 5:
+                    for (int x = 0; x < width; x++) {
+                        h[x] = offset + (x + y) * angleScale;
                     }
-                    if((x==1 && y==0))
-                    {
-                        n = std::abs((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x0*x0 + y*y;
+                    FastTrig::Sin(h.data(), width);
+                    for (int x = 0; x < width; x++) {
+                        h[x] = butterflyH((float)(x * x - y * y) * h[x], x * x + y * y);
                     }
-                    // end of fix
-                    
-                    h=d>0.001 ? n/d : 0.0;
-                    break;
-                    
-                case 2:
-                    f=(frame < maxframe/2) ? frame+1 : maxframe - frame;
-                    x1=(double(x)-buffer.BufferWi/2.0)/f;
-                    y1=(double(y)-buffer.BufferHt/2.0)/f;
-                    h=sqrt(x1*x1+y1*y1);
-                    break;
-                    
-                case 3:
-                    f=(frame < maxframe/2) ? frame+1 : maxframe - frame;
-                    f=f*0.1+double(buffer.BufferHt)/60.0;
-                    x1 = (x-buffer.BufferWi/2.0)/f;
-                    y1 = (y-buffer.BufferHt/2.0)/f;
-                    h=buffer.sin(x1) * buffer.cos(y1);
-                    break;
-                    
-                case 4:
-                    //  http://mathworld.wolfram.com/ButterflyFunction.html
-                    n = ((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                    d = x*x + y*y;
-                    
+
                     //  This section is to fix the colors on pixels at {0,1} and {1,0}
-                    x0=x+1;
-                    y0=y+1;
-                    if((x==0 && y==1))
-                    {
-                        n = ((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x*x + y0*y0;
+                    if (y == 1 && width > 0) {
+                        h[0] = butterflyH(butterflyN(0, 2), 4);
                     }
-                    if((x==1 && y==0))
-                    {
-                        n = ((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x0*x0 + y*y;
+                    if (y == 0 && width > 1) {
+                        h[1] = butterflyH(butterflyN(2, 0), 4);
                     }
-                    // end of fix
-                    
-                    h=d>0.001 ? n/d : 0.0;
-                    fractpart = modf (h , &intpart);
-                    h=fractpart;
-                    if(h<0) h=1.0+h;
                     break;
-                    
-                case 5:
-                    //  http://mathworld.wolfram.com/ButterflyFunction.html
-                    n = std::abs((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
-                    d = x*x + y*y;
-                    
-                    //  This section is to fix the colors on pixels at {0,1} and {1,0}
-                    x0=x+1;
-                    y0=y+1;
-                    if((x==0 && y==1))
-                    {
-                        n = std::abs((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
-                        d = x*x + y0*y0;
+                case 2: {
+                    float y1 = (double(y) - buffer.BufferHt / 2.0) / f;
+                    for (int x = 0; x < width; x++) {
+                        float x1 = (double(x) - buffer.BufferWi / 2.0) / f;
+                        h[x] = x1 * x1 + y1 * y1;
                     }
-                    if((x==1 && y==0))
-                    {
-                        n = std::abs((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
-                        d = x0*x0 + y*y;
+                    FastTrig::Sqrt(h.data(), width);
+                    break;
+                }
+                case 3: {
+                    float cosy1 = FastTrig::FastCos((y - buffer.BufferHt / 2.0) / f);
+                    for (int x = 0; x < width; x++) {
+                        h[x] = sinx1[x] * cosy1;
                     }
-                    // end of fix
-                    
-                    h=d>0.001 ? n/d : 0.0;
                     break;
-                    
+                }
             }
-            if(Style<=5)
-            {
-                
-                
-                hsv.saturation=1.0;
-                hsv.value=1.0;
-                if (Chunks <= 1 || int(h*Chunks) % Skip != 0)
-                {
-                    if (ColorScheme == 0)
-                    {
-                        hsv.hue=h;
-                        buffer.SetPixel(x,y,hsv);
-                    }
-                    else
-                    {
-                        buffer.GetMultiColorBlend(h,false,color);
-                        buffer.SetPixel(x,y,color);
+
+            xlColor color;
+            HSVValue hsv;
+            hsv.saturation = 1.0;
+            hsv.value = 1.0;
+            for (int x = 0; x < width; x++) {
+                if (Chunks <= 1 || int(h[x] * Chunks) % Skip != 0) {
+                    if (ColorScheme == 0) {
+                        hsv.hue = h[x];
+                        buffer.SetPixel(x, y, hsv);
+                    } else {
+                        buffer.GetMultiColorBlend(h[x], false, color);
+                        buffer.SetPixel(x, y, color);
                     }
                 }
             }
-            else  // Plasma
-            {
-                // reference: http://www.bidouille.org/prog/plasma
-                
-                int state = (buffer.curPeriod - buffer.curEffStartPer); // frames 0 to N
-                double Speed_plasma = (Style == 10) ? (101-butterFlySpeed)*3 : (101-butterFlySpeed)*5;
-                time = (state+1.0)/Speed_plasma;
-                
-                v=0;
-                
-                rx = ((float)x/buffer.BufferWi) -0.5;
-                ry = ((float)y/buffer.BufferHt) -0.5;
-                
-                
-                
-                // 1st equation
-                v=buffer.sin(rx*10+time);
-                
-                //  second equation
-                v+=buffer.sin(10*(rx*buffer.sin(time/2)+ry*buffer.cos(time/3))+time);
-                
-                //  third equation
-                cx=rx+.5*buffer.sin(time/5);
-                cy=ry+.5*buffer.cos(time/3);
-                v+=buffer.sin ( sqrt(100*((cx*cx)+(cy*cy))+1+time));
-                
-                
-                //    vec2 c = v_coords * u_k - u_k/2.0;
-                v += buffer.sin(rx+time);
-                v += buffer.sin((ry+time)/2.0);
-                v += buffer.sin((rx+ry+time)/2.0);
-                //   c += u_k/2.0 * vec2(sin(u_time/3.0), cos(u_time/2.0));
-                v += buffer.sin(sqrt(rx*rx+ry*ry+1.0)+time);
-                v = v/2.0;
-                // vec3 col = vec3(1, sin(PI*v), cos(PI*v));
-                //   gl_FragColor = vec4(col*.5 + .5, 1);
-                
-                buffer.GetMultiColorBlend(h,false,color);
-                //color.red=color.green=color.blue=h*255;
-                switch (Style)
-                {
-                    case 6:
-                        color.red = (buffer.sin(v*Chunks*pi)+1)*128;
-                        color.green= (buffer.cos(v*Chunks*pi)+1)*128;
-                        color.blue =0;
-                        break;
-                    case 7:
-                        color.red = 1;
-                        color.green= (buffer.cos(v*Chunks*pi)+1)*128;
-                        color.blue =(buffer.sin(v*Chunks*pi)+1)*128;
-                        break;
-                        
-                    case 8:
-                        color.red = (buffer.sin(v*Chunks*pi)+1)*128;
-                        color.green= (buffer.sin(v*Chunks*pi + 2*pi/3)+1)*128;
-                        color.blue =(buffer.sin(v*Chunks*pi+4*pi/3)+1)*128;
-                        break;
-                        
-                    case 9:
-                        color.red=color.green=color.blue=(buffer.sin(v*Chunks*pi) +1) * 128;
-                        break;
-                    case 10:
-                        if(colorcnt>=2)
-                        {
-                            buffer.GetMultiColorBlend(h,false,color);
-                            
-                            hue1=.1;
-                            hue1=0;
-                            hue2=.7;
-                            hue2=1;
-                            multiplier=(hue2-hue1)/2;
-                            h=hue1+ multiplier*(v+1); // v is between -1 to 1. h
-                            h = buffer.sin(v*Chunks*pi+2*pi/3)+1*0.5;
-                            
-                            hsv.hue=h;
-                            //  hsv.hue=hsv.hue + (v+1)/20.0;
-                            //color.red = (buffer.sin(v*color.red)+1)*128;
-                            //color.green = (buffer.sin(v*color.green)+1)*128;
-                            //color.blue = (buffer.sin(v*color.blue)+1)*128;
-                            
-                        }
-                        break;
+        }, block);
+        return;
+    }
+
+    // Plasma
+    // reference: http://www.bidouille.org/prog/plasma
+    const int state = (buffer.curPeriod - buffer.curEffStartPer); // frames 0 to N
+    const double Speed_plasma = (Style == 10) ? (101 - butterFlySpeed) * 3 : (101 - butterFlySpeed) * 5;
+    const float time = (state + 1.0) / Speed_plasma;
+    const float sin_time_2 = FastTrig::FastSin(time / 2);
+    const float cos_time_3 = FastTrig::FastCos(time / 3);
+    const float sin_time_5 = FastTrig::FastSin(time / 5);
+    const float cpi = Chunks * pi;
+
+    // the terms that only depend on x are the same for every row
+    std::vector<float> rxs(width), xterms(width), tmp(width);
+    for (int x = 0; x < width; x++) {
+        float rx = ((float)x / buffer.BufferWi) - 0.5;
+        rxs[x] = rx;
+        // 1st equation
+        xterms[x] = rx * 10 + time;
+        tmp[x] = rx + time;
+    }
+    FastTrig::Sin(xterms.data(), width);
+    FastTrig::Sin(tmp.data(), width);
+    for (int x = 0; x < width; x++) {
+        xterms[x] += tmp[x];
+    }
+
+    // v for the row ... a, b and c are scratch space
+    auto plasmaRow = [&](int y, std::vector<float>& v, std::vector<float>& a, std::vector<float>& b, std::vector<float>& c) {
+        const float ry = ((float)y / buffer.BufferHt) - 0.5;
+        const float cy = ry + .5 * cos_time_3;
+        const float ryterm = FastTrig::FastSin((ry + time) / 2.0);
+        for (int x = 0; x < width; x++) {
+            const float rx = rxs[x];
+            const float cx = rx + .5 * sin_time_5;
+            //  second equation
+            v[x] = 10 * (rx * sin_time_2 + ry * cos_time_3) + time;
+            //  third equation
+            a[x] = 100 * ((cx * cx) + (cy * cy)) + 1 + time;
+            b[x] = (rx + ry + time) / 2.0;
+            c[x] = rx * rx + ry * ry + 1.0;
+        }
+        FastTrig::Sqrt(a.data(), width);
+        FastTrig::Sqrt(c.data(), width);
+        for (int x = 0; x < width; x++) {
+            c[x] += time;
+        }
+        FastTrig::Sin(v.data(), width);
+        FastTrig::Sin(a.data(), width);
+        FastTrig::Sin(b.data(), width);
+        FastTrig::Sin(c.data(), width);
+        for (int x = 0; x < width; x++) {
+            v[x] = (xterms[x] + v[x] + a[x] + ryterm + b[x] + c[x]) / 2.0;
+        }
+    };
+    // out = sin(v * Chunks * pi + add)
+    auto sinOf = [cpi, width](const std::vector<float>& v, std::vector<float>& out, float add) {
+        for (int x = 0; x < width; x++) {
+            out[x] = v[x] * cpi + add;
+        }
+        FastTrig::Sin(out.data(), width);
+    };
+
+    parallel_for(0, height, [&](int y) {
+        std::vector<float> v(width), a(width), b(width), c(width);
+        xlColor color;
+
+        if (Style == 10) {
+            // style 10 colours each pixel from the hue calculated for the pixel above it
+            if (y == 0 || colorcnt < 2) {
+                buffer.GetMultiColorBlend(0.0, false, color);
+                for (int x = 0; x < width; x++) {
+                    buffer.SetPixel(x, y, color);
+                }
+            } else {
+                plasmaRow(y - 1, v, a, b, c);
+                sinOf(v, a, 2 * pi / 3);
+                for (int x = 0; x < width; x++) {
+                    buffer.GetMultiColorBlend(a[x] + 1 * 0.5, false, color);
+                    buffer.SetPixel(x, y, color);
                 }
-                
-                buffer.SetPixel(x,y,color);
             }
+            return;
+        }
+
+        plasmaRow(y, v, a, b, c);
+        switch (Style) {
+            case 6:
+                sinOf(v, a, 0);
+                sinOf(v, b, pi / 2);
+                for (int x = 0; x < width; x++) {
+                    color.red = (a[x] + 1) * 128;
+                    color.green = (b[x] + 1) * 128;
+                    color.blue = 0;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case 7:
+                sinOf(v, a, pi / 2);
+                sinOf(v, b, 0);
+                for (int x = 0; x < width; x++) {
+                    color.red = 1;
+                    color.green = (a[x] + 1) * 128;
+                    color.blue = (b[x] + 1) * 128;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case 8:
+                sinOf(v, a, 0);
+                sinOf(v, b, 2 * pi / 3);
+                sinOf(v, c, 4 * pi / 3);
+                for (int x = 0; x < width; x++) {
+                    color.red = (a[x] + 1) * 128;
+                    color.green = (b[x] + 1) * 128;
+                    color.blue = (c[x] + 1) * 128;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case 9:
+                sinOf(v, a, 0);
+                for (int x = 0; x < width; x++) {
+                    color.red = color.green = color.blue = (a[x] + 1) * 128;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
         }
     }, block);
 }
@@ -0,0 +1,117 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "EffectSettingsCache.h"
+#include "../UtilClasses.h"
+#include "../ValueCurve.h"
+
+#include <tuple>
+
+namespace
+{
+    const std::string* Find(const SettingsMap& settingsMap, const std::string& key)
+    {
+        auto it = settingsMap.find(key);
+        if (it == settingsMap.end()) return nullptr;
+        return &it->second;
+    }
+}
+
+EffectSettingsCache::Setting::Setting(const std::string& name) :
+    vcKey("VALUECURVE_" + name), sliderKey("SLIDER_" + name), textKey("TEXTCTRL_" + name)
+{
+}
+
+EffectSettingsCache::Setting::~Setting()
+{
+}
+
+EffectSettingsCache::Setting& EffectSettingsCache::Lookup(std::unordered_map<std::string, Setting>& settings, const std::string& name)
+{
+    auto it = settings.find(name);
+    if (it == settings.end()) {
+        it = settings.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(name)).first;
+    }
+    return it->second;
+}
+
+// matches the MapStringString GetInt/GetDouble parsing of the slider or text control value
+double EffectSettingsCache::GetSliderValue(const SettingsMap& settingsMap, Setting& setting, double def, bool isInt)
+{
+    const std::string* v = Find(settingsMap, setting.sliderKey);
+    if (v == nullptr) {
+        v = Find(settingsMap, setting.textKey);
+    }
+    if (v == nullptr) return def;
+
+    if (!setting.valueParsed || setting.valueDefault != def || *v != setting.valueSource) {
+        setting.valueSource = *v;
+        setting.valueDefault = def;
+        setting.valueParsed = true;
+        setting.value = def;
+        if (v->length() != 0 && v->at(0) != ' ') {
+            try {
+                setting.value = isInt ? stoi(*v) : stod(*v);
+            } catch (...) {
+                setting.value = def;
+            }
+        }
+    }
+    return setting.value;
+}
+
+double EffectSettingsCache::GetValueCurveDouble(const SettingsMap& settingsMap, const std::string& name, double def, float offset, double min, double max, long startMS, long endMS, int divisor)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    Setting& setting = Lookup(_doubles, name);
+    const std::string* vc = Find(settingsMap, setting.vcKey);
+    if (vc != nullptr && *vc != xlEMPTY_STRING) {
+        if (setting.curve == nullptr || *vc != setting.curveSource || setting.curveMin != min || setting.curveMax != max || setting.curveDivisor != divisor) {
+            setting.curve = std::make_unique<ValueCurve>(*vc);
+            setting.curve->SetLimits(min, max);
+            setting.curve->SetDivisor(divisor);
+            setting.curveSource = *vc;
+            setting.curveMin = min;
+            setting.curveMax = max;
+            setting.curveDivisor = divisor;
+        }
+        if (setting.curve->IsActive()) {
+            return setting.curve->GetOutputValueAtDivided(offset, startMS, endMS);
+        }
+    }
+    return GetSliderValue(settingsMap, setting, def, false);
+}
+
+int EffectSettingsCache::GetValueCurveInt(const SettingsMap& settingsMap, const std::string& name, int def, float offset, int min, int max, long startMS, long endMS, int divisor)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    Setting& setting = Lookup(_ints, name);
+    const std::string* vc = Find(settingsMap, setting.vcKey);
+    if (vc != nullptr) {
+        if (setting.curve == nullptr || *vc != setting.curveSource || setting.curveMin != min || setting.curveMax != max || setting.curveDivisor != divisor) {
+            // limits must be set before deserialising so old 0-100 curves get rescaled to them
+            setting.curve = std::make_unique<ValueCurve>();
+            setting.curve->SetDivisor(divisor);
+            setting.curve->SetLimits(min, max);
+            setting.curve->Deserialise(*vc);
+            setting.curveSource = *vc;
+            setting.curveMin = min;
+            setting.curveMax = max;
+            setting.curveDivisor = divisor;
+        }
+        if (setting.curve->IsActive()) {
+            return setting.curve->GetOutputValueAt(offset, startMS, endMS);
+        }
+    }
+    return (int)GetSliderValue(settingsMap, setting, def, true);
+}
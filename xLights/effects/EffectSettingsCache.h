@@ -0,0 +1,64 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class SettingsMap;
+class ValueCurve;
+
+// Parsed form of the value curve and slider settings an effect reads every frame.
+// Owned by the SettingsMap being rendered and thrown away when that map is cleared or reassigned so it is
+// rebuilt whenever the effect is reloaded. Each setting also remembers the string it was parsed from and
+// is re-parsed if that changes so a stale entry can never be used.
+class EffectSettingsCache
+{
+    struct Setting
+    {
+        Setting(const std::string& name);
+        ~Setting();
+
+        // the settings map keys ... built once rather than on every lookup
+        std::string vcKey;
+        std::string sliderKey;
+        std::string textKey;
+
+        std::unique_ptr<ValueCurve> curve;
+        std::string curveSource;
+        double curveMin = 0.0;
+        double curveMax = 0.0;
+        int curveDivisor = 1;
+
+        std::string valueSource;
+        double valueDefault = 0.0;
+        double value = 0.0;
+        bool valueParsed = false;
+    };
+
+    std::mutex _lock;
+    std::unordered_map<std::string, Setting> _doubles;
+    std::unordered_map<std::string, Setting> _ints;
+
+    Setting& Lookup(std::unordered_map<std::string, Setting>& settings, const std::string& name);
+    double GetSliderValue(const SettingsMap& settingsMap, Setting& setting, double def, bool isInt);
+
+public:
+    EffectSettingsCache() {}
+    virtual ~EffectSettingsCache() {}
+
+    // same results as RenderableEffect::GetValueCurveDouble/GetValueCurveInt without building keys or parsing
+    // the curve on every frame
+    double GetValueCurveDouble(const SettingsMap& settingsMap, const std::string& name, double def, float offset, double min, double max, long startMS, long endMS, int divisor);
+    int GetValueCurveInt(const SettingsMap& settingsMap, const std::string& name, int def, float offset, int min, int max, long startMS, long endMS, int divisor);
+};
@@ -201,7 +201,7 @@ void FireEffect::Render(Effect* effect, const SettingsMap& SettingsMap, RenderBu
         HeightPct = 10;
         if (buffer.GetMedia() != nullptr) {
             float f = 0.0;
-            std::list<float> const* const pf = buffer.GetMedia()->GetFrameData(buffer.curPeriod, FRAMEDATA_HIGH, "");
+            const FrameDataSpan* const pf = buffer.GetMedia()->GetFrameData(buffer.curPeriod, FRAMEDATA_HIGH, "");
             if (pf != nullptr) {
                 f = *pf->cbegin();
             }
@@ -22,6 +22,9 @@
 #include "../../include/plasma-64.xpm"
 
 #include "../Parallel.h"
+#include "../FastTrig.h"
+
+#include <vector>
 
 PlasmaEffect::PlasmaEffect(int id) : RenderableEffect(id, "Plasma", plasma_16, plasma_24, plasma_32, plasma_48, plasma_64)
 {
@@ -93,78 +96,119 @@ void PlasmaEffect::Render(Effect *effect, const SettingsMap &SettingsMap, Render
 
     if (PlasmaDirection==1) offset = -offset;
 
-    const double sin_time_5 = buffer.sin(time / 5);
-    const double cos_time_3 = buffer.cos(time / 3);
-    const double sin_time_2 = buffer.sin(time / 2);
-    static const double pi3 = pi / 3.0;
-
-    int block = buffer.BufferHt * buffer.BufferWi > 100 ? 1 : -1;
-    parallel_for(0, buffer.BufferWi, [&] (int x) {
-        double rx = ((float)x / (buffer.BufferWi - 1)); // rx is now in the range 0.0 to 1.0
-        double rx2 = rx * rx;
-        double cx = rx + .5*sin_time_5;
-        double cx2 = cx*cx;
-        double sin_rx_time = buffer.sin(rx + time);
-
+    const float sin_time_5 = FastTrig::FastSin(time / 5);
+    const float cos_time_3 = FastTrig::FastCos(time / 3);
+    const float sin_time_2 = FastTrig::FastSin(time / 2);
+    static const float pi3 = pi / 3.0;
+    const float ftime = time;
+    const int width = buffer.BufferWi;
+
+    // the terms that only depend on x are the same for every row
+    std::vector<float> rxs(width), rx2s(width), cx2s(width), xterms(width), tmp(width);
+    for (int x = 0; x < width; x++) {
+        float rx = ((float)x / (width - 1)); // rx is now in the range 0.0 to 1.0
+        float cx = rx + .5f * sin_time_5;
+        rxs[x] = rx;
+        rx2s[x] = rx * rx;
+        cx2s[x] = cx * cx;
         // 1st equation
-        double v1 = buffer.sin(rx * 10 + time);
-
-        for (int y=0; y<buffer.BufferHt; y++)
-        {
-            // reference: http://www.bidouille.org/prog/plasma
-
-            double ry = ((float)y/(buffer.BufferHt-1)) ;
-            double v = v1;
+        xterms[x] = rx * 10 + ftime;
+        tmp[x] = rx + ftime;
+    }
+    FastTrig::Sin(xterms.data(), width);
+    FastTrig::Sin(tmp.data(), width);
+    for (int x = 0; x < width; x++) {
+        xterms[x] += tmp[x];
+    }
 
+    // each row is done as arrays of angles so the sin/sqrt can be done 4 pixels at a time
+    int block = buffer.BufferHt * buffer.BufferWi > 100 ? 1 : -1;
+    parallel_for(0, buffer.BufferHt, [&] (int y) {
+        // reference: http://www.bidouille.org/prog/plasma
+        const float ry = ((float)y / (buffer.BufferHt - 1));
+        const float cy = ry + .5f * cos_time_3;
+        const float ryterm = FastTrig::FastSin((ry + ftime) / 2.0f);
+
+        std::vector<float> v(width), a(width), b(width), c(width);
+        for (int x = 0; x < width; x++) {
+            const float rx = rxs[x];
             //  second equation
-            v+=buffer.sin (10*(rx*sin_time_2+ry*cos_time_3)+time);
-
+            v[x] = 10 * (rx * sin_time_2 + ry * cos_time_3) + ftime;
             //  third equation
-            double cy=ry+.5*cos_time_3;
-            v+=buffer.sin ( sqrt((Style*50)*((cx2)+(cy*cy))+time));
-
-            //    vec2 c = v_coords * u_k - u_k/2.0;
-            v += sin_rx_time;
-            v += buffer.sin ((ry+time)/2.0);
-            v += buffer.sin ((rx+ry+time)/2.0);
-            //   c += u_k/2.0 * vec2(buffer.sin (u_time/3.0), buffer.cos (u_time/2.0));
-            v += buffer.sin (sqrt(rx2+ry*ry)+time);
-            v = v/2.0;
-            // vec3 col = vec3(1, buffer.sin (PI*v), buffer.cos (PI*v));
-            //   gl_FragColor = vec4(col*.5 + .5, 1);
-
-            double vldpi = v*Line_Density*pi;
-
-            xlColor color;
-            switch (ColorScheme)
-            {
-                case PLASMA_NORMAL_COLORS:
-                    {
-                        double h = (buffer.sin (vldpi + 2 * pi3) + 1) * 0.5;
-                        buffer.GetMultiColorBlend(h,false,color);
-                    }
-                    break;
-                case PLASMA_PRESET1:
-                    color.red = (buffer.sin (vldpi) + 1) * 128;
-                    color.green = (buffer.cos (vldpi) + 1) * 128;
+            a[x] = (Style * 50) * (cx2s[x] + (cy * cy)) + ftime;
+            b[x] = (rx + ry + ftime) / 2.0f;
+            c[x] = rx2s[x] + ry * ry;
+        }
+        FastTrig::Sqrt(a.data(), width);
+        FastTrig::Sqrt(c.data(), width);
+        for (int x = 0; x < width; x++) {
+            c[x] += ftime;
+        }
+        FastTrig::Sin(v.data(), width);
+        FastTrig::Sin(a.data(), width);
+        FastTrig::Sin(b.data(), width);
+        FastTrig::Sin(c.data(), width);
+
+        // v becomes v * Line_Density * pi
+        for (int x = 0; x < width; x++) {
+            v[x] = (xterms[x] + v[x] + a[x] + ryterm + b[x] + c[x]) / 2.0f * Line_Density * (float)pi;
+        }
+
+        // a, b and c are reused for the colour channels
+        auto sinOf = [&v, width](std::vector<float>& out, float add) {
+            for (int x = 0; x < width; x++) {
+                out[x] = v[x] + add;
+            }
+            FastTrig::Sin(out.data(), width);
+        };
+        xlColor color;
+        switch (ColorScheme)
+        {
+            case PLASMA_NORMAL_COLORS:
+                sinOf(a, 2 * pi3);
+                for (int x = 0; x < width; x++) {
+                    buffer.GetMultiColorBlend((a[x] + 1) * 0.5, false, color);
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case PLASMA_PRESET1:
+                sinOf(a, 0);
+                sinOf(b, FastTrig::HALF_PI);
+                for (int x = 0; x < width; x++) {
+                    color.red = (a[x] + 1) * 128;
+                    color.green = (b[x] + 1) * 128;
                     color.blue = 0;
-                    break;
-                case PLASMA_PRESET2:
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case PLASMA_PRESET2:
+                sinOf(a, FastTrig::HALF_PI);
+                sinOf(b, 0);
+                for (int x = 0; x < width; x++) {
                     color.red = 1;
-                    color.green = (buffer.cos (vldpi) + 1) * 128;
-                    color.blue = (buffer.sin (vldpi) + 1) * 128;
-                    break;
-
-                case PLASMA_PRESET3:
-                    color.red = (buffer.sin (vldpi) + 1) * 128;
-                    color.green = (buffer.sin (vldpi + 2 * pi3) + 1) * 128;
-                    color.blue = (buffer.sin (vldpi + 4 * pi3) + 1) * 128;
-                    break;
-                case PLASMA_PRESET4:
-                    color.red=color.green=color.blue = (buffer.sin(vldpi) + 1) * 128;
-                    break;
-            }
-            buffer.SetPixel(x,y,color);
+                    color.green = (a[x] + 1) * 128;
+                    color.blue = (b[x] + 1) * 128;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case PLASMA_PRESET3:
+                sinOf(a, 0);
+                sinOf(b, 2 * pi3);
+                sinOf(c, 4 * pi3);
+                for (int x = 0; x < width; x++) {
+                    color.red = (a[x] + 1) * 128;
+                    color.green = (b[x] + 1) * 128;
+                    color.blue = (c[x] + 1) * 128;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
+            case PLASMA_PRESET4:
+                sinOf(a, 0);
+                for (int x = 0; x < width; x++) {
+                    color.red = color.green = color.blue = (a[x] + 1) * 128;
+                    buffer.SetPixel(x, y, color);
+                }
+                break;
         }
     }, block);
 }
@@ -30,6 +30,10 @@ public:
     {
         return true;
     }
+    virtual int GetRenderVersion() const override
+    {
+        return 2; // fast trig
+    }
 
     virtual double GetSettingVCMin(const std::string& name) const override
     {
@@ -11,6 +11,7 @@
 #include "RenderableEffect.h"
 #include "../sequencer/Effect.h"
 #include "EffectManager.h"
+#include "EffectSettingsCache.h"
 #include "assist/xlGridCanvasEmpty.h"
 #include "../UtilFunctions.h"
 #include "../ExternalHooks.h"
@@ -914,26 +915,8 @@ void RenderableEffect::SetRadioValue(wxRadioButton *r) {
 
 double RenderableEffect::GetValueCurveDouble(const std::string &name, double def, const SettingsMap &SettingsMap, float offset, double min, double max, long startMS, long endMS, int divisor)
 {
-    double res = def;
-    const std::string vn = "VALUECURVE_" + name;
-    const std::string &vc = SettingsMap.Get(vn, xlEMPTY_STRING);
-    if (vc != xlEMPTY_STRING) {
-        ValueCurve valc(vc);
-        if (valc.IsActive()) {
-            valc.SetLimits(min, max);
-            valc.SetDivisor(divisor);
-            return valc.GetOutputValueAtDivided(offset, startMS, endMS);
-        }
-    }
-    
-    const std::string sn = "SLIDER_" + name;
-    const std::string tn = "TEXTCTRL_" + name;
-    if (SettingsMap.Contains(sn)) {
-        res = SettingsMap.GetDouble(sn, def);
-    } else if (SettingsMap.Contains(tn)) {
-        res = SettingsMap.GetDouble(tn, def);
-    }
-    return res;
+    // called for every setting on every frame so the parsed curve/slider is cached against the settings
+    return SettingsMap.GetCache().GetValueCurveDouble(SettingsMap, name, def, offset, min, max, startMS, endMS, divisor);
 }
 
 int RenderableEffect::GetValueCurveIntMax(const std::string& name, int def, const SettingsMap& SettingsMap, int min, int max, int divisor)
@@ -967,29 +950,7 @@ int RenderableEffect::GetValueCurveIntMax(const std::string& name, int def, cons
 
 int RenderableEffect::GetValueCurveInt(const std::string &name, int def, const SettingsMap &SettingsMap, float offset, int min, int max, long startMS, long endMS, int divisor)
 {
-    int res = def;
-    const std::string vn = "VALUECURVE_" + name;
-    if (SettingsMap.Contains(vn)) {
-        const std::string &vc = SettingsMap.Get(vn, xlEMPTY_STRING);
-
-        ValueCurve valc;
-        valc.SetDivisor(divisor);
-        valc.SetLimits(min, max);
-        valc.Deserialise(vc);
-        if (valc.IsActive()) {
-            return valc.GetOutputValueAt(offset, startMS, endMS);
-        }
-    }
-    const std::string sn = "SLIDER_" + name;
-    const std::string tn = "TEXTCTRL_" + name;
-    //bool slider = false;
-    if (SettingsMap.Contains(sn)) {
-        res = SettingsMap.GetInt(sn, def);
-        //slider = true;
-    } else if (SettingsMap.Contains(tn)) {
-        res = SettingsMap.GetInt(tn, def);
-    }
-    return res;
+    return SettingsMap.GetCache().GetValueCurveInt(SettingsMap, name, def, offset, min, max, startMS, endMS, divisor);
 }
 
 EffectLayer* RenderableEffect::GetTiming(const std::string& timingtrack) const
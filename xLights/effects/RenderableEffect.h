@@ -114,6 +114,11 @@ public:
         return true;
     }
     virtual bool SupportsRenderCache(const SettingsMap& settings) const;
+    // bump this when a change alters what the effect renders so previously rendered frames are not reused
+    virtual int GetRenderVersion() const
+    {
+        return 1;
+    }
     virtual void Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer) = 0;
     virtual void RenameTimingTrack(std::string oldname, std::string newname, Effect* effect)
     {}
@@ -744,7 +744,7 @@ void TendrilEffect::Render(RenderBuffer& buffer, const std::string& movement,
             // line movement based on music
             float f = 0.1f;
             if (buffer.GetMedia() != nullptr) {
-                std::list<float> const* const p = buffer.GetMedia()->GetFrameData(buffer.curPeriod, FRAMEDATA_HIGH, "");
+                const FrameDataSpan* const p = buffer.GetMedia()->GetFrameData(buffer.curPeriod, FRAMEDATA_HIGH, "");
                 if (p != nullptr) {
                     f = *p->cbegin();
                 }
@@ -767,7 +767,7 @@ void TendrilEffect::Render(RenderBuffer& buffer, const std::string& movement,
             }
             float f = 0.1f;
             if (buffer.GetMedia() != nullptr) {
-                const std::list<float>* p = buffer.GetMedia()->GetFrameData(buffer.curPeriod, FRAMEDATA_HIGH, "");
+                const FrameDataSpan* p = buffer.GetMedia()->GetFrameData(buffer.curPeriod, FRAMEDATA_HIGH, "");
                 if (p != nullptr) {
                     f = *p->begin();
                 }
@@ -17,6 +17,7 @@
 #include "VideoEffect.h"
 #include "VideoPanel.h"
 #include "../VideoReader.h"
+#include "../VideoFrameCache.h"
 #include "../sequencer/Effect.h"
 #include "../RenderBuffer.h"
 #include "../UtilClasses.h"
@@ -234,22 +235,22 @@ class VideoRenderCache : public EffectRenderCache {
 public:
     VideoRenderCache()
 	{
-		_videoframerate = -1;
-		_videoreader = nullptr;
+        _valid = false;
+        _videolen = 0;
+        _videoWidth = 0;
+        _videoHeight = 0;
         _loops = 0;
         _frameMS = 50;
         _nextManualMS = 0;
 	};
-    virtual ~VideoRenderCache() {
-		if (_videoreader != nullptr)
-		{
-			delete _videoreader;
-			_videoreader = nullptr;
-		}
-	};
-
-    VideoReader* _videoreader;
-	int _videoframerate;
+    virtual ~VideoRenderCache() {};
+
+    // the decoded frames are shared with every other effect showing this file, we just scale them to our buffer
+    VideoFrameScaler _scaler;
+    bool _valid;
+    int _videolen;
+    int _videoWidth;
+    int _videoHeight;
 	int _loops;
     int _frameMS;
     int _nextManualMS = 0;
@@ -300,7 +301,8 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
     }
 
     int &_loops = cache->_loops;
-    VideoReader* &_videoreader = cache->_videoreader;
+    bool& _valid = cache->_valid;
+    int& _videolen = cache->_videolen;
     int& _frameMS = cache->_frameMS;
     int& _nextManualMS = cache->_nextManualMS;
 
@@ -323,11 +325,8 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         _loops = 0;
         _nextManualMS = 0;
         _frameMS = buffer.frameTimeInMs;
-        if (_videoreader != nullptr)
-        {
-            delete _videoreader;
-            _videoreader = nullptr;
-        }
+        _valid = false;
+        _videolen = 0;
 
         if (buffer.BufferHt == 1)
         {
@@ -335,30 +334,16 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         }
         else if (FileExists(filename))
         {
-            // have to open the file
-            int width = buffer.BufferWi * 100 / (cropRight - cropLeft);
-            int height = buffer.BufferHt * 100 / (cropTop - cropBottom);
-
-            bool useNativeResolution = (sampleSpacing > 0);
-
-            _videoreader = new VideoReader(filename, width, height, aspectratio, useNativeResolution, true);
+            // the cache opens the file once for everyone
+            _valid = VideoFrameCache::GetCache().GetInfo(filename, _videolen, cache->_videoWidth, cache->_videoHeight);
 
-            if (_videoreader == nullptr)
+            if (!_valid)
             {
                 logger_base.warn("VideoEffect: Failed to load video file %s.", (const char *)filename.c_str());
             }
             else
             {
-                // extract the video length
-                int videolen = _videoreader->GetLengthMS();
-
-                if (videolen == 0)
-                {
-                    logger_base.warn("VideoEffect: Video %s was read as 0 length.", (const char *)filename.c_str());
-                }
-
-                // read the first frame ... if i dont it thinks the first frame i read is the first frame
-                _videoreader->GetNextFrame(0);
+                int videolen = _videolen;
 
                 VideoPanel *fp = static_cast<VideoPanel*>(panel);
                 if (fp != nullptr)
@@ -370,12 +355,6 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
                     //fp->addVideoTime(filename, videolen);
                 }
 
-                if (starttime != 0)
-                {
-                    logger_base.debug("Video effect initialising ... seeking to start location for the video %f.", (float)starttime);
-                    _videoreader->Seek(starttime * 1000);
-                }
-
                 if (durationTreatment == "Slow/Accelerate")
                 {
                     int effectFrames = buffer.curEffEndPer - buffer.curEffStartPer + 1;
@@ -397,24 +376,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         }
     }
 
-    if (_videoreader != nullptr && sampleSpacing == 0) {
-        int width = buffer.BufferWi * 100 / (cropRight - cropLeft);
-        int height = buffer.BufferHt * 100 / (cropTop - cropBottom);
-        bool vwidthEq = width == _videoreader->GetWidth();
-        bool vheightEq = height == _videoreader->GetHeight();
-        if (aspectratio) {
-            // if aspect ratio scaling, then only one or the other will be equal
-            vwidthEq = vheightEq | vwidthEq;
-            vheightEq = vwidthEq;
-        }
-        if (!vwidthEq || !vheightEq) {
-            // need to close and reopen video reader to the new size ... this is inefficient ... but lots of work to do to change video reader size dynamically
-            delete _videoreader;
-            _videoreader = new VideoReader(filename, width, height, aspectratio, false, true);
-        }
-    }
-
-    if (_videoreader != nullptr && _videoreader->GetLengthMS() > 0)
+    if (_valid && _videolen > 0)
     {
         long frame = 0;
         
@@ -429,63 +391,83 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
 
             while (frame < 0)
             {
-                frame += _videoreader->GetLengthMS();
+                frame += _videolen;
             }
 
-            while (frame > _videoreader->GetLengthMS())
+            while (frame > _videolen)
             {
-                frame -= _videoreader->GetLengthMS();
+                frame -= _videolen;
             }
 
             _nextManualMS += speed * _frameMS;
         }
         else
         {
-            frame = starttime * 1000 + (buffer.curPeriod - buffer.curEffStartPer) * _frameMS - _loops * (_videoreader->GetLengthMS() + _frameMS);
+            frame = starttime * 1000 + (buffer.curPeriod - buffer.curEffStartPer) * _frameMS - _loops * (_videolen + _frameMS);
         }
 
         // get the image for the current frame
-        AVFrame* image = _videoreader->GetNextFrame(frame);
+        VideoFrameCache& frameCache = VideoFrameCache::GetCache();
+        bool atEnd = false;
+        std::shared_ptr<const VideoFrame> image;
+        if (frame >= 0) {
+            image = frameCache.GetFrame(filename, frame, atEnd);
+        }
 
         // if we have reached the end and we are to loop
-        if (_videoreader->AtEnd() && durationTreatment == "Loop")
+        if (atEnd && durationTreatment == "Loop")
         {
             // jump back to start and try to read frame again
             _loops++;
-            frame = starttime * 1000 + (buffer.curPeriod - buffer.curEffStartPer) * _frameMS - _loops * (_videoreader->GetLengthMS() + _frameMS);
+            frame = starttime * 1000 + (buffer.curPeriod - buffer.curEffStartPer) * _frameMS - _loops * (_videolen + _frameMS);
             if (frame < 0)
             {
                 frame = 0;
             }
             logger_base.debug("Video effect loop #%d at frame %d to video frame %d.", _loops, buffer.curPeriod - buffer.curEffStartPer, frame);
 
-            _videoreader->Seek(0);
-            image = _videoreader->GetNextFrame(frame);
+            image = frameCache.GetFrame(filename, frame, atEnd);
         }
 
-            int ch = _videoreader->GetPixelChannels();
+            int ch = 4;
+            int vw = 0;
+            int vh = 0;
+            const uint8_t* data = nullptr;
+            if (image != nullptr) {
+                if (sampleSpacing == 0) {
+                    int width = buffer.BufferWi * 100 / (cropRight - cropLeft);
+                    int height = buffer.BufferHt * 100 / (cropTop - cropBottom);
+                    VideoFrameScaler::GetScaledSize(image->width, image->height, width, height, aspectratio, vw, vh);
+                    data = cache->_scaler.Scale(*image, vw, vh);
+                } else {
+                    // sampling works off the native frame
+                    vw = image->width;
+                    vh = image->height;
+                    data = image->data.data();
+                }
+            }
 
             // check it looks valid
-            if (image != nullptr && frame >= 0) {
+            if (data != nullptr && frame >= 0) {
 
                 // This handles normal scaling of videos
                 if (sampleSpacing == 0) {
-                    int xoffset = cropLeft * _videoreader->GetWidth() / 100;
-                    int yoffset = cropBottom * _videoreader->GetHeight() / 100;
-                    int xtail = (100 - cropRight) * _videoreader->GetWidth() / 100;
-                    int ytail = (100 - cropTop) * _videoreader->GetHeight() / 100;
-                    int startx = (buffer.BufferWi - _videoreader->GetWidth() * (cropRight - cropLeft) / 100) / 2;
-                    int starty = (buffer.BufferHt - _videoreader->GetHeight() * (cropTop - cropBottom) / 100) / 2;
+                    int xoffset = cropLeft * vw / 100;
+                    int yoffset = cropBottom * vh / 100;
+                    int xtail = (100 - cropRight) * vw / 100;
+                    int ytail = (100 - cropTop) * vh / 100;
+                    int startx = (buffer.BufferWi - vw * (cropRight - cropLeft) / 100) / 2;
+                    int starty = (buffer.BufferHt - vh * (cropTop - cropBottom) / 100) / 2;
 
-                    // wxASSERT(xoffset + xtail + buffer.BufferWi == _videoreader->GetWidth());
-                    // wxASSERT(yoffset + ytail + buffer.BufferHt == _videoreader->GetHeight());
+                    // wxASSERT(xoffset + xtail + buffer.BufferWi == vw);
+                    // wxASSERT(yoffset + ytail + buffer.BufferHt == vh);
 
                     // draw the image
                     xlColor c;
-                    for (int y = 0; y < _videoreader->GetHeight() - yoffset - ytail; y++) {
-                        uint8_t* ptr = image->data[0] + (_videoreader->GetHeight() - 1 - y - yoffset) * _videoreader->GetWidth() * ch + xoffset * ch;
+                    for (int y = 0; y < vh - yoffset - ytail; y++) {
+                        const uint8_t* ptr = data + (vh - 1 - y - yoffset) * vw * ch + xoffset * ch;
 
-                        for (int x = 0; x < _videoreader->GetWidth() - xoffset - xtail; x++) {
+                        for (int x = 0; x < vw - xoffset - xtail; x++) {
                             try {
                                 c.Set(*(ptr),
                                       *(ptr + 1),
@@ -514,21 +496,21 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
                     // this handles video sampling where we sample pixels from the image rather than scaling it and thus washing out the colours
                     int xneeded = buffer.BufferWi * sampleSpacing;
                     int yneeded = buffer.BufferHt * sampleSpacing;
-                    int imageWidthAfterCropping = ((100 - cropLeft + cropRight) * image->width) / 200;
-                    int imageHeightAferCropping = ((cropTop + 100 - cropBottom) * image->width) / 200;
-                    int startx = imageWidthAfterCropping / 2 - xneeded / 2 + (cropLeft * image->width) / 100;
-                    int starty = imageHeightAferCropping / 2 - yneeded / 2 + ((100 - cropTop) * image->height) / 100;
+                    int imageWidthAfterCropping = ((100 - cropLeft + cropRight) * vw) / 200;
+                    int imageHeightAferCropping = ((cropTop + 100 - cropBottom) * vw) / 200;
+                    int startx = imageWidthAfterCropping / 2 - xneeded / 2 + (cropLeft * vw) / 100;
+                    int starty = imageHeightAferCropping / 2 - yneeded / 2 + ((100 - cropTop) * vh) / 100;
 
                     int cury = starty;
                     xlColor c;
                     for (int y = 0; y < buffer.BufferHt; ++y)
                     {
-                        if (cury >= 0 && cury < image->height)
+                        if (cury >= 0 && cury < vh)
                         {
                             int curx = startx;
                             for (int x = 0; x < buffer.BufferWi; ++x) {
-                                if (curx >= 0 && curx < image->width) {
-                                    uint8_t* ptr = image->data[0] + (_videoreader->GetHeight() - 1 - cury) * _videoreader->GetWidth() * ch + curx * ch;
+                                if (curx >= 0 && curx < vw) {
+                                    const uint8_t* ptr = data + (vh - 1 - cury) * vw * ch + curx * ch;
                                     try {
                                         c.Set(*(ptr),
                                               *(ptr + 1),
@@ -11,6 +11,7 @@
 #include <wx/checkbox.h>
 
 #include <sstream>
+#include <vector>
 
 #include "../../include/warp-64.xpm"
 #include "../../include/warp-48.xpm"
@@ -30,6 +31,7 @@
 #include "UtilFunctions.h"
 
 #include "../Parallel.h"
+#include "../FastTrig.h"
 
 namespace
 {
@@ -63,8 +65,8 @@ namespace
       bool     IsNormal() const { return fabs( Len2() - 1 ) < 1e-6; }
       Vec2D    Rotate( const double& fAngle ) const
       {
-         float cs = RenderBuffer::cos( fAngle );
-         float sn = RenderBuffer::sin( fAngle );
+         float cs = FastTrig::FastCos( fAngle );
+         float sn = FastTrig::FastSin( fAngle );
          return Vec2D( x*cs + y * sn, -x * sn + y * cs );
       }
       static Vec2D lerp( const Vec2D& a, const Vec2D& b, double progress )
@@ -178,7 +180,7 @@ namespace
 
    float genWave( float len, float speed, float time )
    {
-      float wave = RenderBuffer::sin( speed * PI * len + time );
+      float wave = FastTrig::FastSin( speed * PI * len + time );
       wave = ( wave + 1.0 ) * 0.5;
       wave -= 0.3f;
       wave *= wave * wave;
@@ -208,7 +210,7 @@ namespace
       double distanceFromCenter = toUV.Len();
       Vec2D normToUV = toUV / distanceFromCenter;
 
-      double wave = RenderBuffer::cos( params.frequency * distanceFromCenter - params.speed * params.progress );
+      double wave = FastTrig::FastCos( params.frequency * distanceFromCenter - params.speed * params.progress );
       double offset = params.progress * wave * amplitude;
 
       Vec2D newUV = params.xy + normToUV * ( distanceFromCenter + offset );
@@ -226,7 +228,7 @@ namespace
       double distanceFromCenter = toUV.Len();
       Vec2D normToUV = toUV / distanceFromCenter;
 
-      double wave = RenderBuffer::cos( params.frequency * distanceFromCenter - params.speed * params.progress );
+      double wave = FastTrig::FastCos( params.frequency * distanceFromCenter - params.speed * params.progress );
       double offset = params.progress * wave * amplitude;
 
       Vec2D newUV = params.xy + normToUV * ( distanceFromCenter + offset );
@@ -286,8 +288,8 @@ namespace
       Vec2D normToUV( toUV / distanceFromCenter );
       float angle = ::atan2( normToUV.y, normToUV.x );
 
-      angle += RenderBuffer::sin( distanceFromCenter * params.frequency ) * TwistAmount * (1 - params.progress);
-      Vec2D newUV( RenderBuffer::cos( angle ), RenderBuffer::sin( angle ) );
+      angle += FastTrig::FastSin( distanceFromCenter * params.frequency ) * TwistAmount * (1 - params.progress);
+      Vec2D newUV( FastTrig::FastCos( angle ), FastTrig::FastSin( angle ) );
       newUV = newUV * distanceFromCenter + params.xy;
 
       xlColor c1 = tex2D( cb, s, t );
@@ -304,8 +306,8 @@ namespace
       Vec2D normToUV( toUV / distanceFromCenter );
       float angle = ::atan2( normToUV.y, normToUV.x );
 
-      angle += RenderBuffer::sin( distanceFromCenter * params.frequency ) * TwistAmount * params.progress;
-      Vec2D newUV( RenderBuffer::cos( angle ), RenderBuffer::sin( angle ) );
+      angle += FastTrig::FastSin( distanceFromCenter * params.frequency ) * TwistAmount * params.progress;
+      Vec2D newUV( FastTrig::FastCos( angle ), FastTrig::FastSin( angle ) );
       newUV = newUV * distanceFromCenter + params.xy;
 
       xlColor c1 = tex2D( cb, s, t );
@@ -331,11 +333,11 @@ namespace
       float distanceToDroplet = Vec2D( uv - dropletPosition ).Len();
 
       float dropletHeight = distanceToDroplet > ringRadius ? 0.0 : distanceToDroplet;
-      dropletHeight = RenderBuffer::cos(PI + (dropletHeight - ringRadius) * dropletRipple * dropletStrength) * 0.5 + 0.5;
+      dropletHeight = FastTrig::FastCos(PI + (dropletHeight - ringRadius) * dropletRipple * dropletStrength) * 0.5 + 0.5;
       dropletHeight *= 1.0 - dropFraction;
       dropletHeight *= distanceToDroplet > ringRadius ? 0.0 : distanceToDroplet / ringRadius;
 
-      return (1.0 - (RenderBuffer::cos(dropletHeight * PI) + 1.0) * 0.5) * dropletHeightFactor;
+      return (1.0 - (FastTrig::FastCos(dropletHeight * PI) + 1.0) * 0.5) * dropletHeightFactor;
    }
 
    xlColor singleWaterDrop( const ColorBuffer& cb, double s, double t, const WarpEffectParams& params )
@@ -468,17 +470,23 @@ namespace
        }
    }
 
-    void RenderPixelTransform( PixelTransform transform, RenderBuffer& rb, const WarpEffectParams& params )
+    // the transform is a template parameter so it is inlined into the row loop rather than called through a pointer per pixel
+    template <PixelTransform transform>
+    void RenderPixelTransform( RenderBuffer& rb, const WarpEffectParams& params )
     {
         xlColor *pixels = rb.GetPixels();
         xlColorVector cvOrig(pixels, pixels + rb.GetPixelCount());
         ColorBuffer cb( cvOrig, rb.BufferWi, rb.BufferHt );
 
-        parallel_for(0, rb.BufferHt, [&rb, &cb, &transform, &params](int y) {
+        std::vector<double> ss( rb.BufferWi );
+        for ( int x = 0; x < rb.BufferWi; ++x ) {
+            ss[x] = double( x ) / ( rb.BufferWi - 1 );
+        }
+
+        parallel_for(0, rb.BufferHt, [&rb, &cb, &ss, &params](int y) {
             double t = double( y ) / ( rb.BufferHt - 1 );
             for ( int x = 0; x < rb.BufferWi; ++x ) {
-                double s = double( x ) / ( rb.BufferWi - 1 );
-                rb.SetPixel( x, y, transform( cb, s, t, params ) );
+                rb.SetPixel( x, y, transform( cb, ss[x], t, params ) );
             }
         }, 25);
     }
@@ -595,17 +603,17 @@ void WarpEffect::Render(Effect *eff, const SettingsMap &SettingsMap, RenderBuffe
 
     WarpEffectParams params( progress, Vec2D( x, y ), speed, frequency );
     if ( warpType == WarpEffect::WarpType::WATER_DROPS) {
-        RenderPixelTransform( waterDrops, buffer, params );
+        RenderPixelTransform<waterDrops>( buffer, params );
     } else if (warpType == WarpEffect::WarpType::SAMPLE_ON) {
         RenderSampleOn(buffer, x, y);
     } else if (warpType == WarpEffect::WarpType::WAVY) {
         LinearInterpolater interpolater;
         params.speed = interpolate( params.speed, 0.0,0.5, 40.0,5.0, interpolater );
-        RenderPixelTransform( wavy, buffer, params );
+        RenderPixelTransform<wavy>( buffer, params );
     } else if (warpType == WarpEffect::WarpType::MIRROR) {
-        RenderPixelTransform(mirror, buffer, params);
+        RenderPixelTransform<mirror>(buffer, params);
     } else if (warpType == WarpEffect::WarpType::COPY) {
-        RenderPixelTransform(copy, buffer, params);
+        RenderPixelTransform<copy>(buffer, params);
     } else if (warpType == WarpEffect::WarpType::SINGLE_WATER_DROP) {
         float cycleCount = std::stof( warpStrCycleCount );
         float intervalLen = 1.f / cycleCount;
@@ -617,9 +625,9 @@ void WarpEffect::Render(Effect *eff, const SettingsMap &SettingsMap, RenderBuffe
         float interpolatedProgress = interpolate( intervalProgress, 0.0,0.20, 1.0,0.45, interpolater );
 
         params.progress = interpolatedProgress;
-        RenderPixelTransform( singleWaterDrop, buffer, params );
+        RenderPixelTransform<singleWaterDrop>( buffer, params );
     } else {
-        PixelTransform xform = nullptr;
+        void (*render)( RenderBuffer&, const WarpEffectParams& ) = nullptr;
         // the other warps were originally intended as transitions in or out... for constant
         // treatment, we'll just cycle between progress of [0,1] and [1,0]. "constant" wasn't
         // a very good description, maybe back-and-forth or something would be more accurate
@@ -634,33 +642,33 @@ void WarpEffect::Render(Effect *eff, const SettingsMap &SettingsMap, RenderBuffe
             }
             params.progress = intervalProgress;
             if (warpType == WarpEffect::WarpType::RIPPLE) {
-                xform = rippleIn;
+                render = RenderPixelTransform<rippleIn>;
             } else if (warpType == WarpEffect::WarpType::DISSOLVE) {
-                xform = dissolveIn;
+                render = RenderPixelTransform<dissolveIn>;
             } else if (warpType == WarpEffect::WarpType::BANDED_SWIRL) {
-                xform = bandedSwirlIn;
+                render = RenderPixelTransform<bandedSwirlIn>;
             } else if (warpType == WarpEffect::WarpType::CIRCLE_REVEAL) {
-                xform = circleRevealIn;
+                render = RenderPixelTransform<circleRevealIn>;
             } else if (warpType == WarpEffect::WarpType::CIRCULAR_SWIRL) {
                 params.progress = 1. - params.progress;
-                xform = circularSwirl;
+                render = RenderPixelTransform<circularSwirl>;
             } else if (warpType == WarpEffect::WarpType::DROP) {
                 params.progress = 1. - params.progress;
-                xform = drop;
+                render = RenderPixelTransform<drop>;
             }
         } else {
             if (warpType == WarpEffect::WarpType::RIPPLE) {
-                xform = warpTreatment == "in" ? rippleIn : rippleOut;
+                render = warpTreatment == "in" ? RenderPixelTransform<rippleIn> : RenderPixelTransform<rippleOut>;
             } else if (warpType == WarpEffect::WarpType::DISSOLVE) {
-                xform = ( warpTreatment == "in" ) ? dissolveIn : dissolveOut;
+                render = ( warpTreatment == "in" ) ? RenderPixelTransform<dissolveIn> : RenderPixelTransform<dissolveOut>;
             } else if (warpType == WarpEffect::WarpType::BANDED_SWIRL) {
-                xform = ( warpTreatment == "in" ) ? bandedSwirlIn : bandedSwirlOut;
+                render = ( warpTreatment == "in" ) ? RenderPixelTransform<bandedSwirlIn> : RenderPixelTransform<bandedSwirlOut>;
             } else if (warpType == WarpEffect::WarpType::CIRCLE_REVEAL) {
-                xform = ( warpTreatment == "in" ) ? circleRevealIn : circleRevealOut;
+                render = ( warpTreatment == "in" ) ? RenderPixelTransform<circleRevealIn> : RenderPixelTransform<circleRevealOut>;
             } else if (warpType == WarpEffect::WarpType::CIRCULAR_SWIRL) {
-                xform = circularSwirl;
+                render = RenderPixelTransform<circularSwirl>;
             } else if (warpType == WarpEffect::WarpType::DROP) {
-                xform = drop;
+                render = RenderPixelTransform<drop>;
                 if (warpTreatment == "in") {
                     params.progress = 1. - params.progress;
                 }
@@ -674,8 +682,8 @@ void WarpEffect::Render(Effect *eff, const SettingsMap &SettingsMap, RenderBuffe
             }
         }
 
-        if (xform != nullptr) {
-            RenderPixelTransform( xform, buffer, params );
+        if (render != nullptr) {
+            render( buffer, params );
         }
     }
 }
@@ -41,6 +41,10 @@ public:
 
     WarpEffect(int id);
     virtual ~WarpEffect();
+    virtual int GetRenderVersion() const override
+    {
+        return 2; // fast trig
+    }
     virtual bool CanBeRandom() override
     {
         return false;
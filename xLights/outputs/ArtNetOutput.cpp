@@ -13,6 +13,7 @@
 
 #include "ArtNetOutput.h"
 #include "OutputManager.h"
+#include "BatchedUDPSender.h"
 #include "../UtilFunctions.h"
 #include "ControllerEthernet.h"
 #include "../OutputModelManager.h"
@@ -398,7 +399,9 @@ void ArtNetOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         _data[12] = _sequenceNum;
-        _datagram->SendTo(_remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        if (!BatchedUDPSender::Queue(GetForceLocalIPToUse(), _datagram, _remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels))) {
+            _datagram->SendTo(_remoteAddr, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
         _changed = false;
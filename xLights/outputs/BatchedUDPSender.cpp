@@ -0,0 +1,299 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "BatchedUDPSender.h"
+
+#include <wx/socket.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include <log4cpp/Category.hh>
+
+namespace
+{
+    std::mutex __captureLock;
+    bool __capturing = false;
+    int __captureGroup = 0;
+    std::vector<CapturedPacket> __captured;
+    std::vector<uint8_t> __captureData;
+
+    // returns false if we are not capturing
+    bool Capture(wxDatagramSocket* socket, const wxSockAddress& remoteAddr, const uint8_t* data, size_t len)
+    {
+        if (socket == nullptr) return false;
+
+        std::unique_lock<std::mutex> lock(__captureLock);
+        if (!__capturing) return false;
+
+        CapturedPacket p;
+        p.socket = socket;
+        p.addr = &remoteAddr;
+        p.offset = __captureData.size();
+        p.len = len;
+        p.group = __captureGroup;
+        __captureData.insert(__captureData.end(), data, data + len);
+        __captured.push_back(p);
+        return true;
+    }
+
+    bool QueueBatched(const std::string& localIP, const wxSockAddress& remoteAddr, const uint8_t* data, size_t len);
+}
+
+void BatchedUDPSender::StartCapture()
+{
+    std::unique_lock<std::mutex> lock(__captureLock);
+    __captured.clear();
+    __captureData.clear();
+    __captureGroup = 0;
+    __capturing = true;
+}
+
+void BatchedUDPSender::SetCaptureGroup(int group)
+{
+    std::unique_lock<std::mutex> lock(__captureLock);
+    __captureGroup = group;
+}
+
+void BatchedUDPSender::EndCapture(std::vector<CapturedPacket>& packets, std::vector<uint8_t>& data)
+{
+    std::unique_lock<std::mutex> lock(__captureLock);
+    __capturing = false;
+    // swap so the buffers get reused from frame to frame
+    packets.clear();
+    data.clear();
+    std::swap(packets, __captured);
+    std::swap(data, __captureData);
+}
+
+bool BatchedUDPSender::Queue(const std::string& localIP, wxDatagramSocket* socket, const wxSockAddress& remoteAddr, const uint8_t* data, size_t len)
+{
+    if (Capture(socket, remoteAddr, data, len)) return true;
+    return QueueBatched(localIP, remoteAddr, data, len);
+}
+
+#ifdef __linux__
+
+#define BATCHED_UDP_SNDBUF (4 * 1024 * 1024)
+#define BATCHED_UDP_MAX_MSGS 1024 // sendmmsg is capped at UIO_MAXIOV messages per call
+
+namespace
+{
+    struct QueuedPacket
+    {
+        int socket = -1;
+        sockaddr_storage addr;
+        socklen_t addrLen = 0;
+        size_t offset = 0;
+        size_t len = 0;
+    };
+
+    std::mutex __lock;
+    bool __batching = false;
+    std::vector<QueuedPacket> __packets;
+    std::vector<uint8_t> __arena;
+    std::map<std::string, int> __sockets; // keyed on local ip ... "" is the any address
+    size_t __lastPackets = 0;
+    size_t __lastSyscalls = 0;
+
+    // Must be called with __lock held
+    int GetSocket(const std::string& localIP)
+    {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+        auto it = __sockets.find(localIP);
+        if (it != __sockets.end()) return it->second;
+
+        int s = socket(AF_INET, SOCK_DGRAM, 0);
+        if (s < 0) {
+            logger_base.error("BatchedUDPSender: Error creating socket for '%s' => %d.", (const char*)localIP.c_str(), errno);
+            __sockets[localIP] = -1;
+            return -1;
+        }
+
+        int sndbuf = BATCHED_UDP_SNDBUF;
+        setsockopt(s, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        int broadcast = 1;
+        setsockopt(s, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+
+        sockaddr_in local;
+        memset(&local, 0x00, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_port = 0;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (localIP != "") {
+            if (inet_pton(AF_INET, localIP.c_str(), &local.sin_addr) != 1) {
+                logger_base.warn("BatchedUDPSender: Invalid local IP '%s' using any address.", (const char*)localIP.c_str());
+                local.sin_addr.s_addr = htonl(INADDR_ANY);
+            }
+            else {
+                // make sure multicast leaves on the forced interface as well
+                setsockopt(s, IPPROTO_IP, IP_MULTICAST_IF, &local.sin_addr, sizeof(local.sin_addr));
+            }
+        }
+
+        if (bind(s, (sockaddr*)&local, sizeof(local)) < 0) {
+            logger_base.error("BatchedUDPSender: Error binding socket to '%s' => %d.", (const char*)localIP.c_str(), errno);
+            close(s);
+            s = -1;
+        }
+        else {
+            logger_base.debug("BatchedUDPSender: Opened socket for local IP '%s'.", (const char*)localIP.c_str());
+        }
+
+        __sockets[localIP] = s;
+        return s;
+    }
+
+    // Must be called with __lock held ... sends all packets queued against one socket
+    void SendAll(int socket, std::vector<mmsghdr>& msgs, std::vector<iovec>& iovs)
+    {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+        size_t done = 0;
+        while (done < msgs.size()) {
+            unsigned int count = (unsigned int)std::min(msgs.size() - done, (size_t)BATCHED_UDP_MAX_MSGS);
+            int sent = sendmmsg(socket, &msgs[done], count, 0);
+            __lastSyscalls++;
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                logger_base.warn("BatchedUDPSender: sendmmsg failed => %d. %d packets dropped.", errno, (int)(msgs.size() - done));
+                return;
+            }
+            // a partial send just means the first sent messages went ... carry on from there
+            done += sent;
+        }
+    }
+}
+
+bool BatchedUDPSender::IsSupported()
+{
+    return true;
+}
+
+void BatchedUDPSender::StartBatch()
+{
+    std::unique_lock<std::mutex> lock(__lock);
+    __packets.clear();
+    __arena.clear();
+    __batching = true;
+}
+
+namespace
+{
+    bool QueueBatched(const std::string& localIP, const wxSockAddress& remoteAddr, const uint8_t* data, size_t len)
+    {
+        std::unique_lock<std::mutex> lock(__lock);
+        if (!__batching) return false;
+
+        int s = GetSocket(localIP);
+        if (s < 0) return false;
+
+        int addrLen = remoteAddr.GetAddressDataLen();
+        if (addrLen <= 0 || addrLen > (int)sizeof(sockaddr_storage)) return false;
+
+        QueuedPacket p;
+        p.socket = s;
+        memcpy(&p.addr, remoteAddr.GetAddressData(), addrLen);
+        p.addrLen = addrLen;
+        p.offset = __arena.size();
+        p.len = len;
+        __arena.insert(__arena.end(), data, data + len);
+        __packets.push_back(p);
+        return true;
+    }
+}
+
+void BatchedUDPSender::Flush()
+{
+    std::unique_lock<std::mutex> lock(__lock);
+    __batching = false;
+    __lastPackets = __packets.size();
+    __lastSyscalls = 0;
+    if (__packets.empty()) return;
+
+    // iovecs point into the arena so it must not be touched until we are done
+    std::vector<mmsghdr> msgs;
+    std::vector<iovec> iovs(__packets.size());
+    msgs.reserve(__packets.size());
+
+    // group by socket but preserve the order the outputs queued them within each socket
+    for (const auto& it : __sockets) {
+        if (it.second < 0) continue;
+        msgs.clear();
+        for (size_t i = 0; i < __packets.size(); ++i) {
+            auto& p = __packets[i];
+            if (p.socket != it.second) continue;
+            iovs[i].iov_base = &__arena[p.offset];
+            iovs[i].iov_len = p.len;
+            mmsghdr m;
+            memset(&m, 0x00, sizeof(m));
+            m.msg_hdr.msg_name = &p.addr;
+            m.msg_hdr.msg_namelen = p.addrLen;
+            m.msg_hdr.msg_iov = &iovs[i];
+            m.msg_hdr.msg_iovlen = 1;
+            msgs.push_back(m);
+        }
+        if (!msgs.empty()) {
+            SendAll(it.second, msgs, iovs);
+        }
+    }
+    __packets.clear();
+}
+
+void BatchedUDPSender::Close()
+{
+    std::unique_lock<std::mutex> lock(__lock);
+    __batching = false;
+    __packets.clear();
+    __arena.clear();
+    __arena.shrink_to_fit();
+    for (const auto& it : __sockets) {
+        if (it.second >= 0) close(it.second);
+    }
+    __sockets.clear();
+}
+
+size_t BatchedUDPSender::GetLastBatchPackets()
+{
+    return __lastPackets;
+}
+
+size_t BatchedUDPSender::GetLastBatchSyscalls()
+{
+    return __lastSyscalls;
+}
+
+#else
+
+bool BatchedUDPSender::IsSupported() { return false; }
+void BatchedUDPSender::StartBatch() {}
+void BatchedUDPSender::Flush() {}
+void BatchedUDPSender::Close() {}
+namespace
+{
+    bool QueueBatched(const std::string& localIP, const wxSockAddress& remoteAddr, const uint8_t* data, size_t len) { return false; }
+}
+size_t BatchedUDPSender::GetLastBatchPackets() { return 0; }
+size_t BatchedUDPSender::GetLastBatchSyscalls() { return 0; }
+
+#endif
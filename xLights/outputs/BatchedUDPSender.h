@@ -0,0 +1,61 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <vector>
+
+class wxSockAddress;
+class wxDatagramSocket;
+
+// A packet held back by a capture so it can be sent later ... the socket and address belong to the output which queued it
+struct CapturedPacket
+{
+    wxDatagramSocket* socket = nullptr;
+    const wxSockAddress* addr = nullptr;
+    size_t offset = 0; // into the capture data
+    size_t len = 0;
+    int group = 0;
+};
+
+// Collects all the UDP packets generated by the outputs during OutputManager::EndFrame and sends them
+// in as few system calls as possible. On linux this uses sendmmsg with one socket per local interface.
+// On other platforms IsSupported returns false and the outputs keep sending through their own datagrams.
+//
+// Capturing works on all platforms. Packets are held rather than sent and handed back by EndCapture so the
+// paced transmission can send each one at its own time.
+class BatchedUDPSender
+{
+public:
+
+    #pragma region Static Functions
+    static bool IsSupported();
+
+    // frame lifecycle ... called by the output manager
+    static void StartBatch();
+    static void Flush();
+    static void Close();
+
+    static void StartCapture();
+    // packets queued from now on are tagged with this group ... the output manager uses the controller
+    static void SetCaptureGroup(int group);
+    static void EndCapture(std::vector<CapturedPacket>& packets, std::vector<uint8_t>& data);
+
+    // returns false if the packet was not queued and the caller should send it itself
+    // the packet data is copied so the caller can reuse its buffer immediately but the socket and address must
+    // stay valid until the packet is sent
+    static bool Queue(const std::string& localIP, wxDatagramSocket* socket, const wxSockAddress& remoteAddr, const uint8_t* data, size_t len);
+
+    static size_t GetLastBatchPackets();
+    static size_t GetLastBatchSyscalls();
+    #pragma endregion
+};
@@ -17,6 +17,7 @@
 
 #include "DDPOutput.h"
 #include "OutputManager.h"
+#include "BatchedUDPSender.h"
 #include "../UtilFunctions.h"
 #include "../OutputModelManager.h"
 #include "ControllerEthernet.h"
@@ -534,7 +535,9 @@ void DDPOutput::EndFrame(int suppressFrames) {
 
             memcpy(&_data[10], _fulldata + index, thissend);
 
-            _datagram->SendTo(_remoteAddr, &_data[0], DDP_PACKET_LEN - (1440 - thissend));
+            if (!BatchedUDPSender::Queue(GetForceLocalIPToUse(), _datagram, _remoteAddr, &_data[0], DDP_PACKET_LEN - (1440 - thissend))) {
+                _datagram->SendTo(_remoteAddr, &_data[0], DDP_PACKET_LEN - (1440 - thissend));
+            }
             _sequenceNum = _sequenceNum == 15 ? 1 : _sequenceNum + 1;
 
             tosend -= thissend;
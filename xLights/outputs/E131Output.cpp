@@ -11,6 +11,7 @@
 
 #include "E131Output.h"
 #include "OutputManager.h"
+#include "BatchedUDPSender.h"
 #include "../UtilFunctions.h"
 #include "../utils/ip_utils.h"
 #include "ControllerEthernet.h"
@@ -445,7 +446,9 @@ void E131Output::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         _data[111] = _sequenceNum;
-        _datagram->SendTo(_remoteAddr, _data, E131_PACKET_LEN - (512 - _channels));
+        if (!BatchedUDPSender::Queue(GetForceLocalIPToUse(), _datagram, _remoteAddr, _data, E131_PACKET_LEN - (512 - _channels))) {
+            _datagram->SendTo(_remoteAddr, _data, E131_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
     }
@@ -13,6 +13,7 @@
 
 #include "KinetOutput.h"
 #include "OutputManager.h"
+#include "BatchedUDPSender.h"
 #include "../UtilFunctions.h"
 #include "ControllerEthernet.h"
 #include "../utils/ip_utils.h"
@@ -243,7 +244,9 @@ void KinetOutput::EndFrame(int suppressFrames) {
         _data[9] = (_sequenceNum >> 8) & 0xFF;
         _data[10] = (_sequenceNum >> 16) & 0xFF;
         _data[11] = (_sequenceNum >> 24) & 0xFF;
-        _datagram->SendTo(_remoteAddr, _data, GetHeaderPacketLength() + _channels);
+        if (!BatchedUDPSender::Queue(GetForceLocalIPToUse(), _datagram, _remoteAddr, _data, GetHeaderPacketLength() + _channels)) {
+            _datagram->SendTo(_remoteAddr, _data, GetHeaderPacketLength() + _channels);
+        }
         _sequenceNum++;
         FrameOutput();
         _changed = false;
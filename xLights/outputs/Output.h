@@ -209,6 +209,7 @@ public:
     virtual void ResetFrame() {}
     void FrameOutput();
     void SkipFrame() { _skippedFrames++; }
+    int GetSkippedFrames() const { return _skippedFrames; }
     bool NeedToOutput(int suppressFrames) const { return !IsSuppressDuplicateFrames() || _skippedFrames >= suppressFrames; }
     #pragma endregion 
 
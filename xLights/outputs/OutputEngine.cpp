@@ -0,0 +1,224 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputEngine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include <log4cpp/Category.hh>
+
+#define OUTPUT_ENGINE_LATE_TOLERANCE_MS 2.0
+#define OUTPUT_ENGINE_RESYNC_MS 250
+
+#pragma region Constructors and Destructors
+OutputEngine::OutputEngine(TRANSMIT_FN transmit, int latencyMS) : _transmit(transmit), _latencyMS(latencyMS) {
+
+    _thread = std::thread([this]() { Run(); });
+}
+
+OutputEngine::~OutputEngine() {
+
+    _stop = true;
+    _wake.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+#pragma endregion
+
+#pragma region Private Functions
+void OutputEngine::SetRealTimePriority() {
+
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        logger_base.warn("OutputEngine: Unable to raise output thread priority.");
+    }
+#else
+    sched_param param;
+    memset(&param, 0x00, sizeof(param));
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+    int res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (res != 0) {
+        // usually means we dont have CAP_SYS_NICE/rtprio ... we still get the dedicated thread just not the priority
+        logger_base.warn("OutputEngine: Unable to set real time priority on output thread => %d. Running at normal priority.", res);
+    }
+#endif
+}
+
+void OutputEngine::SleepUntil(std::chrono::steady_clock::time_point deadline) {
+
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC on linux so we can sleep on the absolute time and not accumulate wakeup error
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+// works out when a frame should go out and re-anchors the deadline clock when the timestamps jump
+std::chrono::steady_clock::time_point OutputEngine::GetDeadline(long msec) {
+
+    auto now = std::chrono::steady_clock::now();
+
+    // callers which dont supply a timestamp just want the frame sent as soon as possible
+    if (_anchored && msec == _lastMsec) return now;
+
+    bool anchor = !_anchored || msec < _lastMsec || msec - _lastMsec > 1000;
+    if (!anchor) {
+        auto deadline = _anchorTime + std::chrono::milliseconds(msec - _anchorMsec);
+        // the playback clock and ours have drifted too far apart
+        if (deadline < now - std::chrono::milliseconds(OUTPUT_ENGINE_RESYNC_MS) ||
+            deadline > now + std::chrono::milliseconds(_latencyMS + OUTPUT_ENGINE_RESYNC_MS)) {
+            anchor = true;
+        }
+    }
+
+    if (anchor) {
+        if (_anchored) {
+            _resyncs.fetch_add(1, std::memory_order_relaxed);
+        }
+        _anchored = true;
+        _anchorMsec = msec;
+        _anchorTime = now + std::chrono::milliseconds(_latencyMS);
+    }
+    _lastMsec = msec;
+
+    return _anchorTime + std::chrono::milliseconds(msec - _anchorMsec);
+}
+
+void OutputEngine::Run() {
+
+    SetRealTimePriority();
+
+    while (!_stop) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+
+        if (head == tail) {
+            std::unique_lock<std::mutex> lock(_wakeLock);
+            _wake.wait_for(lock, std::chrono::milliseconds(10), [this, head]() { return _stop || _tail.load(std::memory_order_acquire) != head; });
+            continue;
+        }
+
+        _transmitting = true;
+        Frame& frame = _frames[head % OUTPUT_ENGINE_QUEUE_SIZE];
+
+        // if a newer frame is already waiting and is already due there is no point sending this one
+        if (tail - head > 1 && _anchored) {
+            const Frame& next = _frames[(head + 1) % OUTPUT_ENGINE_QUEUE_SIZE];
+            if (next.msec > _lastMsec && _anchorTime + std::chrono::milliseconds(next.msec - _anchorMsec) <= std::chrono::steady_clock::now()) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                _lastMsec = frame.msec;
+                _head.store(head + 1, std::memory_order_release);
+                _transmitting = false;
+                continue;
+            }
+        }
+
+        auto deadline = GetDeadline(frame.msec);
+        SleepUntil(deadline);
+
+        double late = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - deadline).count();
+        _transmit(frame.data.data(), frame.size, frame.msec);
+
+        _sent.fetch_add(1, std::memory_order_relaxed);
+        if (late > OUTPUT_ENGINE_LATE_TOLERANCE_MS) {
+            _late.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (late > _maxLateMS.load(std::memory_order_relaxed)) {
+            _maxLateMS.store(late, std::memory_order_relaxed);
+        }
+
+        _head.store(head + 1, std::memory_order_release);
+        _transmitting = false;
+        _wake.notify_all();
+    }
+}
+#pragma endregion
+
+#pragma region Frame Handling
+bool OutputEngine::SubmitFrame(const uint8_t* data, size_t size, long msec) {
+
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t head = _head.load(std::memory_order_acquire);
+
+    _submitted.fetch_add(1, std::memory_order_relaxed);
+    if (tail - head >= OUTPUT_ENGINE_QUEUE_SIZE) {
+        // engine has fallen behind ... drop the frame rather than block playback
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Frame& frame = _frames[tail % OUTPUT_ENGINE_QUEUE_SIZE];
+    if (frame.data.size() < size) {
+        frame.data.resize(size);
+    }
+    if (size > 0) {
+        memcpy(frame.data.data(), data, size);
+    }
+    frame.size = size;
+    frame.msec = msec;
+
+    _tail.store(tail + 1, std::memory_order_release);
+    _wake.notify_all();
+    return true;
+}
+
+void OutputEngine::WaitIdle() {
+
+    std::unique_lock<std::mutex> lock(_wakeLock);
+    while (!_stop && (_head.load(std::memory_order_acquire) != _tail.load(std::memory_order_acquire) || _transmitting)) {
+        _wake.wait_for(lock, std::chrono::milliseconds(5));
+    }
+}
+#pragma endregion
+
+#pragma region Statistics
+OutputEngine::Statistics OutputEngine::GetStatistics() const {
+
+    Statistics res;
+    res.submitted = _submitted.load(std::memory_order_relaxed);
+    res.sent = _sent.load(std::memory_order_relaxed);
+    res.late = _late.load(std::memory_order_relaxed);
+    res.dropped = _dropped.load(std::memory_order_relaxed);
+    res.resyncs = _resyncs.load(std::memory_order_relaxed);
+    res.maxLateMS = _maxLateMS.load(std::memory_order_relaxed);
+    return res;
+}
+
+std::string OutputEngine::GetStatisticsString() const {
+
+    auto s = GetStatistics();
+    return "Submitted: " + std::to_string(s.submitted) +
+        " Sent: " + std::to_string(s.sent) +
+        " Late: " + std::to_string(s.late) +
+        " Dropped: " + std::to_string(s.dropped) +
+        " Resyncs: " + std::to_string(s.resyncs) +
+        " Max late: " + std::to_string((int)s.maxLateMS) + "ms";
+}
+#pragma endregion
@@ -0,0 +1,110 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define OUTPUT_ENGINE_QUEUE_SIZE 4
+
+// Owns a high priority thread which puts completed frames on the wire.
+// The playback thread submits whole frame buffers through a lock free single producer/single consumer queue and each frame
+// is transmitted at an absolute deadline derived from its timestamp plus a fixed latency. This stops UI stalls on the
+// playback thread from showing up as wire jitter.
+class OutputEngine
+{
+public:
+    // called on the engine thread to actually send a frame
+    typedef std::function<void(const uint8_t* data, size_t size, long msec)> TRANSMIT_FN;
+
+    struct Statistics
+    {
+        uint64_t submitted = 0;
+        uint64_t sent = 0;
+        uint64_t late = 0;       // sent more than the tolerance after its deadline
+        uint64_t dropped = 0;    // queue full or superseded by a newer frame before it could be sent
+        uint64_t resyncs = 0;    // timestamps jumped so the deadline clock was re-anchored
+        double maxLateMS = 0.0;
+    };
+
+private:
+
+    struct Frame
+    {
+        std::vector<uint8_t> data;
+        size_t size = 0;
+        long msec = 0;
+    };
+
+    #pragma region Member Variables
+    TRANSMIT_FN _transmit;
+    int _latencyMS = 20;
+    std::thread _thread;
+    std::atomic_bool _stop = false;
+
+    // lock free ring ... _head is only written by the engine thread, _tail only by the producer
+    Frame _frames[OUTPUT_ENGINE_QUEUE_SIZE];
+    std::atomic<uint32_t> _head = 0;
+    std::atomic<uint32_t> _tail = 0;
+    std::atomic_bool _transmitting = false;
+
+    // only used to sleep the engine thread when there is nothing queued
+    std::mutex _wakeLock;
+    std::condition_variable _wake;
+
+    // deadline mapping from frame timestamps to the monotonic clock
+    bool _anchored = false;
+    long _anchorMsec = 0;
+    std::chrono::steady_clock::time_point _anchorTime;
+    long _lastMsec = 0;
+
+    // atomic so neither thread ever waits on the other to count something
+    std::atomic<uint64_t> _submitted = 0;
+    std::atomic<uint64_t> _sent = 0;
+    std::atomic<uint64_t> _late = 0;
+    std::atomic<uint64_t> _dropped = 0;
+    std::atomic<uint64_t> _resyncs = 0;
+    std::atomic<double> _maxLateMS = 0.0; // only written by the engine thread
+    #pragma endregion
+
+    #pragma region Private Functions
+    void Run();
+    void SetRealTimePriority();
+    void SleepUntil(std::chrono::steady_clock::time_point deadline);
+    std::chrono::steady_clock::time_point GetDeadline(long msec);
+    #pragma endregion
+
+public:
+
+    #pragma region Constructors and Destructors
+    OutputEngine(TRANSMIT_FN transmit, int latencyMS);
+    virtual ~OutputEngine();
+    #pragma endregion
+
+    #pragma region Frame Handling
+    // called by the playback thread ... data is copied. Returns false if the frame was dropped.
+    bool SubmitFrame(const uint8_t* data, size_t size, long msec);
+    // blocks until everything queued has been sent
+    void WaitIdle();
+    #pragma endregion
+
+    #pragma region Statistics
+    Statistics GetStatistics() const;
+    std::string GetStatisticsString() const;
+    #pragma endregion
+};
@@ -27,9 +27,13 @@
 #include "xxxEthernetOutput.h"
 #include "OPCOutput.h"
 #include "TestPreset.h"
+#include "BatchedUDPSender.h"
+#include "OutputPacer.h"
+#include "OutputEngine.h"
 #include "../Parallel.h"
 #include "../UtilFunctions.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include <log4cpp/Category.hh>
@@ -131,6 +135,80 @@ void OutputManager::AsyncPingAll() {
 
     std::for_each(begin(_controllers), end(_controllers), [](Controller* c) { c->AsyncPing(); });
 }
+
+void OutputManager::SendSync() {
+
+    if (IsSyncEnabled()) {
+        if (_syncUniverse != 0) {
+            if (AtLeastOneOutputUsingProtocol(OUTPUT_E131)) {
+                for (const auto& it : GetForceIPs(OUTPUT_E131))
+                    E131Output::SendSync(_syncUniverse, it);
+            }
+        }
+
+        if (AtLeastOneOutputUsingProtocol(OUTPUT_ARTNET)) {
+            for (const auto& it : GetForceIPs(OUTPUT_ARTNET))
+                ArtNetOutput::SendSync(it);
+        }
+
+        if (AtLeastOneOutputUsingProtocol(OUTPUT_DDP)) {
+            for (const auto& it : GetForceIPs(OUTPUT_DDP))
+                DDPOutput::SendSync(it);
+        }
+
+        if (AtLeastOneOutputUsingProtocol(OUTPUT_ZCPP)) {
+            for (const auto& it : GetForceIPs(OUTPUT_ZCPP))
+                ZCPPOutput::SendSync(it);
+        }
+    }
+}
+
+// Paced frames are still being sent after EndFrame returns. The packet data is copied but the pacer still uses the
+// output sockets so anything which starts, stops or resets the outputs must wait for them
+void OutputManager::WaitForPacedFrame() {
+
+    if (_pacer != nullptr) {
+        _pacer->WaitForFrame();
+    }
+}
+
+// Must be called with _routesLock held
+void OutputManager::BuildRoutes() const {
+
+    _routes.clear();
+    for (const auto& it : _controllers) {
+        for (const auto& it2 : it->GetOutputs()) {
+            // outputs with no channels can never receive data so leave them out of the table
+            if (it2->GetChannels() > 0 && it2->GetStartChannel() > 0) {
+                _routes.push_back({ it2->GetStartChannel() - 1, it2->GetChannels(), it2 });
+            }
+        }
+    }
+
+    // start channels are allocated in controller/output order but sort anyway so the binary search is always safe
+    std::stable_sort(begin(_routes), end(_routes), [](const OutputRoute& a, const OutputRoute& b) { return a.startChannel < b.startChannel; });
+    _routesValid = true;
+}
+
+// The routing table holds raw output pointers so it must be dropped whenever outputs are added, removed or renumbered
+void OutputManager::InvalidateRoutes() const {
+
+    std::unique_lock<std::mutex> lock(_routesLock);
+    _routes.clear();
+    _routesValid = false;
+}
+
+// Must be called with _routesLock held ... channel is zero based
+const OutputRoute* OutputManager::FindRoute(int32_t channel) const {
+
+    if (!_routesValid) BuildRoutes();
+
+    auto it = std::upper_bound(begin(_routes), end(_routes), channel, [](int32_t ch, const OutputRoute& r) { return ch < r.startChannel; });
+    if (it == begin(_routes)) return nullptr;
+    --it;
+    if (channel >= it->startChannel + it->channels) return nullptr;
+    return &(*it);
+}
 #pragma endregion
 
 #pragma region Constructors and Destructors
@@ -145,6 +223,16 @@ OutputManager::~OutputManager()
         StopOutput();
     }
 
+    if (_engine != nullptr) {
+        delete _engine;
+        _engine = nullptr;
+    }
+
+    if (_pacer != nullptr) {
+        delete _pacer;
+        _pacer = nullptr;
+    }
+
     // destroy all out output objects
     DeleteAllControllers();
 
@@ -550,6 +638,11 @@ void OutputManager::AddController(Controller* controller, int pos)
 
 void OutputManager::DeleteController(const std::string& controllerName) {
 
+    // the output thread may be part way through sending to these outputs
+    if (_engine != nullptr) _engine->WaitIdle();
+    wxCriticalSectionLocker locker(_outputCriticalSection);
+    WaitForPacedFrame();
+
     for (auto it = begin(_controllers); it != end(_controllers); ++it) {
         if ((*it)->GetName() == controllerName) {
             delete* it;
@@ -562,6 +655,11 @@ void OutputManager::DeleteController(const std::string& controllerName) {
 
 void OutputManager::DeleteAllControllers() {
 
+    // the output thread may be part way through sending to these outputs
+    if (_engine != nullptr) _engine->WaitIdle();
+    wxCriticalSectionLocker locker(_outputCriticalSection);
+    WaitForPacedFrame();
+
     while (_controllers.size() > 0) {
         delete _controllers.front();
         _controllers.pop_front();
@@ -571,6 +669,8 @@ void OutputManager::DeleteAllControllers() {
         delete _conversionOutputs.front().first;
         _conversionOutputs.pop_front();
     }
+
+    InvalidateRoutes();
 }
 
 void OutputManager::MoveController(Controller* controller, int toControllerNumber) {
@@ -984,6 +1084,72 @@ void OutputManager::SuspendAll(bool suspend) {
     for_each(begin(outputs), end(outputs), [suspend](auto c) { return c->Suspend(suspend); });
 }
 
+void OutputManager::SetBatchedTransmission(bool batched) {
+
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (batched && !BatchedUDPSender::IsSupported()) {
+        logger_base.warn("Batched UDP transmission is not supported on this platform.");
+        batched = false;
+    }
+    if (batched != _batchedTransmission) {
+        logger_base.debug("Batched UDP transmission %s.", batched ? "enabled" : "disabled");
+    }
+    _batchedTransmission = batched;
+}
+
+void OutputManager::SetPacedTransmission(bool paced, int windowPercent, int maxPacketsPerMS) {
+
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (!paced) {
+        if (_pacer != nullptr) {
+            logger_base.debug("Paced transmission disabled. %s", (const char*)_pacer->GetStatistics().c_str());
+            _pacer->WaitForFrame();
+            delete _pacer;
+            _pacer = nullptr;
+        }
+        return;
+    }
+
+    if (_pacer == nullptr) {
+        _pacer = new OutputPacer();
+    }
+    _pacer->SetWindowPercent(windowPercent);
+    _pacer->SetMaxPacketsPerMS(maxPacketsPerMS);
+    logger_base.debug("Paced transmission enabled. Window %d%% of frame. Max %d packets per ms per controller.", _pacer->GetWindowPercent(), _pacer->GetMaxPacketsPerMS());
+}
+
+std::string OutputManager::GetPacingStatistics() const {
+
+    if (_pacer == nullptr) return "";
+    return _pacer->GetStatistics();
+}
+
+void OutputManager::SetOutputThread(bool enabled, int latencyMS) {
+
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (_engine != nullptr) {
+        _engine->WaitIdle();
+        logger_base.debug("Output thread stopped. %s", (const char*)_engine->GetStatisticsString().c_str());
+        delete _engine;
+        _engine = nullptr;
+    }
+
+    if (enabled) {
+        _engineFrame.assign(GetTotalChannels(), 0);
+        _engine = new OutputEngine([this](const uint8_t* data, size_t size, long msec) { TransmitFrame(data, size, msec); }, latencyMS);
+        logger_base.debug("Output thread started with %dms latency.", latencyMS);
+    }
+}
+
+std::string OutputManager::GetOutputThreadStatistics() const {
+
+    if (_engine == nullptr) return "";
+    return _engine->GetStatisticsString();
+}
+
 int OutputManager::GetPacketsPerSecond() const {
 
     if (IsOutputting()) {
@@ -995,6 +1161,9 @@ int OutputManager::GetPacketsPerSecond() const {
 // Mark all controllers with the same IP address as unmanaged
 void OutputManager::UpdateUnmanaged() {
 
+    // this is called whenever controllers are added or removed
+    InvalidateRoutes();
+
     // start with everything managed
     for (auto& it : _controllers) {
         auto eth = dynamic_cast<ControllerEthernet*>(it);
@@ -1070,6 +1239,7 @@ void OutputManager::SomethingChanged() const {
     for (auto& it : _controllers) {
         it->SetTransientData(start, nullcnt);
     }
+    InvalidateRoutes();
 }
 
 bool OutputManager::IsDirty() const {
@@ -1183,6 +1353,12 @@ bool OutputManager::StartOutput() {
         _outputting = true;
     }
 
+    {
+        // build the routing table now rather than on the first frame
+        std::unique_lock<std::mutex> lock(_routesLock);
+        BuildRoutes();
+    }
+
     _outputCriticalSection.Leave();
 
     if (_outputting) {
@@ -1197,15 +1373,26 @@ void OutputManager::StopOutput() {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     if (!_outputting) return;
+    // the output thread blocks on the lock so let it finish first
+    if (_engine != nullptr) _engine->WaitIdle();
     if (!_outputCriticalSection.TryEnter()) return;
 
     logger_base.debug("Stopping light output.");
 
+    if (_engine != nullptr) {
+        logger_base.debug("Output thread statistics: %s", (const char*)_engine->GetStatisticsString().c_str());
+    }
+    WaitForPacedFrame();
+    if (_pacer != nullptr) {
+        logger_base.debug("Paced transmission statistics: %s", (const char*)_pacer->GetStatistics().c_str());
+    }
+
     _outputting = false;
 
     for (const auto& it : GetAllOutputs()) {
         it->Close();
     }
+    BatchedUDPSender::Close();
 
     SetGlobalOutputtingFlag(false);
     _outputCriticalSection.Leave();
@@ -1233,19 +1420,57 @@ bool OutputManager::TxEmpty() {
 void OutputManager::StartFrame(long msec) {
 
     if (!_outputting) return;
+
+    if (_engine != nullptr) {
+        // the output thread starts the frame on the outputs when it is ready to send it
+        _engineMsec = msec;
+        return;
+    }
+    DoStartFrame(msec);
+}
+
+void OutputManager::DoStartFrame(long msec) {
+
     if (!_outputCriticalSection.TryEnter()) return;
-    
+    StartFrameLocked(msec);
+    _outputCriticalSection.Leave();
+}
+
+// Must be called with _outputCriticalSection held
+void OutputManager::StartFrameLocked(long msec) {
+
+    WaitForPacedFrame();
+
     for (const auto& it : GetAllOutputs()) {
         it->StartFrame(msec);
     }
-    _outputCriticalSection.Leave();
+}
+
+// Called on the output thread with a completed frame
+// The output thread has nowhere else to send the frame so it waits for the lock rather than dropping the frame.
+// Anything which waits for the output thread (_engine->WaitIdle) must do so before taking the lock.
+void OutputManager::TransmitFrame(const uint8_t* data, size_t size, long msec) {
+
+    if (!_outputting) return;
+
+    wxCriticalSectionLocker locker(_outputCriticalSection);
+
+    // output may have been stopped while we waited
+    if (!_outputting) return;
+
+    StartFrameLocked(msec);
+    DoSetManyChannels(0, data, size);
+    EndFrameLocked();
 }
 
 void OutputManager::ResetFrame() {
 
     if (!_outputting) return;
+    if (_engine != nullptr) _engine->WaitIdle();
     if (!_outputCriticalSection.TryEnter()) return;
 
+    WaitForPacedFrame();
+
     for (const auto& it : GetAllOutputs()) {
         it->ResetFrame();
     }
@@ -1255,9 +1480,50 @@ void OutputManager::ResetFrame() {
 void OutputManager::EndFrame() {
 
     if (!_outputting) return;
+
+    if (_engine != nullptr) {
+        _engine->SubmitFrame(_engineFrame.data(), _engineFrame.size(), _engineMsec);
+        return;
+    }
+    DoEndFrame();
+}
+
+void OutputManager::DoEndFrame() {
+
     if (!_outputCriticalSection.TryEnter()) return;
+    EndFrameLocked();
+    _outputCriticalSection.Leave();
+}
+
+// Must be called with _outputCriticalSection held
+void OutputManager::EndFrameLocked() {
+
+    if (_pacer != nullptr) {
+        // The IP outputs build their packets here but they are captured rather than sent, tagged with the controller
+        // they belong to, and the pacer then sends each datagram at its own time. Outputs which dont queue their
+        // packets (and serial outputs) just send as normal.
+        // Sync packets are sent by the pacer once all the data has gone.
+        BatchedUDPSender::StartCapture();
+        int group = 0;
+        for (const auto& it : _controllers) {
+            BatchedUDPSender::SetCaptureGroup(group++);
+            for (const auto& it2 : it->GetOutputs()) {
+                it2->EndFrame(_suppressFrames);
+            }
+        }
+        std::vector<CapturedPacket> packets;
+        std::vector<uint8_t> data;
+        BatchedUDPSender::EndCapture(packets, data);
+        _pacer->SendFrame(std::move(packets), std::move(data), [this]() { SendSync(); });
+        return;
+    }
 
     auto outputs = GetAllOutputs();
+
+    // when batching the outputs queue their packets rather than sending them and we push them all out in one go
+    // this must happen before any sync packets are sent
+    if (_batchedTransmission) BatchedUDPSender::StartBatch();
+
     if (_parallelTransmission) {
         std::function<void(Output*&, int)> f = [this](Output*&o, int n) {
             o->EndFrame(_suppressFrames);
@@ -1270,30 +1536,9 @@ void OutputManager::EndFrame() {
         }
     }
 
-    if (IsSyncEnabled()) {
-        if (_syncUniverse != 0) {
-            if (AtLeastOneOutputUsingProtocol(OUTPUT_E131)) {
-                for (const auto& it : GetForceIPs(OUTPUT_E131))
-                    E131Output::SendSync(_syncUniverse, it);
-            }
-        }
+    if (_batchedTransmission) BatchedUDPSender::Flush();
 
-        if (AtLeastOneOutputUsingProtocol(OUTPUT_ARTNET)) {
-            for (const auto& it : GetForceIPs(OUTPUT_ARTNET))
-                ArtNetOutput::SendSync(it);
-        }
-
-        if (AtLeastOneOutputUsingProtocol(OUTPUT_DDP)) {
-            for (const auto& it : GetForceIPs(OUTPUT_DDP))
-                DDPOutput::SendSync(it);
-        }
-
-        if (AtLeastOneOutputUsingProtocol(OUTPUT_ZCPP)) {
-            for (const auto& it : GetForceIPs(OUTPUT_ZCPP))
-                ZCPPOutput::SendSync(it);
-        }
-    }
-    _outputCriticalSection.Leave();
+    SendSync();
 }
 
 void OutputManager::SendHeartbeat() {
@@ -1308,11 +1553,17 @@ void OutputManager::SendHeartbeat() {
 // channel here is zero based
 void OutputManager::SetOneChannel(int32_t channel, unsigned char data) {
 
-    int32_t sc = 0;
-    Output* output = GetOutput(channel + 1, sc);
-    if (output != nullptr) {
-        if (output->IsEnabled()) {
-            output->SetOneChannel(sc - 1, data);
+    if (_engine != nullptr) {
+        if (_engineFrame.size() != (size_t)GetTotalChannels()) _engineFrame.resize(GetTotalChannels(), 0);
+        if (channel >= 0 && channel < (int32_t)_engineFrame.size()) _engineFrame[channel] = data;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_routesLock);
+    auto r = FindRoute(channel);
+    if (r != nullptr) {
+        if (r->output->IsEnabled()) {
+            r->output->SetOneChannel(channel - r->startChannel, data);
         }
     }
 }
@@ -1322,43 +1573,54 @@ void OutputManager::SetManyChannels(int32_t channel, unsigned char* data, size_t
 
     if (size == 0) return;
 
-    int32_t stch;
-    Output* o = GetOutput(channel + 1, stch);
+    if (_engine != nullptr) {
+        // just assemble the frame ... the output thread will route it to the outputs
+        if (_engineFrame.size() != (size_t)GetTotalChannels()) _engineFrame.resize(GetTotalChannels(), 0);
+        if (channel < 0 || channel >= (int32_t)_engineFrame.size()) return;
+        memcpy(&_engineFrame[channel], data, std::min(size, _engineFrame.size() - channel));
+        return;
+    }
+    DoSetManyChannels(channel, data, size);
+}
+
+void OutputManager::DoSetManyChannels(int32_t channel, const unsigned char* data, size_t size) {
 
-    // if this doesnt map to an output then skip it
-    if (o == nullptr) return;
+    if (size == 0) return;
 
-    // get an iterator to the output which contains our first channel
-    auto outputs = GetAllOutputs();
-    auto it = outputs.begin();
-    while (*it != o && it != outputs.end()) ++it;
+    std::unique_lock<std::mutex> lock(_routesLock);
+    auto r = FindRoute(channel);
 
+    // if this doesnt map to an output then skip it
+    if (r == nullptr) return;
+
+    // outputs are contiguous so once we have the first one just walk the table handing each output its slice
+    auto end = _routes.data() + _routes.size();
+    int32_t offset = channel - r->startChannel;
     size_t left = size;
-    while (left > 0 && o != nullptr) {
-        wxASSERT(!o->IsOutputCollection_CONVERT());
-        size_t mx = o->GetChannels() - stch + 1;
-        size_t send = std::min(left, mx);
-        if (o->IsEnabled()) {
-            o->SetManyChannels(stch - 1, &data[size - left], send);
+    while (left > 0 && r != end) {
+        wxASSERT(!r->output->IsOutputCollection_CONVERT());
+        size_t send = std::min(left, (size_t)(r->channels - offset));
+        if (r->output->IsEnabled()) {
+            r->output->SetManyChannels(offset, const_cast<unsigned char*>(&data[size - left]), send);
         }
-        stch = 1;
+        offset = 0;
         left -= send;
-
-        // Move to the next output
-        ++it;
-        if (it == outputs.end()) {
-            o = nullptr;
-        }
-        else {
-            o = *it;
-        }
+        ++r;
     }
 }
 
 void OutputManager::AllOff(bool send) {
 
+    if (_engine != nullptr) {
+        // make sure a queued frame doesnt turn things back on and that later frames start from black
+        _engine->WaitIdle();
+        std::fill(begin(_engineFrame), end(_engineFrame), 0);
+    }
+
     if (!_outputCriticalSection.TryEnter()) return;
 
+    WaitForPacedFrame();
+
     for (const auto& it : GetAllOutputs()) {
         it->AllOff();
         if (send) {
@@ -14,6 +14,7 @@
 
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -25,9 +26,19 @@ class Controller;
 class TestPreset;
 class Controller;
 class ControllerEthernet;
+class OutputPacer;
+class OutputEngine;
 
 #define NETWORKSFILE "xlights_networks.xml";
 
+// One entry per output in absolute channel order ... used to route frame data without walking the controllers
+struct OutputRoute
+{
+    int32_t startChannel = 0; // zero based absolute start channel
+    int32_t channels = 0;
+    Output* output = nullptr;
+};
+
 class OutputManager
 {
     #pragma region Member Variables
@@ -40,6 +51,11 @@ class OutputManager
     bool _dirty = false;
     int _suppressFrames = 0;
     bool _parallelTransmission = false;
+    bool _batchedTransmission = false;
+    OutputPacer* _pacer = nullptr; // only exists when paced transmission is enabled
+    OutputEngine* _engine = nullptr; // only exists when the dedicated output thread is enabled
+    std::vector<uint8_t> _engineFrame; // frame being assembled by the playback thread for the engine
+    long _engineMsec = 0;
     bool _outputting = false; // true if we are currently sending out data
     bool _didConvert = false;
     std::string _globalFPPProxy;
@@ -47,6 +63,9 @@ class OutputManager
     wxCriticalSection _outputCriticalSection; // used to protect areas that must be single threaded
     std::string _baseShowDir = "";
     bool _autoUpdateFromBaseShowDir = false;
+    mutable std::mutex _routesLock;
+    mutable std::vector<OutputRoute> _routes; // sorted by start channel
+    mutable bool _routesValid = false;
     #pragma endregion 
 
     #pragma region Static Variables
@@ -63,6 +82,17 @@ class OutputManager
     bool SetGlobalOutputtingFlag(bool state, bool force = false);
     bool ConvertStartChannel(const std::string sc, std::string& newsc) const;
     void AsyncPingAll();
+    void BuildRoutes() const;
+    void InvalidateRoutes() const;
+    const OutputRoute* FindRoute(int32_t channel) const;
+    void SendSync();
+    void WaitForPacedFrame();
+    void TransmitFrame(const uint8_t* data, size_t size, long msec);
+    void DoStartFrame(long msec);
+    void DoEndFrame();
+    void StartFrameLocked(long msec);
+    void EndFrameLocked();
+    void DoSetManyChannels(int32_t channel, const unsigned char* data, size_t size);
     #pragma endregion 
 
 public:
@@ -175,6 +205,20 @@ public:
     
     void SetParallelTransmission(bool parallel) { _parallelTransmission = parallel; }
     bool GetParallelTransmission() const { return _parallelTransmission; }
+
+    void SetBatchedTransmission(bool batched);
+    bool GetBatchedTransmission() const { return _batchedTransmission; }
+
+    // windowPercent is the percentage of the frame interval to spread the packets over
+    // maxPacketsPerMS caps how fast any one controller is sent packets ... 0 is unlimited
+    void SetPacedTransmission(bool paced, int windowPercent = 50, int maxPacketsPerMS = 0);
+    bool GetPacedTransmission() const { return _pacer != nullptr; }
+    std::string GetPacingStatistics() const;
+
+    // when enabled frames are queued to a dedicated high priority thread and sent latencyMS after their timestamp
+    void SetOutputThread(bool enabled, int latencyMS = 20);
+    bool GetOutputThread() const { return _engine != nullptr; }
+    std::string GetOutputThreadStatistics() const;
     
     int GetPacketsPerSecond() const;
     
@@ -0,0 +1,195 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputPacer.h"
+
+#include <wx/socket.h>
+
+#include <cstring>
+
+#include <log4cpp/Category.hh>
+
+#pragma region Constructors and Destructors
+OutputPacer::OutputPacer() {
+
+    ResetStatistics();
+    _thread = std::thread([this]() { Run(); });
+}
+
+OutputPacer::~OutputPacer() {
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop = true;
+    }
+    _signal.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+#pragma endregion
+
+#pragma region Private Functions
+void OutputPacer::Run() {
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(_lock);
+        while (!_pending && !_stop) {
+            _signal.wait(lock);
+        }
+        if (_stop) break;
+        _pending = false;
+        lock.unlock();
+
+        TransmitFrame();
+        if (_afterFrame) _afterFrame();
+
+        lock.lock();
+        _packets.clear();
+        _afterFrame = nullptr;
+        _busy = false;
+        lock.unlock();
+        _signal.notify_all();
+    }
+}
+
+void OutputPacer::TransmitFrame() {
+
+    static log4cpp::Category& logger_frame = log4cpp::Category::getInstance(std::string("log_frame"));
+
+    // interleave the controllers so each controllers packets are spread across the window
+    std::vector<std::vector<size_t>> groups;
+    for (size_t i = 0; i < _packets.size(); ++i) {
+        size_t g = (size_t)std::max(0, _packets[i].group);
+        if (g >= groups.size()) groups.resize(g + 1);
+        groups[g].push_back(i);
+    }
+    std::vector<size_t> order;
+    order.reserve(_packets.size());
+    size_t longest = 0;
+    for (const auto& it : groups) {
+        longest = std::max(longest, it.size());
+    }
+    for (size_t i = 0; i < longest; ++i) {
+        for (const auto& it : groups) {
+            if (i < it.size()) {
+                order.push_back(it[i]);
+            }
+        }
+    }
+    if (order.empty()) return;
+
+    const double spacing = order.size() > 1 ? (double)_windowMS / (double)order.size() : 0.0;
+    const double minGap = _maxPacketsPerMS > 0 ? 1.0 / (double)_maxPacketsPerMS : 0.0;
+    std::vector<double> lastSend(groups.size(), -1000.0);
+    std::vector<uint32_t> perMS(_windowMS + 1, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    double target = 0.0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto& p = _packets[order[i]];
+        size_t g = (size_t)std::max(0, p.group);
+
+        // never earlier than our slot or than this controllers rate cap allows
+        target = std::max(i * spacing, lastSend[g] + minGap);
+        auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(target));
+        if (due > std::chrono::steady_clock::now()) {
+            std::this_thread::sleep_until(due);
+        }
+
+        p.socket->SendTo(*p.addr, &_data[p.offset], p.len);
+
+        double sent = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        lastSend[g] = sent;
+        size_t bucket = (size_t)sent;
+        if (bucket >= perMS.size()) perMS.resize(bucket + 1, 0);
+        perMS[bucket]++;
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::unique_lock<std::mutex> lock(_statsLock);
+    for (const auto& it : perMS) {
+        _histogram[std::min((size_t)it, (size_t)PACER_HISTOGRAM_BUCKETS - 1)]++;
+    }
+    _frames++;
+    if (elapsed > _frameInterval) {
+        _overruns++;
+        logger_frame.debug("OutputPacer: Frame took %dms to send which is longer than the frame interval %dms.", (int)elapsed, (int)_frameInterval);
+    }
+}
+#pragma endregion
+
+#pragma region Frame Handling
+void OutputPacer::SendFrame(std::vector<CapturedPacket>&& packets, std::vector<uint8_t>&& data, std::function<void()> afterFrame) {
+
+    // only one frame can be in flight
+    WaitForFrame();
+
+    auto now = std::chrono::steady_clock::now();
+    if (_lastFrame != std::chrono::steady_clock::time_point()) {
+        float interval = std::chrono::duration<float, std::milli>(now - _lastFrame).count();
+        // ignore silly intervals such as the gap when playback pauses
+        if (interval >= 5.0f && interval <= 1000.0f) {
+            _frameInterval = _frameInterval * 0.9f + interval * 0.1f;
+        }
+    }
+    _lastFrame = now;
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _packets = std::move(packets);
+        _data = std::move(data);
+        _afterFrame = afterFrame;
+        _windowMS = (int)(_frameInterval * _windowPercent / 100);
+        _pending = true;
+        _busy = true;
+    }
+    _signal.notify_all();
+}
+
+void OutputPacer::WaitForFrame() {
+
+    if (!_busy) return;
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_busy) {
+        _signal.wait(lock);
+    }
+}
+#pragma endregion
+
+#pragma region Statistics
+std::vector<uint64_t> OutputPacer::GetHistogram() {
+
+    std::unique_lock<std::mutex> lock(_statsLock);
+    return std::vector<uint64_t>(_histogram, _histogram + PACER_HISTOGRAM_BUCKETS);
+}
+
+std::string OutputPacer::GetStatistics() {
+
+    std::unique_lock<std::mutex> lock(_statsLock);
+    std::string res = "Frames: " + std::to_string(_frames) + " Overruns: " + std::to_string(_overruns) + " Packets/ms:";
+    for (size_t i = 0; i < PACER_HISTOGRAM_BUCKETS; ++i) {
+        if (_histogram[i] == 0) continue;
+        res += " " + std::to_string(i) + ((i == PACER_HISTOGRAM_BUCKETS - 1) ? "+" : "") + "=" + std::to_string(_histogram[i]);
+    }
+    return res;
+}
+
+void OutputPacer::ResetStatistics() {
+
+    std::unique_lock<std::mutex> lock(_statsLock);
+    memset(_histogram, 0x00, sizeof(_histogram));
+    _frames = 0;
+    _overruns = 0;
+}
+#pragma endregion
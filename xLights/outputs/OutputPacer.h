@@ -0,0 +1,93 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BatchedUDPSender.h"
+
+#define PACER_HISTOGRAM_BUCKETS 17 // 0-15 packets in a millisecond plus a 16+ bucket
+
+// Spreads the output of a frame across part of the frame interval rather than sending every datagram in one burst.
+// Cheap receivers and wireless bridges drop packets when hundreds arrive within a millisecond.
+// The packets are captured from the outputs by BatchedUDPSender and sent on a background thread so the caller does
+// not block for the pacing window. Callers must WaitForFrame before touching the output sockets again.
+class OutputPacer
+{
+    #pragma region Member Variables
+    std::thread _thread;
+    std::mutex _lock;
+    std::condition_variable _signal;
+    bool _stop = false;
+    bool _pending = false;
+    std::atomic_bool _busy = false;
+
+    // the frame being sent
+    std::vector<CapturedPacket> _packets;
+    std::vector<uint8_t> _data;
+    std::function<void()> _afterFrame;
+    int _windowMS = 0;
+
+    int _windowPercent = 50;
+    int _maxPacketsPerMS = 0; // per controller ... 0 = no limit
+
+    std::chrono::steady_clock::time_point _lastFrame;
+    float _frameInterval = 50.0f;
+
+    std::mutex _statsLock;
+    uint64_t _histogram[PACER_HISTOGRAM_BUCKETS];
+    uint32_t _frames = 0;
+    uint32_t _overruns = 0;
+    #pragma endregion
+
+    #pragma region Private Functions
+    void Run();
+    void TransmitFrame();
+    #pragma endregion
+
+public:
+
+    #pragma region Constructors and Destructors
+    OutputPacer();
+    virtual ~OutputPacer();
+    #pragma endregion
+
+    #pragma region Getters and Setters
+    void SetWindowPercent(int percent) { _windowPercent = std::max(1, std::min(100, percent)); }
+    int GetWindowPercent() const { return _windowPercent; }
+    void SetMaxPacketsPerMS(int packets) { _maxPacketsPerMS = std::max(0, packets); }
+    int GetMaxPacketsPerMS() const { return _maxPacketsPerMS; }
+    #pragma endregion
+
+    #pragma region Frame Handling
+    // packets are in the order they should be sent within each group (controller) ... data holds their bytes
+    // afterFrame is called on the pacing thread once all data is sent ... use it to send sync packets
+    void SendFrame(std::vector<CapturedPacket>&& packets, std::vector<uint8_t>&& data, std::function<void()> afterFrame);
+    void WaitForFrame();
+    bool IsBusy() const { return _busy; }
+    #pragma endregion
+
+    #pragma region Statistics
+    // histogram of how many packets went out in each millisecond of the pacing window
+    std::vector<uint64_t> GetHistogram();
+    std::string GetStatistics();
+    void ResetStatistics();
+    #pragma endregion
+};
@@ -21,6 +21,7 @@
 #include "../controllers/Falcon.h"
 #include "ZCPPOutput.h"
 #include "OutputManager.h"
+#include "BatchedUDPSender.h"
 #include "../UtilFunctions.h"
 #include "ControllerEthernet.h"
 #include "../OutputModelManager.h"
@@ -907,7 +908,9 @@ void ZCPPOutput::EndFrame(int suppressFrames) {
                           (i == 0 ? ZCPP_DATA_FLAG_FIRST : 0x00);
             _packet.Data.packetDataLength = ntohs(packetlen);
             memcpy(_packet.Data.data, &_data[i], packetlen);
-            _datagram->SendTo(_remoteAddr, &_packet, ZCPP_GetPacketActualSize(_packet));
+            if (!BatchedUDPSender::Queue(GetForceLocalIPToUse(), _datagram, _remoteAddr, (const uint8_t*)&_packet, ZCPP_GetPacketActualSize(_packet))) {
+                _datagram->SendTo(_remoteAddr, &_packet, ZCPP_GetPacketActualSize(_packet));
+            }
             i += packetlen;
         }
         _sequenceNum++;
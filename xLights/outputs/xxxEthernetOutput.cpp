@@ -15,6 +15,7 @@
 #include <wx/process.h>
 
 #include "OutputManager.h"
+#include "BatchedUDPSender.h"
 #include "../UtilFunctions.h"
 #include "../utils/ip_utils.h"
 
@@ -250,7 +251,9 @@ void xxxEthernetOutput::EndFrame(int suppressFrames) {
                 _packet[6] = (uint8_t)(ch & 0xFF); // low pixels per packet
                 memcpy(&_packet[xxxETHERNET_PACKET_HEADERLEN], &_data[current], ch);
                 _packet[xxxETHERNET_PACKET_HEADERLEN + ch] = 0x81;
-                _datagram->SendTo(_remoteAddr, _packet, xxxETHERNET_PACKET_HEADERLEN + ch + xxxETHERNET_PACKET_FOOTERLEN);
+                if (!BatchedUDPSender::Queue(GetForceLocalIPToUse(), _datagram, _remoteAddr, _packet, xxxETHERNET_PACKET_HEADERLEN + ch + xxxETHERNET_PACKET_FOOTERLEN)) {
+                    _datagram->SendTo(_remoteAddr, _packet, xxxETHERNET_PACKET_HEADERLEN + ch + xxxETHERNET_PACKET_FOOTERLEN);
+                }
                 current += xxxCHANNELSPERPACKET;
             }
             FrameOutput();
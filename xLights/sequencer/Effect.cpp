@@ -22,6 +22,7 @@
 #include "../xLightsMain.h"
 #include "../xLightsApp.h"
 #include "../effects/RenderableEffect.h"
+#include "../effects/EffectSettingsCache.h"
 #include "../ExternalHooks.h"
 
 #include <unordered_map>
@@ -87,6 +88,31 @@ private:
     std::unordered_map<std::string, std::string> data;
 } Remaps;
 
+SettingsMap::~SettingsMap()
+{
+    delete _cache.load();
+}
+
+EffectSettingsCache& SettingsMap::GetCache() const
+{
+    EffectSettingsCache* cache = _cache.load(std::memory_order_acquire);
+    if (cache == nullptr) {
+        // several buffers of the same effect can be rendering at once so only one of them gets to create it
+        EffectSettingsCache* created = new EffectSettingsCache();
+        if (_cache.compare_exchange_strong(cache, created, std::memory_order_acq_rel)) {
+            cache = created;
+        } else {
+            delete created;
+        }
+    }
+    return *cache;
+}
+
+void SettingsMap::ResetCache()
+{
+    delete _cache.exchange(nullptr);
+}
+
 void SettingsMap::RemapChangedSettingKey(std::string &n,  std::string &value)
 {
     Remaps.map(n);
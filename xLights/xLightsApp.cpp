@@ -36,6 +36,8 @@
 #include "TraceLog.h"
 #include "ExternalHooks.h"
 #include "BitmapCache.h"
+#include "Parallel.h"
+#include "ParallelBatchRender.h"
 #include "utils/CurlManager.h"
 
 #ifndef __WXMSW__
@@ -482,6 +484,9 @@ bool xLightsApp::OnInit()
     {
         { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters", wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
         { wxCMD_LINE_SWITCH, "r", "render", "render files and exit"},
+        { wxCMD_LINE_OPTION, "j", "jobs", "number of render processes to split the sequences across", wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_OPTION, "t", "threads", "maximum number of render threads", wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_OPTION, "rp", "report", "write render timings to this csv file" },
         { wxCMD_LINE_SWITCH, "cs", "checksequence", "run check sequence and exit" },
         { wxCMD_LINE_OPTION, "m", "media", "specify media directory"},
         { wxCMD_LINE_OPTION, "s", "show", "specify show directory" },
@@ -622,6 +627,26 @@ bool xLightsApp::OnInit()
     if (parser.Found("r")) {
         logger_base.info("-r: Render mode is ON");
         renderOnlyMode = true;
+
+        long threads = 0;
+        if (parser.Found("t", &threads) && threads > 0) {
+            logger_base.info("-t: Render threads limited to %ld.", threads);
+            renderThreads = threads;
+            ParallelJobPool::SetPJPMaxThreadCount(renderThreads);
+        }
+        parser.Found("rp", &renderReport);
+
+        long jobs = 1;
+        if (parser.Found("j", &jobs) && jobs > 1 && sequenceFiles.size() > 1) {
+            // no window at all ... we just hand the sequences to other xLights render processes and wait
+            logger_base.info("-j: Rendering %d sequences across %ld processes.", (int)sequenceFiles.size(), jobs);
+            _parallelRender = new ParallelBatchRender(showDir, mediaDir, sequenceFiles, jobs, renderThreads, renderReport);
+            if (!_parallelRender->Start()) {
+                DisplayError(_("Unable to start render processes"));
+                return false;
+            }
+            return true;
+        }
     }
 
     //(*AppInitialize
@@ -676,6 +701,15 @@ void xLightsApp::WipeSettings()
     config->DeleteAll();
 }
 
+int xLightsApp::OnExit()
+{
+    if (_parallelRender != nullptr) {
+        delete _parallelRender;
+        _parallelRender = nullptr;
+    }
+    return xLightsAppBaseClass::OnExit();
+}
+
 bool xLightsApp::ProcessIdle() {
     uint64_t now = wxGetLocalTimeMillis().GetValue();
     if (now > _nextIdleTime) {
@@ -690,3 +724,5 @@ bool xLightsApp::ProcessIdle() {
 wxString xLightsApp::mediaDir;
 wxString xLightsApp::showDir;
 wxArrayString xLightsApp::sequenceFiles;
+int xLightsApp::renderThreads = 0;
+wxString xLightsApp::renderReport;
@@ -13,6 +13,7 @@
 #include "../common/xlBaseApp.h"
 
 class xLightsFrame;
+class ParallelBatchRender;
 
 #include "graphics/xlGraphicsBase.h"
 
@@ -27,15 +28,19 @@ class xLightsFrame;
 class xLightsApp : public xLightsAppBaseClass
 {
     void WipeSettings();
+    ParallelBatchRender* _parallelRender = nullptr;
 
 public:
     xLightsApp();
 
     virtual bool OnInit() override;
+    virtual int OnExit() override;
     static xLightsFrame* GetFrame() { return __frame; }
     static wxString showDir;
     static wxString mediaDir;
     static wxArrayString sequenceFiles;
+    static int renderThreads;
+    static wxString renderReport;
     static xLightsFrame* __frame;
 
     #ifdef __WXOSX__
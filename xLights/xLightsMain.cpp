@@ -73,6 +73,8 @@
 #include "PathGenerationDialog.h"
 #include "PixelTestDialog.h"
 #include "RenderCommandEvent.h"
+#include "RenderProfileDialog.h"
+#include "RenderProfiler.h"
 #include "RestoreBackupDialog.h"
 #include "SeqSettingsDialog.h"
 #include "ShaderDownloadDialog.h"
@@ -87,6 +89,7 @@
 #include "VendorModelDialog.h"
 #include "VendorMusicDialog.h"
 #include "VideoExporter.h"
+#include "VideoFrameCache.h"
 #include "ViewsModelsPanel.h"
 #include "xLightsApp.h"
 #include "xLightsMain.h"
@@ -257,6 +260,8 @@ const long xLightsFrame::ID_MENU_VIEW_LOG = wxNewId();
 const long xLightsFrame::ID_MENUITEM18 = wxNewId();
 const long xLightsFrame::iD_MNU_VENDORCACHEPURGE = wxNewId();
 const long xLightsFrame::ID_MNU_PURGERENDERCACHE = wxNewId();
+const long xLightsFrame::ID_MNU_PROFILERENDER = wxNewId();
+const long xLightsFrame::ID_MNU_RENDERPROFILE = wxNewId();
 const long xLightsFrame::ID_MNU_CRASH = wxNewId();
 const long xLightsFrame::ID_MNU_DUMPRENDERSTATE = wxNewId();
 const long xLightsFrame::ID_MENU_GENERATE2DPATH = wxNewId();
@@ -644,7 +649,7 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     MainToolBar->AddTool(ID_AUITOOLBAR_OPEN, _("Open Sequence"), GetToolbarBitmapBundle("wxART_FILE_OPEN"), wxNullBitmap, wxITEM_NORMAL, _("Open Sequence"), wxEmptyString, NULL);
     MainToolBar->AddTool(ID_AUITOOLBAR_SAVE, _("Save"), GetToolbarBitmapBundle("wxART_FILE_SAVE"), wxNullBitmap, wxITEM_NORMAL, _("Save"), wxEmptyString, NULL);
     MainToolBar->AddTool(ID_AUITOOLBAR_SAVEAS, _("Save As"), GetToolbarBitmapBundle("wxART_FILE_SAVE_AS"), wxNullBitmap, wxITEM_NORMAL, _("Save As"), wxEmptyString, NULL);
-    MainToolBar->AddTool(ID_AUITOOLBAR_RENDERALL, _("Render All"), GetToolbarBitmapBundle("xlART_RENDER_ALL"), wxNullBitmap, wxITEM_NORMAL, _("Render All"), wxEmptyString, NULL);
+    MainToolBar->AddTool(ID_AUITOOLBAR_RENDERALL, _("Render All"), GetToolbarBitmapBundle("xlART_RENDER_ALL"), wxNullBitmap, wxITEM_NORMAL, _("Render All (Shift to re-render everything)"), wxEmptyString, NULL);
     MainToolBar->Realize();
     MainAuiManager->AddPane(MainToolBar, wxAuiPaneInfo().Name(_T("Main Tool Bar")).ToolbarPane().Caption(_("Main Tool Bar")).CloseButton(false).Layer(10).Top().Gripper());
     PlayToolBar = new xlAuiToolBar(this, ID_AUITOOLBAR_PLAY, wxDefaultPosition, wxDefaultSize, wxAUI_TB_DEFAULT_STYLE);
@@ -992,6 +997,10 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     Menu1->Append(MenuItem_PurgeVendorCache);
     MenuItem_PurgeRenderCache = new wxMenuItem(Menu1, ID_MNU_PURGERENDERCACHE, _("Purge Render Cache"), wxEmptyString, wxITEM_NORMAL);
     Menu1->Append(MenuItem_PurgeRenderCache);
+    MenuItem_ProfileRender = new wxMenuItem(Menu1, ID_MNU_PROFILERENDER, _("Profile Rendering"), _("Record how long each effect, model and layer blend takes to render."), wxITEM_CHECK);
+    Menu1->Append(MenuItem_ProfileRender);
+    MenuItem_RenderProfile = new wxMenuItem(Menu1, ID_MNU_RENDERPROFILE, _("Render Profile"), wxEmptyString, wxITEM_NORMAL);
+    Menu1->Append(MenuItem_RenderProfile);
     MenuItem_CrashXLights = new wxMenuItem(Menu1, ID_MNU_CRASH, _("Crash xLights"), wxEmptyString, wxITEM_NORMAL);
     Menu1->Append(MenuItem_CrashXLights);
     MenuItem_LogRenderState = new wxMenuItem(Menu1, ID_MNU_DUMPRENDERSTATE, _("Log Render State"), wxEmptyString, wxITEM_NORMAL);
@@ -1264,6 +1273,8 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     Connect(ID_MENUITEM18, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItemPackageDebugFiles);
     Connect(iD_MNU_VENDORCACHEPURGE, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_PurgeVendorCacheSelected);
     Connect(ID_MNU_PURGERENDERCACHE, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_PurgeRenderCacheSelected);
+    Connect(ID_MNU_PROFILERENDER, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_ProfileRenderSelected);
+    Connect(ID_MNU_RENDERPROFILE, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_RenderProfileSelected);
     Connect(ID_MNU_CRASH, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_CrashXLightsSelected);
     Connect(ID_MNU_DUMPRENDERSTATE, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_LogRenderStateSelected);
     Connect(ID_MENU_GENERATE2DPATH, wxEVT_COMMAND_MENU_SELECTED, (wxObjectEventFunction)&xLightsFrame::OnMenuItem_Generate2DPathSelected);
@@ -1688,6 +1699,17 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     logger_base.debug("Enable Render Cache: %s.", (const char*)_enableRenderCache.c_str());
     _renderCache.Enable(_enableRenderCache);
 
+    // in MB across all sequences, 0 for no limit
+    long renderCacheMaxSize = 4096;
+    config->Read(_("xLightsRenderCacheMaxSize"), &renderCacheMaxSize, 4096);
+    logger_base.debug("Render Cache max size: %ldMB.", renderCacheMaxSize);
+    _renderCache.SetMaxSize((uint64_t)std::max(0L, renderCacheMaxSize) * 1024 * 1024);
+
+    long videoFrameCacheMaxSize = 512;
+    config->Read(_("xLightsVideoFrameCacheMaxSize"), &videoFrameCacheMaxSize, 512);
+    logger_base.debug("Video Frame Cache max size: %ldMB.", videoFrameCacheMaxSize);
+    VideoFrameCache::GetCache().SetMaxMemory((size_t)std::max(0L, videoFrameCacheMaxSize) * 1024 * 1024);
+
     config->Read("xLightsAutoSavePerspectives", &_autoSavePerspecive, false);
     MenuItem_PerspectiveAutosave->Check(_autoSavePerspecive);
     logger_base.debug("Autosave perspectives: %s.", toStr(_autoSavePerspecive));
@@ -1914,6 +1936,10 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     if (threadCount < 20) {
         threadCount = 20;
     }
+    if (xLightsApp::renderThreads > 0) {
+        // command line render with a thread budget (-t) so other render processes can share the machine
+        threadCount = std::max(xLightsApp::renderThreads * multiplier, 8);
+    }
     jobPool.Start(threadCount);
 
     if (!xLightsApp::sequenceFiles.IsEmpty()) {
@@ -2054,6 +2080,8 @@ xLightsFrame::~xLightsFrame()
     config->Write("xLightsShowACLights", _showACLights);
     config->Write("xLightsShowACRamps", _showACRamps);
     config->Write("xLightsEnableRenderCache", _enableRenderCache);
+    config->Write("xLightsRenderCacheMaxSize", (long)(_renderCache.GetMaxSize() / (1024 * 1024)));
+    config->Write("xLightsVideoFrameCacheMaxSize", (long)(VideoFrameCache::GetCache().GetMaxMemory() / (1024 * 1024)));
     config->Write("xLightsPlayControlsOnPreview", _playControlsOnPreview);
     config->Write("xLightsShowBaseFolder", _showBaseShowFolder);
     config->Write("xLightsAutoShowHousePreview", _autoShowHousePreview);
@@ -3353,7 +3381,8 @@ void xLightsFrame::OnResize(wxSizeEvent& event)
 
 void xLightsFrame::OnAuiToolBarItemRenderAllClick(wxCommandEvent& event)
 {
-    RenderAll();
+    // shift forces everything to be rendered rather than just what has changed
+    RenderAll(wxGetKeyState(WXK_SHIFT));
 }
 
 bool AUIToolbarButtonWrapper::IsChecked()
@@ -9041,6 +9070,17 @@ void xLightsFrame::OnMenuItem_PurgeRenderCacheSelected(wxCommandEvent& event)
     _renderCache.Purge(&_sequenceElements, true);
 }
 
+void xLightsFrame::OnMenuItem_ProfileRenderSelected(wxCommandEvent& event)
+{
+    RenderProfiler::Instance().SetEnabled(MenuItem_ProfileRender->IsChecked());
+}
+
+void xLightsFrame::OnMenuItem_RenderProfileSelected(wxCommandEvent& event)
+{
+    RenderProfileDialog dlg(this);
+    dlg.ShowModal();
+}
+
 void xLightsFrame::SetEnableRenderCache(const wxString& t)
 {
     _enableRenderCache = t;
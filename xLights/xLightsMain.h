@@ -79,6 +79,7 @@
 #include "xLightsXmlFile.h"
 #include "sequencer/EffectsGrid.h"
 #include "RenderCache.h"
+#include "RenderHashIndex.h"
 #include "outputs/ZCPP.h"
 #include "OutputModelManager.h"
 #include "models/Model.h"
@@ -323,6 +324,7 @@ public:
     int TxOverflowTotal = 0;
     std::mutex saveLock;
     RenderCache _renderCache;
+    RenderHashIndex _renderHashIndex;
     std::atomic_bool _exiting;
     #ifdef __WXMSW__
     // windows has issues if we create it later
@@ -400,6 +402,10 @@ public:
     std::string GetPresetIconFilename(const std::string& preset) const;
     void CreatePresetIcons();
     void ClearSequenceData();
+    bool IsEffectOnlySequenceData() const;
+    void LoadRenderHashIndex();
+    void SaveRenderHashIndex();
+    RenderHashIndex& GetRenderHashIndex() { return _renderHashIndex; }
     void LoadAudioData(xLightsXmlFile& xml_file);
     virtual void CreateDebugReport(xlCrashHandler* crashHandler) override;
     virtual std::string GetCurrentDir() const override { return CurrentDir.ToStdString(); }
@@ -580,6 +586,8 @@ public:
     void OnMenuItemShiftSelectedEffectsSelected(wxCommandEvent& event);
     void OnMenuItemUserDictSelected(wxCommandEvent& event);
     void OnMenuItem_PurgeRenderCacheSelected(wxCommandEvent& event);
+    void OnMenuItem_ProfileRenderSelected(wxCommandEvent& event);
+    void OnMenuItem_RenderProfileSelected(wxCommandEvent& event);
     void OnMenuItem_ShowKeyBindingsSelected(wxCommandEvent& event);
     void OnChar(wxKeyEvent& event);
     void OnMenuItem_ZoomSelected(wxCommandEvent& event);
@@ -760,6 +768,8 @@ public:
     static const long ID_MENUITEM18;
     static const long iD_MNU_VENDORCACHEPURGE;
     static const long ID_MNU_PURGERENDERCACHE;
+    static const long ID_MNU_PROFILERENDER;
+    static const long ID_MNU_RENDERPROFILE;
     static const long ID_MNU_CRASH;
     static const long ID_MNU_DUMPRENDERSTATE;
     static const long ID_MENU_GENERATE2DPATH;
@@ -968,10 +978,12 @@ public:
     wxMenuItem* MenuItem_PackageSequence;
     wxMenuItem* MenuItem_PerspectiveAutosave;
     wxMenuItem* MenuItem_PrepareAudio;
+    wxMenuItem* MenuItem_ProfileRender;
     wxMenuItem* MenuItem_PurgeRenderCache;
     wxMenuItem* MenuItem_PurgeVendorCache;
     wxMenuItem* MenuItem_QuietVol;
     wxMenuItem* MenuItem_RemapCustom;
+    wxMenuItem* MenuItem_RenderProfile;
     wxMenuItem* MenuItem_SD_HP;
     wxMenuItem* MenuItem_SD_MP;
     wxMenuItem* MenuItem_ShowACRamps;
@@ -1432,7 +1444,7 @@ public:
     int GetCurrentPlayTime();
     bool InitPixelBuffer(const std::string &modelName, PixelBufferClass &buffer, int layerCount, bool zeroBased = false);
     Model *GetModel(const std::string& name) const;
-    void RenderGridToSeqData(std::function<void(bool)>&& callback);
+    void RenderGridToSeqData(std::function<void(bool)>&& callback, bool force = false);
     bool AbortRender(int maxTimeMs = 60000, int* numThreadsAborted = nullptr);
     std::string GetSelectedLayoutPanelPreview() const;
     void UpdateRenderStatus();
@@ -1451,7 +1463,9 @@ public:
                 const std::list<Model *> &restrictToModels,
                 int startFrame, int endFrame,
                 bool progressDialog, bool clear,
-                std::function<void(bool)>&& callback);
+                std::function<void(bool)>&& callback,
+                const RenderFrameMasks* frameMasks = nullptr);
+    void RenderStaleModels(std::function<void(bool)>&& callback);
     void BuildRenderTree();
 
     void RenderRange(RenderCommandEvent &cmd);
@@ -1485,7 +1499,7 @@ public:
 
     void SetSequenceEnd(int ms);
     void SetFrequency(int frequency);
-    void RenderAll();
+    void RenderAll(bool force = false);
 
     void SetXmlSetting(const wxString& settingName,const wxString& value);
     uint32_t GetMaxNumChannels();
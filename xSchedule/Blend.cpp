@@ -8,23 +8,24 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
-
 #include "Blend.h"
 
-//#define SIMD
-
-#ifdef SIMD
-#include "emmintrin.h"
-#define ALIGNMENT (128 / 8)
-
-int GetMisalignedBytes(uint8_t* b1, uint8_t* b2)
-{
-    int m1 = (size_t)b1 % ALIGNMENT;
-    int m2 = (size_t)b2 % ALIGNMENT;
-
-    if (m1 == m2) return m1;
-    return -1;
-}
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define BLEND_HAVE_SSE2
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BLEND_AVX2_TARGET
+#else
+#define BLEND_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BLEND_HAVE_NEON
 #endif
 
 void PopulateBlendModes(wxChoice* choice)
@@ -118,404 +119,579 @@ std::string DecodeBlendMode(APPLYMETHOD blendMode)
     return "Overwrite";
 }
 
-void Blend(uint8_t* buffer, size_t bufferSize, uint8_t* blendBuffer, size_t blendBufferSize, APPLYMETHOD applyMethod, size_t offset)
-{
-    if (offset > bufferSize) return;
-
-    size_t bytesToUse = std::min(bufferSize - offset, blendBufferSize);
-    uint8_t* pb = buffer + offset;
+// Each blend mode is an op applied to a byte (or a pixel for the pixel modes) with overloads for each vector
+// type. The loops below run them as wide as the cpu allows and finish off the odd bytes at the end with the
+// scalar version.
 
-    switch (applyMethod) {
-    case APPLYMETHOD::METHOD_OVERWRITE:
-        return Overwrite(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_OVERWRITEIFZERO:
-        return OverwriteIfZero(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_MASK:
-        return Mask(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_UNMASK:
-        return Unmask(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_AVERAGE:
-        return Average(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_MAX:
-        return Maximum(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_OVERWRITEIFBLACK:
-        return OverwriteIfBlack(pb, blendBuffer, bytesToUse / 3);
-    case APPLYMETHOD::METHOD_MASKPIXEL:
-        return MaskPixel(pb, blendBuffer, bytesToUse / 3);
-    case APPLYMETHOD::METHOD_UNMASKPIXEL:
-        return UnmaskPixel(pb, blendBuffer, bytesToUse / 3);
-    case APPLYMETHOD::METHOD_MIN:
-        return Minimum(pb, blendBuffer, bytesToUse);
-    case APPLYMETHOD::METHOD_OVERWRITESKIPBLACK:
-        return OverwriteSkipBlack(pb, blendBuffer, bytesToUse / 3);
-    case APPLYMETHOD::METHOD_BRIGHTNESS:
-        return Brightness(pb, blendBuffer, bytesToUse / 3);
-    }
+#ifdef BLEND_HAVE_SSE2
+// 0xFF where v is zero
+static inline __m128i IsZero(__m128i v)
+{
+    return _mm_cmpeq_epi8(v, _mm_setzero_si128());
 }
-
-void Overwrite(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
+BLEND_AVX2_TARGET static inline __m256i IsZero(__m256i v)
 {
-    memcpy(buffer, blendBuffer, channels);
+    return _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+}
+// mask ? a : b
+static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
 }
+BLEND_AVX2_TARGET static inline __m256i Select(__m256i mask, __m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, mask);
+}
+#endif
 
-void OverwriteIfZero(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
+#ifdef BLEND_HAVE_NEON
+static inline uint8x16_t IsZero(uint8x16_t v)
 {
-#ifdef SIMD
-    int misaligned = GetMisalignedBytes(buffer, blendBuffer);
-    if (misaligned >= 0 && (channels - misaligned) >= ALIGNMENT) // we can only use SIMD if misalignment is the same for both buffers and we have the minimum number of bytes to do
-    {
-        // do the misaligned
-        for (size_t i = 0; i < misaligned; ++i)
-        {
-            if (*(buffer + i) == 0x00)
-            {
-                *(buffer + i) = *(blendBuffer + i);
-            }
-        }
+    return vceqq_u8(v, vdupq_n_u8(0));
+}
+#endif
 
-        __m128i zero = _mm_setr_epi32(0, 0, 0, 0);
-        int simd = channels / ALIGNMENT;
-        for (size_t i = 0; i < simd; ++i)
-        {
-            size_t offset = misaligned + i * ALIGNMENT;
-            __m128i b = _mm_load_si128((__m128i*)(buffer + offset));
-            __m128i bb = _mm_load_si128((__m128i*)(blendBuffer + offset));
+struct BlendOverwriteIfZero
+{
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return b == 0 ? bb : b; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb) { return _mm_or_si128(b, _mm_and_si128(IsZero(b), bb)); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb) { return _mm256_or_si256(b, _mm256_and_si256(IsZero(b), bb)); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb) { return vbslq_u8(IsZero(b), bb, b); }
+#endif
+};
 
-            __m128i mask = _mm_cmpeq_epi8(b, zero); // sets FF where B is zero
-            __m128i newv = _mm_and_si128(mask, bb); // grab bb where B has zero
-            __m128i r = _mm_or_si128(b, newv); // merge them
+struct BlendMask
+{
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return bb > 0 ? 0 : b; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb) { return _mm_and_si128(IsZero(bb), b); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb) { return _mm256_and_si256(IsZero(bb), b); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb) { return vandq_u8(IsZero(bb), b); }
+#endif
+};
 
-            _mm_store_si128((__m128i*)(buffer + offset), r);
-        }
+struct BlendUnmask
+{
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return bb == 0 ? 0 : b; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb) { return _mm_andnot_si128(IsZero(bb), b); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb) { return _mm256_andnot_si256(IsZero(bb), b); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb) { return vbicq_u8(b, IsZero(bb)); }
+#endif
+};
 
-        // do the residual
-        for (size_t i = 0; i < channels % ALIGNMENT; ++i)
-        {
-            size_t offset = misaligned + i + simd * ALIGNMENT;
-            if (*(buffer + offset) == 0)
-            {
-                *(buffer + offset) = *(blendBuffer + offset);
-            }
-        }
+// rounds down ... the vector averages round up so take off the bit they added
+struct BlendAverage
+{
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return (uint8_t)(((int)b + (int)bb) / 2); }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb)
+    {
+        return _mm_sub_epi8(_mm_avg_epu8(b, bb), _mm_and_si128(_mm_xor_si128(b, bb), _mm_set1_epi8(1)));
     }
-    else
-#endif
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb)
     {
-        for (size_t i = 0; i < channels; ++i)
-        {
-            if (*(buffer + i) == 0x00)
-            {
-                *(buffer + i) = *(blendBuffer + i);
-            }
-        }
+        return _mm256_sub_epi8(_mm256_avg_epu8(b, bb), _mm256_and_si256(_mm256_xor_si256(b, bb), _mm256_set1_epi8(1)));
     }
-}
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb) { return vhaddq_u8(b, bb); }
+#endif
+};
+
+struct BlendMaximum
+{
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return std::max(b, bb); }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb) { return _mm_max_epu8(b, bb); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb) { return _mm256_max_epu8(b, bb); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb) { return vmaxq_u8(b, bb); }
+#endif
+};
+
+struct BlendMinimum
+{
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return std::min(b, bb); }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb) { return _mm_min_epu8(b, bb); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb) { return _mm256_min_epu8(b, bb); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb) { return vminq_u8(b, bb); }
+#endif
+};
 
-void Mask(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
+// apply the input data as if it was (inputvalue / 255) * currentvalue ... ie a brightness
+// x / 255 for x up to 255 * 255 is (x + 1 + (x >> 8)) >> 8 which saves a divide
+struct BlendBrightness
 {
-#ifdef SIMD
-    int misaligned = GetMisalignedBytes(buffer, blendBuffer);
-    if (misaligned >= 0 && (channels - misaligned) >= ALIGNMENT) // we can only use SIMD if misalignment is the same for both buffers and we have the minimum number of bytes to do
+    static uint8_t Apply(uint8_t b, uint8_t bb) { return (uint8_t)(((int)b * (int)bb) / 255); }
+#ifdef BLEND_HAVE_SSE2
+    static inline __m128i Div255(__m128i x)
     {
-        // do the misaligned
-        for (size_t i = 0; i < misaligned; ++i)
-        {
-            if (*(blendBuffer + i) > 0)
-            {
-                *(buffer + i) = 0x00;
-            }
-        }
+        return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+    }
+    static __m128i Apply(__m128i b, __m128i bb)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(bb, zero));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(bb, zero));
+        return _mm_packus_epi16(Div255(lo), Div255(hi));
+    }
+    BLEND_AVX2_TARGET static inline __m256i Div255(__m256i x)
+    {
+        return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+    }
+    // the unpacks and pack all work within each 128 bit lane so the bytes come back out in order
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), _mm256_unpacklo_epi8(bb, zero));
+        __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), _mm256_unpackhi_epi8(bb, zero));
+        return _mm256_packus_epi16(Div255(lo), Div255(hi));
+    }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static inline uint8x8_t Div255(uint16x8_t x)
+    {
+        return vshrn_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+    }
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb)
+    {
+        uint16x8_t lo = vmull_u8(vget_low_u8(b), vget_low_u8(bb));
+        uint16x8_t hi = vmull_u8(vget_high_u8(b), vget_high_u8(bb));
+        return vcombine_u8(Div255(lo), Div255(hi));
+    }
+#endif
+};
 
-        __m128i zero = _mm_setr_epi32(0, 0, 0, 0);
-        int simd = channels / ALIGNMENT;
+// The pixel modes are given black as 0xFF for every byte of a pixel which is black in the buffer (BLEND_DECIDES
+// false) or the blend buffer (BLEND_DECIDES true)
+struct BlendOverwriteIfBlack
+{
+    static const bool BLEND_DECIDES = false;
+    static uint8_t Apply(uint8_t b, uint8_t bb, uint8_t black) { return black ? bb : b; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb, __m128i black) { return Select(black, bb, b); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb, __m256i black) { return Select(black, bb, b); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb, uint8x16_t black) { return vbslq_u8(black, bb, b); }
+#endif
+};
 
-        for (size_t i = 0; i < simd; ++i)
-        {
-            size_t offset = misaligned + i * ALIGNMENT;
-            __m128i b = _mm_load_si128((__m128i*)(buffer + offset));
-            __m128i bb = _mm_load_si128((__m128i*)(blendBuffer + offset));
+struct BlendOverwriteSkipBlack
+{
+    static const bool BLEND_DECIDES = true;
+    static uint8_t Apply(uint8_t b, uint8_t bb, uint8_t black) { return black ? b : bb; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb, __m128i black) { return Select(black, b, bb); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb, __m256i black) { return Select(black, b, bb); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb, uint8x16_t black) { return vbslq_u8(black, b, bb); }
+#endif
+};
 
-            __m128i mask = _mm_cmpeq_epi8(bb, zero); // sets FF where BB is zero
-            __m128i r = _mm_and_si128(mask, b); // and the mask
+struct BlendMaskPixel
+{
+    static const bool BLEND_DECIDES = true;
+    static uint8_t Apply(uint8_t b, uint8_t bb, uint8_t black) { return black ? b : 0; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb, __m128i black) { return _mm_and_si128(black, b); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb, __m256i black) { return _mm256_and_si256(black, b); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb, uint8x16_t black) { return vandq_u8(black, b); }
+#endif
+};
 
-            _mm_store_si128((__m128i*)(buffer + offset), r);
-        }
+struct BlendUnmaskPixel
+{
+    static const bool BLEND_DECIDES = true;
+    static uint8_t Apply(uint8_t b, uint8_t bb, uint8_t black) { return black ? 0 : b; }
+#ifdef BLEND_HAVE_SSE2
+    static __m128i Apply(__m128i b, __m128i bb, __m128i black) { return _mm_andnot_si128(black, b); }
+    BLEND_AVX2_TARGET static __m256i Apply(__m256i b, __m256i bb, __m256i black) { return _mm256_andnot_si256(black, b); }
+#endif
+#ifdef BLEND_HAVE_NEON
+    static uint8x16_t Apply(uint8x16_t b, uint8x16_t bb, uint8x16_t black) { return vbicq_u8(b, black); }
+#endif
+};
 
-        // do the residual
-        for (size_t i = 0; i < channels % ALIGNMENT; ++i)
-        {
-            size_t offset = misaligned + i + simd * ALIGNMENT;
-            if (*(blendBuffer + offset) > 0)
-            {
-                *(buffer + offset) = 0x00;
-            }
+struct ScalarBlend
+{
+    template<class OP>
+    static void Channels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+    {
+        for (size_t i = 0; i < channels; ++i) {
+            buffer[i] = OP::Apply(buffer[i], blendBuffer[i]);
         }
     }
-    else
-#endif
+
+    template<class OP>
+    static void Pixels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
     {
-        for (size_t i = 0; i < channels; ++i)
-        {
-            if (*(blendBuffer + i) > 0)
-            {
-                *(buffer + i) = 0x00;
-            }
+        for (size_t i = 0; i + 3 <= channels; i += 3) {
+            const uint8_t* d = OP::BLEND_DECIDES ? blendBuffer + i : buffer + i;
+            uint8_t black = (d[0] | d[1] | d[2]) == 0 ? 0xFF : 0x00;
+            buffer[i] = OP::Apply(buffer[i], blendBuffer[i], black);
+            buffer[i + 1] = OP::Apply(buffer[i + 1], blendBuffer[i + 1], black);
+            buffer[i + 2] = OP::Apply(buffer[i + 2], blendBuffer[i + 2], black);
         }
     }
-}
+};
 
-void MaskPixel(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels)
+#ifdef BLEND_HAVE_SSE2
+struct SSE2Blend
 {
-    for (size_t i = 0; i < pixels; ++i)
+    template<class OP>
+    static void Channels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
     {
-        uint8_t* p = blendBuffer + i * 3;
-        auto sum = *p + *(p + 1) + *(p + 2);
-        if (sum > 0)
-        {
-            uint8_t* pp = buffer + i * 3;
-            *pp = 0x00;
-            *(pp + 1) = 0x00;
-            *(pp + 2) = 0x00;
+        size_t i = 0;
+        for (; i + 16 <= channels; i += 16) {
+            __m128i b = _mm_loadu_si128((const __m128i*)(buffer + i));
+            __m128i bb = _mm_loadu_si128((const __m128i*)(blendBuffer + i));
+            _mm_storeu_si128((__m128i*)(buffer + i), OP::Apply(b, bb));
         }
+        ScalarBlend::Channels<OP>(buffer + i, blendBuffer + i, channels - i);
     }
-}
 
-void Unmask(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
-{
-#ifdef SIMD
-    int misaligned = GetMisalignedBytes(buffer, blendBuffer);
-    if (misaligned >= 0 && (channels - misaligned) >= ALIGNMENT) // we can only use SIMD if misalignment is the same for both buffers and we have the minimum number of bytes to do
+    // 5 pixels in each 16 bytes, the last byte is put back as it was
+    static inline __m128i Black(__m128i v)
+    {
+        const __m128i firstOfPixel = _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, 0);
+        __m128i any = _mm_or_si128(v, _mm_or_si128(_mm_srli_si128(v, 1), _mm_srli_si128(v, 2)));
+        __m128i black = _mm_and_si128(IsZero(any), firstOfPixel);
+        return _mm_or_si128(black, _mm_or_si128(_mm_slli_si128(black, 1), _mm_slli_si128(black, 2)));
+    }
+
+    // the next block overlaps the last byte of this one so it is loaded before this one is stored, otherwise
+    // every load waits on the store before it
+    template<class OP>
+    static void Pixels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
     {
-        // do the misaligned
-        for (size_t i = 0; i < misaligned; ++i)
-        {
-            if (*(blendBuffer + i) == 0)
-            {
-                *(buffer + i) = 0x00;
+        const __m128i used = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0);
+        size_t i = 0;
+        if (channels >= 16) {
+            __m128i b = _mm_loadu_si128((const __m128i*)buffer);
+            __m128i bb = _mm_loadu_si128((const __m128i*)blendBuffer);
+            for (;;) {
+                __m128i r = Select(used, OP::Apply(b, bb, Black(OP::BLEND_DECIDES ? bb : b)), b);
+                if (i + 15 + 16 > channels) {
+                    _mm_storeu_si128((__m128i*)(buffer + i), r);
+                    i += 15;
+                    break;
+                }
+                __m128i nb = _mm_loadu_si128((const __m128i*)(buffer + i + 15));
+                bb = _mm_loadu_si128((const __m128i*)(blendBuffer + i + 15));
+                _mm_storeu_si128((__m128i*)(buffer + i), r);
+                b = nb;
+                i += 15;
             }
         }
+        ScalarBlend::Pixels<OP>(buffer + i, blendBuffer + i, channels - i);
+    }
+};
 
-        __m128i zero = _mm_setr_epi32(0, 0, 0, 0);
-        int simd = channels / ALIGNMENT;
-        for (size_t i = 0; i < simd; ++i)
-        {
-            size_t offset = misaligned + i * ALIGNMENT;
-            __m128i b = _mm_load_si128((__m128i*)(buffer + offset));
-            __m128i bb = _mm_load_si128((__m128i*)(blendBuffer + offset));
+struct AVX2Blend
+{
+    template<class OP>
+    BLEND_AVX2_TARGET static void Channels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+    {
+        size_t i = 0;
+        for (; i + 32 <= channels; i += 32) {
+            __m256i b = _mm256_loadu_si256((const __m256i*)(buffer + i));
+            __m256i bb = _mm256_loadu_si256((const __m256i*)(blendBuffer + i));
+            _mm256_storeu_si256((__m256i*)(buffer + i), OP::Apply(b, bb));
+        }
+        ScalarBlend::Channels<OP>(buffer + i, blendBuffer + i, channels - i);
+    }
 
-            __m128i mask = _mm_cmpeq_epi8(bb, zero); // sets FF where BB is zero
-            __m128i r = _mm_andnot_si128(mask, b); // invert the mask and then and it
+    BLEND_AVX2_TARGET static inline __m256i Load2(const uint8_t* p)
+    {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)), _mm_loadu_si128((const __m128i*)(p + 15)), 1);
+    }
 
-            _mm_store_si128((__m128i*)(buffer + offset), r);
-        }
+    // the same 5 pixels per 16 bytes as SSE2 in each 128 bit lane as the byte shifts dont cross lanes
+    BLEND_AVX2_TARGET static inline __m256i Black(__m256i v)
+    {
+        const __m256i firstOfPixel = _mm256_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, 0,
+                                                      -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, 0);
+        __m256i any = _mm256_or_si256(v, _mm256_or_si256(_mm256_srli_si256(v, 1), _mm256_srli_si256(v, 2)));
+        __m256i black = _mm256_and_si256(IsZero(any), firstOfPixel);
+        return _mm256_or_si256(black, _mm256_or_si256(_mm256_slli_si256(black, 1), _mm256_slli_si256(black, 2)));
+    }
 
-        // do the residual
-        for (size_t i = 0; i < channels % ALIGNMENT; ++i)
-        {
-            size_t offset = misaligned + i + simd * ALIGNMENT;
-            if (*(blendBuffer + offset) == 0)
-            {
-                *(buffer + offset) = 0x00;
+    template<class OP>
+    BLEND_AVX2_TARGET static void Pixels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+    {
+        const __m256i used = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0,
+                                              -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0);
+        size_t i = 0;
+        if (channels >= 31) {
+            __m256i b = Load2(buffer);
+            __m256i bb = Load2(blendBuffer);
+            for (;;) {
+                __m256i r = Select(used, OP::Apply(b, bb, Black(OP::BLEND_DECIDES ? bb : b)), b);
+                bool more = i + 30 + 31 <= channels;
+                __m256i nb = b;
+                if (more) {
+                    nb = Load2(buffer + i + 30);
+                    bb = Load2(blendBuffer + i + 30);
+                }
+                // low lane first as its last byte is the unchanged first byte of the high lane
+                _mm_storeu_si128((__m128i*)(buffer + i), _mm256_castsi256_si128(r));
+                _mm_storeu_si128((__m128i*)(buffer + i + 15), _mm256_extracti128_si256(r, 1));
+                i += 30;
+                if (!more) break;
+                b = nb;
             }
         }
+        SSE2Blend::Pixels<OP>(buffer + i, blendBuffer + i, channels - i);
     }
-    else
+};
+
+static bool IsAVX2Supported()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    // and the OS saves the ymm registers
+    return osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
 #endif
+
+#ifdef BLEND_HAVE_NEON
+struct NEONBlend
+{
+    template<class OP>
+    static void Channels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
     {
-        for (size_t i = 0; i < channels; ++i)
-        {
-            if (*(blendBuffer + i) == 0)
-            {
-                *(buffer + i) = 0x00;
-            }
+        size_t i = 0;
+        for (; i + 16 <= channels; i += 16) {
+            vst1q_u8(buffer + i, OP::Apply(vld1q_u8(buffer + i), vld1q_u8(blendBuffer + i)));
         }
+        ScalarBlend::Channels<OP>(buffer + i, blendBuffer + i, channels - i);
     }
-}
 
-void UnmaskPixel(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels)
-{
-    for (size_t i = 0; i < pixels; ++i)
+    // vld3 splits 16 pixels into red, green and blue
+    template<class OP>
+    static void Pixels(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
     {
-        uint8_t* p = blendBuffer + i * 3;
-        auto sum = *p + *(p + 1) + *(p + 2);
-        if (sum == 0)
-        {
-            uint8_t* pp = buffer + i * 3;
-            *pp = 0x00;
-            *(pp + 1) = 0x00;
-            *(pp + 2) = 0x00;
+        size_t i = 0;
+        for (; i + 48 <= channels; i += 48) {
+            uint8x16x3_t b = vld3q_u8(buffer + i);
+            uint8x16x3_t bb = vld3q_u8(blendBuffer + i);
+            const uint8x16x3_t& d = OP::BLEND_DECIDES ? bb : b;
+            uint8x16_t black = IsZero(vorrq_u8(d.val[0], vorrq_u8(d.val[1], d.val[2])));
+            b.val[0] = OP::Apply(b.val[0], bb.val[0], black);
+            b.val[1] = OP::Apply(b.val[1], bb.val[1], black);
+            b.val[2] = OP::Apply(b.val[2], bb.val[2], black);
+            vst3q_u8(buffer + i, b);
         }
+        ScalarBlend::Pixels<OP>(buffer + i, blendBuffer + i, channels - i);
     }
+};
+#endif
+
+typedef void (*BLEND_FN)(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+
+static void BlendOverwrite(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+{
+    memcpy(buffer, blendBuffer, channels);
 }
 
-void Average(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
+struct BlendFunctions
 {
-#ifdef SIMD
-    int misaligned = GetMisalignedBytes(buffer, blendBuffer);
-    if (misaligned >= 0 && (channels - misaligned) >= ALIGNMENT) // we can only use SIMD if misalignment is the same for both buffers and we have the minimum number of bytes to do
-    {
-        // do the misaligned
-        for (size_t i = 0; i < misaligned; ++i)
-        {
-            *(buffer + i) = (uint8_t)(((int)*(buffer + i) + (int)*(blendBuffer + i)) / 2);
-        }
+    BLEND_FN fns[METHOD_BRIGHTNESS + 1];
+};
 
-        int simd = channels / ALIGNMENT;
-        for (size_t i = 0; i < simd; ++i)
-        {
-            size_t offset = misaligned + i * ALIGNMENT;
-            __m128i b = _mm_load_si128((__m128i*)(buffer + offset));
-            __m128i bb = _mm_load_si128((__m128i*)(blendBuffer + offset));
+template<class ISA>
+static BlendFunctions CreateBlendFunctions()
+{
+    BlendFunctions res;
+    res.fns[METHOD_OVERWRITE] = &BlendOverwrite;
+    res.fns[METHOD_OVERWRITEIFZERO] = &ISA::template Channels<BlendOverwriteIfZero>;
+    res.fns[METHOD_OVERWRITESKIPBLACK] = &ISA::template Pixels<BlendOverwriteSkipBlack>;
+    res.fns[METHOD_MASK] = &ISA::template Channels<BlendMask>;
+    res.fns[METHOD_UNMASK] = &ISA::template Channels<BlendUnmask>;
+    res.fns[METHOD_AVERAGE] = &ISA::template Channels<BlendAverage>;
+    res.fns[METHOD_MAX] = &ISA::template Channels<BlendMaximum>;
+    res.fns[METHOD_OVERWRITEIFBLACK] = &ISA::template Pixels<BlendOverwriteIfBlack>;
+    res.fns[METHOD_MASKPIXEL] = &ISA::template Pixels<BlendMaskPixel>;
+    res.fns[METHOD_UNMASKPIXEL] = &ISA::template Pixels<BlendUnmaskPixel>;
+    res.fns[METHOD_MIN] = &ISA::template Channels<BlendMinimum>;
+    res.fns[METHOD_BRIGHTNESS] = &ISA::template Channels<BlendBrightness>;
+    return res;
+}
 
-            __m128i r = _mm_avg_epu8(b, bb);
+static const BlendFunctions* GetBlendFunctions(BLENDINSTRUCTIONSET set)
+{
+    static const BlendFunctions scalar = CreateBlendFunctions<ScalarBlend>();
+#ifdef BLEND_HAVE_SSE2
+    static const BlendFunctions sse2 = CreateBlendFunctions<SSE2Blend>();
+    static const BlendFunctions avx2 = CreateBlendFunctions<AVX2Blend>();
+    if (set == BLEND_SSE2) return &sse2;
+    if (set == BLEND_AVX2) return &avx2;
+#endif
+#ifdef BLEND_HAVE_NEON
+    static const BlendFunctions neon = CreateBlendFunctions<NEONBlend>();
+    if (set == BLEND_NEON) return &neon;
+#endif
+    return &scalar;
+}
 
-            _mm_store_si128((__m128i*)(buffer + offset), r);
-        }
+static BLENDINSTRUCTIONSET GetBestBlendInstructionSet()
+{
+#ifdef BLEND_HAVE_SSE2
+    return IsAVX2Supported() ? BLEND_AVX2 : BLEND_SSE2;
+#elif defined(BLEND_HAVE_NEON)
+    return BLEND_NEON;
+#else
+    return BLEND_SCALAR;
+#endif
+}
 
-        // do the residual
-        for (size_t i = 0; i < channels % ALIGNMENT; ++i)
-        {
-            size_t offset = i + misaligned + simd * ALIGNMENT;
-            *(buffer + offset) = (uint8_t)(((int)*(buffer + offset) + (int)*(blendBuffer + offset)) / 2);
-        }
-    }
-    else
+// picked once when the program starts
+static BLENDINSTRUCTIONSET __blendInstructionSet = GetBestBlendInstructionSet();
+static const BlendFunctions* __blendFunctions = GetBlendFunctions(__blendInstructionSet);
+
+bool IsBlendInstructionSetSupported(BLENDINSTRUCTIONSET set)
+{
+    switch (set) {
+    case BLEND_SCALAR:
+        return true;
+#ifdef BLEND_HAVE_SSE2
+    case BLEND_SSE2:
+        return true;
+    case BLEND_AVX2:
+        return IsAVX2Supported();
 #endif
-    {
-        for (size_t i = 0; i < channels; ++i)
-        {
-            *(buffer + i) = (uint8_t)(((int)*(buffer + i) + (int)*(blendBuffer + i)) / 2);
-        }
+#ifdef BLEND_HAVE_NEON
+    case BLEND_NEON:
+        return true;
+#endif
+    default:
+        return false;
     }
 }
 
-void Maximum(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
+BLENDINSTRUCTIONSET GetBlendInstructionSet()
 {
-#ifdef SIMD
-    int misaligned = GetMisalignedBytes(buffer, blendBuffer);
-    if (misaligned >= 0 && (channels - misaligned) >= ALIGNMENT) // we can only use SIMD if misalignment is the same for both buffers and we have the minimum number of bytes to do
-    {
-        // do the misaligned
-        for (size_t i = 0; i < misaligned; ++i)
-        {
-            *(buffer + i) = std::max(*(buffer + i), *(blendBuffer + i));
-        }
+    return __blendInstructionSet;
+}
+
+void SetBlendInstructionSet(BLENDINSTRUCTIONSET set)
+{
+    if (!IsBlendInstructionSetSupported(set)) return;
+    __blendInstructionSet = set;
+    __blendFunctions = GetBlendFunctions(set);
+}
 
-        // do the aligned pieces using SIMD instructions ... up to 16 times faster
-        int simd = (channels - misaligned) / ALIGNMENT;
-        for (size_t i = 0; i < simd; ++i)
-        {
-            size_t offset = misaligned + i * ALIGNMENT;
-            __m128i b = _mm_load_si128((__m128i*)(buffer + offset));
-            __m128i bb = _mm_load_si128((__m128i*)(blendBuffer + offset));
+std::string DecodeBlendInstructionSet(BLENDINSTRUCTIONSET set)
+{
+    switch (set) {
+    case BLEND_SCALAR:
+        return "Scalar";
+    case BLEND_SSE2:
+        return "SSE2";
+    case BLEND_AVX2:
+        return "AVX2";
+    case BLEND_NEON:
+        return "NEON";
+    }
+    return "Scalar";
+}
 
-            __m128i r = _mm_max_epu8(b, bb);
+void Blend(uint8_t* buffer, size_t bufferSize, const uint8_t* blendBuffer, size_t blendBufferSize, APPLYMETHOD applyMethod, size_t offset)
+{
+    if (offset > bufferSize) return;
+    if (applyMethod < METHOD_OVERWRITE || applyMethod > METHOD_BRIGHTNESS) return;
 
-            _mm_store_si128((__m128i*)(buffer + offset), r);
-                                }
+    size_t bytesToUse = std::min(bufferSize - offset, blendBufferSize);
 
-        // do the residual part at the end where we dont have enough bytes to process
-        for (size_t i = 0; i < channels % ALIGNMENT; ++i)
-        {
-            size_t offset = i + misaligned + simd * ALIGNMENT;
-            *(buffer + offset) = std::max(*(buffer + offset), *(blendBuffer + offset));
-        }
-    }
-    else
-#endif
-    {
-        for (size_t i = 0; i < channels; ++i)
-        {
-            *(buffer + i) = std::max(*(buffer + i), *(blendBuffer + i));
-        }
-    }
+    // brightness has always only done whole pixels
+    if (applyMethod == METHOD_BRIGHTNESS) bytesToUse -= bytesToUse % 3;
+
+    __blendFunctions->fns[applyMethod](buffer + offset, blendBuffer, bytesToUse);
 }
 
-void Minimum(uint8_t* buffer, uint8_t* blendBuffer, size_t channels)
+void Overwrite(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
 {
-#ifdef SIMD
-    int misaligned = GetMisalignedBytes(buffer, blendBuffer);
+    __blendFunctions->fns[METHOD_OVERWRITE](buffer, blendBuffer, channels);
+}
 
-    if (misaligned >= 0 && (channels - misaligned) >= ALIGNMENT) // we can only use SIMD if misalignment is the same for both buffers and we have the minimum number of bytes to do
-    {
-        // do the misaligned
-        for (size_t i = 0; i < misaligned; ++i)
-        {
-            *(buffer + i) = std::min(*(buffer + i), *(blendBuffer + i));
-        }
+void OverwriteIfZero(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+{
+    __blendFunctions->fns[METHOD_OVERWRITEIFZERO](buffer, blendBuffer, channels);
+}
 
-        int simd = channels / ALIGNMENT;
-        for (size_t i = 0; i < simd; ++i)
-        {
-            size_t offset = misaligned + i * ALIGNMENT;
-            __m128i b = _mm_load_si128((__m128i*)(buffer + offset));
-            __m128i bb = _mm_load_si128((__m128i*)(blendBuffer + offset));
+void Mask(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+{
+    __blendFunctions->fns[METHOD_MASK](buffer, blendBuffer, channels);
+}
 
-            __m128i r = _mm_min_epu8(b, bb);
+void Unmask(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+{
+    __blendFunctions->fns[METHOD_UNMASK](buffer, blendBuffer, channels);
+}
 
-            _mm_store_si128((__m128i*)(buffer + offset), r);
-        }
+void Average(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+{
+    __blendFunctions->fns[METHOD_AVERAGE](buffer, blendBuffer, channels);
+}
 
-        // do the residual
-        for (size_t i = 0; i < channels % ALIGNMENT; ++i)
-        {
-            size_t offset = i + misaligned + simd * ALIGNMENT;
-            *(buffer + offset) = std::min(*(buffer + offset), *(blendBuffer + offset));
-        }
-    }
-    else
-#endif
-    {
-        for (size_t i = 0; i < channels; ++i)
-        {
-            *(buffer + i) = std::min(*(buffer + i), *(blendBuffer + i));
-        }
-    }
+void Maximum(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
+{
+    __blendFunctions->fns[METHOD_MAX](buffer, blendBuffer, channels);
 }
 
-void OverwriteIfBlack(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels)
+void Minimum(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels)
 {
-    for (size_t i = 0; i < pixels; ++i)
-    {
-        uint8_t* p = buffer + i * 3;
-        auto sum = *p + *(p + 1) + *(p + 2);
-        if (sum == 0)
-        {
-            uint8_t* pp = blendBuffer + i * 3;
-            *p = *pp;
-            *(p + 1) = *(pp + 1);
-            *(p + 2) = *(pp + 2);
-        }
-    }
+    __blendFunctions->fns[METHOD_MIN](buffer, blendBuffer, channels);
 }
 
-void OverwriteSkipBlack(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels)
+void Brightness(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels)
 {
-    for (size_t i = 0; i < pixels; ++i)
-    {
-        uint8_t* pp = blendBuffer + i * 3;
-        auto sum = *pp + *(pp + 1) + *(pp + 2);
-        if (sum > 0)
-        {
-            uint8_t* p = buffer + i * 3;
-            *p = *pp;
-            *(p + 1) = *(pp + 1);
-            *(p + 2) = *(pp + 2);
-        }
-    }
+    __blendFunctions->fns[METHOD_BRIGHTNESS](buffer, blendBuffer, pixels * 3);
 }
 
-// apply the input data as if it was (inputvalue / 255) * currentvalue ... ie a brightness
-void Brightness(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels)
+void OverwriteIfBlack(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels)
 {
-    uint8_t* p = buffer;
-    uint8_t* pp = blendBuffer;
-    for (size_t i = 0; i < pixels * 3; ++i)         {
-        if (*pp == 0)             {
-            *p = 0;
-        }
-        else if (*pp != 255)             {
-            *p = ((int)*p * (int)*pp) / 255;
-        }
-    }
-}
\ No newline at end of file
+    __blendFunctions->fns[METHOD_OVERWRITEIFBLACK](buffer, blendBuffer, pixels * 3);
+}
+
+void MaskPixel(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels)
+{
+    __blendFunctions->fns[METHOD_MASKPIXEL](buffer, blendBuffer, pixels * 3);
+}
+
+void UnmaskPixel(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels)
+{
+    __blendFunctions->fns[METHOD_UNMASKPIXEL](buffer, blendBuffer, pixels * 3);
+}
+
+void OverwriteSkipBlack(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels)
+{
+    __blendFunctions->fns[METHOD_OVERWRITESKIPBLACK](buffer, blendBuffer, pixels * 3);
+}
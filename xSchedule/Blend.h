@@ -30,22 +30,36 @@ typedef enum {
     METHOD_BRIGHTNESS
 } APPLYMETHOD;
 
+// the widest one the cpu supports is picked at startup, the others are there for testing and comparison
+typedef enum {
+    BLEND_SCALAR,
+    BLEND_SSE2,
+    BLEND_AVX2,
+    BLEND_NEON
+} BLENDINSTRUCTIONSET;
+
 void PopulateBlendModes(wxChoice* choice);
 
-void Blend(uint8_t* buffer, size_t bufferSize, uint8_t* blendBuffer, size_t blendBufferSize, APPLYMETHOD applyMethod, size_t offset = 0);
-
-void Overwrite(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void OverwriteIfZero(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void Mask(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void Unmask(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void Average(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void Maximum(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void Minimum(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void Brightness(uint8_t* buffer, uint8_t* blendBuffer, size_t channels);
-void OverwriteIfBlack(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels);
-void MaskPixel(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels);
-void UnmaskPixel(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels);
-void OverwriteSkipBlack(uint8_t* buffer, uint8_t* blendBuffer, size_t pixels);
+void Blend(uint8_t* buffer, size_t bufferSize, const uint8_t* blendBuffer, size_t blendBufferSize, APPLYMETHOD applyMethod, size_t offset = 0);
+
+void Overwrite(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void OverwriteIfZero(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void Mask(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void Unmask(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void Average(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void Maximum(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void Minimum(uint8_t* buffer, const uint8_t* blendBuffer, size_t channels);
+void Brightness(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels);
+void OverwriteIfBlack(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels);
+void MaskPixel(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels);
+void UnmaskPixel(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels);
+void OverwriteSkipBlack(uint8_t* buffer, const uint8_t* blendBuffer, size_t pixels);
 APPLYMETHOD EncodeBlendMode(const std::string blendMode);
 std::string DecodeBlendMode(APPLYMETHOD blendMode);
 
+bool IsBlendInstructionSetSupported(BLENDINSTRUCTIONSET set);
+BLENDINSTRUCTIONSET GetBlendInstructionSet();
+// ignored if the cpu does not support it
+void SetBlendInstructionSet(BLENDINSTRUCTIONSET set);
+std::string DecodeBlendInstructionSet(BLENDINSTRUCTIONSET set);
+
@@ -59,6 +59,7 @@ void ESEQFile::Close()
         free(_frameBuffer);
         _frameBuffer = nullptr;
     }
+    _bufferedFrame = SIZE_MAX;
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     logger_base.info("ESEQ file %s closed.", (const char *)_filename.c_str());
@@ -144,9 +145,10 @@ void ESEQFile::Load(const std::string& filename)
     }
 }
 
-void ESEQFile::ReadData(uint8_t* buffer, size_t buffersize, size_t frame, APPLYMETHOD applyMethod)
+bool ESEQFile::ReadFrame(size_t frame)
 {
-    if (frame >= _frames) return; // cant read past end of file
+    if (frame >= _frames) return false; // cant read past end of file
+    if (frame == _bufferedFrame) return true;
 
     if (_fh->Tell() != _frame0Offset + _channelsPerFrame * frame)
     {
@@ -156,6 +158,13 @@ void ESEQFile::ReadData(uint8_t* buffer, size_t buffersize, size_t frame, APPLYM
 
     // read in the frame from disk
     _fh->Read(_frameBuffer, _channelsPerFrame);
+    _bufferedFrame = frame;
+    return true;
+}
+
+void ESEQFile::ReadData(uint8_t* buffer, size_t buffersize, size_t frame, APPLYMETHOD applyMethod)
+{
+    if (!ReadFrame(frame)) return;
 
     Blend(buffer, buffersize, _frameBuffer, _modelSize, applyMethod, _offset - 1);
 }
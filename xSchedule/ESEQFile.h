@@ -13,6 +13,7 @@
 #include <string>
 #include <list>
 
+#include <cstdint>
 #include <wx/file.h>
 
 #include "Blend.h"
@@ -26,6 +27,7 @@ class ESEQFile
 	size_t _modelSize;
     wxFile* _fh;
     uint8_t* _frameBuffer;
+    size_t _bufferedFrame = SIZE_MAX; // the frame in _frameBuffer
     size_t _frame0Offset;
     bool _ok;
 
@@ -41,6 +43,7 @@ class ESEQFile
 		virtual ~ESEQFile();
 		int GetLengthFrames() const { return _frames; }
 		void ReadData(uint8_t* buffer, size_t buffersize, size_t frame, APPLYMETHOD applyMethod);
+        bool ReadFrame(size_t frame); // just reads it from disk so ReadData doesnt have to
 		bool IsOk() const { return _ok; }
 		size_t GetChannels() const { return _channelsPerFrame; }
 		size_t GetOffset() const { return _offset; }
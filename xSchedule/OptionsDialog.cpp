@@ -37,6 +37,9 @@ const long OptionsDialog::ID_CHECKBOX3 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX5 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX2 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX6 = wxNewId();
+const long OptionsDialog::ID_CHECKBOX19 = wxNewId();
+const long OptionsDialog::ID_CHECKBOX20 = wxNewId();
+const long OptionsDialog::ID_CHECKBOX21 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX7 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX8 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX9 = wxNewId();
@@ -48,6 +51,10 @@ const long OptionsDialog::ID_CHECKBOX15 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX16 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX17 = wxNewId();
 const long OptionsDialog::ID_CHECKBOX18 = wxNewId();
+const long OptionsDialog::ID_STATICTEXT15 = wxNewId();
+const long OptionsDialog::ID_SPINCTRL3 = wxNewId();
+const long OptionsDialog::ID_STATICTEXT16 = wxNewId();
+const long OptionsDialog::ID_SPINCTRL4 = wxNewId();
 const long OptionsDialog::ID_STATICTEXT2 = wxNewId();
 const long OptionsDialog::ID_LISTVIEW1 = wxNewId();
 const long OptionsDialog::ID_BUTTON5 = wxNewId();
@@ -103,6 +110,7 @@ OptionsDialog::OptionsDialog(wxWindow* parent, CommandManager* commandManager, S
     wxFlexGridSizer* FlexGridSizer1;
     wxFlexGridSizer* FlexGridSizer2;
     wxFlexGridSizer* FlexGridSizer3;
+    wxFlexGridSizer* FlexGridSizer4;
     wxFlexGridSizer* FlexGridSizer5;
     wxFlexGridSizer* FlexGridSizer6;
     wxFlexGridSizer* FlexGridSizer7;
@@ -127,6 +135,15 @@ OptionsDialog::OptionsDialog(wxWindow* parent, CommandManager* commandManager, S
     CheckBox_MultithreadedTransmission = new wxCheckBox(this, ID_CHECKBOX6, _("Multithreaded transmission"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX6"));
     CheckBox_MultithreadedTransmission->SetValue(false);
     FlexGridSizer7->Add(CheckBox_MultithreadedTransmission, 1, wxALL|wxEXPAND, 5);
+    CheckBox_BatchedTransmission = new wxCheckBox(this, ID_CHECKBOX19, _("Batched UDP transmission"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX19"));
+    CheckBox_BatchedTransmission->SetValue(false);
+    FlexGridSizer7->Add(CheckBox_BatchedTransmission, 1, wxALL|wxEXPAND, 5);
+    CheckBox_PacedTransmission = new wxCheckBox(this, ID_CHECKBOX20, _("Paced transmission"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX20"));
+    CheckBox_PacedTransmission->SetValue(false);
+    FlexGridSizer7->Add(CheckBox_PacedTransmission, 1, wxALL|wxEXPAND, 5);
+    CheckBox_OutputThread = new wxCheckBox(this, ID_CHECKBOX21, _("Dedicated output thread"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX21"));
+    CheckBox_OutputThread->SetValue(false);
+    FlexGridSizer7->Add(CheckBox_OutputThread, 1, wxALL|wxEXPAND, 5);
     CheckBox_RetryOpen = new wxCheckBox(this, ID_CHECKBOX7, _("Continually try to open outputs"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX7"));
     CheckBox_RetryOpen->SetValue(false);
     FlexGridSizer7->Add(CheckBox_RetryOpen, 1, wxALL|wxEXPAND, 5);
@@ -161,6 +178,20 @@ OptionsDialog::OptionsDialog(wxWindow* parent, CommandManager* commandManager, S
     CheckBoxSuppressDarkMode->SetValue(false);
     FlexGridSizer7->Add(CheckBoxSuppressDarkMode, 1, wxALL|wxEXPAND, 5);
     FlexGridSizer1->Add(FlexGridSizer7, 1, wxALL|wxEXPAND, 5);
+    FlexGridSizer4 = new wxFlexGridSizer(0, 4, 0, 0);
+    StaticText15 = new wxStaticText(this, ID_STATICTEXT15, _("Paced window (% of frame):"), wxDefaultPosition, wxDefaultSize, 0, _T("ID_STATICTEXT15"));
+    FlexGridSizer4->Add(StaticText15, 1, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+    SpinCtrl_PacedWindowPercent = new wxSpinCtrl(this, ID_SPINCTRL3, _T("50"), wxDefaultPosition, wxDefaultSize, 0, 1, 100, 50, _T("ID_SPINCTRL3"));
+    SpinCtrl_PacedWindowPercent->SetValue(_T("50"));
+    SpinCtrl_PacedWindowPercent->SetHelpText(_("How much of each frame interval the output packets are spread across."));
+    FlexGridSizer4->Add(SpinCtrl_PacedWindowPercent, 1, wxALL|wxEXPAND, 5);
+    StaticText16 = new wxStaticText(this, ID_STATICTEXT16, _("Max packets per ms per controller (0 = no limit):"), wxDefaultPosition, wxDefaultSize, 0, _T("ID_STATICTEXT16"));
+    FlexGridSizer4->Add(StaticText16, 1, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+    SpinCtrl_PacedMaxPacketsPerMS = new wxSpinCtrl(this, ID_SPINCTRL4, _T("0"), wxDefaultPosition, wxDefaultSize, 0, 0, 100, 0, _T("ID_SPINCTRL4"));
+    SpinCtrl_PacedMaxPacketsPerMS->SetValue(_T("0"));
+    SpinCtrl_PacedMaxPacketsPerMS->SetHelpText(_("Limits how fast packets are sent to any one controller. 0 leaves it up to the window."));
+    FlexGridSizer4->Add(SpinCtrl_PacedMaxPacketsPerMS, 1, wxALL|wxEXPAND, 5);
+    FlexGridSizer1->Add(FlexGridSizer4, 1, wxALL|wxEXPAND, 5);
     FlexGridSizer5 = new wxFlexGridSizer(0, 3, 0, 0);
     FlexGridSizer5->AddGrowableCol(1);
     FlexGridSizer5->AddGrowableRow(0);
@@ -276,6 +307,7 @@ OptionsDialog::OptionsDialog(wxWindow* parent, CommandManager* commandManager, S
     FlexGridSizer1->SetSizeHints(this);
     Center();
 
+    Connect(ID_CHECKBOX20,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&OptionsDialog::OnCheckBox_PacedTransmissionClick);
     Connect(ID_LISTVIEW1,wxEVT_COMMAND_LIST_BEGIN_DRAG,(wxObjectEventFunction)&OptionsDialog::OnListView_ButtonsBeginDrag);
     Connect(ID_LISTVIEW1,wxEVT_COMMAND_LIST_ITEM_SELECTED,(wxObjectEventFunction)&OptionsDialog::OnListView_ButtonsItemSelect);
     Connect(ID_LISTVIEW1,wxEVT_COMMAND_LIST_ITEM_ACTIVATED,(wxObjectEventFunction)&OptionsDialog::OnListView_ButtonsItemActivated);
@@ -318,6 +350,15 @@ OptionsDialog::OptionsDialog(wxWindow* parent, CommandManager* commandManager, S
     Choice_OnCrash->SetStringSelection(options->GetCrashBehaviour());
     CheckBox_SendOffWhenNotRunning->SetValue(options->IsSendOffWhenNotRunning());
     CheckBox_MultithreadedTransmission->SetValue(options->IsParallelTransmission());
+    CheckBox_OutputThread->SetValue(options->IsOutputThread());
+    CheckBox_BatchedTransmission->SetValue(options->IsBatchedTransmission());
+#ifndef __linux__
+    // sendmmsg is only available on linux
+    CheckBox_BatchedTransmission->Enable(false);
+#endif
+    CheckBox_PacedTransmission->SetValue(options->IsPacedTransmission());
+    SpinCtrl_PacedWindowPercent->SetValue(options->GetPacedWindowPercent());
+    SpinCtrl_PacedMaxPacketsPerMS->SetValue(options->GetPacedMaxPacketsPerMS());
     Choice_ARTNetTimeCodeFormat->SetSelection(static_cast<int>(options->GetARTNetTimeCodeFormat()));
     CheckBox_RunBackground->SetValue(options->IsSendBackgroundWhenNotRunning());
     CheckBox_Sync->SetValue(options->IsSync());
@@ -434,6 +475,11 @@ void OptionsDialog::OnButton_OkClick(wxCommandEvent& event)
     _options->SetSync(CheckBox_Sync->GetValue());
     _options->SetSendOffWhenNotRunning(CheckBox_SendOffWhenNotRunning->GetValue());
     _options->SetParallelTransmission(CheckBox_MultithreadedTransmission->GetValue());
+    _options->SetOutputThread(CheckBox_OutputThread->GetValue());
+    _options->SetBatchedTransmission(CheckBox_BatchedTransmission->GetValue());
+    _options->SetPacedTransmission(CheckBox_PacedTransmission->GetValue());
+    _options->SetPacedWindowPercent(SpinCtrl_PacedWindowPercent->GetValue());
+    _options->SetPacedMaxPacketsPerMS(SpinCtrl_PacedMaxPacketsPerMS->GetValue());
     _options->SetHardwareAcceleratedVideo(CheckBox_HWAcceleratedVideo->GetValue());
     _options->SetRetryOutputOpen(CheckBox_RetryOpen->GetValue());
     _options->SetSendBackgroundWhenNotRunning(CheckBox_RunBackground->GetValue());
@@ -581,6 +627,9 @@ void OptionsDialog::ValidateWindow()
         Button_Export->Enable(false);
     }
 
+    SpinCtrl_PacedWindowPercent->Enable(CheckBox_PacedTransmission->GetValue());
+    SpinCtrl_PacedMaxPacketsPerMS->Enable(CheckBox_PacedTransmission->GetValue());
+
     if (TextCtrl_wwwRoot->GetValue() == "") {
         Button_Ok->Enable(false);
     }
@@ -589,6 +638,11 @@ void OptionsDialog::ValidateWindow()
     }
 }
 
+void OptionsDialog::OnCheckBox_PacedTransmissionClick(wxCommandEvent& event)
+{
+    ValidateWindow();
+}
+
 void OptionsDialog::OnTextCtrl_wwwRootText(wxCommandEvent& event)
 {
     ValidateWindow();
@@ -54,6 +54,7 @@ class OptionsDialog: public wxDialog
 		wxButton* Button_Ok;
 		wxCheckBox* CheckBoxSuppressDarkMode;
 		wxCheckBox* CheckBox_APIOnly;
+		wxCheckBox* CheckBox_BatchedTransmission;
 		wxCheckBox* CheckBox_AlllowPageBypass;
 		wxCheckBox* CheckBox_DisableOutputOnPingFailure;
 		wxCheckBox* CheckBox_HWAcceleratedVideo;
@@ -61,6 +62,8 @@ class OptionsDialog: public wxDialog
 		wxCheckBox* CheckBox_LastStartingSequenceUsesTime;
 		wxCheckBox* CheckBox_MinimiseUI;
 		wxCheckBox* CheckBox_MultithreadedTransmission;
+		wxCheckBox* CheckBox_OutputThread;
+		wxCheckBox* CheckBox_PacedTransmission;
 		wxCheckBox* CheckBox_RemoteAllOff;
 		wxCheckBox* CheckBox_RetryOpen;
 		wxCheckBox* CheckBox_RunBackground;
@@ -79,6 +82,8 @@ class OptionsDialog: public wxDialog
 		wxChoice* Choice_SMPTEDevice;
 		wxChoice* Choice_SMPTEFrameRate;
 		wxListView* ListView_Buttons;
+		wxSpinCtrl* SpinCtrl_PacedMaxPacketsPerMS;
+		wxSpinCtrl* SpinCtrl_PacedWindowPercent;
 		wxSpinCtrl* SpinCtrl_PasswordTimeout;
 		wxSpinCtrl* SpinCtrl_WebServerPort;
 		wxStaticText* StaticText10;
@@ -86,6 +91,8 @@ class OptionsDialog: public wxDialog
 		wxStaticText* StaticText12;
 		wxStaticText* StaticText13;
 		wxStaticText* StaticText14;
+		wxStaticText* StaticText15;
+		wxStaticText* StaticText16;
 		wxStaticText* StaticText1;
 		wxStaticText* StaticText2;
 		wxStaticText* StaticText3;
@@ -108,6 +115,9 @@ class OptionsDialog: public wxDialog
 		static const long ID_CHECKBOX5;
 		static const long ID_CHECKBOX2;
 		static const long ID_CHECKBOX6;
+		static const long ID_CHECKBOX19;
+		static const long ID_CHECKBOX20;
+		static const long ID_CHECKBOX21;
 		static const long ID_CHECKBOX7;
 		static const long ID_CHECKBOX8;
 		static const long ID_CHECKBOX9;
@@ -119,6 +129,10 @@ class OptionsDialog: public wxDialog
 		static const long ID_CHECKBOX16;
 		static const long ID_CHECKBOX17;
 		static const long ID_CHECKBOX18;
+		static const long ID_STATICTEXT15;
+		static const long ID_SPINCTRL3;
+		static const long ID_STATICTEXT16;
+		static const long ID_SPINCTRL4;
 		static const long ID_STATICTEXT2;
 		static const long ID_LISTVIEW1;
 		static const long ID_BUTTON5;
@@ -176,6 +190,7 @@ class OptionsDialog: public wxDialog
 		void OnButton_ExportClick(wxCommandEvent& event);
 		void OnCheckBox1Click(wxCommandEvent& event);
 		void OnButton_DefaultWindowLocationClick(wxCommandEvent& event);
+		void OnCheckBox_PacedTransmissionClick(wxCommandEvent& event);
 		//*)
 
 		DECLARE_EVENT_TABLE()
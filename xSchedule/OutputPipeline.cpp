@@ -0,0 +1,233 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputPipeline.h"
+#include "OutputProcess.h"
+#include "OutputProcessExcludeDim.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <log4cpp/Category.hh>
+
+bool OutputPipeline::IsCompiled(const std::list<OutputProcess*>& processes, size_t size, int version, int brightness) const
+{
+    if (size != _size || version != _version || brightness != _brightness || processes.size() != _signature.size()) return false;
+
+    auto sig = _signature.begin();
+    for (const auto& it : processes) {
+        if (sig->first != it || sig->second != it->GetChangeCount()) return false;
+        ++sig;
+    }
+    return true;
+}
+
+uint32_t OutputPipeline::AddLut(const uint8_t* lut)
+{
+    std::vector<uint8_t> key(lut, lut + 256);
+    auto it = _lutIds.find(key);
+    if (it != _lutIds.end()) return it->second;
+
+    uint32_t offset = _luts.size();
+    _luts.insert(_luts.end(), lut, lut + 256);
+    _lutIds[key] = offset;
+    return offset;
+}
+
+uint32_t OutputPipeline::AddConstant(uint8_t value)
+{
+    uint8_t lut[256];
+    memset(lut, value, sizeof(lut));
+    return AddLut(lut);
+}
+
+// the lut which does first and then then
+uint32_t OutputPipeline::Compose(uint32_t first, uint32_t then)
+{
+    if (first == 0) return then;
+    if (then == 0) return first;
+
+    uint64_t key = ((uint64_t)first << 32) | then;
+    auto it = _composed.find(key);
+    if (it != _composed.end()) return it->second;
+
+    uint8_t lut[256];
+    for (int i = 0; i < 256; i++) {
+        lut[i] = _luts[then + _luts[first + i]];
+    }
+    uint32_t res = AddLut(lut);
+    _composed[key] = res;
+    return res;
+}
+
+void OutputPipeline::Touch(size_t ch)
+{
+    if (_first == _last) {
+        _first = ch;
+        _last = ch + 1;
+    } else {
+        _first = std::min(_first, ch);
+        _last = std::max(_last, ch + 1);
+    }
+}
+
+void OutputPipeline::ApplyLut(size_t ch, uint32_t lut)
+{
+    if (lut == 0) return;
+    Touch(ch);
+
+    // neighbouring channels nearly always share a lut so dont go to the map every time
+    if (_lastFirst != _lut[ch] || _lastThen != lut) {
+        _lastFirst = _lut[ch];
+        _lastThen = lut;
+        _lastComposed = Compose(_lastFirst, lut);
+    }
+    _lut[ch] = _lastComposed;
+}
+
+void OutputPipeline::Gather(size_t start, const std::vector<size_t>& from)
+{
+    if (from.empty()) return;
+
+    std::vector<uint32_t> lut(from.size());
+    std::vector<uint32_t> source(from.size());
+    for (size_t i = 0; i < from.size(); i++) {
+        lut[i] = _lut[from[i]];
+        source[i] = _source[from[i]];
+    }
+    for (size_t i = 0; i < from.size(); i++) {
+        _lut[start + i] = lut[i];
+        _source[start + i] = source[i];
+    }
+    Touch(start);
+    Touch(start + from.size() - 1);
+}
+
+void OutputPipeline::EndStage()
+{
+    if (_first == _last) return;
+
+    Stage stage;
+    stage.start = _first;
+    stage.lut.assign(_lut.begin() + _first, _lut.begin() + _last);
+
+    bool moved = false;
+    bool changed = false;
+    for (size_t i = _first; i < _last; i++) {
+        if (_source[i] != i) moved = true;
+        if (_lut[i] != 0) changed = true;
+    }
+    if (moved) {
+        stage.source.assign(_source.begin() + _first, _source.begin() + _last);
+    }
+
+    // ready for the next stage
+    std::fill(_lut.begin() + _first, _lut.begin() + _last, 0);
+    std::iota(_source.begin() + _first, _source.begin() + _last, (uint32_t)_first);
+    _first = _last = 0;
+
+    if (moved || changed) {
+        _stages.push_back(std::move(stage));
+    }
+}
+
+void OutputPipeline::Compile(std::list<OutputProcess*>& processes, size_t size, int version, int brightness, const uint8_t* brightnessTable)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _stages.clear();
+    _luts.clear();
+    _lutIds.clear();
+    _composed.clear();
+    uint8_t identity[256];
+    for (int i = 0; i < 256; i++) {
+        identity[i] = i;
+    }
+    AddLut(identity);
+    _lastFirst = _lastThen = _lastComposed = 0;
+
+    _lut.assign(size, 0);
+    _source.resize(size);
+    std::iota(_source.begin(), _source.end(), 0);
+    _first = _last = 0;
+    _temp.resize(size);
+
+    _excludeDim.assign(size, false);
+    if (size > 0) {
+        for (const auto& it : OutputProcess::GetExcludeDim(processes, 1, size)) {
+            size_t last = std::min(it->GetLastExcludeChannel(), size);
+            for (size_t i = std::max(it->GetFirstExcludeChannel(), (size_t)1); i <= last; i++) {
+                _excludeDim[i - 1] = true;
+            }
+        }
+    }
+
+    _signature.clear();
+    for (const auto& it : processes) {
+        _signature.push_back({ it, it->GetChangeCount() });
+        if (!it->Compile(*this, size)) {
+            EndStage();
+            Stage stage;
+            stage.process = it;
+            _stages.push_back(std::move(stage));
+        }
+    }
+
+    if (brightnessTable != nullptr) {
+        uint32_t lut = AddLut(brightnessTable);
+        for (size_t i = 0; i < size; i++) {
+            if (!_excludeDim[i]) ApplyLut(i, lut);
+        }
+    }
+    EndStage();
+
+    // the working state is only needed while compiling
+    _lut = std::vector<uint32_t>();
+    _source = std::vector<uint32_t>();
+    _composed.clear();
+    _lutIds.clear();
+
+    _size = size;
+    _version = version;
+    _brightness = brightness;
+
+    logger_base.debug("Output processing compiled: %d processes, %d passes, %d luts.", (int)processes.size(), (int)_stages.size(), (int)(_luts.size() / 256));
+}
+
+void OutputPipeline::Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes)
+{
+    const uint8_t* luts = _luts.data();
+
+    for (const auto& it : _stages) {
+        if (it.process != nullptr) {
+            it.process->Frame(buffer, size, processes);
+            continue;
+        }
+
+        size_t chs = it.lut.size();
+        const uint32_t* lut = it.lut.data();
+        uint8_t* p = buffer + it.start;
+        if (it.source.empty()) {
+            for (size_t i = 0; i < chs; i++) {
+                p[i] = luts[lut[i] + p[i]];
+            }
+        }
+        else {
+            // sources can be anywhere in the buffer so dont write until they have all been read
+            const uint32_t* source = it.source.data();
+            uint8_t* temp = _temp.data();
+            for (size_t i = 0; i < chs; i++) {
+                temp[i] = luts[lut[i] + buffer[source[i]]];
+            }
+            memcpy(p, temp, chs);
+        }
+    }
+}
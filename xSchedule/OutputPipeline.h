@@ -0,0 +1,77 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+
+class OutputProcess;
+
+// The output processes and brightness compiled down to as few passes over the channel buffer as possible.
+//
+// Each run of processes that just map channel values (dim, gamma, set, brightness) or move channels around
+// (remap, reverse, colour order) becomes one stage where every channel is out[c] = lut[c][in[source[c]]]. Processes
+// that depend on the channel data itself (sustain, dim white etc) cant be folded in and run their own Frame between
+// the stages. Channels are 0 based everywhere in here.
+class OutputPipeline
+{
+    struct Stage
+    {
+        size_t start = 0;
+        std::vector<uint32_t> lut; // offset into _luts for each channel from start
+        std::vector<uint32_t> source; // where each channel from start comes from, empty if nothing moves
+        OutputProcess* process = nullptr; // run this instead if it could not be compiled
+    };
+
+    std::vector<Stage> _stages;
+    std::vector<uint8_t> _luts; // 256 entries each, the first is the identity
+    std::map<std::vector<uint8_t>, uint32_t> _lutIds;
+    std::map<uint64_t, uint32_t> _composed;
+    uint32_t _lastFirst = 0;
+    uint32_t _lastThen = 0;
+    uint32_t _lastComposed = 0;
+    std::vector<bool> _excludeDim;
+    std::vector<uint8_t> _temp;
+
+    // the stage being compiled
+    std::vector<uint32_t> _lut;
+    std::vector<uint32_t> _source;
+    size_t _first = 0;
+    size_t _last = 0; // one past the last channel touched
+
+    // what was compiled so we know when to do it again
+    std::vector<std::pair<OutputProcess*, int>> _signature;
+    size_t _size = 0;
+    int _version = -1;
+    int _brightness = -1;
+
+    void Touch(size_t ch);
+    void EndStage();
+    uint32_t Compose(uint32_t first, uint32_t then);
+
+public:
+    bool IsCompiled(const std::list<OutputProcess*>& processes, size_t size, int version, int brightness) const;
+    // brightnessTable is applied to all the channels not excluded from dimming last, nullptr for none
+    void Compile(std::list<OutputProcess*>& processes, size_t size, int version, int brightness, const uint8_t* brightnessTable);
+    void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes);
+    size_t GetStageCount() const { return _stages.size(); }
+
+    // for the processes to describe what they do
+    bool IsExcludedFromDim(size_t ch) const { return _excludeDim[ch]; }
+    uint32_t AddLut(const uint8_t* lut);
+    uint32_t AddConstant(uint8_t value);
+    void ApplyLut(size_t ch, uint32_t lut);
+    // out[start + i] = in[from[i]]
+    void Gather(size_t start, const std::vector<size_t>& from);
+};
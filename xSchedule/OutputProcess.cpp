@@ -77,9 +77,10 @@ size_t OutputProcess::GetStartChannelAsNumber()
     return _sc;
 }
 
-bool compare_excluderanges(const OutputProcessExcludeDim* first, const OutputProcessExcludeDim* second)
+// lowest start channel first ... the start channel strings dont sort in channel order
+bool compare_excluderanges(OutputProcessExcludeDim* first, OutputProcessExcludeDim* second)
 {
-    return first->GetStartChannel() > second->GetStartChannel();
+    return first->GetFirstExcludeChannel() < second->GetFirstExcludeChannel();
 }
 
 std::list<OutputProcessExcludeDim*> OutputProcess::GetExcludeDim(std::list<OutputProcess*>& processes, size_t sc, size_t ec)
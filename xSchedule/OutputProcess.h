@@ -16,6 +16,7 @@
 class wxXmlNode;
 class OutputManager;
 class OutputProcessExcludeDim;
+class OutputPipeline;
 
 class OutputProcess
 {
@@ -37,6 +38,7 @@ class OutputProcess
 
         bool IsDirty() const { return _changeCount != _lastSavedChangeCount; };
         void ClearDirty() { _lastSavedChangeCount = _changeCount; };
+        int GetChangeCount() const { return _changeCount; }
         OutputProcess(OutputManager* outputManager, wxXmlNode* node);
         OutputProcess(OutputManager* outputManager);
         OutputProcess(const OutputProcess& op);
@@ -57,4 +59,7 @@ class OutputProcess
         static std::list<OutputProcessExcludeDim*> GetExcludeDim(std::list<OutputProcess*>& processes, size_t sc, size_t ec);
 
         virtual void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes) = 0;
+        // describe what Frame does to the pipeline so it can be fused with its neighbours. false if it cant be
+        // and Frame needs to be called each frame
+        virtual bool Compile(OutputPipeline& pipeline, size_t size) { return false; }
 };
@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessColourOrder.h"
+#include "OutputPipeline.h"
 #include <wx/xml/xml.h>
 
 OutputProcessColourOrder::OutputProcessColourOrder(OutputManager* outputManager, wxXmlNode* node) : OutputProcess(outputManager, node)
@@ -94,3 +95,37 @@ void OutputProcessColourOrder::Frame(uint8_t* buffer, size_t size, std::list<Out
 		}
     }
 }
+
+bool OutputProcessColourOrder::Compile(OutputPipeline& pipeline, size_t size)
+{
+    if (!_enabled) return true;
+    if (_colourOrder == 123) return true;
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t nodes = std::min(_nodes, (size - (sc - 1)) / 3);
+
+    // which of the incoming channels ends up in each position
+    int order[3];
+    switch (_colourOrder) {
+    case 132: order[0] = 0; order[1] = 2; order[2] = 1; break;
+    case 213: order[0] = 1; order[1] = 0; order[2] = 2; break;
+    case 231: order[0] = 1; order[1] = 2; order[2] = 0; break;
+    case 312: order[0] = 2; order[1] = 0; order[2] = 1; break;
+    case 321: order[0] = 2; order[1] = 1; order[2] = 0; break;
+    default:
+        wxASSERT(false);
+        return true;
+    }
+
+    std::vector<size_t> from(nodes * 3);
+    for (size_t i = 0; i < nodes; i++) {
+        size_t c = (sc - 1) + (i * 3);
+        from[i * 3] = c + order[0];
+        from[i * 3 + 1] = c + order[1];
+        from[i * 3 + 2] = c + order[2];
+    }
+    pipeline.Gather(sc - 1, from);
+    return true;
+}
@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessDim.h"
+#include "OutputPipeline.h"
 #include "OutputProcessExcludeDim.h"
 #include <wx/xml/xml.h>
 
@@ -72,6 +73,7 @@ void OutputProcessDim::Frame(uint8_t* buffer, size_t size, std::list<OutputProce
     if (_dim == 100) return;
 
     size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return;
 
     size_t chs = std::min(_channels, size - (sc - 1));
 
@@ -97,12 +99,31 @@ void OutputProcessDim::Frame(uint8_t* buffer, size_t size, std::list<OutputProce
 
             if (!ex) {
                 if (_dim == 0) {
-                    *(buffer + i + sc - 1) = 0;
+                    *(buffer + i) = 0;
                 }
                 else {
-                    *(buffer + i + sc - 1) = _dimTable[*(buffer + i + sc - 1)];
+                    *(buffer + i) = _dimTable[*(buffer + i)];
                 }
             }
         }
     }
 }
+
+bool OutputProcessDim::Compile(OutputPipeline& pipeline, size_t size)
+{
+    if (!_enabled) return true;
+    if (_dim == 100) return true;
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t chs = std::min(_channels, size - (sc - 1));
+
+    uint32_t lut = _dim == 0 ? pipeline.AddConstant(0) : pipeline.AddLut(_dimTable);
+    for (size_t i = sc - 1; i < sc - 1 + chs; i++) {
+        if (!pipeline.IsExcludedFromDim(i)) {
+            pipeline.ApplyLut(i, lut);
+        }
+    }
+    return true;
+}
@@ -40,6 +40,7 @@ OutputProcessDimWhite::OutputProcessDimWhite(OutputManager* outputManager, std::
     _lastDim = -1;
     _nodes = p1;
     _dim = p2;
+    BuildDimTable();
 }
 
 wxXmlNode* OutputProcessDimWhite::Save()
@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessGamma.h"
+#include "OutputPipeline.h"
 #include "OutputProcessExcludeDim.h"
 #include <wx/xml/xml.h>
 
@@ -145,3 +146,28 @@ void OutputProcessGamma::Frame(uint8_t* buffer, size_t size, std::list<OutputPro
         }
     }
 }
+
+bool OutputProcessGamma::Compile(OutputPipeline& pipeline, size_t size)
+{
+    if (!_enabled) return true;
+    if (_gamma == 1.0) return true;
+    if (_gamma == 0.00 && _gammaR == 1.0 && _gammaG == 1.0 && _gammaB == 1.0) return true;
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t nodes = std::min(_nodes, (size - (sc - 1)) / 3);
+
+    uint32_t r = pipeline.AddLut(_gamma != 0.0 ? _gammaData : _gammaDataR);
+    uint32_t g = pipeline.AddLut(_gamma != 0.0 ? _gammaData : _gammaDataG);
+    uint32_t b = pipeline.AddLut(_gamma != 0.0 ? _gammaData : _gammaDataB);
+    for (size_t i = 0; i < nodes; i++) {
+        size_t c = (sc - 1) + (i * 3);
+        if (!pipeline.IsExcludedFromDim(c)) {
+            pipeline.ApplyLut(c, r);
+            pipeline.ApplyLut(c + 1, g);
+            pipeline.ApplyLut(c + 2, b);
+        }
+    }
+    return true;
+}
@@ -9,6 +9,7 @@
  **************************************************************/
 
 #include "OutputProcessReverse.h"
+#include "OutputPipeline.h"
 #include <wx/xml/xml.h>
 
 OutputProcessReverse::OutputProcessReverse(OutputManager* outputManager, wxXmlNode* node) : OutputProcess(outputManager, node)
@@ -55,7 +56,8 @@ void OutputProcessReverse::Frame(uint8_t* buffer, size_t size, std::list<OutputP
 	uint8_t* from = p;
 	uint8_t* to = p + (nodes - 1) * 3;
 		
-	for (int i = 0; i < nodes; i++)
+	// only half way otherwise the second half swaps everything back again
+	for (int i = 0; i < nodes / 2; i++)
 	{
 		memcpy(rgb, from, 3);
 		memcpy(from, to, 3);
@@ -65,3 +67,23 @@ void OutputProcessReverse::Frame(uint8_t* buffer, size_t size, std::list<OutputP
 		to -= 3;
     }
 }
+
+bool OutputProcessReverse::Compile(OutputPipeline& pipeline, size_t size)
+{
+    if (_nodes < 2) return true;
+
+    size_t sc = GetStartChannelAsNumber();
+    if (sc == 0 || sc > size) return true;
+
+    size_t nodes = std::min(_nodes, (size - (sc - 1)) / 3);
+
+    std::vector<size_t> from(nodes * 3);
+    for (size_t i = 0; i < nodes; i++) {
+        size_t c = (sc - 1) + (nodes - 1 - i) * 3;
+        from[i * 3] = c;
+        from[i * 3 + 1] = c + 1;
+        from[i * 3 + 2] = c + 2;
+    }
+    pipeline.Gather(sc - 1, from);
+    return true;
+}
@@ -26,6 +26,7 @@ class OutputProcessSet : public OutputProcess
         virtual ~OutputProcessSet() {}
         virtual wxXmlNode* Save() override;
         virtual void Frame(uint8_t* buffer, size_t size, std::list<OutputProcess*>& processes) override;
+        virtual bool Compile(OutputPipeline& pipeline, size_t size) override;
         virtual size_t GetP1() const override { return _channels; }
         virtual size_t GetP2() const override { return _value; }
         virtual std::string GetType() const override { return "Set"; }
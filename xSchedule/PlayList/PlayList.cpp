@@ -608,6 +608,27 @@ bool PlayList::IsTimecodeNoAdvance()
     return sm->GetOptions()->IsRemoteTimecodeStepAdvance();
 }
 
+bool PlayList::IsEveryStepPlaying(PlayListStep* step)
+{
+    if (IsFirstStepPlaying() && step->GetEveryStepExcludeFirst()) return false;
+    if (IsLastStepPlaying() && step->GetEveryStepExcludeLast()) return false;
+    return true;
+}
+
+void PlayList::PrepareFrame(bool outputframe)
+{
+    if (_currentStep == nullptr || IsPaused() || IsSuspended()) return;
+
+    _currentStep->PrepareFrame(outputframe);
+
+    for (auto it : _everySteps)
+    {
+        if (IsEveryStepPlaying(it)) {
+            it->PrepareFrame(outputframe);
+        }
+    }
+}
+
 // return true if done
 bool PlayList::Frame(uint8_t* buffer, size_t size, bool outputframe)
 {
@@ -622,6 +643,12 @@ bool PlayList::Frame(uint8_t* buffer, size_t size, bool outputframe)
         // This returns true if everything is done
         if (_currentStep->Frame(buffer, size, outputframe))
         {
+            // the every steps dont get this frame
+            for (auto it : _everySteps)
+            {
+                it->DiscardPreparedFrame();
+            }
+
             if (!IsInSlaveMode())
             {
                 logger_base.debug("PlayList: Frame moving to next step because step '%s' is done.", (const char *)_currentStep->GetNameNoTime().c_str());
@@ -638,11 +665,7 @@ bool PlayList::Frame(uint8_t* buffer, size_t size, bool outputframe)
 
         for (auto it : _everySteps)
         {
-            if (IsFirstStepPlaying() && it->GetEveryStepExcludeFirst()) {
-                // we dont play this step
-            } else if (IsLastStepPlaying() && it->GetEveryStepExcludeLast()) {
-                // we dont play this step
-            } else {
+            if (IsEveryStepPlaying(it)) {
                 it->Frame(buffer, size, outputframe);
             }
         }
@@ -123,6 +123,7 @@ public:
     void SetLastOnce(bool foo) { if (_lastOnlyOnce != foo) { _lastOnlyOnce = foo; _changeCount++; } }
     void SetShuffle(bool foo) { if (_alwaysShuffle != foo) { _alwaysShuffle = foo; _changeCount++; } }
     bool Frame(uint8_t* buffer, size_t size, bool outputframe); // true if this was the last frame
+    void PrepareFrame(bool outputframe); // safe to call on a worker thread while nothing else touches the playlist
     int GetPlayListSize() const { return _steps.size(); }
     bool IsLooping() const { return _looping; }
     void StopAtEndOfThisLoop() { _lastLoop = true; }
@@ -165,6 +166,7 @@ public:
     PlayListItemText* GetRunningText(const std::string& name);
     bool IsFirstStepPlaying();
     bool IsLastStepPlaying();
+    bool IsEveryStepPlaying(PlayListStep* step);
     void StartEveryStep(int loops);
     void StopEveryStep();
     void RestartEveryStep();
@@ -85,6 +85,8 @@ protected:
     void SetPriority(size_t priority) { if (_priority != priority) { _priority = priority; _changeCount++; } }
     virtual bool Done() const { return false; }
     virtual void Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe) = 0;
+    // runs on a worker thread before Frame with the same ms so slow reads happen alongside the other playlists ... no UI and no buffer
+    virtual void PrepareFrame(size_t ms, size_t framems, bool outputframe) {}
     virtual std::string GetSyncItemFSEQ() const { return ""; }
     virtual std::string GetSyncItemMedia() { return ""; }
     virtual std::string GetTitle() const = 0;
@@ -114,6 +114,14 @@ void PlayListItemESEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fra
     }
 }
 
+void PlayListItemESEQ::PrepareFrame(size_t ms, size_t framems, bool outputframe)
+{
+    if (outputframe && _ESEQFile != nullptr)
+    {
+        _ESEQFile->ReadFrame(ms / framems);
+    }
+}
+
 void PlayListItemESEQ::Start(long stepLengthMS)
 {
     PlayListItem::Start(stepLengthMS);
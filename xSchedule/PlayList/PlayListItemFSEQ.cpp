@@ -494,6 +494,32 @@ bool PlayListItemFSEQ::Done() const
     return GetPositionMS() >= GetDurationMS() - _msPerFrame;
 }
 
+// reads and decompresses the frame unless it already has been
+bool PlayListItemFSEQ::ReadFrame(int frame)
+{
+    if (frame == _frameDataNumber) return true;
+
+    FSEQFile::FrameData* data = _fseqFile->getFrame(frame);
+    if (data == nullptr) return false;
+
+    _frameData.resize(_fseqFile->getMaxChannel() + 1);
+    data->readFrame(&_frameData[0], _frameData.size());
+    delete data;
+    _frameDataNumber = frame;
+    return true;
+}
+
+void PlayListItemFSEQ::PrepareFrame(size_t ms, size_t framems, bool outputframe)
+{
+    if (!outputframe || _fseqFile == nullptr || ms < _delay) return;
+
+    int frame = (ms - _delay) / framems;
+    if (_fseqFile->getMappedFrame(frame) == nullptr)
+    {
+        ReadFrame(frame);
+    }
+}
+
 void PlayListItemFSEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe)
 {
     //static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -516,21 +542,28 @@ void PlayListItemFSEQ::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fra
                 ms -= _delay;
                 
                 int frame =  ms / framems;
-                FSEQFile::FrameData *data = _fseqFile->getFrame(frame);
-                if (data != nullptr)
+                // uncompressed files are blended straight out of the page cache
+                const uint8_t* mapped = _fseqFile->getMappedFrame(frame);
+                if (mapped != nullptr)
+                {
+                    size_t offset = _channels > 0 ? GetStartChannelAsNumber() - 1 : 0;
+                    if (offset < _fseqFile->getChannelCount()) {
+                        size_t channelsPerFrame = _fseqFile->getChannelCount() - offset;
+                        if (_channels > 0) channelsPerFrame = std::min(_channels, channelsPerFrame);
+                        Blend(buffer, size, mapped + offset, channelsPerFrame, _applyMethod, offset);
+                    }
+                }
+                else if (ReadFrame(frame))
                 {
-                    std::vector<uint8_t> buf(_fseqFile->getMaxChannel() + 1);
-                    data->readFrame(&buf[0], buf.size());
                     size_t channelsPerFrame = (size_t)_fseqFile->getMaxChannel() + 1;
                     if (_channels > 0) channelsPerFrame = std::min(_channels, (size_t)_fseqFile->getMaxChannel() + 1);
                     if (_channels > 0) {
                         long offset = GetStartChannelAsNumber() - 1;
-                        Blend(buffer, size, &buf[offset], channelsPerFrame, _applyMethod, offset);
+                        Blend(buffer, size, &_frameData[offset], channelsPerFrame, _applyMethod, offset);
                     }
                     else {
-                        Blend(buffer, size, &buf[0], channelsPerFrame, _applyMethod, 0);
+                        Blend(buffer, size, &_frameData[0], channelsPerFrame, _applyMethod, 0);
                     }
-                    delete data;
                 }
                 else
                 {
@@ -569,7 +602,16 @@ void PlayListItemFSEQ::Start(long stepLengthMS)
     LoadFiles();
 
     if (_fseqFile != nullptr) {
-        _fseqFile->prepareRead({ { 0, _fseqFile->getMaxChannel() + 1 } });
+        // decode the next block in the background so we dont stall on block boundaries
+        _fseqFile->enableReadAhead(true);
+        _fseqFile->enableMemoryMap(true);
+        if (_channels > 0) {
+            // only the channels we play need to be read ... channel grouped files skip decompressing the rest
+            _fseqFile->prepareRead({ { (uint32_t)(GetStartChannelAsNumber() - 1), (uint32_t)_channels } });
+        }
+        else {
+            _fseqFile->prepareRead({ { 0, _fseqFile->getMaxChannel() + 1 } });
+        }
     }
 
     if (ControlsTiming() && _audioManager != nullptr) {
@@ -623,9 +665,12 @@ void PlayListItemFSEQ::CloseFiles()
 {
     if (_fseqFile != nullptr)
     {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        logger_base.debug("FSEQ %s slowest frame read %dus, read ahead misses %d.", (const char*)_fseqFileName.c_str(), (int)_fseqFile->getMaxFrameReadTimeUS(), (int)_fseqFile->getReadAheadMisses());
         delete _fseqFile;
         _fseqFile = nullptr;
     }
+    _frameDataNumber = -1;
 
     if (_audioManager != nullptr)
     {
@@ -13,6 +13,7 @@
 #include "PlayListItem.h"
 #include "../Blend.h"
 #include <string>
+#include <vector>
 
 class wxXmlNode;
 class wxWindow;
@@ -42,10 +43,13 @@ protected:
     bool _fastStartAudio;
     std::string _cachedAudioFilename;
     std::string _audioDevice = "";
+    std::vector<uint8_t> _frameData; // the last frame read from a compressed file
+    int _frameDataNumber = -1;
     #pragma endregion Member Variables
 
     void LoadFiles();
     void CloseFiles();
+    bool ReadFrame(int frame);
     void FastSetDuration();
     void LoadAudio();
 
@@ -106,6 +110,7 @@ public:
 
     #pragma region Playing
     virtual void Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe) override;
+    virtual void PrepareFrame(size_t ms, size_t framems, bool outputframe) override;
     virtual void Start(long stepLengthMS) override;
     virtual void Stop() override;
     virtual void Restart() override;
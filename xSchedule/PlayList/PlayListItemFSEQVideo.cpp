@@ -78,6 +78,7 @@ void PlayListItemFSEQVideo::Load(wxXmlNode* node)
     _startChannel = node->GetAttribute("StartChannel", "1").ToStdString();
     _fastStartAudio = (node->GetAttribute("FastStartAudio", "FALSE") == "TRUE");
     _cacheVideo = (node->GetAttribute("CacheVideo", "FALSE") == "TRUE");
+    _cacheFrames = wxAtoi(node->GetAttribute("CacheFrames", "0"));
     _loopVideo = (node->GetAttribute("LoopVideo", "FALSE") == "TRUE");
     _useMediaPlayer = (node->GetAttribute("UseMediaPlayer", "FALSE") == "TRUE");
     _videoFile = node->GetAttribute("VideoFile", "");
@@ -208,7 +209,7 @@ void PlayListItemFSEQVideo::LoadFiles(bool doCache)
     }
 
     if (!_useMediaPlayer && _cacheVideo && doCache) {
-        _cachedVideoReader = new CachedVideoReader(_videoFile, 0, GetFrameMS(), _size, false);
+        _cachedVideoReader = new CachedVideoReader(_videoFile, 0, GetFrameMS(), _size, false, _cacheFrames);
     }
     else {
         _videoReader = new VideoReader(_videoFile, _size.GetWidth(), _size.GetHeight(), false);
@@ -279,6 +280,7 @@ PlayListItem* PlayListItemFSEQVideo::Copy(const bool isClone) const
     res->_startChannel = _startChannel;
     res->_fastStartAudio = _fastStartAudio;
     res->_cacheVideo = _cacheVideo;
+    res->_cacheFrames = _cacheFrames;
     res->_loopVideo = _loopVideo;
     res->_origin = _origin;
     res->_size = _size;
@@ -334,6 +336,10 @@ wxXmlNode* PlayListItemFSEQVideo::Save()
         node->AddAttribute("CacheVideo", "TRUE");
     }
 
+    if (_cacheFrames != 0) {
+        node->AddAttribute("CacheFrames", wxString::Format(wxT("%i"), _cacheFrames));
+    }
+
     if (_loopVideo) {
         node->AddAttribute("LoopVideo", "TRUE");
     }
@@ -539,6 +545,31 @@ size_t PlayListItemFSEQVideo::GetPositionMS() const
 // Maximum milliseconds a media player file can be out of sync with the sequence
 #define MAXMEDIAJITTER (3 * framems)
 
+// reads and decompresses the frame unless it already has been
+bool PlayListItemFSEQVideo::ReadFrame(int frame)
+{
+    if (frame == _frameDataNumber) return true;
+
+    FSEQFile::FrameData* data = _fseqFile->getFrame(frame);
+    if (data == nullptr) return false;
+
+    _frameData.resize(_fseqFile->getMaxChannel() + 1);
+    data->readFrame(&_frameData[0], _frameData.size());
+    delete data;
+    _frameDataNumber = frame;
+    return true;
+}
+
+void PlayListItemFSEQVideo::PrepareFrame(size_t ms, size_t framems, bool outputframe)
+{
+    if (!outputframe || _fseqFile == nullptr || ms < _delay) return;
+
+    int frame = (ms - _delay) / framems;
+    if (_fseqFile->getMappedFrame(frame) == nullptr) {
+        ReadFrame(frame);
+    }
+}
+
 void PlayListItemFSEQVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -557,20 +588,26 @@ void PlayListItemFSEQVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_
 
             if (_fseqFile != nullptr) {
                 int frame =  adjustedMS / framems;
-                FSEQFile::FrameData *data = _fseqFile->getFrame(frame);
-                if (data != nullptr) {
-                    std::vector<uint8_t> buf(_fseqFile->getMaxChannel() + 1);
-                    data->readFrame(&buf[0], buf.size());
+                // uncompressed files are blended straight out of the page cache
+                const uint8_t* mapped = _fseqFile->getMappedFrame(frame);
+                if (mapped != nullptr) {
+                    size_t offset = _channels > 0 ? GetStartChannelAsNumber() - 1 : 0;
+                    if (offset < _fseqFile->getChannelCount()) {
+                        size_t channelsPerFrame = _fseqFile->getChannelCount() - offset;
+                        if (_channels > 0) channelsPerFrame = std::min(_channels, channelsPerFrame);
+                        Blend(buffer, size, mapped + offset, channelsPerFrame, _applyMethod, offset);
+                    }
+                }
+                else if (ReadFrame(frame)) {
                     size_t channelsPerFrame = (size_t)_fseqFile->getMaxChannel() + 1;
                     if (_channels > 0) channelsPerFrame = std::min(_channels, (size_t)_fseqFile->getMaxChannel() + 1);
                     if (_channels > 0) {
                         long offset = GetStartChannelAsNumber() - 1;
-                        Blend(buffer, size, &buf[offset], channelsPerFrame, _applyMethod, offset);
+                        Blend(buffer, size, &_frameData[offset], channelsPerFrame, _applyMethod, offset);
                     }
                     else {
-                        Blend(buffer, size, &buf[0], channelsPerFrame, _applyMethod, 0);
+                        Blend(buffer, size, &_frameData[0], channelsPerFrame, _applyMethod, 0);
                     }
-                    delete data;
                 }
                 else {
                     wxASSERT(false);
@@ -633,7 +670,7 @@ void PlayListItemFSEQVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_
                         adjustedMS -= videoLength;
                     }
 
-                    _window->SetImage(CachedVideoReader::FadeImage(_cachedVideoReader->GetNextFrame(adjustedMS), brightness));
+                    _window->SetFrame(CachedVideoReader::FadeFrame(_cachedVideoReader->GetNextFrame(adjustedMS), brightness));
                 }
             }
             else {
@@ -682,7 +719,16 @@ void PlayListItemFSEQVideo::Start(long stepLengthMS)
     LoadFiles(true);
 
     if (_fseqFile != nullptr) {
-        _fseqFile->prepareRead({ { 0, _fseqFile->getMaxChannel() + 1} });
+        // decode the next block in the background so we dont stall on block boundaries
+        _fseqFile->enableReadAhead(true);
+        _fseqFile->enableMemoryMap(true);
+        if (_channels > 0) {
+            // only the channels we play need to be read ... channel grouped files skip decompressing the rest
+            _fseqFile->prepareRead({ { (uint32_t)(GetStartChannelAsNumber() - 1), (uint32_t)_channels } });
+        }
+        else {
+            _fseqFile->prepareRead({ { 0, _fseqFile->getMaxChannel() + 1 } });
+        }
     }
 
     _currentFrame = 0;
@@ -796,9 +842,12 @@ void PlayListItemFSEQVideo::Stop()
 void PlayListItemFSEQVideo::CloseFiles()
 {
     if (_fseqFile != nullptr) {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        logger_base.debug("FSEQ %s slowest frame read %dus, read ahead misses %d.", (const char*)_fseqFileName.c_str(), (int)_fseqFile->getMaxFrameReadTimeUS(), (int)_fseqFile->getReadAheadMisses());
         delete _fseqFile;
         _fseqFile = nullptr;
     }
+    _frameDataNumber = -1;
 
     if (_audioManager != nullptr) {
         if (!_fastStartAudio) {
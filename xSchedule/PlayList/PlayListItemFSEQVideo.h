@@ -11,6 +11,7 @@
  **************************************************************/
 
 #include <string>
+#include <vector>
 
 #include "PlayListItem.h"
 #include "../Blend.h"
@@ -48,6 +49,7 @@ protected:
     size_t _channels = 0;
     bool _fastStartAudio = false;
     bool _cacheVideo = false;
+    int _cacheFrames = 0; // how far ahead the cache decodes, 0 for the default
     VideoReader* _videoReader = nullptr;
     CachedVideoReader* _cachedVideoReader = nullptr;
     std::string _cachedAudioFilename;
@@ -61,10 +63,13 @@ protected:
 	PlayerWindow* _window = nullptr;
     PlayerFrame* _frame = nullptr;
     std::string _audioDevice = "";
+    std::vector<uint8_t> _frameData; // the last frame read from a compressed file
+    int _frameDataNumber = -1;
     #pragma endregion
 
     void LoadFiles(bool doCache);
     void CloseFiles();
+    bool ReadFrame(int frame);
     void FastSetDuration();
     void LoadAudio();
 
@@ -104,6 +109,7 @@ public:
     }
     bool GetFastStartAudio() const { return _fastStartAudio; }
     bool GetCacheVideo() const { return _cacheVideo; }
+    int GetCacheFrames() const { return _cacheFrames; }
     bool GetLoopVideo() const { return _loopVideo; }
     void SetFSEQFileName(const std::string& fseqFileName);
     void SetAudioFile(const std::string& audioFile);
@@ -123,6 +129,7 @@ public:
     long GetChannels() const { return _channels; }
     void SetChannels(long channels) { if (_channels != channels) { _channels = channels; _changeCount++; } }
     void SetCacheVideo(bool cacheVideo) { if (_cacheVideo != cacheVideo) { _cacheVideo = cacheVideo; _changeCount++; } }
+    void SetCacheFrames(int cacheFrames) { if (_cacheFrames != cacheFrames) { _cacheFrames = cacheFrames; _changeCount++; } }
     void SetLoopVideo(bool loopVideo) { if (_loopVideo != loopVideo) { _loopVideo = loopVideo; _changeCount++; } }
     virtual bool SetPosition(size_t frame, size_t ms) override;
     void SetLocation(wxPoint pt, wxSize size) { if (_origin != pt || _size != size) { _origin = pt; _size = size; _changeCount++; } }
@@ -141,6 +148,7 @@ public:
 
     #pragma region Playing
     virtual void Frame(uint8_t* buffer, size_t size, size_t ms, size_t framems, bool outputframe) override;
+    virtual void PrepareFrame(size_t ms, size_t framems, bool outputframe) override;
     virtual void Start(long stepLengthMS) override;
     virtual void Stop() override;
     virtual void Restart() override;
@@ -69,6 +69,7 @@ void PlayListItemVideo::Load(wxXmlNode* node)
     _fadeOutMS = wxAtoi(node->GetAttribute("FadeOutMS", "0"));
     _topMost = (node->GetAttribute("Topmost", "TRUE") == "TRUE");
     _cacheVideo = (node->GetAttribute("CacheVideo", "FALSE") == "TRUE");
+    _cacheFrames = wxAtoi(node->GetAttribute("CacheFrames", "0"));
     _loopVideo = (node->GetAttribute("LoopVideo", "FALSE") == "TRUE");
     _suppressVirtualMatrix = (node->GetAttribute("SuppressVM", "FALSE") == "TRUE");
     _durationMS = VideoReader::GetVideoLength(_videoFile);
@@ -108,6 +109,7 @@ PlayListItem* PlayListItemVideo::Copy(const bool isClone) const
     res->_durationMS = _durationMS;
     res->_topMost = _topMost;
     res->_cacheVideo = _cacheVideo;
+    res->_cacheFrames = _cacheFrames;
     res->_loopVideo = _loopVideo;
     res->_suppressVirtualMatrix = _suppressVirtualMatrix;
     res->_useMediaPlayer = _useMediaPlayer;
@@ -150,6 +152,10 @@ wxXmlNode* PlayListItemVideo::Save()
         node->AddAttribute("CacheVideo", "TRUE");
     }
 
+    if (_cacheFrames != 0) {
+        node->AddAttribute("CacheFrames", wxString::Format(wxT("%i"), _cacheFrames));
+    }
+
     if (_useMediaPlayer) {
         node->AddAttribute("UseMediaPlayer", "TRUE");
     }
@@ -221,7 +227,7 @@ void PlayListItemVideo::OpenFiles(bool doCache)
     CloseFiles();
 
     if (_cacheVideo && doCache && !_useMediaPlayer) {
-        _cachedVideoReader = new CachedVideoReader(_videoFile, 0, GetFrameMS(), _size, false);
+        _cachedVideoReader = new CachedVideoReader(_videoFile, 0, GetFrameMS(), _size, false, _cacheFrames);
         _durationMS = _cachedVideoReader->GetLengthMS();
     }
     else {
@@ -295,7 +301,7 @@ void PlayListItemVideo::Frame(uint8_t* buffer, size_t size, size_t ms, size_t fr
                         adjustedMS -= videoLength;
                     }
 
-                    if (_window != nullptr) _window->SetImage(CachedVideoReader::FadeImage(_cachedVideoReader->GetNextFrame(adjustedMS), brightness));
+                    if (_window != nullptr) _window->SetFrame(CachedVideoReader::FadeFrame(_cachedVideoReader->GetNextFrame(adjustedMS), brightness));
                 }
             }
             else {
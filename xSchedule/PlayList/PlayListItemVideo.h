@@ -33,6 +33,7 @@ protected:
     bool _suppressVirtualMatrix = false;
     bool _topMost = false;
     bool _cacheVideo = false;
+    int _cacheFrames = 0; // how far ahead the cache decodes, 0 for the default
     bool _loopVideo = false;
     VideoReader* _videoReader = nullptr;
     CachedVideoReader* _cachedVideoReader = nullptr;
@@ -59,9 +60,11 @@ public:
     #pragma region Getters and Setters
     bool GetTopMost() const { return _topMost; }
     bool GetCacheVideo() const { return _cacheVideo; }
+    int GetCacheFrames() const { return _cacheFrames; }
     bool GetLoopVideo() const { return _loopVideo; }
     void SetTopmost(bool topmost) { if (_topMost != topmost) { _topMost = topmost; _changeCount++; } }
     void SetCacheVideo(bool cacheVideo) { if (_cacheVideo != cacheVideo) { _cacheVideo = cacheVideo; _changeCount++; } }
+    void SetCacheFrames(int cacheFrames) { if (_cacheFrames != cacheFrames) { _cacheFrames = cacheFrames; _changeCount++; } }
     void SetLoopVideo(bool loopVideo) { if (_loopVideo != loopVideo) { _loopVideo = loopVideo; _changeCount++; } }
     bool GetSuppressVirtualMatrix() const { return _suppressVirtualMatrix; }
     void SetSuppressVirtualMatrix(bool suppressVirtualMatrix) { if (_suppressVirtualMatrix != suppressVirtualMatrix) { _suppressVirtualMatrix = suppressVirtualMatrix; _changeCount++; } }
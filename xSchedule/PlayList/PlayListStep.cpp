@@ -516,15 +516,9 @@ PlayListItem* PlayListStep::GetTimeSource(size_t &ms) const
     return timesource;
 }
 
-bool PlayListStep::Frame(uint8_t* buffer, size_t size, bool outputframe)
+PlayListItem* PlayListStep::GetFrameTime(size_t& frameMS, size_t& msPerFrame) const
 {
-    ReentrancyCounter rec(_reentrancyCounter);
-
-    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
-
-    _currentFrame++;
-
-    size_t msPerFrame = 1000;
+    msPerFrame = 1000;
     PlayListItem* timesource = GetTimeSource(msPerFrame);
 
     if (msPerFrame == 0)
@@ -532,7 +526,6 @@ bool PlayListStep::Frame(uint8_t* buffer, size_t size, bool outputframe)
         msPerFrame = 50;
     }
 
-    size_t frameMS;
     if (timesource != nullptr)
     {
         frameMS = timesource->GetPositionMS();
@@ -542,6 +535,39 @@ bool PlayListStep::Frame(uint8_t* buffer, size_t size, bool outputframe)
         frameMS = wxGetUTCTimeMillis().GetLo() - _startTime;
     }
 
+    return timesource;
+}
+
+void PlayListStep::PrepareFrame(bool outputframe)
+{
+    GetFrameTime(_preparedMS, _preparedMSPerFrame);
+
+    for (const auto& it : _items)
+    {
+        it->PrepareFrame(_preparedMS, _preparedMSPerFrame, outputframe);
+    }
+    _prepared = true;
+}
+
+bool PlayListStep::Frame(uint8_t* buffer, size_t size, bool outputframe)
+{
+    ReentrancyCounter rec(_reentrancyCounter);
+
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    _currentFrame++;
+
+    size_t msPerFrame;
+    size_t frameMS;
+    PlayListItem* timesource = GetFrameTime(frameMS, msPerFrame);
+    if (_prepared)
+    {
+        // stick with the time the items were prepared for
+        frameMS = _preparedMS;
+        msPerFrame = _preparedMSPerFrame;
+        _prepared = false;
+    }
+
     //logger_base.debug("Step %s frame %ld start.", (const char *)GetNameNoTime().c_str(), (long)frameMS);
 
     //if (frameMS >= GetLengthMS())
@@ -588,6 +614,7 @@ void PlayListStep::Start(int loops)
 
     _loops = loops;
     _startTime = wxGetUTCTimeMillis().GetLo();
+    _prepared = false;
     {
         ReentrancyCounter rec(_reentrancyCounter);
         for (auto it: _items)
@@ -45,10 +45,14 @@ protected:
     bool _everyStep = false;
     bool _everyStepExcludeFirst = false;
     bool _everyStepExcludeLast = false;
+    bool _prepared = false;
+    size_t _preparedMS = 0;
+    size_t _preparedMSPerFrame = 50;
 #pragma endregion Member Variables
 
     std::string FormatTime(size_t timems, bool ms = false) const;
     AudioManager* GetAudioManager(PlayListItem* pli) const;
+    PlayListItem* GetFrameTime(size_t& frameMS, size_t& msPerFrame) const;
 
 public:
 
@@ -127,6 +131,9 @@ public:
     void AddItem(PlayListItem* item) { _items.push_back(item); _items.sort(); ++_changeCount; }
     void RemoveItem(PlayListItem* item);
     bool Frame(uint8_t* buffer, size_t size, bool outputframe);
+    // lets the items read their next frame on a worker thread, the following Frame uses the same time
+    void PrepareFrame(bool outputframe);
+    void DiscardPreparedFrame() { _prepared = false; }
     size_t GetPosition();
     PlayListItem* GetItem(const std::string item);
     PlayListItem* GetItem(const wxUint32 id);
@@ -14,6 +14,7 @@
 
 #include "PlayerWindow.h"
 #include "../VirtualMatrix.h"
+#include "../VideoCache.h"
 
 extern "C"
 {
@@ -96,9 +97,12 @@ bool PlayerWindow::PrepareImage()
 
                 if (_swsQuality < 0) {
                     _image.Destroy();
-                    _image = _inputImage.Copy();
                     if (srcWidth != width || srcHeight != height) {
-                        _image.Rescale(width, height, _quality);
+                        // scale straight from the input rather than copying it first
+                        _image = _inputImage.Scale(width, height, _quality);
+                    }
+                    else {
+                        _image = _inputImage.Copy();
                     }
                 }
                 else {
@@ -134,6 +138,7 @@ bool PlayerWindow::PrepareImage()
                 }
                 logger_frame.debug("Player Window image updated %ldms", sw.Time());
             }
+            _imageChanged = false;
             _mutex.unlock();
         }
         else {
@@ -164,12 +169,29 @@ void PlayerWindow::SetImage(const wxImage& image)
         if (changed) {
             _inputImage.Destroy();
             _inputImage = image.Copy();
+            _inputFrame = nullptr;
             _imageChanged = true;
             Refresh(false); // force a paint on the main thread
         }
     }
 }
 
+void PlayerWindow::SetFrame(const std::shared_ptr<const VideoCacheFrame>& frame)
+{
+    if (frame == nullptr || frame->width <= 0 || frame->height <= 0) return;
+
+    std::unique_lock<std::timed_mutex> lock(_mutex);
+
+    if (frame == _inputFrame) return;
+
+    // wrap the frame data rather than copying it ... the frame is never changed once handed out
+    _inputImage.Destroy();
+    _inputImage = wxImage(frame->width, frame->height, (unsigned char*)frame->data.data(), true);
+    _inputFrame = frame;
+    _imageChanged = true;
+    Refresh(false); // force a paint on the main thread
+}
+
 void PlayerWindow::Paint(wxPaintEvent& event)
 {
     wxASSERT(wxThread::IsMain());
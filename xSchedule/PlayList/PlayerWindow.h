@@ -16,11 +16,15 @@
 
 #include <mutex>
 #include <atomic>
+#include <memory>
+
+struct VideoCacheFrame;
 
 class PlayerWindow: public wxFrame
 {
     wxImage _image;
     wxImage _inputImage;
+    std::shared_ptr<const VideoCacheFrame> _inputFrame; // owns the data _inputImage points at when set
     wxPoint _startDragPos;
     wxPoint _startMousePos;
     bool _dragging;
@@ -36,6 +40,8 @@ class PlayerWindow: public wxFrame
 		PlayerWindow(wxWindow* parent, bool topMost, wxImageResizeQuality quality = wxIMAGE_QUALITY_HIGH, int swsQuality = -1, wxWindowID id=wxID_ANY,const wxPoint& pos=wxDefaultPosition,const wxSize& size=wxDefaultSize);
 		virtual ~PlayerWindow();
         void SetImage(const wxImage& image);
+        // no copy ... the window just holds onto the frame until the next one arrives
+        void SetFrame(const std::shared_ptr<const VideoCacheFrame>& frame);
 
 	private:
 
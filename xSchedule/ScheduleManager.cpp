@@ -47,9 +47,9 @@
 #include "wxJSON/jsonreader.h"
 #include "../xLights/VideoReader.h"
 #include "../xLights/outputs/Controller.h"
-#include "OutputProcessExcludeDim.h"
 #include "../xLights/Parallel.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <log4cpp/Category.hh>
@@ -58,6 +58,7 @@ ScheduleManager::ScheduleManager(xScheduleFrame* frame, const std::string& showD
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     logger_base.info("Loading schedule from %s.", (const char *)showDir.c_str());
+    logger_base.info("Blending using %s.", (const char*)DecodeBlendInstructionSet(GetBlendInstructionSet()).c_str());
 
     // prime fix file with our show directory for any filename fixups
     SetFixFileShowDir(showDir);
@@ -118,6 +119,9 @@ ScheduleManager::ScheduleManager(xScheduleFrame* frame, const std::string& showD
             {
                 _scheduleOptions = new ScheduleOptions(_outputManager, n, GetCommandManager());
                 _outputManager->SetParallelTransmission(_scheduleOptions->IsParallelTransmission());
+                _outputManager->SetBatchedTransmission(_scheduleOptions->IsBatchedTransmission());
+                _outputManager->SetPacedTransmission(_scheduleOptions->IsPacedTransmission(), _scheduleOptions->GetPacedWindowPercent(), _scheduleOptions->GetPacedMaxPacketsPerMS());
+                _outputManager->SetOutputThread(_scheduleOptions->IsOutputThread());
                 OutputManager::SetRetryOpen(_scheduleOptions->IsRetryOpen());
                 _outputManager->SetSyncEnabled(_scheduleOptions->IsSync());
                 Schedule::SetCity(_scheduleOptions->GetCity());
@@ -155,6 +159,9 @@ ScheduleManager::ScheduleManager(xScheduleFrame* frame, const std::string& showD
         _scheduleOptions = new ScheduleOptions();
         Schedule::SetCity(_scheduleOptions->GetCity());
         _outputManager->SetParallelTransmission(_scheduleOptions->IsParallelTransmission());
+        _outputManager->SetBatchedTransmission(_scheduleOptions->IsBatchedTransmission());
+        _outputManager->SetPacedTransmission(_scheduleOptions->IsPacedTransmission(), _scheduleOptions->GetPacedWindowPercent(), _scheduleOptions->GetPacedMaxPacketsPerMS());
+        _outputManager->SetOutputThread(_scheduleOptions->IsOutputThread());
         _outputManager->SetSyncEnabled(_scheduleOptions->IsSync());
         OutputManager::SetRetryOpen(_scheduleOptions->IsRetryOpen());
     }
@@ -759,15 +766,7 @@ void ScheduleManager::AllOff()
     }
 
     // apply any output processing
-    for (const auto& it : _outputProcessing)
-    {
-        it->Frame(_buffer, _outputManager->GetTotalChannels(), _outputProcessing);
-    }
-
-    //if (_brightness < 100)
-    //{
-    //    ApplyBrightness();
-    //}
+    ApplyOutputProcessing(false);
 
     for (const auto& it : *GetOptions()->GetVirtualMatrices())
     {
@@ -778,43 +777,115 @@ void ScheduleManager::AllOff()
     _outputManager->EndFrame();
 }
 
-void ScheduleManager::ApplyBrightness()
+void ScheduleManager::ApplyOutputProcessing(bool brightness)
 {
-    if (_brightness == 100) return;
+    if (_outputProcessing.empty() && !brightness) return;
 
-    if (_brightness != _lastBrightness) {
+    if (brightness && _brightness != _lastBrightness) {
         _lastBrightness = _brightness;
         CreateBrightnessArray();
     }
 
     auto totalChannels = _outputManager->GetTotalChannels();
 
-    auto ed = OutputProcess::GetExcludeDim(_outputProcessing, 1, totalChannels);
+    // the processes are only compiled into the pipeline when they or the brightness change
+    auto& pipeline = _outputPipeline[brightness ? 1 : 0];
+    int b = brightness ? _brightness : 100;
+    if (!pipeline.IsCompiled(_outputProcessing, totalChannels, _outputProcessingVersion, b)) {
+        pipeline.Compile(_outputProcessing, totalChannels, _outputProcessingVersion, b, brightness ? _brightnessArray : nullptr);
+    }
+    pipeline.Frame(_buffer, totalChannels, _outputProcessing);
+}
 
-    if (ed.size() == 0) { // handle the simple case fast
-        //uint8_t* pb = _buffer;
-        //for (size_t i = 0; i < totalChannels; ++i) {
-        //    *pb = _brightnessArray[*pb];
-        //    pb++;
-        //}
-        parallel_for(0, totalChannels, [this](int i) {
-            _buffer[i] = _brightnessArray[_buffer[i]];
-        });
+void ScheduleManager::AddFrameSource(PlayList* playList, const std::string& type)
+{
+    for (const auto& it : _frameTiming)
+    {
+        if (it.playList == playList) return;
     }
-    else {
-        auto exclude = ed.begin();
-        uint8_t* pb = _buffer;
-        for (size_t i = 0; i < totalChannels; ++i) {
 
-            while (exclude != ed.end() && i > (*exclude)->GetLastExcludeChannel() - 1) ++exclude;
-            bool ex = (exclude != ed.end() && i >= (*exclude)->GetFirstExcludeChannel() - 1);
+    FrameSourceTiming timing;
+    timing.playList = playList;
+    timing.name = playList->GetNameNoTime();
+    timing.type = type;
+    _frameTiming.push_back(timing);
+}
 
-            if (!ex) {
-                *pb = _brightnessArray[*pb];
-            }
-            pb++;
+// Each playlist reads its fseq/eseq data for the frame on the job pool at the same time so the frame takes as long as
+// the slowest rather than all of them added up. The blending into _buffer still happens in order in FramePlayList.
+void ScheduleManager::PrepareFrame(PlayList* running, bool background, bool outputframe)
+{
+    _frameTiming.clear();
+    if (running != nullptr) AddFrameSource(running, "running");
+    if (background && _backgroundPlayList != nullptr && _backgroundPlayList->IsRunning()) AddFrameSource(_backgroundPlayList, "background");
+    for (const auto& it : _eventPlayLists)
+    {
+        AddFrameSource(it, "event");
+    }
+
+    parallel_for(0, (int)_frameTiming.size(), [this, outputframe](int i) {
+        wxStopWatch sw;
+        _frameTiming[i].playList->PrepareFrame(outputframe);
+        _frameTiming[i].prepareUS = sw.TimeInMicro().GetValue();
+    });
+}
+
+bool ScheduleManager::FramePlayList(PlayList* playList, long totalChannels, bool outputframe)
+{
+    wxStopWatch sw;
+    bool done = playList->Frame(_buffer, totalChannels, outputframe);
+
+    auto timing = std::find_if(_frameTiming.begin(), _frameTiming.end(), [playList](const FrameSourceTiming& t) { return t.playList == playList; });
+    if (timing == _frameTiming.end())
+    {
+        // it was started after the frame was prepared
+        AddFrameSource(playList, playList == _backgroundPlayList ? "background" : "event");
+        timing = _frameTiming.end() - 1;
+    }
+    timing->frameUS = sw.TimeInMicro().GetValue();
+
+    return done;
+}
+
+void ScheduleManager::EndFrameTiming(long frameUS)
+{
+    for (auto& it : _frameTiming)
+    {
+        it.playList = nullptr; // it may not be around by the time anyone looks
+    }
+
+    std::unique_lock<std::mutex> lock(_frameTimingLock);
+    std::swap(_lastFrameTiming, _frameTiming);
+    _frameTiming.clear();
+    _lastFrameUS = frameUS;
+}
+
+std::string ScheduleManager::GetFrameTimingStatus()
+{
+    std::unique_lock<std::mutex> lock(_frameTimingLock);
+
+    std::string res = "\"frametiming\":{\"frameus\":\"" + wxString::Format("%ld", _lastFrameUS).ToStdString() + "\",\"sources\":[";
+
+    bool first = true;
+    for (const auto& it : _lastFrameTiming)
+    {
+        if (first)
+        {
+            first = false;
+        }
+        else
+        {
+            res += ",";
         }
+
+        res += "{\"name\":\"" + it.name +
+            "\",\"type\":\"" + it.type +
+            "\",\"prepareus\":\"" + wxString::Format("%ld", it.prepareUS).ToStdString() +
+            "\",\"frameus\":\"" + wxString::Format("%ld", it.frameUS).ToStdString() + "\"}";
     }
+
+    res += "]}";
+    return res;
 }
 
 int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
@@ -854,15 +925,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
         }
 
         // apply any output processing
-        for (const auto& it : _outputProcessing)
-        {
-            it->Frame(_buffer, totalChannels, _outputProcessing);
-        }
-
-        if (outputframe && _brightness < 100)
-        {
-            ApplyBrightness();
-        }
+        ApplyOutputProcessing(outputframe && _brightness < 100);
 
         for (const auto& it : *GetOptions()->GetVirtualMatrices())
         {
@@ -899,11 +962,14 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                 _outputManager->StartFrame(msec);
             }
 
+            PrepareFrame(running, true, outputframe);
+            logger_frame.debug("Frame: Playlists prepared %ldms", sw.Time());
+
             bool done = false;
             if (running != nullptr)
             {
                 logger_frame.debug("Frame: About to run step frame %ldms", sw.Time());
-                done = running->Frame(_buffer, totalChannels, outputframe);
+                done = FramePlayList(running, totalChannels, outputframe);
                 logger_frame.debug("Frame: step frame done %ldms", sw.Time());
 
                 if (running->GetRunningStep() != nullptr)
@@ -948,7 +1014,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                     _backgroundPlayList->Start(true);
                     logger_base.debug("Background playlist restarted. %s.", (const char *)_backgroundPlayList->GetNameNoTime().c_str());
                 }
-                _backgroundPlayList->Frame(_buffer, totalChannels, outputframe);
+                FramePlayList(_backgroundPlayList, totalChannels, outputframe);
             }
 
             if (_eventPlayLists.size() > 0)
@@ -956,7 +1022,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                 auto it = _eventPlayLists.begin();
                 while (it != _eventPlayLists.end())
                 {
-                    if ((*it)->Frame(_buffer, _outputManager->GetTotalChannels(), outputframe))
+                    if (FramePlayList(*it, totalChannels, outputframe))
                     {
                         auto temp = it;
                         ++it;
@@ -973,7 +1039,14 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
 
             if (_xyzzy != nullptr)
             {
+                wxStopWatch xsw;
                 _xyzzy->Frame(_buffer, totalChannels, outputframe);
+
+                FrameSourceTiming timing;
+                timing.name = "xyzzy";
+                timing.type = "xyzzy";
+                timing.frameUS = xsw.TimeInMicro().GetValue();
+                _frameTiming.push_back(timing);
             }
 
             if (outputframe)
@@ -989,20 +1062,10 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                 logger_frame.debug("Frame: Overlay data done %ldms", sw.Time());
 
                 // apply any output processing
-                for (auto it = _outputProcessing.begin(); it != _outputProcessing.end(); ++it)
-                {
-                    (*it)->Frame(_buffer, totalChannels, _outputProcessing);
-                }
+                ApplyOutputProcessing(outputframe && _brightness < 100);
 
                 logger_frame.debug("Frame: Output processing done %ldms", sw.Time());
 
-                if (outputframe && _brightness < 100)
-                {
-                    ApplyBrightness();
-                }
-
-                logger_frame.debug("Frame: Brightness done %ldms", sw.Time());
-
                 for (const auto& it : *GetOptions()->GetVirtualMatrices())
                 {
                     it->Frame(_buffer, totalChannels);
@@ -1055,6 +1118,8 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
 
                 if ((_backgroundPlayList != nullptr || _eventPlayLists.size() > 0) && _scheduleOptions->IsSendBackgroundWhenNotRunning())
                 {
+                    PrepareFrame(nullptr, true, true);
+
                     if (_backgroundPlayList != nullptr)
                     {
                         if (!_backgroundPlayList->IsRunning())
@@ -1062,7 +1127,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                             _backgroundPlayList->Start(true);
                             logger_base.debug("Background playlist restarted. %s.", (const char *)_backgroundPlayList->GetNameNoTime().c_str());
                         }
-                        _backgroundPlayList->Frame(_buffer, totalChannels, outputframe);
+                        FramePlayList(_backgroundPlayList, totalChannels, outputframe);
                     }
 
                     if (_eventPlayLists.size() > 0)
@@ -1070,7 +1135,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                         auto it = _eventPlayLists.begin();
                         while (it != _eventPlayLists.end())
                         {
-                            if ((*it)->Frame(_buffer, _outputManager->GetTotalChannels(), true))
+                            if (FramePlayList(*it, totalChannels, true))
                             {
                                 auto temp = it;
                                 ++it;
@@ -1095,15 +1160,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                 }
 
                 // apply any output processing
-                for (const auto& it : _outputProcessing)
-                {
-                    it->Frame(_buffer, totalChannels, _outputProcessing);
-                }
-
-                if (outputframe && _brightness < 100)
-                {
-                    ApplyBrightness();
-                }
+                ApplyOutputProcessing(outputframe && _brightness < 100);
 
                 for (const auto& it : *GetOptions()->GetVirtualMatrices())
                 {
@@ -1129,10 +1186,12 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                         _outputManager->AllOff(false);
                     }
 
+                    PrepareFrame(nullptr, false, true);
+
                     auto it = _eventPlayLists.begin();
                     while (it != _eventPlayLists.end())
                     {
-                        if ((*it)->Frame(_buffer, _outputManager->GetTotalChannels(), true))
+                        if (FramePlayList(*it, totalChannels, true))
                         {
                             auto temp = it;
                             ++it;
@@ -1149,15 +1208,7 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
                     frame->ManipulateBuffer(_buffer, totalChannels);
 
                     // apply any output processing
-                    for (auto it2 = _outputProcessing.begin(); it2 != _outputProcessing.end(); ++it2)
-                    {
-                        (*it2)->Frame(_buffer, totalChannels, _outputProcessing);
-                    }
-
-                    if (outputframe && _brightness < 100)
-                    {
-                        ApplyBrightness();
-                    }
+                    ApplyOutputProcessing(outputframe && _brightness < 100);
 
                     for (auto it2 :*GetOptions()->GetVirtualMatrices())
                     {
@@ -1184,6 +1235,8 @@ int ScheduleManager::Frame(bool outputframe, xScheduleFrame* frame)
         }
     }
 
+    EndFrameTiming(sw.TimeInMicro().GetValue());
+
     reentry = false;
     if (rate == 0) rate = 50;
     oldrate = rate;
@@ -3798,7 +3851,7 @@ bool ScheduleManager::Query(const wxString& command, const wxString& parameters,
                 "\",\"reference\":\"" + reference +
                 "\",\"passwordset\":\"" + (_scheduleOptions->GetPassword() == ""? "false" : "true") +
                 "\",\"time\":\""+ wxDateTime::Now().Format("%Y-%m-%d %H:%M:%S") +
-                "\"," + GetPingStatus() +"}";
+                "\"," + GetFrameTimingStatus() + "," + GetPingStatus() +"}";
         }
         else
         {
@@ -3864,7 +3917,7 @@ bool ScheduleManager::Query(const wxString& command, const wxString& parameters,
                 "\",\"autooutputtolights\":\"" + (_manualOTL ? "false" : "true") +
                 "\",\"passwordset\":\"" + (_scheduleOptions->GetPassword() == "" ? "false" : "true") +
                 "\",\"outputtolights\":\"" + std::string(_outputManager->IsOutputting() ? "true" : "false") + 
-                "\"," + GetPingStatus() + "}";
+                "\"," + GetFrameTimingStatus() + "," + GetPingStatus() + "}";
             //static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
             //logger_base.info("%s", (const char*)data.c_str());
         }
@@ -11,7 +11,9 @@
  **************************************************************/
 
 #include <list>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <wx/wx.h>
 #include "Schedule.h"
 #include "CommandManager.h"
@@ -20,6 +22,7 @@
 #include "wxMIDI/src/wxMidi.h"
 #include "Blend.h"
 #include "SyncManager.h"
+#include "OutputPipeline.h"
 
 class PlayListItemText;
 class ScheduleOptions;
@@ -68,6 +71,16 @@ public:
     std::string _data;
 };
 
+// how long one of the playlists (or xyzzy) playing took to produce its part of the last frame
+struct FrameSourceTiming
+{
+    PlayList* playList = nullptr;
+    std::string name;
+    std::string type; // running, background, event or xyzzy
+    long prepareUS = 0; // reading its data ... done alongside the others
+    long frameUS = 0; // blending into the frame ... done in order
+};
+
 class ScheduleManager
 {
     int _mode = (int)SYNCMODE::STANDALONE;
@@ -99,6 +112,8 @@ class ScheduleManager
     wxDatagramSocket* _artNetSyncMaster = nullptr;
     wxDatagramSocket* _fppSyncMasterUnicast = nullptr;
     std::list<OutputProcess*> _outputProcessing;
+    OutputPipeline _outputPipeline[2]; // without and with brightness
+    int _outputProcessingVersion = 0;
     ListenerManager* _listenerManager = nullptr;
     XyzzyBase* _xyzzy = nullptr;
     wxDateTime _lastXyzzyCommand;
@@ -106,9 +121,18 @@ class ScheduleManager
     bool _webRequestToggle = false;
     Pinger* _pinger = nullptr;
     std::unique_ptr<SyncManager> _syncManager = nullptr;
+    std::vector<FrameSourceTiming> _frameTiming; // the frame being built
+    std::vector<FrameSourceTiming> _lastFrameTiming;
+    long _lastFrameUS = 0;
+    std::mutex _frameTimingLock;
 
     void DisableRemoteOutputs();
     std::string GetPingStatus();
+    std::string GetFrameTimingStatus();
+    void AddFrameSource(PlayList* playList, const std::string& type);
+    void PrepareFrame(PlayList* running, bool background, bool outputframe);
+    bool FramePlayList(PlayList* playList, long totalChannels, bool outputframe);
+    void EndFrameTiming(long frameUS);
     std::string FormatTime(size_t timems);
     void CreateBrightnessArray();
     void ManageBackground();
@@ -182,14 +206,15 @@ class ScheduleManager
         int GetBrightness() const { return _brightness; }
         void AdjustBrightness(int by) { _brightness += by; if (_brightness < 0) _brightness = 0; else if (_brightness > 100) _brightness = 100; }
         void SetBrightness(int brightness) { if (brightness < 0) _brightness = 0; else if (brightness > 100) _brightness = 100; else _brightness = brightness; }
-        void ApplyBrightness();
+        // runs the output processes and optionally the brightness over the frame buffer
+        void ApplyOutputProcessing(bool brightness);
         int Frame(bool outputframe, xScheduleFrame* frame); // called when a frame needs to be displayed ... returns desired frame rate
         int CheckSchedule();
         std::string GetShowDir() const { return _showDir; }
         bool PlayPlayList(PlayList* playlist, size_t& rate, bool loop = false, const std::string& step = "", bool forcelast = false, int loops = -1, bool random = false, int steploops = -1);
         bool IsSomethingPlaying() const { return GetRunningPlayList() != nullptr; }
         void OptionsChanged() { _changeCount++; };
-        void OutputProcessingChanged() { _changeCount++; };
+        void OutputProcessingChanged() { _changeCount++; _outputProcessingVersion++; };
         bool Action(const wxString& label, PlayList* selplaylist, PlayListStep* selplayliststep, Schedule* selschedule, size_t& rate, wxString& msg);
         bool Action(const wxString& command, const wxString& parameters, const wxString& data, PlayList* selplaylist, PlayListStep* selplayliststep, Schedule* selschedule, size_t& rate, wxString& msg);
         bool Query(const wxString& command, const wxString& parameters, wxString& data, wxString& msg, const wxString& ip, const wxString& reference);
@@ -55,6 +55,11 @@ ScheduleOptions::ScheduleOptions(OutputManager* outputManager, wxXmlNode* node,
     _webAPIOnly = node->GetAttribute("APIOnly", "FALSE") == "TRUE";
     _sendOffWhenNotRunning = node->GetAttribute("SendOffWhenNotRunning", "FALSE") == "TRUE";
     _parallelTransmission = node->GetAttribute("ParallelTransmission", "FALSE") == "TRUE";
+    _outputThread = node->GetAttribute("OutputThread", "FALSE") == "TRUE";
+    _batchedTransmission = node->GetAttribute("BatchedTransmission", "FALSE") == "TRUE";
+    _pacedTransmission = node->GetAttribute("PacedTransmission", "FALSE") == "TRUE";
+    _pacedWindowPercent = wxAtoi(node->GetAttribute("PacedWindowPercent", "50"));
+    _pacedMaxPacketsPerMS = wxAtoi(node->GetAttribute("PacedMaxPacketsPerMS", "0"));
     _remoteAllOff = node->GetAttribute("RemoteSustain", "FALSE") == "FALSE";
     _keepScreenOn = node->GetAttribute("KeepScreenOn", "FALSE") == "TRUE";
     _minimiseUIUpdates = node->GetAttribute("MinimiseUIUpdates", "FALSE") == "TRUE";
@@ -277,6 +282,11 @@ ScheduleOptions::ScheduleOptions()
     _sync = false;
     _sendOffWhenNotRunning = false;
     _parallelTransmission = false;
+    _outputThread = false;
+    _batchedTransmission = false;
+    _pacedTransmission = false;
+    _pacedWindowPercent = 50;
+    _pacedMaxPacketsPerMS = 0;
     _remoteAllOff = true;
     _keepScreenOn = false;
     _minimiseUIUpdates = false;
@@ -378,6 +388,20 @@ wxXmlNode* ScheduleOptions::Save()
         res->AddAttribute("ParallelTransmission", "TRUE");
     }
 
+    if (IsOutputThread()) {
+        res->AddAttribute("OutputThread", "TRUE");
+    }
+
+    if (IsBatchedTransmission()) {
+        res->AddAttribute("BatchedTransmission", "TRUE");
+    }
+
+    if (IsPacedTransmission()) {
+        res->AddAttribute("PacedTransmission", "TRUE");
+    }
+    res->AddAttribute("PacedWindowPercent", wxString::Format("%d", _pacedWindowPercent));
+    res->AddAttribute("PacedMaxPacketsPerMS", wxString::Format("%d", _pacedMaxPacketsPerMS));
+
     if (!IsRemoteAllOff()) {
         res->AddAttribute("RemoteSustain", "TRUE");
     }
@@ -199,6 +199,11 @@ class ScheduleOptions
     wxSize _defaultVideoSize = { 300, 300 };
     wxPoint _defaultVideoPos = { 0, 0 };
     bool _parallelTransmission;
+    bool _outputThread;
+    bool _batchedTransmission;
+    bool _pacedTransmission;
+    int _pacedWindowPercent;
+    int _pacedMaxPacketsPerMS;
     bool _remoteAllOff;
     bool _keepScreenOn;
     bool _retryOutputOpen;
@@ -245,7 +250,12 @@ public:
     void SetMIDITimecodeFormat(TIMECODEFORMAT format) { if (format != _MIDITimecodeFormat) { _MIDITimecodeFormat = format; _changeCount++; } }
     void SetMIDITimecodeOffset(size_t offset) { if (offset != _MIDITimecodeOffset) { _MIDITimecodeOffset = offset; _changeCount++; } }
     void SetAdvancedMode(bool advancedMode) { if (_advancedMode != advancedMode) { _advancedMode = advancedMode; _changeCount++; } }
+    void SetOutputThread(bool value) { if (_outputThread != value) { _outputThread = value; _changeCount++; } }
     void SetParallelTransmission(bool parallel) { if (_parallelTransmission != parallel) { _parallelTransmission = parallel; _changeCount++; } }
+    void SetBatchedTransmission(bool batched) { if (_batchedTransmission != batched) { _batchedTransmission = batched; _changeCount++; } }
+    void SetPacedTransmission(bool paced) { if (_pacedTransmission != paced) { _pacedTransmission = paced; _changeCount++; } }
+    void SetPacedWindowPercent(int percent) { if (_pacedWindowPercent != percent) { _pacedWindowPercent = percent; _changeCount++; } }
+    void SetPacedMaxPacketsPerMS(int packets) { if (_pacedMaxPacketsPerMS != packets) { _pacedMaxPacketsPerMS = packets; _changeCount++; } }
     void SetRemoteAllOff(bool remoteAllOff) { if (_remoteAllOff != remoteAllOff) { _remoteAllOff = remoteAllOff; _changeCount++; } }
     void SetMinimiseUIUpdates(bool minimiseUIUpdates) { if (_minimiseUIUpdates != minimiseUIUpdates) { _minimiseUIUpdates = minimiseUIUpdates; _changeCount++; } }
     void SetKeepScreenOn(bool keepScreenOn) { if (_keepScreenOn != keepScreenOn) { _keepScreenOn = keepScreenOn; _changeCount++; } }
@@ -274,6 +284,11 @@ public:
     void SetSendOffWhenNotRunning(bool send) { if (_sendOffWhenNotRunning != send) { _sendOffWhenNotRunning = send; _changeCount++; } }
     bool IsSendOffWhenNotRunning() const { return _sendOffWhenNotRunning; }
     bool IsParallelTransmission() const { return _parallelTransmission; }
+    bool IsOutputThread() const { return _outputThread; }
+    bool IsBatchedTransmission() const { return _batchedTransmission; }
+    bool IsPacedTransmission() const { return _pacedTransmission; }
+    int GetPacedWindowPercent() const { return _pacedWindowPercent; }
+    int GetPacedMaxPacketsPerMS() const { return _pacedMaxPacketsPerMS; }
     bool IsRemoteAllOff() const { return _remoteAllOff; }
     bool IsKeepScreenOn() const { return _keepScreenOn; }
     bool IsMinimiseUIUpdates() const { return _minimiseUIUpdates; }
@@ -12,6 +12,8 @@
 #include "../xLights/VideoReader.h"
 #include "../xLights/UtilFunctions.h"
 
+#include <atomic>
+
 #include <log4cpp/Category.hh>
 
 //#define VIDEO_EXTRALOGGING
@@ -23,8 +25,8 @@ class CVRThread : public wxThread
     int _maxFrames;
     std::mutex _access;
     wxSize _size;
-    bool _stop;
-    bool _running;
+    std::atomic_bool _stop;
+    std::atomic_bool _running;
     VideoReader* _videoReader;
     int _frameMS;
     CachedVideoReader* _cvr;
@@ -36,6 +38,27 @@ class CVRThread : public wxThread
         return _currentStart;
     }
 
+    void CopyFrame(AVFrame* src, VideoCacheFrame& frame)
+    {
+        if (src == nullptr)
+        {
+            // show black
+            frame.width = _size.GetWidth();
+            frame.height = _size.GetHeight();
+            frame.data.assign((size_t)frame.width * frame.height * 3, 0);
+            return;
+        }
+
+        frame.width = src->width;
+        frame.height = src->height;
+        size_t row = (size_t)frame.width * 3;
+        frame.data.resize(row * frame.height);
+        for (int y = 0; y < frame.height; ++y)
+        {
+            memcpy(frame.data.data() + y * row, src->data[0] + (size_t)y * src->linesize[0], row);
+        }
+    }
+
 public:
     CVRThread(CachedVideoReader* cvr, int maxFrames, const std::string& videoFile, long startMillisecond, int frameMS, const wxSize& size, bool keepAspectRatio)
     {
@@ -117,56 +140,67 @@ public:
         static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
         logger_base.debug("Video reading thread %s (%dx%d) started", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight());
 
-        int lastStart = -1;
+        long lastStart = -1;
+        long skipTo = -1;
 
         while (!_stop)
         {
             long currentStart = GetCurrentStart();
-            if (lastStart != currentStart)
+            if (currentStart < lastStart)
             {
-                _cvr->PurgeCachePriorTo(currentStart);
-
-                lastStart = currentStart;
-                long end = std::min((long)currentStart + _maxFrames * _frameMS, (long)_videoReader->GetLengthMS());
-#ifdef VIDEO_EXTRALOGGING
-                logger_base.debug("Video reading thread %s (%dx%d) filling cache %ld-%ld", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), currentStart, end);
-#endif
+                // gone backwards so forget we were behind
+                skipTo = -1;
+            }
+            lastStart = currentStart;
 
-                // we need to refill the cache
-                for (long i = currentStart ; i < currentStart + _maxFrames * _frameMS && !_stop; i += _frameMS)
+            // the first frame in the window we dont have yet
+            long end = std::min((long)currentStart + _maxFrames * _frameMS, (long)_videoReader->GetLengthMS() + 1);
+            long next = -1;
+            for (long i = std::max(currentStart, skipTo); i < end && !_stop; i += _frameMS)
+            {
+                if (!_cvr->HasFrame(i))
                 {
-                    if (!_cvr->HasFrame(i))
-                    {
-                        wxStopWatch sw;
-
-                        //_videoReader->Seek(i);
-                        _cvr->CacheImage(i, CachedVideoReader::CreateImageFromFrame(_videoReader->GetNextFrame(i), _size));
-
-                        if (sw.Time() > _frameMS)
-                        {
-                            logger_base.warn("Video reading thread %s (%dx%d) took more than %ldms to decode frame %ldms.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), _frameMS, i);
-                        }
-
-                        // if we have fallen behind ... jump ahead - this will cause blank frames
-                        long s = GetCurrentStart();
-                        if (s > i + _frameMS)
-                        {
-                            logger_base.warn("Video reading thread %s (%dx%d) has fallen behind ... jumping ahead ... video will go black.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight());
-                            i = s + 3 * _frameMS;
-                        }
-                    }
+                    next = i;
+                    break;
                 }
             }
-            else
+
+            if (next == -1)
             {
 #ifdef VIDEO_EXTRALOGGING
                 logger_base.debug("Video reading thread %s (%dx%d) waiting for start time to change.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight());
 #endif
                 std::unique_lock<std::mutex> accessLock(_access);
-                _signal.wait(accessLock);
+                _signal.wait(accessLock, [this, currentStart] { return _stop || _currentStart != currentStart; });
 #ifdef VIDEO_EXTRALOGGING
                 logger_base.debug("Video reading thread %s (%dx%d) start time changed.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight());
 #endif
+                continue;
+            }
+
+            wxStopWatch sw;
+
+            // decode straight into the slot ... reusing its memory if the player is done with it
+            auto frame = _cvr->TakeSlot(next);
+            if (frame == nullptr)
+            {
+                frame = std::make_shared<VideoCacheFrame>();
+            }
+            CopyFrame(_videoReader->GetNextFrame(next), *frame);
+            frame->ms = next;
+            _cvr->CacheFrame(next, frame);
+
+            if (sw.Time() > _frameMS)
+            {
+                logger_base.warn("Video reading thread %s (%dx%d) took more than %ldms to decode frame %ldms.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), (long)_frameMS, next);
+            }
+
+            // if we have fallen behind ... jump ahead - the frames we skip will be dropped
+            long s = GetCurrentStart();
+            if (s > next + _frameMS)
+            {
+                logger_base.warn("Video reading thread %s (%dx%d) has fallen behind ... jumping ahead ... frames will be dropped.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight());
+                skipTo = s + 3 * _frameMS;
             }
         }
 
@@ -183,11 +217,14 @@ public:
 
         return nullptr;
     }
-    void SetNewStart(int newStart)
+    void SetNewStart(long newStart)
     {
         std::unique_lock<std::mutex> mutLock(_access);
-        _currentStart = newStart;
-        _signal.notify_all();
+        if (_currentStart != newStart)
+        {
+            _currentStart = newStart;
+            _signal.notify_all();
+        }
     }
 };
 
@@ -251,33 +288,45 @@ CachedVideoReader::~CachedVideoReader()
         logger_base.debug("Cached Video Reader destructor clearing cache.");
 #endif
 
-        _cache.clear();
+        if (_frames > 0)
+        {
+            logger_base.debug("Cached Video Reader %s (%dx%d) played %ld frames, %ld late, %ld dropped.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), _frames, _late, _dropped);
+        }
+
+        _ring.clear();
+        _last = nullptr;
     }
 }
 
-#define TIMEOUT(a) a / 2
+std::shared_ptr<VideoCacheFrame> CachedVideoReader::TakeSlot(long millisecond)
+{
+    std::unique_lock<std::mutex> locker(_cacheAccess);
+    auto& slot = GetSlot(millisecond);
+    std::shared_ptr<VideoCacheFrame> frame;
+    // only reuse it if no one else is holding the frame ... no one can take a new reference while we hold the lock
+    if (slot.frame != nullptr && slot.frame.use_count() == 1)
+    {
+        frame = slot.frame;
+    }
+    slot.ms = -1;
+    slot.frame = nullptr;
+    return frame;
+}
 
-void CachedVideoReader::CacheImage(long millisecond, const wxImage& image)
+void CachedVideoReader::CacheFrame(long millisecond, const std::shared_ptr<VideoCacheFrame>& frame)
 {
 #ifdef VIDEO_EXTRALOGGING
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.debug("Cached image for time %ld.", millisecond);
 #endif
 
-    std::unique_lock<std::mutex> locker(_cacheAccess);
-    auto it = _cache.find(millisecond);
-    if (it == _cache.end())
     {
-#ifdef VIDEO_EXTRALOGGING
-        logger_base.debug("Cached image for time %ld.", millisecond);
-#endif
-        _cache[millisecond] = image.Copy();
-    }
-    else
-    {
-#ifdef VIDEO_EXTRALOGGING
-        logger_base.debug("Cache already had the image.");
-#endif
+        std::unique_lock<std::mutex> locker(_cacheAccess);
+        auto& slot = GetSlot(millisecond);
+        slot.ms = millisecond;
+        slot.frame = frame;
     }
+    _frameCached.notify_all();
 }
 
 void CachedVideoReader::SetLengthMS(long lengthMS)
@@ -286,13 +335,13 @@ void CachedVideoReader::SetLengthMS(long lengthMS)
     _lengthMS = lengthMS;
 }
 
-wxImage CachedVideoReader::GetNextFrame(long ms)
+std::shared_ptr<const VideoCacheFrame> CachedVideoReader::GetNextFrame(long ms)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     if (_thread == nullptr || ms > _lengthMS)
     {
-        return wxImage(_size);
+        return _blank;
     }
 
     // round ms to frame boundary
@@ -300,38 +349,36 @@ wxImage CachedVideoReader::GetNextFrame(long ms)
 
     _thread->SetNewStart(ms);
 
+    std::unique_lock<std::mutex> locker(_cacheAccess);
+    ++_frames;
+
+    auto& slot = GetSlot(ms);
+    if (slot.ms == ms)
     {
-        std::unique_lock<std::mutex> locker(_cacheAccess);
-        auto it = _cache.find(ms);
-        if (it != _cache.end())
-        {
-            return it->second.Copy();
-        }
+        _last = slot.frame;
+        return _last;
     }
 
+    // give it a bit of time ... say half a frame
+    if (_frameCached.wait_for(locker, std::chrono::milliseconds(_frameTime / 2), [&slot, ms] { return slot.ms == ms; }))
     {
-        logger_base.debug("Video %s (%dx%d) tried to get frame %d from cache but it wasnt there ... give it a bit of time.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), ms);
+        ++_late;
+#ifdef VIDEO_EXTRALOGGING
+        logger_base.debug("Video %s (%dx%d) frame %ld arrived late.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), ms);
+#endif
+        _last = slot.frame;
+        return _last;
+    }
 
-        // give it a bit of time ... say half a frame
-        int i = 0;
-        while (i < _frameTime / 2)
-        {
-            wxMilliSleep(2);
-            i += 2;
+    ++_dropped;
+    logger_base.debug("Video %s (%dx%d) tried to get frame %ld from cache but it wasnt there :( %ld dropped so far.", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), ms, _dropped);
 
-            {
-                std::unique_lock<std::mutex> locker(_cacheAccess);
-                auto it = _cache.find(ms);
-                if (it != _cache.end())
-                {
-                    return it->second.Copy();
-                }
-            }
-        }
+    // better to hold the last frame than flash black
+    if (_last != nullptr)
+    {
+        return _last;
     }
-
-    logger_base.debug("Video %s (%dx%d) tried to get frame %d from cache but it wasnt there :(", (const char *)_videoFile.c_str(), _size.GetWidth(), _size.GetHeight(), ms);
-    return wxImage(_size);
+    return _blank;
 }
 
 wxImage CachedVideoReader::CreateImageFromFrame(AVFrame* frame, const wxSize& size)
@@ -385,40 +432,67 @@ wxImage CachedVideoReader::FadeImage(const wxImage& image, int brightness)
 bool CachedVideoReader::HasFrame(long millisecond)
 {
     std::unique_lock<std::mutex> locker(_cacheAccess);
-    auto it = _cache.find(millisecond);
-    return (it != _cache.end());
+    return GetSlot(millisecond).ms == millisecond;
 }
 
-#define CALCCACHESIZE(a) 5 * 1000 / a
-void CachedVideoReader::PurgeCachePriorTo(long start)
+std::shared_ptr<const VideoCacheFrame> CachedVideoReader::FadeFrame(const std::shared_ptr<const VideoCacheFrame>& frame, int brightness)
 {
-    std::unique_lock<std::mutex> locker(_cacheAccess);
+    if (frame == nullptr || brightness >= 100)
+    {
+        return frame;
+    }
+
+    auto faded = std::make_shared<VideoCacheFrame>();
+    faded->ms = frame->ms;
+    faded->width = frame->width;
+    faded->height = frame->height;
 
-    auto it = _cache.begin();
-    while (it != _cache.end())
+    if (brightness <= 0)
+    {
+        faded->data.assign(frame->data.size(), 0);
+    }
+    else
     {
-        if (it->first < start)
+        unsigned char btable[256];
+        for (int i = 0; i < 256; i++)
         {
-            auto next = it;
-            ++next;
-            _cache.erase(it);
-            it = next;
+            btable[i] = i * brightness / 100;
         }
-        else
+
+        faded->data.resize(frame->data.size());
+        const uint8_t* src = frame->data.data();
+        uint8_t* dst = faded->data.data();
+        for (size_t i = 0; i < frame->data.size(); i++)
         {
-            ++it;
+            dst[i] = btable[src[i]];
         }
     }
+
+    return faded;
 }
 
-CachedVideoReader::CachedVideoReader(const std::string& videoFile, long startMillisecond, int frameTime, const wxSize& size, bool keepAspectRatio)
+int CachedVideoReader::GetDefaultLookAhead(int frameTime)
+{
+    // half a second ... at 4K each frame is 25MB so we dont want too many
+    return std::max(4, 500 / std::max(1, frameTime));
+}
+
+CachedVideoReader::CachedVideoReader(const std::string& videoFile, long startMillisecond, int frameTime, const wxSize& size, bool keepAspectRatio, int lookAheadFrames)
 {
     _done = false;
-    _maxItems = CALCCACHESIZE(frameTime);
-    _frameTime = frameTime;
+    _frameTime = std::max(1, frameTime);
+    _maxItems = lookAheadFrames > 0 ? lookAheadFrames : GetDefaultLookAhead(_frameTime);
+    _ring.resize(_maxItems);
     _videoFile = FixFile("", videoFile);
     _size = size;
     _lengthMS = 0;
+
+    auto blank = std::make_shared<VideoCacheFrame>();
+    blank->width = size.GetWidth();
+    blank->height = size.GetHeight();
+    blank->data.assign((size_t)blank->width * blank->height * 3, 0);
+    _blank = blank;
+
     _thread = new CVRThread(this, _maxItems, _videoFile, startMillisecond, _frameTime, _size, keepAspectRatio);
     if (!_thread->IsOk())
     {
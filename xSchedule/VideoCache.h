@@ -11,9 +11,11 @@
  **************************************************************/
 
 #include <mutex>
+#include <condition_variable>
 #include <wx/wx.h>
 #include <string>
-#include <map>
+#include <memory>
+#include <vector>
 #include "../xLights/JobPool.h"
 
 class VideoReader;
@@ -21,10 +23,31 @@ class VideoCacheItem;
 class CVRThread;
 struct AVFrame;
 
+// a decoded frame ready for the player window ... RGB24 at the window size
+struct VideoCacheFrame
+{
+    long ms = -1;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> data;
+};
+
+// Decodes a video on a background thread a fixed number of frames ahead of where it is being played.
+//
+// The frames sit in a ring buffer one slot per frame time. Frames are handed out as shared pointers so nothing is
+// copied on the way to the player window ... the decode thread only reuses a slot's memory once no one else is
+// holding the frame.
 class CachedVideoReader
 {
-    std::map<long, wxImage> _cache;
+    struct Slot
+    {
+        long ms = -1;
+        std::shared_ptr<VideoCacheFrame> frame;
+    };
+
+    std::vector<Slot> _ring;
     std::mutex _cacheAccess;
+    std::condition_variable _frameCached;
     int _maxItems;
     CVRThread* _thread;
     int _frameTime;
@@ -32,21 +55,36 @@ class CachedVideoReader
     wxSize _size;
     long _lengthMS;
     bool _done;
+    std::shared_ptr<const VideoCacheFrame> _blank;
+    std::shared_ptr<const VideoCacheFrame> _last;
+
+    // playback stats
+    long _frames = 0;
+    long _late = 0; // not there when asked for but arrived while we waited
+    long _dropped = 0; // never arrived so we showed something else
+
+    Slot& GetSlot(long ms) { return _ring[(ms / _frameTime) % _maxItems]; }
 
 public:
-    CachedVideoReader(const std::string& videoFile, long startMillisecond, int frameTime, const wxSize& size, bool keepAspectRatio);
+    CachedVideoReader(const std::string& videoFile, long startMillisecond, int frameTime, const wxSize& size, bool keepAspectRatio, int lookAheadFrames = 0);
     virtual ~CachedVideoReader();
 
+    static int GetDefaultLookAhead(int frameTime);
+
     static wxImage CreateImageFromFrame(AVFrame* frame, const wxSize& size);
     static wxImage FadeImage(const wxImage& image, int brightness);
+    static std::shared_ptr<const VideoCacheFrame> FadeFrame(const std::shared_ptr<const VideoCacheFrame>& frame, int brightness);
 
+    // used by the decode thread
     bool HasFrame(long millisecond);
-    void CacheImage(long millisecond, const wxImage& image);
+    std::shared_ptr<VideoCacheFrame> TakeSlot(long millisecond);
+    void CacheFrame(long millisecond, const std::shared_ptr<VideoCacheFrame>& frame);
     void SetLengthMS(long lengthMS);
     void Done();
-    void PurgeCachePriorTo(long start);
 
     long GetLengthMS() const { return _lengthMS; };
-    wxImage GetNextFrame(long ms);
+    int GetLookAhead() const { return _maxItems; }
+    long GetLateFrames() const { return _late; }
+    long GetDroppedFrames() const { return _dropped; }
+    std::shared_ptr<const VideoCacheFrame> GetNextFrame(long ms);
 };
-
@@ -1769,6 +1769,9 @@ void xScheduleFrame::OnMenuItem_OptionsSelected(wxCommandEvent& event)
 
         Schedule::SetCity(__schedule->GetOptions()->GetCity());
         __schedule->GetOutputManager()->SetParallelTransmission(__schedule->GetOptions()->IsParallelTransmission());
+        __schedule->GetOutputManager()->SetBatchedTransmission(__schedule->GetOptions()->IsBatchedTransmission());
+        __schedule->GetOutputManager()->SetPacedTransmission(__schedule->GetOptions()->IsPacedTransmission(), __schedule->GetOptions()->GetPacedWindowPercent(), __schedule->GetOptions()->GetPacedMaxPacketsPerMS());
+        __schedule->GetOutputManager()->SetOutputThread(__schedule->GetOptions()->IsOutputThread());
         OutputManager::SetRetryOpen(__schedule->GetOptions()->IsRetryOpen());
         __schedule->GetOutputManager()->SetSyncEnabled(__schedule->GetOptions()->IsSync());
 